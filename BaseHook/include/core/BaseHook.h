@@ -8,6 +8,8 @@
 #include <imgui.h>
 #include <atomic>
 #include <cstdint>
+#include <filesystem>
+#include <vector>
 #include "hooks/Hooks.h"
 
 // DX9 Types
@@ -15,6 +17,7 @@ typedef long(__stdcall* EndScene_t)(LPDIRECT3DDEVICE9);
 typedef HRESULT(__stdcall* Reset_t)(LPDIRECT3DDEVICE9, D3DPRESENT_PARAMETERS*);
 typedef HRESULT(__stdcall* ResetEx_t)(IDirect3DDevice9Ex*, D3DPRESENT_PARAMETERS*, D3DDISPLAYMODEEX*);
 typedef HRESULT(__stdcall* Present9_t)(LPDIRECT3DDEVICE9, CONST RECT*, CONST RECT*, HWND, CONST RGNDATA*);
+typedef HRESULT(__stdcall* SwapChainPresent9_t)(IDirect3DSwapChain9*, CONST RECT*, CONST RECT*, HWND, CONST RGNDATA*, DWORD);
 typedef HRESULT(__stdcall* TestCooperativeLevel_t)(LPDIRECT3DDEVICE9);
 
 // DX10/11 Types
@@ -93,6 +96,7 @@ namespace BaseHook
         // Input Management
         extern thread_local bool                   bCallingImGui;   // True when ImGui_ImplWin32_NewFrame is polling inputs
         extern std::atomic<unsigned long long>     lastXInputTime;  // Timestamp of last successful XInput poll
+        extern std::atomic<long long>              firstFrameEndUs; // Trace::NowUs() when the first overlay frame was drawn; 0 before
 
         // DX9
         extern IDirect3DDevice9* pDevice;
@@ -100,6 +104,7 @@ namespace BaseHook
         extern Reset_t           oReset;
         extern ResetEx_t         oResetEx;
         extern Present9_t        oPresent9;
+        extern SwapChainPresent9_t oSwapChainPresent9;
         extern TestCooperativeLevel_t oTestCooperativeLevel;
         extern std::atomic<FakeResetState> g_fakeResetState;
 
@@ -124,6 +129,14 @@ namespace BaseHook
         extern UINT DetachDll;
     }
 
+    // What the overlay currently needs from the render hooks (see OverlayFrameGate).
+    enum class OverlayActivity : int
+    {
+        Active, // Interactive or changing: build a full ImGui frame
+        Static, // Visible but unchanged: re-submit the last draw data, rebuild occasionally
+        Idle    // Nothing visible and nothing focused: skip ImGui entirely
+    };
+
     class Settings
     {
     public:
@@ -144,6 +157,14 @@ namespace BaseHook
 
         bool m_RenderInBackground;
 
+        // Font glyph cache (util/FontAtlasCache.h); empty = rasterize every run
+        std::filesystem::path m_FontCacheDir;
+        // Sizes to bake up front, as multiples of the 16 px font size
+        std::vector<float> m_FontPreloadScales;
+
+        // Swap chain vtable slots per DXGI build (util/VTableCache.h); empty = always discover
+        std::filesystem::path m_VTableCachePath;
+
     public:
         Settings(WndProc_t wndProc = BaseHook::Hooks::WndProc_Base, bool bSaveImGuiIni = false)
             : m_WndProc(wndProc), m_bSaveImGuiIni(bSaveImGuiIni),
@@ -159,6 +180,13 @@ namespace BaseHook
         virtual void DrawMenu() = 0;    // Replaces ImGuiLayer_WhenMenuIsOpen
         virtual void DrawOverlay() = 0; // Replaces ImGuiLayer_EvenWhenMenuIsClosed
 
+        // Idle fast path. Queried once per frame before any ImGui work; the default keeps
+        // building a full frame every time.
+        virtual OverlayActivity GetOverlayActivity() { return OverlayActivity::Active; }
+        // Called instead of DrawOverlay() on frames without an ImGui frame. Must not call ImGui
+        // widgets; meant for hotkey polling and other per-frame bookkeeping.
+        virtual void UpdateWithoutFrame() {}
+
         virtual ~Settings() {}
     };
 }
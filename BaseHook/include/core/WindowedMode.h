@@ -3,6 +3,8 @@
 #include <atomic>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include "util/GeometryTransform.h"
 
 namespace BaseHook
 {
@@ -166,6 +168,25 @@ namespace BaseHook
         int GetCurrentMonitorIndex();
         int GetPrimaryMonitorIndex();
 
+        // Main-window geometry used by the coordinate hooks (GetCursorPos, SetCursorPos, ClipCursor,
+        // mouse messages, ...). Rebuilt only after InvalidateGeometry() (WM_SIZE, WM_MOVE, WM_DPICHANGED,
+        // display changes, resolution changes) instead of re-querying User32 on every call, and
+        // published under a sequence counter so readers on any thread never take a lock.
+        struct GeometrySnapshot
+        {
+            HWND hWnd = NULL;
+            RECT windowRect{};  // Physical screen rect
+            RECT clientRect{};  // Physical client rect (0,0,w,h)
+            RECT monitorRect{}; // Monitor the window is on
+            Geometry::ClientTransform transform;
+            uint32_t generation = 0; // InvalidateGeometry() count this snapshot reflects
+            bool valid = false;
+        };
+
+        void InvalidateGeometry();
+        // Copies the current snapshot, rebuilding it first if it is stale. Returns snapshot.valid.
+        bool GetGeometry(GeometrySnapshot& out);
+
         // Coordinate transforms (Virtual <-> Physical Client)
         // NOTE: Uses original (unhooked) User32 calls via BaseHook::Data to avoid recursion.
         // Replaces local helpers in WindowHooks.
@@ -187,7 +208,9 @@ namespace BaseHook
 
         // Multi-viewport support
         bool IsMainViewportWindow(HWND hWnd);
-        bool IsImGuiPlatformWindow(HWND hWnd);
+        bool IsImGuiPlatformWindow(HWND hWnd); // Cached; only true for this process's platform windows
+        void RegisterImGuiPlatformWindow(HWND hWnd);
+        void ForgetWindow(HWND hWnd); // Drops a cached classification (window destroyed)
         bool IsMultiViewportEnabled();
         void SetMultiViewportEnabled(bool enabled);
         void SetMultiViewportScalingMode(ViewportScalingMode mode);
@@ -8,5 +8,9 @@ namespace BaseHook::Hooks
     HRESULT __stdcall hkReset(LPDIRECT3DDEVICE9 pDevice, D3DPRESENT_PARAMETERS* pPresentationParameters);
     HRESULT __stdcall hkResetEx(IDirect3DDevice9Ex* pDevice, D3DPRESENT_PARAMETERS* pPresentationParameters, D3DDISPLAYMODEEX* pFullscreenDisplayMode);
     HRESULT __stdcall hkPresent9(LPDIRECT3DDEVICE9 pDevice, CONST RECT* pSourceRect, CONST RECT* pDestRect, HWND hDestWindowOverride, CONST RGNDATA* pDirtyRegion);
+    HRESULT __stdcall hkSwapChainPresent9(IDirect3DSwapChain9* pSwapChain, CONST RECT* pSourceRect, CONST RECT* pDestRect, HWND hDestWindowOverride, CONST RGNDATA* pDirtyRegion, DWORD dwFlags);
     HRESULT __stdcall hkTestCooperativeLevel(LPDIRECT3DDEVICE9 pDevice);
+
+    // Drops the back buffer reference kept for the per-frame render target checks.
+    void ReleaseCachedBackBuffer();
 }
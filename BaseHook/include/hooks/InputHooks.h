@@ -1,6 +1,10 @@
 #pragma once
 #include <Windows.h>
 #include <XInput.h>
+#include <filesystem>
+#include "IPlugin.h"
+#include "util/LatencyHistogram.h"
+#include "util/PadPresence.h"
 
 namespace BaseHook::Hooks
 {
@@ -9,6 +13,17 @@ namespace BaseHook::Hooks
     void CleanupDirectInput();
     void NotifyDirectInputWindow(HWND hWnd);
     void ApplyBufferedInput();
+
+    // DirectInput mouse events queued for ImGui since startup.
+    struct InputQueueStats
+    {
+        uint64_t events = 0;
+        uint64_t coalesced = 0;     // Adjacent moves merged on the render thread
+        uint64_t dropped = 0;       // Lost because the queue was full
+    };
+    InputQueueStats GetMouseQueueStats();
+    // Render thread: DirectInput mouse events for ImGui are waiting for the next ApplyBufferedInput.
+    bool HasBufferedMouseInput();
     
     enum class GamepadInputSource : uint8_t
     {
@@ -19,6 +34,29 @@ namespace BaseHook::Hooks
     };
 
     bool TryGetVirtualXInputState(DWORD dwUserIndex, XINPUT_STATE* pState);
-    bool SubmitVirtualGamepadState(GamepadInputSource source, void* context, const XINPUT_STATE& state, bool markAuthoritative, bool* outSourceChanged = nullptr);
+    // sourceTimeUs: QPC time (us) the source data arrived; 0 = now.
+    bool SubmitVirtualGamepadState(GamepadInputSource source, void* context, const XINPUT_STATE& state, bool markAuthoritative, bool* outSourceChanged = nullptr, int64_t sourceTimeUs = 0);
     void ResetVirtualGamepad(GamepadInputSource sourceFilter = GamepadInputSource::None, void* contextFilter = nullptr);
+
+    // Gyro/accelerometer/touchpad of the Sony controller driving the virtual pad. False if none.
+    bool TryGetControllerMotion(ControllerMotionState* out);
+
+    // TryGetVirtualXInputState for the game's own XInputGetState: the first time an update is handed
+    // out, its age is recorded in the pad latency histogram.
+    bool ConsumeVirtualXInputState(DWORD dwUserIndex, XINPUT_STATE* pState);
+    const LatencyHistogram& GetPadLatencyHistogram();
+    void ResetPadLatencyHistogram();
+
+    // Background XInput slot monitor (started by InitXInput). Wake it on device changes; false
+    // from GetPadPresence until the first probe has finished.
+    void StartPadPresenceMonitor();
+    void StopPadPresenceMonitor();
+    void WakePadPresenceMonitor();
+    bool GetPadPresence(PadPresence* out);
+
+    // Records every raw Sony HID read to `path` (see util/InputRecording.h) until stopped.
+    bool StartInputRecording(const std::filesystem::path& path);
+    void StopInputRecording();
+    bool IsInputRecordingActive();
+    uint64_t GetRecordedInputReads();
 }
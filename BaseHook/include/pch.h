@@ -24,3 +24,4 @@
 
 #include <iostream>
 #include "log.h"
+#include "Trace.h"
@@ -0,0 +1,34 @@
+#pragma once
+#include "util/AllocationTally.h"
+#include <Windows.h>
+#include <atomic>
+
+namespace BaseHook {
+
+    // Opt-in count of CRT heap allocations per presented frame, for spotting UI code that
+    // allocates every frame. Hooks malloc/calloc/realloc in the shared CRT (ucrtbase), which
+    // covers operator new and every module built against the DLL runtime (loader, plugins, ImGui),
+    // on all threads. The game's own allocator is not counted.
+    class AllocationCounter {
+    public:
+        using FrameStats = AllocationTally::FrameStats;
+
+        // Installs the hooks on first enable. Returns false if they couldn't be installed.
+        bool SetEnabled(bool enabled);
+        bool IsEnabled() const { return m_enabled; }
+
+        // Called once per frame by the render hooks; closes the current frame's counts.
+        void OnFrame();
+
+        FrameStats GetLastFrame() const;
+        uint32_t GetPeakAllocations() const;
+
+    private:
+        bool InstallHooks();
+
+        std::atomic<bool> m_enabled = false;
+        bool m_hooksInstalled = false;
+    };
+
+    extern AllocationCounter g_AllocationCounter;
+}
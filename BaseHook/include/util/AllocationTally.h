@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BaseHook {
+
+    // The bookkeeping behind AllocationCounter: counts for the frame in progress, the last closed
+    // frame and the peak. Add() is called from every allocating thread and is two relaxed adds;
+    // CloseFrame() and Reset() come from the render thread. An allocation racing with CloseFrame()
+    // may land its count in one frame and its bytes in the next.
+    //
+    // Win32-free so it can be exercised anywhere.
+    class AllocationTally {
+    public:
+        struct FrameStats {
+            uint32_t allocations = 0;
+            uint64_t bytes = 0;
+        };
+
+        void Add(size_t bytes)
+        {
+            m_allocations.fetch_add(1, std::memory_order_relaxed);
+            m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        // Ends the frame in progress: its counts become the last frame's and may raise the peak.
+        void CloseFrame()
+        {
+            const uint32_t allocations = m_allocations.exchange(0, std::memory_order_relaxed);
+            m_lastAllocations.store(allocations, std::memory_order_relaxed);
+            m_lastBytes.store(m_bytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            if (allocations > m_peakAllocations.load(std::memory_order_relaxed))
+                m_peakAllocations.store(allocations, std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            m_allocations.store(0, std::memory_order_relaxed);
+            m_bytes.store(0, std::memory_order_relaxed);
+            m_lastAllocations.store(0, std::memory_order_relaxed);
+            m_lastBytes.store(0, std::memory_order_relaxed);
+            m_peakAllocations.store(0, std::memory_order_relaxed);
+        }
+
+        FrameStats GetLastFrame() const { return { m_lastAllocations.load(std::memory_order_relaxed), m_lastBytes.load(std::memory_order_relaxed) }; }
+        uint32_t GetPeakAllocations() const { return m_peakAllocations.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint32_t> m_allocations{ 0 };
+        std::atomic<uint64_t> m_bytes{ 0 };
+        std::atomic<uint32_t> m_lastAllocations{ 0 };
+        std::atomic<uint64_t> m_lastBytes{ 0 };
+        std::atomic<uint32_t> m_peakAllocations{ 0 };
+    };
+}
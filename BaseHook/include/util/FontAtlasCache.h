@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+struct ImFontAtlas;
+
+namespace BaseHook {
+
+    // Rasterized glyphs of one font file. Each bake is keyed by everything that changes the bitmap or
+    // its placement (size, density, oversampling, offsets), and the file by a hash of the font data and
+    // the font loader, so a cache is never applied to a different font or rasterizer.
+    class GlyphCache {
+    public:
+        struct BakeKey {
+            float size = 0.0f;
+            float density = 1.0f;
+            float offsetX = 0.0f;       // Snapped GlyphOffset at this size
+            float offsetY = 0.0f;       // Same, plus the rounded ascent
+            uint8_t oversampleH = 1;
+            uint8_t oversampleV = 1;
+
+            bool operator==(const BakeKey& other) const;
+        };
+
+        struct Glyph {
+            bool visible = false;
+            float advanceX = 0.0f;
+            float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;   // Quad relative to the pen position
+            uint16_t width = 0, height = 0;
+            std::vector<uint8_t> pixels;                       // Alpha8, width * height
+        };
+
+        explicit GlyphCache(uint64_t fontHash = 0) : m_fontHash(fontHash) {}
+
+        const Glyph* Find(const BakeKey& key, uint32_t codepoint) const;
+        void Add(const BakeKey& key, uint32_t codepoint, Glyph glyph);
+
+        uint64_t GetFontHash() const { return m_fontHash; }
+        size_t GetBakeCount() const { return m_bakes.size(); }
+        size_t GetGlyphCount() const;
+
+        // Header (magic, format version, ImGui version, font hash, payload size and hash), then the bakes.
+        std::vector<uint8_t> Serialize(uint32_t imguiVersion) const;
+        // False, leaving the cache unchanged, if the data is truncated or corrupt, or was written for
+        // another font or ImGui version.
+        bool Deserialize(const uint8_t* data, size_t size, uint32_t imguiVersion);
+
+        // FNV-1a
+        static uint64_t Hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+    private:
+        struct Bake {
+            BakeKey key;
+            std::unordered_map<uint32_t, Glyph> glyphs;
+        };
+
+        uint64_t m_fontHash;
+        std::vector<Bake> m_bakes;
+    };
+
+    // Font loader that serves glyphs from a GlyphCache per font file and only falls back to the
+    // atlas' previous loader (stb_truetype) for glyphs it hasn't seen. With the dynamic atlas,
+    // glyphs are baked on first use at each size; the cache keeps every one of them across runs.
+    namespace FontAtlasCache {
+        struct Stats {
+            uint32_t fonts = 0;
+            uint32_t cachedGlyphs = 0;
+            uint32_t hits = 0;          // Glyphs copied from the cache this run
+            uint32_t misses = 0;        // Glyphs rasterized this run
+            double loadMs = 0.0;        // Reading and validating cache files
+        };
+
+        // Call before adding fonts. Cache files go to `directory` (created on the first write).
+        void Install(ImFontAtlas* atlas, const std::filesystem::path& directory);
+
+        // Bakes printable ASCII of every font at each scale of its configured size, so switching to
+        // one of those sizes later doesn't stall a frame.
+        void Preload(ImFontAtlas* atlas, const std::vector<float>& scales);
+
+        // Writes caches that gained glyphs. Safe to call from any thread.
+        void Flush();
+
+        Stats GetStats();
+    }
+
+} // namespace BaseHook
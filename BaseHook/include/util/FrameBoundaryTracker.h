@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+
+namespace BaseHook {
+
+    enum class OverlayDrawPoint : uint8_t {
+        None,       // Nothing submitted yet this frame
+        EndScene,   // Inside the game's last back-buffer scene
+        Present,    // In a scene of our own just before Present
+    };
+
+    // D3D9 games call BeginScene/EndScene several times per frame (shadow maps, reflections,
+    // post-processing), so EndScene is not a frame boundary; Present is. This decides where in a
+    // frame the overlay goes, so it's built and drawn once per presented frame:
+    //  - Once the number of EndScenes per frame has been the same for a few frames, the overlay is
+    //    drawn in the last of them, inside the game's own scene, if that scene targets the back buffer.
+    //  - Otherwise (still learning, the last scene renders off-screen, or the frame had fewer scenes
+    //    than expected) it is drawn just before Present. A frame with more scenes than expected
+    //    drops back to learning.
+    // Only the candidate scene needs its render target checked, so the caller passes that check as
+    // a callable: at most one query per frame, none while learning.
+    // Render thread only; no D3D dependency.
+    class FrameBoundaryTracker {
+    public:
+        struct FrameStats {
+            uint32_t endScenes = 0;             // All EndScene calls
+            uint32_t targetChecks = 0;          // Render target queries (0 or 1)
+            uint32_t builds = 0;                // ImGui frames built
+            uint32_t draws = 0;                 // Draw data submissions
+            OverlayDrawPoint drawPoint = OverlayDrawPoint::None;
+        };
+
+        // Consecutive frames with the same scene count before drawing moves into EndScene.
+        static constexpr uint32_t kStableFrames = 8;
+
+        // Every EndScene, before the original. `targetsBackBuffer()` is only called for the scene the
+        // overlay would go in. True = draw the overlay now.
+        template <typename TargetCheck>
+        bool OnEndScene(TargetCheck&& targetsBackBuffer)
+        {
+            if (!IsDrawCandidate())
+                return false;
+            ++m_current.targetChecks;
+            if (!targetsBackBuffer())
+                return false;
+            m_current.drawPoint = OverlayDrawPoint::EndScene;
+            return true;
+        }
+
+        // Before the original Present. True = the overlay hasn't been drawn this frame; draw it now.
+        bool ShouldDrawBeforePresent();
+
+        // Reported by the caller when it actually did the work (the overlay gate may skip both).
+        void OnOverlayBuilt() { ++m_current.builds; }
+        void OnOverlayDrawn() { ++m_current.draws; }
+
+        // After the overlay work for the frame, before the original Present. Closes the frame.
+        void OnPresent();
+
+        // Device reset or resize: learn the scene count again.
+        void Invalidate();
+
+        bool IsAnchoredToEndScene() const { return m_stableFrames >= kStableFrames; }
+        const FrameStats& GetLastFrame() const { return m_last; }
+
+    private:
+        // Counts the EndScene; true if it is the last one of a stable frame and nothing drew yet.
+        bool IsDrawCandidate();
+
+        FrameStats m_current;
+        FrameStats m_last;
+        uint32_t m_expectedScenes = 0;  // EndScenes in the previous frame
+        uint32_t m_stableFrames = 0;
+    };
+
+    extern FrameBoundaryTracker g_FrameBoundary;
+}
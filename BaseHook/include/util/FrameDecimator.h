@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace BaseHook {
+
+    // Decides which frames rebuild the ImGui frame while the overlay is interactive, when the UI is
+    // capped to a rate below the game's framerate. The frames in between re-submit the last draw data.
+    //
+    // - Rebuilds are scheduled on a fixed grid (1/rate apart) rather than "1/rate after the last one",
+    //   so a 60 Hz UI on a 144 Hz game averages 60 Hz instead of rounding down to every third frame.
+    // - Input rebuilds at once, and so do the next kSettleFrames frames: ImGui often shows the result
+    //   of an event a frame later (popups opening, hover after a click, trickled input events).
+    // - Invalidate() (overlay just became interactive, resize, device reset) forces the next frame.
+    //
+    // Win32-free so it can be exercised anywhere.
+    class FrameDecimator {
+    public:
+        static constexpr int kSettleFrames = 2;
+
+        // 0 rebuilds every frame.
+        void SetRateHz(int hz) { m_rateHz = hz > 0 ? hz : 0; }
+        int GetRateHz() const { return m_rateHz; }
+
+        // Once per frame. `inputPending`: input arrived that no ImGui frame has seen yet.
+        bool ShouldRebuild(int64_t nowUs, bool inputPending);
+
+        void Invalidate() { m_valid = false; }
+
+        uint64_t GetRebuiltFrames() const { return m_rebuiltFrames; }
+        uint64_t GetReusedFrames() const { return m_reusedFrames; }
+
+    private:
+        std::atomic<int> m_rateHz{ 0 };
+        bool m_valid = false;
+        int64_t m_nextRebuildUs = 0;
+        int m_settleFrames = 0;
+        uint64_t m_rebuiltFrames = 0;
+        uint64_t m_reusedFrames = 0;
+    };
+
+} // namespace BaseHook
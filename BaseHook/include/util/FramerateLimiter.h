@@ -3,9 +3,20 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include "util/LatencyHistogram.h"
+#include "IPlugin.h"
+#include "FrameClock.h"
 
 namespace BaseHook {
 
+    // Where the frame's wait happens. Only one site waits per frame: once a game hook waits in the
+    // game loop, the Present wait of that frame is skipped.
+    enum class FrameWaitSite : uint8_t {
+        Present,    // BaseHook's Present hooks
+        GameLoop,   // The game's own throttle point, redirected by a plugin (AC2 FPS unlock)
+        Count
+    };
+
     struct FrameStats {
         double currentFps = 0.0; // Smoothed over last ~500ms
         double avgFps = 0.0;     // Rolling average over history buffer
@@ -27,12 +38,21 @@ namespace BaseHook {
         bool IsEnabled() const { return m_enabled; }
         double GetTargetFPS() const { return m_targetFPS; }
 
-        // Core - Must be called just before Present
-        void Wait();
+        // Core - Must be called just before Present (and from the game's throttle point, if hooked)
+        void Wait(FrameWaitSite site = FrameWaitSite::Present);
 
         // Stats (Thread Safe)
         FrameStats GetStats() const;
 
+        // The site that did the most recent wait.
+        FrameWaitSite GetControllingSite() const { return static_cast<FrameWaitSite>(m_controllingSite.load(std::memory_order_relaxed)); }
+        // How far past the deadline each site woke up.
+        const LatencyHistogram& GetOversleep(FrameWaitSite site) const { return m_oversleep[static_cast<size_t>(site)]; }
+        void ResetOversleep();
+
+        // Frame clock, advanced at every Present. False until two frames have been presented.
+        bool GetFrameTiming(FrameTiming& out) const;
+
     private:
         // Timer
         LARGE_INTEGER m_qpcFreq = {};
@@ -56,10 +76,18 @@ namespace BaseHook {
         std::vector<double> m_history;
         size_t m_historyIdx = 0;
         LONGLONG m_lastPresentTime = 0;
+        LONGLONG m_clockStartQPC = 0;
+        FrameDeltaSmoother m_deltaSmoother;
+        FrameTiming m_timing = {};                  // Guarded by m_statsMutex
         mutable std::mutex m_statsMutex;
         mutable std::mutex m_settingsMutex;
         bool m_resetRequired = false;
 
+        // Wait sites
+        std::atomic<bool> m_gameLoopWaited{ false };    // Since the last Present
+        std::atomic<uint8_t> m_controllingSite{ 0 };
+        LatencyHistogram m_oversleep[static_cast<size_t>(FrameWaitSite::Count)];
+
         // Cached stats to avoid re-sorting every frame for UI
         mutable FrameStats m_cachedStats;
         mutable LONGLONG m_lastStatsUpdate = 0;
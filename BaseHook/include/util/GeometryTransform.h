@@ -0,0 +1,84 @@
+#pragma once
+#include <cmath>
+
+// Coordinate math for windowed-mode virtualization: the game renders at a virtual resolution
+// while the window's client area has some other physical size/position. Kept free of Win32 so it
+// can be built and checked anywhere; WindowedMode feeds it from its cached geometry snapshot.
+namespace BaseHook
+{
+    namespace Geometry
+    {
+        struct ClientTransform
+        {
+            int clientW = 0;    // Physical client size of the main window
+            int clientH = 0;
+            int originX = 0;    // Client (0,0) in physical screen coordinates
+            int originY = 0;
+            int virtualW = 0;   // Resolution reported to the game
+            int virtualH = 0;
+
+            // Precomputed ratios; same float expressions the per-call code used, so results match exactly.
+            float toVirtualX = 0.0f;  // virtual / physical
+            float toVirtualY = 0.0f;
+            float toPhysicalX = 0.0f; // physical / virtual
+            float toPhysicalY = 0.0f;
+
+            bool IsValid() const { return clientW > 0 && clientH > 0 && virtualW > 0 && virtualH > 0; }
+        };
+
+        inline ClientTransform MakeClientTransform(int clientW, int clientH, int originX, int originY, int virtualW, int virtualH)
+        {
+            ClientTransform t;
+            t.clientW = clientW;
+            t.clientH = clientH;
+            t.originX = originX;
+            t.originY = originY;
+            t.virtualW = virtualW;
+            t.virtualH = virtualH;
+            if (t.IsValid())
+            {
+                t.toVirtualX = (float)virtualW / (float)clientW;
+                t.toVirtualY = (float)virtualH / (float)clientH;
+                t.toPhysicalX = (float)clientW / (float)virtualW;
+                t.toPhysicalY = (float)clientH / (float)virtualH;
+            }
+            return t;
+        }
+
+        // Physical client -> virtual client
+        inline void PhysicalClientToVirtual(const ClientTransform& t, int& x, int& y)
+        {
+            x = (int)std::lroundf((float)x * t.toVirtualX);
+            y = (int)std::lroundf((float)y * t.toVirtualY);
+        }
+
+        // Virtual client -> physical client
+        inline void VirtualClientToPhysical(const ClientTransform& t, int& x, int& y)
+        {
+            x = (int)std::lroundf((float)x * t.toPhysicalX);
+            y = (int)std::lroundf((float)y * t.toPhysicalY);
+        }
+
+        // Physical screen -> virtual (the virtual window sits at 0,0, so virtual screen == virtual client)
+        inline void PhysicalScreenToVirtual(const ClientTransform& t, int& x, int& y)
+        {
+            x -= t.originX;
+            y -= t.originY;
+            PhysicalClientToVirtual(t, x, y);
+        }
+
+        // Virtual -> physical screen
+        inline void VirtualToPhysicalScreen(const ClientTransform& t, int& x, int& y)
+        {
+            VirtualClientToPhysical(t, x, y);
+            x += t.originX;
+            y += t.originY;
+        }
+
+        inline void VirtualSizeToPhysical(const ClientTransform& t, int& w, int& h)
+        {
+            w = (int)std::lroundf((float)w * (float)t.clientW / (float)t.virtualW);
+            h = (int)std::lroundf((float)h * (float)t.clientH / (float)t.virtualH);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Small fixed-size map from window handle to a yes/no classification, for hooks that are called
+// every frame and need "is this one of ours?" without a syscall.
+//
+// - Open addressing with linear probing over packed 64-bit slots (key | class << 32), so a reader
+//   always sees a key and its class together. Lookups are lock-free; writers serialize on a mutex.
+// - Keys are the low 32 bits of the handle. Win32 user handles (HWND) only use 32 significant bits,
+//   even in 64-bit processes. 0 is reserved for empty slots and is never cached.
+// - Forget() keeps the key (as Unknown) so probe chains stay intact. When the table gets crowded,
+//   everything except Match entries is dropped and the table is rebuilt. Readers racing with a
+//   rebuild just see Unknown and fall back to their slow path.
+//
+// Win32-free so it can be exercised anywhere.
+template <size_t Capacity>
+class HandleClassCache
+{
+    static_assert(Capacity >= 8 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    enum class Class : uint8_t { Unknown = 0, Match = 1, Other = 2 };
+
+    Class Find(uint32_t key) const
+    {
+        if (key == 0)
+            return Class::Unknown;
+
+        size_t index = Hash(key);
+        for (size_t probe = 0; probe < Capacity; ++probe, index = (index + 1) & (Capacity - 1))
+        {
+            const uint64_t slot = m_slots[index].load(std::memory_order_acquire);
+            if (slot == 0)
+                return Class::Unknown;
+            if ((uint32_t)slot == key)
+                return (Class)(slot >> 32);
+        }
+        return Class::Unknown;
+    }
+
+    void Set(uint32_t key, Class cls)
+    {
+        if (key == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (!Store(key, cls))
+        {
+            Purge();
+            Store(key, cls);
+        }
+    }
+
+    void Forget(uint32_t key)
+    {
+        if (key == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const size_t index = Locate(key);
+        if (index != kNotFound)
+            m_slots[index].store(Pack(key, Class::Unknown), std::memory_order_release);
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        for (auto& slot : m_slots)
+            slot.store(0, std::memory_order_release);
+        m_used = 0;
+    }
+
+    size_t GetUsedSlots() const { return m_used; }
+    size_t GetPurgeCount() const { return m_purges; }
+
+private:
+    static constexpr size_t kNotFound = (size_t)-1;
+    static constexpr size_t kMaxLoad = Capacity * 3 / 4;
+
+    static constexpr unsigned Log2(size_t v) { return v <= 1 ? 0 : 1 + Log2(v >> 1); }
+    static constexpr unsigned kHashShift = 32 - Log2(Capacity);
+
+    // Fibonacci hashing: take the top bits, so handles that only differ in their low bits still spread.
+    static size_t Hash(uint32_t key) { return (size_t)((uint32_t)(key * 2654435761u) >> kHashShift); }
+    static uint64_t Pack(uint32_t key, Class cls) { return (uint64_t)key | ((uint64_t)cls << 32); }
+
+    // Writer-side helpers (m_writeMutex held)
+    size_t Locate(uint32_t key) const
+    {
+        size_t index = Hash(key);
+        for (size_t probe = 0; probe < Capacity; ++probe, index = (index + 1) & (Capacity - 1))
+        {
+            const uint64_t slot = m_slots[index].load(std::memory_order_relaxed);
+            if (slot == 0)
+                return kNotFound;
+            if ((uint32_t)slot == key)
+                return index;
+        }
+        return kNotFound;
+    }
+
+    bool Store(uint32_t key, Class cls)
+    {
+        size_t index = Hash(key);
+        for (size_t probe = 0; probe < Capacity; ++probe, index = (index + 1) & (Capacity - 1))
+        {
+            const uint64_t slot = m_slots[index].load(std::memory_order_relaxed);
+            if (slot != 0 && (uint32_t)slot != key)
+                continue;
+
+            if (slot == 0)
+            {
+                if (m_used >= kMaxLoad)
+                    return false;
+                ++m_used;
+            }
+            m_slots[index].store(Pack(key, cls), std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    void Purge()
+    {
+        uint32_t keep[Capacity];
+        size_t keepCount = 0;
+        for (auto& slot : m_slots)
+        {
+            const uint64_t value = slot.load(std::memory_order_relaxed);
+            if (value != 0 && (Class)(value >> 32) == Class::Match)
+                keep[keepCount++] = (uint32_t)value;
+            slot.store(0, std::memory_order_release);
+        }
+
+        m_used = 0;
+        for (size_t i = 0; i < keepCount; ++i)
+            Store(keep[i], Class::Match);
+        ++m_purges;
+    }
+
+    std::atomic<uint64_t> m_slots[Capacity] = {};
+    std::mutex m_writeMutex;
+    size_t m_used = 0;
+    size_t m_purges = 0;
+};
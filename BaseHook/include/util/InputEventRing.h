@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BaseHook {
+
+    // One input change, stamped by whoever saw it. `buttons` is the mouse button mask (bit i =
+    // button i) after the event, so consumers can tell whether motion happened with a button held.
+    struct InputEvent {
+        enum class Type : uint8_t { Move, Button, Wheel, Key, Char };
+
+        Type type = Type::Move;
+        uint8_t buttons = 0;
+        uint8_t down = 0;           // Button / Key: pressed
+        uint8_t code = 0;           // Button: index; Key: virtual key
+        int32_t x = 0;              // Move: relative X; Wheel: horizontal delta; Char: UTF-16 unit
+        int32_t y = 0;              // Move: relative Y; Wheel: vertical delta
+        int64_t timeUs = 0;
+    };
+
+    // Fixed-size single-producer single-consumer queue of input events. Push and Pop never block or
+    // allocate; the producer and consumer only share the two indices. A full ring drops the new event
+    // and counts it, so the consumer still sees everything before the overflow in order.
+    //
+    // Win32-free so it can be exercised anywhere.
+    template <size_t Capacity>
+    class InputEventRing
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Producer side.
+        bool Push(const InputEvent& event)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_tail.load(std::memory_order_acquire) >= Capacity)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_events[head & (Capacity - 1)] = event;
+            m_head.store(head + 1, std::memory_order_release);
+            m_pushed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Consumer side.
+        bool Pop(InputEvent& out)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire))
+                return false;
+            out = m_events[tail & (Capacity - 1)];
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Calls fn(const InputEvent&) for everything queued when it starts, oldest first.
+        template <typename Fn>
+        size_t Drain(Fn&& fn)
+        {
+            const size_t head = m_head.load(std::memory_order_acquire);
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t count = head - tail;
+            for (; tail != head; ++tail)
+                fn(m_events[tail & (Capacity - 1)]);
+            m_tail.store(tail, std::memory_order_release);
+            return count;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_tail.load(std::memory_order_relaxed) == m_head.load(std::memory_order_acquire);
+        }
+
+        // Any thread.
+        uint64_t GetPushedCount() const { return m_pushed.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+        static constexpr size_t GetCapacity() { return Capacity; }
+
+    private:
+        alignas(64) std::atomic<size_t> m_head{ 0 };     // Written by the producer
+        alignas(64) std::atomic<size_t> m_tail{ 0 };     // Written by the consumer
+        alignas(64) std::atomic<uint64_t> m_pushed{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+        InputEvent m_events[Capacity];
+    };
+
+    // Folds a Move into the previous event when that is also a Move with the same button mask (deltas
+    // add up, the later timestamp wins). Anything else in between, including a button change, keeps
+    // the motion on either side of it apart. Returns true if `event` was folded into `last`.
+    inline bool CoalesceMove(InputEvent& last, const InputEvent& event)
+    {
+        if (event.type != InputEvent::Type::Move || last.type != InputEvent::Type::Move || last.buttons != event.buttons)
+            return false;
+        last.x += event.x;
+        last.y += event.y;
+        last.timeUs = event.timeUs;
+        return true;
+    }
+
+    // Coalesces adjacent moves in events[0, count) in place; returns the new count.
+    inline size_t CoalesceMoves(InputEvent* events, size_t count)
+    {
+        size_t out = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (out > 0 && CoalesceMove(events[out - 1], events[i]))
+                continue;
+            events[out++] = events[i];
+        }
+        return out;
+    }
+
+} // namespace BaseHook
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace BaseHook::InputRecording {
+
+    // Raw controller input as it was read (one record per HID read, possibly several reports), with
+    // its arrival time, so a session can be fed through the decoder and the pad merge again.
+    //
+    // File layout, little-endian:
+    //   "ACIN", uint32 version
+    //   per record: int64 timeUs (since the first record), uint8 controllerType (Sony::ControllerType),
+    //               uint8 reserved, uint16 reportSize, uint32 byteCount, byteCount bytes
+    constexpr uint32_t kVersion = 1;
+
+    struct Record {
+        int64_t timeUs = 0;
+        uint8_t controllerType = 0;
+        uint16_t reportSize = 0;
+        std::vector<uint8_t> data;
+    };
+
+    class Writer {
+    public:
+        ~Writer() { Close(); }
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+        // Cheap enough to check on every read.
+        bool IsOpen() const { return m_open.load(std::memory_order_relaxed); }
+
+        // Thread-safe. `timeUs` is any monotonic clock; it's stored relative to the first record.
+        void Append(int64_t timeUs, uint8_t controllerType, uint16_t reportSize, const uint8_t* data, uint32_t byteCount);
+        uint64_t GetRecordCount() const { return m_records.load(std::memory_order_relaxed); }
+
+    private:
+        std::mutex m_mutex;
+        std::ofstream m_file;
+        std::atomic<bool> m_open{ false };
+        std::atomic<uint64_t> m_records{ 0 };
+        int64_t m_startUs = -1;
+    };
+
+    class Reader {
+    public:
+        // False if the file is missing or not a capture of a supported version.
+        bool Open(const std::filesystem::path& path);
+        // False at the end of the file or on a truncated record.
+        bool Next(Record& out);
+
+    private:
+        std::ifstream m_file;
+    };
+}
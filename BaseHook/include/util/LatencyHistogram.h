@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace BaseHook {
+
+    // Histogram of durations in microseconds: fixed-width buckets plus an overflow bucket.
+    // Record() is lock-free and may run on any thread; Summarize() gives an approximate snapshot.
+    class LatencyHistogram {
+    public:
+        static constexpr int kBucketCount = 64;
+        static constexpr int64_t kBucketWidthUs = 500;   // 0 - 32 ms, the rest goes to overflow
+
+        struct Summary {
+            uint64_t count = 0;
+            double meanUs = 0.0;
+            double p50Us = 0.0;
+            double p95Us = 0.0;
+            double p99Us = 0.0;
+            int64_t maxUs = 0;
+            uint64_t buckets[kBucketCount + 1] = {};   // Last one = overflow
+        };
+
+        void Record(int64_t us);
+        void Reset();
+        Summary Summarize() const;
+
+    private:
+        std::atomic<uint64_t> m_buckets[kBucketCount + 1] = {};
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<int64_t> m_sumUs{ 0 };
+        std::atomic<int64_t> m_maxUs{ 0 };
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+#include "util/FrameDecimator.h"
+
+namespace BaseHook {
+
+    class Settings;
+
+    enum class OverlayFrameMode {
+        Full,   // NewFrame -> DrawOverlay/DrawMenu -> Render -> RenderDrawData
+        Replay, // Re-submit last frame's draw data, no ImGui frame
+        Skip,   // Nothing visible: no ImGui work at all
+        Reuse,  // Interactive, between UI-rate rebuilds: re-submit last frame's draw data, keep queued input
+    };
+
+    // Decides per frame how much ImGui work the render hooks do, based on
+    // Settings::GetOverlayActivity(). Used by both the DX9 and DXGI paths.
+    class OverlayFrameGate {
+    public:
+        // Call once per frame before any ImGui work.
+        OverlayFrameMode Begin(Settings* settings);
+
+        // Forces the next frame to be a full one (device reset, resize, ...).
+        void Invalidate() { m_settled = false; m_decimator.Invalidate(); }
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; if (!enabled) Invalidate(); }
+        bool IsEnabled() const { return m_enabled; }
+
+        // Caps how often the ImGui frame is rebuilt while the overlay is interactive (menu, console,
+        // plugin windows); input still rebuilds at once. 0 rebuilds every frame.
+        void SetUiRateHz(int hz) { m_decimator.SetRateHz(hz); }
+        const FrameDecimator& GetDecimator() const { return m_decimator; }
+
+        // Input keeps arriving through WndProc/DirectInput while no ImGui frame consumes it.
+        // Drops the queued events (keeping the latest mouse position) so the queue can't grow
+        // and stale clicks/keys aren't replayed when the overlay wakes up. Keys and buttons are
+        // released once per idle stretch, since their release events are dropped too.
+        void DiscardPendingInput();
+
+        // Total frames that skipped the ImGui frame (Skip or Replay), for the settings UI.
+        unsigned long long GetSkippedFrames() const { return m_skippedFrames; }
+
+    private:
+        // Static overlays are still rebuilt this often so time-based content doesn't freeze.
+        static constexpr ULONGLONG kStaticRefreshMs = 250;
+
+        std::atomic<bool> m_enabled = true;
+        bool m_settled = false;
+        bool m_inputReleased = false;
+        ULONGLONG m_lastFullFrameMs = 0;
+        unsigned long long m_skippedFrames = 0;
+        FrameDecimator m_decimator;
+    };
+
+    extern OverlayFrameGate g_OverlayFrameGate;
+}
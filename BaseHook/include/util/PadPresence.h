@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace BaseHook {
+
+    // Which XInput slots have a controller, and the one the game should read.
+    struct PadPresence {
+        uint8_t connectedMask = 0;      // Bit n = slot n
+        int8_t preferredIndex = -1;     // -1 = nothing connected
+        uint32_t generation = 0;        // Bumped whenever the mask or the preferred slot changes
+    };
+
+    // Turns raw per-slot probe results into a stable presence snapshot. A slot has to probe the
+    // same way for debounceMs before the change is committed, so a controller that drops out for
+    // one probe (Bluetooth hiccup, USB re-enumeration) doesn't make the game switch pads. The
+    // preferred slot is sticky: it only moves when its controller goes away, and then to the slot
+    // that has been connected longest (lowest index on ties).
+    // Observe() is called from a single thread; Get() is lock-free and safe from any thread.
+    class PadPresenceTracker {
+    public:
+        static constexpr int kSlots = 4;
+
+        explicit PadPresenceTracker(uint64_t debounceMs) : m_debounceMs(debounceMs) {}
+
+        // Feeds one probe of all slots. The first call is committed as is. Returns true if the
+        // snapshot changed.
+        bool Observe(uint8_t probedMask, uint64_t nowMs);
+
+        // A slot probed differently from its committed state and is waiting out the debounce.
+        bool HasPendingChange() const { return m_pendingMask != 0; }
+
+        // generation 0 = nothing observed yet.
+        PadPresence Get() const;
+
+    private:
+        void Publish();
+
+        uint64_t m_debounceMs;
+        bool m_observed = false;
+        uint8_t m_mask = 0;
+        uint8_t m_pendingMask = 0;              // Slots whose probe differs from m_mask
+        int m_preferred = -1;
+        uint32_t m_generation = 0;
+        uint64_t m_pendingSince[kSlots] = {};
+        uint64_t m_connectedSince[kSlots] = {};
+        std::atomic<uint32_t> m_snapshot{ 0 };  // mask | (preferred + 1) << 4 | generation << 8
+    };
+
+} // namespace BaseHook
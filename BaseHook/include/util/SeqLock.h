@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace BaseHook {
+
+    // Single value published under a sequence counter: readers on any thread copy it without a lock
+    // and find out afterwards whether a writer got in the way; writers serialize among themselves
+    // (the caller's mutex). Meant for small snapshots that are read constantly and rebuilt rarely.
+    //
+    // The value is kept as an array of 32-bit atomic words rather than a plain T, so a reader racing
+    // a writer is a detected retry rather than a data race (and ThreadSanitizer sees it that way).
+    // 32-bit words stay lock-free and cheap on x86 builds too.
+    //
+    // Win32-free so it can be exercised anywhere.
+    template <typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+
+    public:
+        explicit SeqLock(const T& initial = T{})
+        {
+            uint32_t words[kWords] = {};
+            std::memcpy(words, &initial, sizeof(T));
+            for (size_t i = 0; i < kWords; ++i)
+                m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        // Any thread. False if a write was in progress or landed during the copy; `out` is then
+        // unspecified and the caller retries or takes its slow path.
+        bool TryLoad(T& out) const
+        {
+            const uint32_t seq = m_seq.load(std::memory_order_acquire);
+            if (seq & 1)
+                return false;
+
+            // Acquire loads keep the re-check below after the copy. If a load sees a word from a
+            // newer Store(), it also sees that Store()'s odd sequence.
+            uint32_t words[kWords];
+            for (size_t i = 0; i < kWords; ++i)
+                words[i] = m_words[i].load(std::memory_order_acquire);
+
+            if (m_seq.load(std::memory_order_relaxed) != seq)
+                return false;
+            std::memcpy(&out, words, sizeof(T));
+            return true;
+        }
+
+        // Writer side (caller holds the write lock): the current value, without the sequence check.
+        T LoadLocked() const
+        {
+            uint32_t words[kWords];
+            for (size_t i = 0; i < kWords; ++i)
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            T out;
+            std::memcpy(&out, words, sizeof(T));
+            return out;
+        }
+
+        // Writers must be serialized by the caller.
+        void Store(const T& value)
+        {
+            uint32_t words[kWords] = {};
+            std::memcpy(words, &value, sizeof(T));
+
+            const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+            m_seq.store(seq + 1, std::memory_order_relaxed);
+            // Release stores: no word can become visible before the odd sequence above.
+            for (size_t i = 0; i < kWords; ++i)
+                m_words[i].store(words[i], std::memory_order_release);
+            m_seq.store(seq + 2, std::memory_order_release);
+        }
+
+        // Completed Store() calls times two; odd while one is in progress.
+        uint32_t GetSequence() const { return m_seq.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        std::atomic<uint32_t> m_seq{ 0 };
+        std::atomic<uint32_t> m_words[kWords];
+    };
+
+} // namespace BaseHook
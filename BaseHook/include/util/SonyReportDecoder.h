@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "util/VirtualPad.h"
+
+namespace BaseHook::Sony {
+
+    enum class ControllerType : uint8_t { DualShock4, DualSense };
+
+    // Touchpad click, in a wButtons bit XInput leaves unused (like Guide, games ignore it). Kept
+    // apart from Share/Create so hotkeys and the DirectInput view can tell the two apart.
+    constexpr uint16_t kTouchpadButton = 0x0800;
+
+    struct TouchPoint {
+        bool active = false;
+        uint8_t id = 0;     // Increments with every new finger-down
+        uint16_t x = 0;
+        uint16_t y = 0;
+    };
+
+    // One input report, fully decoded. Buttons use the XInput wButtons bits.
+    struct DecodedReport {
+        uint16_t buttons = 0;
+        uint8_t leftTrigger = 0;
+        uint8_t rightTrigger = 0;
+        int16_t thumbLX = 0, thumbLY = 0, thumbRX = 0, thumbRY = 0;
+
+        // Only filled by report variants that carry them (not the DualSense BT short report).
+        bool hasMotion = false;
+        float gyro[3] = {};         // deg/s, nominal scale (no per-controller calibration)
+        float accel[3] = {};        // g
+        uint32_t sensorTimestamp = 0;   // Raw controller clock; see SensorTimestampToUs
+
+        bool hasTouch = false;
+        TouchPoint touch[2];
+    };
+
+    // Touchpad resolution, for normalizing TouchPoint coordinates.
+    void GetTouchpadSize(ControllerType type, uint16_t& width, uint16_t& height);
+
+    // Microseconds between two sensorTimestamp values of the same controller (handles wrap-around).
+    uint32_t SensorTimestampDeltaUs(ControllerType type, uint32_t previous, uint32_t current);
+
+    // Decodes one report (report ID included, as returned by ReadFile). False if no layout matches.
+    bool DecodeReport(ControllerType type, const uint8_t* data, size_t len, DecodedReport& out);
+
+    // Decodes `count` back-to-back reports of `reportSize` bytes each, as delivered by a ReadFile
+    // with a multi-report buffer. Reports that don't decode are skipped; returns how many were
+    // written to `out` (which must hold `count`).
+    size_t DecodeReports(ControllerType type, const uint8_t* data, size_t reportSize, size_t count, DecodedReport* out);
+
+    // The pad part of a report, as fed to the virtual pad.
+    PadState ToPadState(const DecodedReport& report);
+
+    // Name of the layout a report would be decoded with, or nullptr. For logging.
+    const char* GetLayoutName(ControllerType type, const uint8_t* data, size_t len);
+
+} // namespace BaseHook::Sony
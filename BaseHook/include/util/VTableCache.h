@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BaseHook {
+
+    // Where the graphics hooks found the methods they patch, remembered per system DLL build so a
+    // late injection can hook the swap chain without creating a throwaway device first.
+    //
+    // An entry holds the RVAs of a few vtable slots of one interface, relative to the module that
+    // implements them (modules[0]), plus the identity of every module the result depends on (e.g.
+    // dxgi.dll and the d3d11.dll that created the swap chain). It's only used while all of them are
+    // loaded with the same version, timestamp and image size; a Windows update or a wrapper DLL
+    // (DXVK, ReShade) makes it stale and the hooks fall back to discovering the slots again.
+    //
+    // Win32-free so it can be exercised anywhere.
+    namespace VTableCache {
+
+        struct ModuleIdentity {
+            std::string name;           // Lowercase file name, e.g. "dxgi.dll"
+            uint64_t fileVersion = 0;   // VS_FIXEDFILEINFO dwFileVersionMS << 32 | dwFileVersionLS
+            uint32_t timestamp = 0;     // PE TimeDateStamp
+            uint32_t imageSize = 0;     // PE SizeOfImage
+
+            bool operator==(const ModuleIdentity& other) const;
+            bool operator!=(const ModuleIdentity& other) const { return !(*this == other); }
+        };
+
+        struct Entry {
+            std::string interfaceName;
+            std::vector<ModuleIdentity> modules;
+            std::vector<uint32_t> rvas;     // Into modules[0], in the order the caller stored them
+        };
+
+        class Cache {
+        public:
+            // The entry for `interfaceName` if every module it depends on is in `loaded` with the same
+            // identity and every RVA lies inside modules[0]; nullptr otherwise.
+            const Entry* Find(const std::string& interfaceName, const std::vector<ModuleIdentity>& loaded) const;
+
+            // Replaces any entry for the same interface (one per interface: the system DLLs only
+            // change on updates). Returns false if nothing changed.
+            bool Store(const Entry& entry);
+
+            const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+            // Text, one entry per line:
+            //   <interface> module <name> <a.b.c.d> <timestamp hex> <size hex> [module ...] rva <hex> ...
+            // '#' starts a comment. Parse returns false (and sets `error`) on malformed input and
+            // leaves the cache unchanged.
+            std::string Serialize() const;
+            bool Parse(const std::string& text, std::string* error = nullptr);
+
+        private:
+            std::vector<Entry> m_entries;
+        };
+    }
+
+} // namespace BaseHook
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+
+namespace BaseHook {
+
+    // Same layout as XINPUT_STATE (checked where the two meet), without needing <xinput.h>.
+    struct PadState {
+        uint32_t packetNumber = 0;
+        uint16_t buttons = 0;
+        uint8_t leftTrigger = 0;
+        uint8_t rightTrigger = 0;
+        int16_t thumbLX = 0, thumbLY = 0, thumbRX = 0, thumbRY = 0;
+    };
+
+    // The single pad the game sees, merged from whichever sources feed it (Sony HID reader, hooked
+    // DirectInput devices, private fallback polling). A higher-priority source wins while it keeps
+    // updating; one that stops for longer than staleMs no longer blocks the others. Each update
+    // carries the time its source data arrived, so the reader can tell how old the state is.
+    // Times are passed in rather than read from a clock, so a replayed session merges the same way.
+    class VirtualPadMerger {
+    public:
+        struct Delivery {
+            PadState state;
+            int64_t sourceTimeUs = 0;       // Arrival time of the data behind `state`
+            bool firstDelivery = false;     // Consume() hasn't returned this update before
+        };
+
+        explicit VirtualPadMerger(uint64_t staleMs) : m_staleMs(staleMs) {}
+
+        // False if a higher-priority source is still active. outSourceChanged: a different
+        // source/context than the previous update.
+        bool Submit(int source, int priority, const void* context, const PadState& state,
+                    int64_t sourceTimeUs, uint64_t nowMs, bool& outSourceChanged);
+
+        // Drops the state if it came from `sourceFilter` / `contextFilter` (0 / nullptr = any).
+        void Reset(int sourceFilter, const void* contextFilter);
+
+        // Latest state, unless stale.
+        bool Peek(uint64_t nowMs, PadState& out) const;
+
+        // Peek() for the game's own read: also says whether this update is new to it.
+        bool Consume(uint64_t nowMs, Delivery& out);
+
+        // Calls fn(state, source, context) under the lock if any state is held, stale or not.
+        template <typename Fn>
+        void Inspect(Fn&& fn) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_hasData)
+                fn(m_state, m_source, m_context);
+        }
+
+    private:
+        bool IsFresh(uint64_t nowMs) const { return m_hasData && nowMs - m_lastUpdateMs <= m_staleMs; }
+
+        mutable std::mutex m_mutex;
+        const uint64_t m_staleMs;
+
+        PadState m_state;
+        int m_source = 0;
+        int m_priority = 0;
+        const void* m_context = nullptr;
+        bool m_hasData = false;
+        uint64_t m_lastUpdateMs = 0;
+        int64_t m_sourceTimeUs = 0;
+        uint32_t m_packetCounter = 1;
+        uint32_t m_deliveredPacket = 0;
+    };
+}
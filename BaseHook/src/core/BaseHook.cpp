@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "core/BaseHook.h"
+#include "util/FontAtlasCache.h"
 #include <filesystem>
 
 namespace BaseHook
@@ -32,6 +33,7 @@ namespace BaseHook
 
         thread_local bool               bCallingImGui = false;
         std::atomic<unsigned long long> lastXInputTime = 0;
+        std::atomic<long long>          firstFrameEndUs = 0;
 
         // DX9
         IDirect3DDevice9* pDevice = nullptr;
@@ -39,6 +41,7 @@ namespace BaseHook
         Reset_t           oReset = nullptr;
         ResetEx_t         oResetEx = nullptr;
         Present9_t        oPresent9 = nullptr;
+        SwapChainPresent9_t oSwapChainPresent9 = nullptr;
         TestCooperativeLevel_t oTestCooperativeLevel = nullptr;
         std::atomic<FakeResetState> g_fakeResetState = FakeResetState::Clear;
 
@@ -116,7 +119,11 @@ namespace BaseHook
 
     void LoadSystemFonts()
     {
+        TRACE_SCOPE_CAT("LoadSystemFonts", "render");
         ImGuiIO& io = ImGui::GetIO();
+        if (Data::pSettings && !Data::pSettings->m_FontCacheDir.empty())
+            FontAtlasCache::Install(io.Fonts, Data::pSettings->m_FontCacheDir);
+
         char windir[MAX_PATH];
         if (GetWindowsDirectoryA(windir, MAX_PATH))
         {
@@ -153,6 +160,12 @@ namespace BaseHook
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad | ImGuiConfigFlags_DockingEnable;
         io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
         LoadSystemFonts();
+        if (Data::pSettings && !Data::pSettings->m_FontPreloadScales.empty())
+        {
+            FontAtlasCache::Preload(io.Fonts, Data::pSettings->m_FontPreloadScales);
+            const FontAtlasCache::Stats stats = FontAtlasCache::GetStats();
+            LOG_INFO("Font glyphs: %u from cache, %u rasterized (cache read %.1f ms)", stats.hits, stats.misses, stats.loadMs);
+        }
         
         ImGui::StyleColorsDark();
 
@@ -6,11 +6,14 @@
 #include "log.h"
 #include "util/ComPtr.h"
 #include "util/RenderDetection.h"
+#include "util/HandleClassCache.h"
+#include "util/SeqLock.h"
 #include <cstdio>
 #include <vector>
 #include <filesystem>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include <imgui_internal.h>
 #include "imgui_impl_win32.h"
 
@@ -786,6 +789,94 @@ namespace BaseHook
             return ::GetClientRect(hWnd, &outRect) != FALSE;
         }
 
+        // --- Geometry snapshot ---
+        // Readers copy it lock-free and retry if a rebuild landed under them. Rebuilds are rare, so
+        // writers simply serialize on a mutex.
+        static SeqLock<GeometrySnapshot> g_Geometry;
+        static std::atomic<uint32_t> g_GeometryInvalidations = 1; // Start stale
+        static std::mutex g_GeometryWriteMutex;
+
+        void InvalidateGeometry()
+        {
+            g_GeometryInvalidations.fetch_add(1, std::memory_order_release);
+        }
+
+        static bool IsGeometryCurrent(const GeometrySnapshot& geo, uint32_t generation)
+        {
+            // hWnd and virtual size are compared directly, so missing an invalidation for those can't go stale.
+            return geo.generation == generation && geo.hWnd == Data::hWindow &&
+                geo.transform.virtualW == g_State.virtualWidth && geo.transform.virtualH == g_State.virtualHeight;
+        }
+
+        static void BuildGeometry(GeometrySnapshot& geo)
+        {
+            geo.hWnd = Data::hWindow;
+            geo.valid = false;
+            if (!GetPhysicalClientRect(geo.hWnd, geo.clientRect))
+            {
+                geo.transform = {};
+                geo.transform.virtualW = g_State.virtualWidth;
+                geo.transform.virtualH = g_State.virtualHeight;
+                return;
+            }
+
+            if (Data::oGetWindowRect) ((GetWindowRect_t)Data::oGetWindowRect)(geo.hWnd, &geo.windowRect);
+            else ::GetWindowRect(geo.hWnd, &geo.windowRect);
+
+            POINT origin = { 0, 0 };
+            if (Data::oClientToScreen) ((BOOL(WINAPI*)(HWND, LPPOINT))Data::oClientToScreen)(geo.hWnd, &origin);
+            else ::ClientToScreen(geo.hWnd, &origin);
+
+            geo.monitorRect = {};
+            MONITORINFO mi{};
+            mi.cbSize = sizeof(mi);
+            HMONITOR mon = MonitorFromWindow(geo.hWnd, MONITOR_DEFAULTTONEAREST);
+            if (mon && GetMonitorInfoA(mon, &mi))
+                geo.monitorRect = mi.rcMonitor;
+
+            geo.transform = Geometry::MakeClientTransform(
+                geo.clientRect.right - geo.clientRect.left, geo.clientRect.bottom - geo.clientRect.top,
+                origin.x, origin.y, g_State.virtualWidth, g_State.virtualHeight);
+            geo.valid = geo.transform.IsValid();
+        }
+
+        bool GetGeometry(GeometrySnapshot& out)
+        {
+            const uint32_t generation = g_GeometryInvalidations.load(std::memory_order_acquire);
+
+            for (int attempt = 0; attempt < 4; ++attempt)
+            {
+                if (!g_Geometry.TryLoad(out))
+                {
+                    YieldProcessor();
+                    continue;
+                }
+
+                if (IsGeometryCurrent(out, generation))
+                    return out.valid;
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(g_GeometryWriteMutex);
+            const GeometrySnapshot current = g_Geometry.LoadLocked();
+            if (IsGeometryCurrent(current, generation))
+            {
+                out = current; // Another thread rebuilt it while we waited
+                return out.valid;
+            }
+
+            // Stamp with the generation read before querying, so an invalidation that lands
+            // during the rebuild still marks the result stale.
+            GeometrySnapshot geo;
+            BuildGeometry(geo);
+            geo.generation = generation;
+
+            g_Geometry.Store(geo);
+
+            out = geo;
+            return out.valid;
+        }
+
         void GetWindowResolution(int& width, int& height)
         {
             if (g_State.hWnd && IsWindow(g_State.hWnd))
@@ -873,6 +964,7 @@ namespace BaseHook
 
             g_State.virtualWidth = width;
             g_State.virtualHeight = height;
+            InvalidateGeometry();
 
             if (changed && g_State.hWnd) {
                 LOG_INFO("Resolution Change Detected: Resizing Window to %dx%d", width, height);
@@ -900,6 +992,7 @@ namespace BaseHook
             
             g_State.windowWidth = width;
             g_State.windowHeight = height;
+            InvalidateGeometry();
 
             // Force ImGui to refresh monitor bounds with new resolution scaling
             // We do this ALWAYS on WM_SIZE because even if g_State matches (e.g. updated elsewhere by SetSettings),
@@ -997,18 +1090,14 @@ namespace BaseHook
                 return false;
 
             // Always use the main game window's scale factor for coordinate consistency
-            RECT mainRect{};
-            if (!GetPhysicalClientRect(Data::hWindow, mainRect))
-                return false;
-
-            const int mainW = mainRect.right - mainRect.left;
-            const int mainH = mainRect.bottom - mainRect.top;
-            
-            if (mainW <= 0 || mainH <= 0 || g_State.virtualWidth <= 0 || g_State.virtualHeight <= 0)
+            GeometrySnapshot geo;
+            if (!GetGeometry(geo))
                 return false;
 
-            pt.x = (LONG)std::lroundf((float)pt.x * ((float)g_State.virtualWidth / (float)mainW));
-            pt.y = (LONG)std::lroundf((float)pt.y * ((float)g_State.virtualHeight / (float)mainH));
+            int x = pt.x, y = pt.y;
+            Geometry::PhysicalClientToVirtual(geo.transform, x, y);
+            pt.x = x;
+            pt.y = y;
             return true;
         }
 
@@ -1017,78 +1106,46 @@ namespace BaseHook
         {
             if (!Data::hWindow) return;
 
-            // Cache metrics
-            RECT mainRect;
-            if (!GetPhysicalClientRect(Data::hWindow, mainRect)) return;
-            
-            POINT offset = { 0, 0 };
-            if (Data::oClientToScreen) ((BOOL(WINAPI*)(HWND, LPPOINT))Data::oClientToScreen)(Data::hWindow, &offset);
-            else ::ClientToScreen(Data::hWindow, &offset);
+            GeometrySnapshot geo;
+            if (!GetGeometry(geo)) return;
 
-            ConvertVirtualToPhysical(x, y, w, h, scaleSize, mainRect, offset);
+            Geometry::VirtualToPhysicalScreen(geo.transform, x, y);
+            if (scaleSize)
+                Geometry::VirtualSizeToPhysical(geo.transform, w, h);
         }
 
         void ConvertVirtualToPhysical(int& x, int& y, int& w, int& h, bool scaleSize, const RECT& mainRect, const POINT& offset)
         {
-            const int mainW = mainRect.right - mainRect.left;
-            const int mainH = mainRect.bottom - mainRect.top;
-
-            if (mainW <= 0 || mainH <= 0 || g_State.virtualWidth <= 0 || g_State.virtualHeight <= 0)
+            const Geometry::ClientTransform t = Geometry::MakeClientTransform(
+                mainRect.right - mainRect.left, mainRect.bottom - mainRect.top,
+                offset.x, offset.y, g_State.virtualWidth, g_State.virtualHeight);
+            if (!t.IsValid())
                 return;
 
-            // Virtual Client -> Physical Client
-            POINT pt = { x, y };
-            // Manual inline of VirtualClientToPhysical logic using cached rect
-            pt.x = (LONG)std::lroundf((float)pt.x * ((float)mainW / (float)g_State.virtualWidth));
-            pt.y = (LONG)std::lroundf((float)pt.y * ((float)mainH / (float)g_State.virtualHeight));
-
-            // Physical Client -> Physical Screen
-            pt.x += offset.x;
-            pt.y += offset.y;
-
-            x = pt.x;
-            y = pt.y;
-
-            if (scaleSize) {
-                // Scale dimensions (Virtual -> Physical)
-                w = (int)std::lroundf((float)w * (float)mainW / (float)g_State.virtualWidth);
-                h = (int)std::lroundf((float)h * (float)mainH / (float)g_State.virtualHeight);
-            }
+            Geometry::VirtualToPhysicalScreen(t, x, y);
+            if (scaleSize)
+                Geometry::VirtualSizeToPhysical(t, w, h);
         }
 
         void ConvertPhysicalToVirtual(int& x, int& y)
         {
             if (!Data::hWindow) return;
 
-            RECT mainRect;
-            if (!GetPhysicalClientRect(Data::hWindow, mainRect)) return;
-
-            POINT offset = { 0, 0 };
-            if (Data::oClientToScreen) ((BOOL(WINAPI*)(HWND, LPPOINT))Data::oClientToScreen)(Data::hWindow, &offset);
-            else ::ClientToScreen(Data::hWindow, &offset);
+            GeometrySnapshot geo;
+            if (!GetGeometry(geo)) return;
 
-            ConvertPhysicalToVirtual(x, y, mainRect, offset);
+            Geometry::PhysicalScreenToVirtual(geo.transform, x, y);
         }
 
         void ConvertPhysicalToVirtual(int& x, int& y, const RECT& mainRect, const POINT& offset)
         {
-            const int mainW = mainRect.right - mainRect.left;
-            const int mainH = mainRect.bottom - mainRect.top;
-
-            if (mainW <= 0 || mainH <= 0 || g_State.virtualWidth <= 0 || g_State.virtualHeight <= 0)
+            const Geometry::ClientTransform t = Geometry::MakeClientTransform(
+                mainRect.right - mainRect.left, mainRect.bottom - mainRect.top,
+                offset.x, offset.y, g_State.virtualWidth, g_State.virtualHeight);
+            if (!t.IsValid())
                 return;
 
-            // Physical Screen -> Physical Client
-            // Inverse of adding offset
-            POINT pt = { x - offset.x, y - offset.y };
-
-            // Physical Client -> Virtual Client
-            // Inverse scaling
-            pt.x = (LONG)std::lroundf((float)pt.x * ((float)g_State.virtualWidth / (float)mainW));
-            pt.y = (LONG)std::lroundf((float)pt.y * ((float)g_State.virtualHeight / (float)mainH));
-
-            x = pt.x;
-            y = pt.y;
+            Geometry::PhysicalScreenToVirtual(t, x, y);
         }
 
         bool VirtualClientToPhysical(HWND hWnd, POINT& pt)
@@ -1100,18 +1157,14 @@ namespace BaseHook
                 return false;
 
             // Always use the main game window's scale factor for coordinate consistency
-            RECT mainRect{};
-            if (!GetPhysicalClientRect(Data::hWindow, mainRect))
+            GeometrySnapshot geo;
+            if (!GetGeometry(geo))
                 return false;
 
-            const int mainW = mainRect.right - mainRect.left;
-            const int mainH = mainRect.bottom - mainRect.top;
-
-            if (mainW <= 0 || mainH <= 0 || g_State.virtualWidth <= 0 || g_State.virtualHeight <= 0)
-                return false;
-
-            pt.x = (LONG)std::lroundf((float)pt.x * ((float)mainW / (float)g_State.virtualWidth));
-            pt.y = (LONG)std::lroundf((float)pt.y * ((float)mainH / (float)g_State.virtualHeight));
+            int x = pt.x, y = pt.y;
+            Geometry::VirtualClientToPhysical(geo.transform, x, y);
+            pt.x = x;
+            pt.y = y;
             return true;
         }
 
@@ -1153,14 +1206,56 @@ namespace BaseHook
             return hWnd == Data::hWindow;
         }
 
+        // Focus/foreground hooks and every mouse message ask this, so answers are cached per HWND.
+        // Our platform windows are registered when created and forgotten on WM_NCDESTROY;
+        // anything else is classified once by class name (and process) and cached as well.
+        static HandleClassCache<256> g_PlatformWindowCache;
+
+        static uint32_t HandleKey(HWND hWnd)
+        {
+            return (uint32_t)(uintptr_t)hWnd;
+        }
+
+        void RegisterImGuiPlatformWindow(HWND hWnd)
+        {
+            g_PlatformWindowCache.Set(HandleKey(hWnd), HandleClassCache<256>::Class::Match);
+        }
+
+        void ForgetWindow(HWND hWnd)
+        {
+            g_PlatformWindowCache.Forget(HandleKey(hWnd));
+        }
+
         bool IsImGuiPlatformWindow(HWND hWnd)
         {
+            if (!hWnd)
+                return false;
+
+            using Class = HandleClassCache<256>::Class;
+            switch (g_PlatformWindowCache.Find(HandleKey(hWnd)))
+            {
+            case Class::Match: return true;
+            case Class::Other: return false;
+            default: break;
+            }
+
+            // Unknown handle: classify once. Only windows of this process count, so callers
+            // don't need their own GetWindowThreadProcessId check.
+            bool isPlatform = false;
             char className[256];
-            if (::GetClassNameA(hWnd, className, sizeof(className)))
+            if (::GetClassNameA(hWnd, className, sizeof(className)) && strstr(className, "ImGui Platform") != nullptr)
             {
-                return strstr(className, "ImGui Platform") != nullptr;
+                DWORD pid = 0;
+                GetWindowThreadProcessId(hWnd, &pid);
+                isPlatform = (pid == GetCurrentProcessId());
             }
-            return false;
+            else if (!::IsWindow(hWnd))
+            {
+                return false; // Don't cache dead handles; the value may be reused
+            }
+
+            g_PlatformWindowCache.Set(HandleKey(hWnd), isPlatform ? Class::Match : Class::Other);
+            return isPlatform;
         }
 
         bool IsMultiViewportEnabled()
@@ -1196,18 +1291,12 @@ namespace BaseHook
             static RECT lastMainRect = { 0 };
             static int lastVWidth = 0, lastVHeight = 0;
 
-            RECT currMainRect;
-            if (!GetPhysicalClientRect(Data::hWindow, currMainRect)) return;
-            // Note: currMainRect here is CLIENT rect (0,0 to W,H). We need SCREEN rect for position tracking.
-            
-            RECT currMainScreenRect;
-            if (Data::oGetWindowRect) ((GetWindowRect_t)Data::oGetWindowRect)(Data::hWindow, &currMainScreenRect);
-            else GetWindowRect(Data::hWindow, &currMainScreenRect);
-
-            // Pre-calculate mapping metrics for optimization
-            POINT offset = { 0, 0 };
-            if (Data::oClientToScreen) ((BOOL(WINAPI*)(HWND, LPPOINT))Data::oClientToScreen)(Data::hWindow, &offset);
-            else ::ClientToScreen(Data::hWindow, &offset);
+            GeometrySnapshot geo;
+            if (!GetGeometry(geo)) return;
+            // Note: clientRect is the CLIENT rect (0,0 to W,H). We need the SCREEN rect for position tracking.
+            const RECT& currMainRect = geo.clientRect;
+            const RECT& currMainScreenRect = geo.windowRect;
+            const POINT offset = { geo.transform.originX, geo.transform.originY };
 
             const int currMainW = currMainRect.right - currMainRect.left;
             const int currMainH = currMainRect.bottom - currMainRect.top;
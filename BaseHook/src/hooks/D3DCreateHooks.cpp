@@ -11,18 +11,152 @@
 #include "core/WindowedMode.h"
 #include "log.h"
 #include "util/ComPtr.h"
+#include "util/VTableCache.h"
 #include <d3d9.h>
 #include <kiero/minhook/include/MinHook.h>
+#include <algorithm>
+#include <fstream>
 #include <mutex>
+#include <sstream>
 
 namespace BaseHook
 {
     namespace Hooks
     {
+        // --- VTable Slot Cache ---
+        // IDXGISwapChain Present, ResizeBuffers, ResizeTarget
+        static constexpr int kSwapChainSlots[] = { 8, 13, 14 };
+        static const char* const kSwapChainEntry = "IDXGISwapChain";
+
+        static std::mutex s_VTableCacheMutex;
+        static VTableCache::Cache s_VTableCache;
+        static bool s_VTableCacheLoaded = false;
+
+        static bool GetModuleIdentity(HMODULE hModule, VTableCache::ModuleIdentity& out)
+        {
+            char path[MAX_PATH];
+            if (!hModule || GetModuleFileNameA(hModule, path, MAX_PATH) == 0) return false;
+
+            const char* name = strrchr(path, '\\');
+            out.name = name ? name + 1 : path;
+            std::transform(out.name.begin(), out.name.end(), out.name.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+
+            auto* dos = (IMAGE_DOS_HEADER*)hModule;
+            if (dos->e_magic != IMAGE_DOS_SIGNATURE) return false;
+            auto* nt = (IMAGE_NT_HEADERS*)((BYTE*)hModule + dos->e_lfanew);
+            if (nt->Signature != IMAGE_NT_SIGNATURE) return false;
+            out.timestamp = nt->FileHeader.TimeDateStamp;
+            out.imageSize = nt->OptionalHeader.SizeOfImage;
+
+            // VS_FIXEDFILEINFO straight from the mapped resource; GetFileVersionInfo would read the file again
+            out.fileVersion = 0;
+            HRSRC hRes = FindResourceW(hModule, MAKEINTRESOURCEW(VS_VERSION_INFO), (LPCWSTR)RT_VERSION);
+            HGLOBAL hData = hRes ? LoadResource(hModule, hRes) : NULL;
+            const BYTE* data = hData ? (const BYTE*)LockResource(hData) : nullptr;
+            const DWORD size = hRes ? SizeofResource(hModule, hRes) : 0;
+            for (DWORD offset = 0; data && offset + sizeof(VS_FIXEDFILEINFO) <= size; offset += 4)
+            {
+                const VS_FIXEDFILEINFO* info = (const VS_FIXEDFILEINFO*)(data + offset);
+                if (info->dwSignature == VS_FFI_SIGNATURE)
+                {
+                    out.fileVersion = ((uint64_t)info->dwFileVersionMS << 32) | info->dwFileVersionLS;
+                    break;
+                }
+            }
+            return true;
+        }
+
+        static void LoadVTableCacheLocked()
+        {
+            if (s_VTableCacheLoaded) return;
+            s_VTableCacheLoaded = true;
+            if (!Data::pSettings || Data::pSettings->m_VTableCachePath.empty()) return;
+
+            std::ifstream file(Data::pSettings->m_VTableCachePath);
+            if (!file) return;
+            std::stringstream text;
+            text << file.rdbuf();
+
+            std::string error;
+            if (!s_VTableCache.Parse(text.str(), &error))
+                LOG_WARN("VTable cache: Ignoring %s (%s)", Data::pSettings->m_VTableCachePath.string().c_str(), error.c_str());
+        }
+
+        static void SaveVTableCacheLocked()
+        {
+            if (!Data::pSettings || Data::pSettings->m_VTableCachePath.empty()) return;
+
+            std::ofstream file(Data::pSettings->m_VTableCachePath, std::ios::trunc);
+            file << "# Graphics hook vtable slots per system DLL build. Safe to delete.\n" << s_VTableCache.Serialize();
+            if (!file)
+                LOG_WARN("VTable cache: Failed to write %s", Data::pSettings->m_VTableCachePath.string().c_str());
+        }
+
+        static void RecordSwapChainSlots(IDXGISwapChain* pSwapChain, const char* runtimeModule)
+        {
+            void** vtable = *(void***)pSwapChain;
+            HMODULE hOwner = NULL;
+            if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)vtable[kSwapChainSlots[0]], &hOwner))
+                return;
+
+            VTableCache::Entry entry;
+            entry.interfaceName = kSwapChainEntry;
+            entry.modules.emplace_back();
+            if (!GetModuleIdentity(hOwner, entry.modules[0])) return;
+            VTableCache::ModuleIdentity runtime;
+            if (GetModuleIdentity(GetModuleHandleA(runtimeModule), runtime) && runtime.name != entry.modules[0].name)
+                entry.modules.push_back(runtime);
+
+            for (int slot : kSwapChainSlots)
+            {
+                // Every slot has to live in the same module, or it was patched by someone else
+                const uintptr_t rva = (uintptr_t)vtable[slot] - (uintptr_t)hOwner;
+                if ((uintptr_t)vtable[slot] < (uintptr_t)hOwner || rva >= entry.modules[0].imageSize) return;
+                entry.rvas.push_back((uint32_t)rva);
+            }
+
+            std::lock_guard<std::mutex> lock(s_VTableCacheMutex);
+            LoadVTableCacheLocked();
+            if (s_VTableCache.Store(entry))
+            {
+                SaveVTableCacheLocked();
+                LOG_INFO("VTable cache: Recorded %s slots in %s.", kSwapChainEntry, entry.modules[0].name.c_str());
+            }
+        }
+
+        // Swap chain methods resolved from the cache for the DLLs loaded right now, or false.
+        static bool LookupSwapChainSlots(void* (&methods)[3])
+        {
+            std::vector<VTableCache::ModuleIdentity> loaded;
+            for (const char* name : { "dxgi.dll", "d3d11.dll", "d3d10.dll", "d3d10_1.dll" })
+            {
+                VTableCache::ModuleIdentity module;
+                if (GetModuleIdentity(GetModuleHandleA(name), module))
+                    loaded.push_back(module);
+            }
+
+            std::lock_guard<std::mutex> lock(s_VTableCacheMutex);
+            LoadVTableCacheLocked();
+            const VTableCache::Entry* entry = s_VTableCache.Find(kSwapChainEntry, loaded);
+            if (!entry || entry->rvas.size() != 3) return false;
+
+            BYTE* base = (BYTE*)GetModuleHandleA(entry->modules[0].name.c_str());
+            for (int i = 0; i < 3; ++i)
+            {
+                methods[i] = base + entry->rvas[i];
+                MEMORY_BASIC_INFORMATION mbi;
+                if (!VirtualQuery(methods[i], &mbi, sizeof(mbi)) || mbi.State != MEM_COMMIT ||
+                    !(mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)))
+                    return false;
+            }
+            return true;
+        }
+
         // --- Binding Helpers ---
         static void BindD3D9Hooks(IDirect3DDevice9* pDevice) {
             if (Data::bGraphicsInitialized) return;
             if (!pDevice) return;
+            TRACE_SCOPE_CAT("BindD3D9Hooks", "basehook");
             LOG_INFO("BindD3D9Hooks: Capture successful. Device=%p", pDevice);
 
             void** vtable = *(void***)pDevice;
@@ -39,6 +173,14 @@ namespace BaseHook
                 MH_EnableHook(vtable[17]);
                 LOG_INFO("D3D9 Hook: Present hooked.");
             }
+            ComPtr<IDirect3DSwapChain9> swapChain;
+            if (SUCCEEDED(pDevice->GetSwapChain(0, swapChain.GetAddressOf()))) {
+                void** swapVtable = *(void***)swapChain.Get();
+                if (MH_CreateHook(swapVtable[3], hkSwapChainPresent9, (LPVOID*)&Data::oSwapChainPresent9) == MH_OK) {
+                    MH_EnableHook(swapVtable[3]);
+                    LOG_INFO("D3D9 Hook: SwapChain Present hooked.");
+                }
+            }
             if (MH_CreateHook(vtable[3], hkTestCooperativeLevel, (LPVOID*)&Data::oTestCooperativeLevel) == MH_OK) {
                 MH_EnableHook(vtable[3]);
                 LOG_INFO("D3D9 Hook: TestCooperativeLevel hooked.");
@@ -51,8 +193,10 @@ namespace BaseHook
         static void BindD3D11Hooks(IDXGISwapChain* pSwapChain) {
             if (Data::bGraphicsInitialized) return;
             if (!pSwapChain) return;
+            TRACE_SCOPE_CAT("BindD3D11Hooks", "basehook");
             LOG_INFO("BindD3D11Hooks: Capture successful. SwapChain=%p", pSwapChain);
 
+            RecordSwapChainSlots(pSwapChain, "d3d11.dll");
             void** vtable = *(void***)pSwapChain;
             
             if (MH_CreateHook(vtable[8], hkPresentDX11, (LPVOID*)&Data::oPresent) == MH_OK) {
@@ -75,8 +219,10 @@ namespace BaseHook
         static void BindD3D10Hooks(IDXGISwapChain* pSwapChain) {
             if (Data::bGraphicsInitialized) return;
             if (!pSwapChain) return;
+            TRACE_SCOPE_CAT("BindD3D10Hooks", "basehook");
             LOG_INFO("BindD3D10Hooks: Capture successful. SwapChain=%p", pSwapChain);
 
+            RecordSwapChainSlots(pSwapChain, "d3d10.dll");
             void** vtable = *(void***)pSwapChain;
             
             if (MH_CreateHook(vtable[8], hkPresentDX10, (LPVOID*)&Data::oPresent) == MH_OK) {
@@ -956,6 +1102,22 @@ namespace BaseHook
             }
 
             LOG_INFO("InstallDXGIHooksLate: Starting...");
+
+            // Slots seen on a real or dummy swap chain of this DXGI build on an earlier run
+            void* cached[3];
+            if (LookupSwapChainSlots(cached)) {
+                MH_CreateHook(cached[0], hkPresentDXGIGeneric, (LPVOID*)&Data::oPresent);
+                MH_EnableHook(cached[0]);
+                MH_CreateHook(cached[1], hkResizeBuffersDXGIGeneric, (LPVOID*)&Data::oResizeBuffers);
+                MH_EnableHook(cached[1]);
+                MH_CreateHook(cached[2], hkResizeTargetDXGIGeneric, (LPVOID*)&Data::oResizeTarget);
+                MH_EnableHook(cached[2]);
+
+                LOG_INFO("InstallDXGIHooksLate: Hooks installed from vtable cache.");
+                s_DXGILateHooksInstalled = true;
+                s_IsInstalling = false;
+                return;
+            }
             
             WNDCLASSEX wc = { 0 };
             wc.cbSize = sizeof(wc);
@@ -1016,6 +1178,7 @@ namespace BaseHook
             }
 
             if (SUCCEEDED(hr) && pSwapChain) {
+                RecordSwapChainSlots(pSwapChain.Get(), pDev11 ? "d3d11.dll" : "d3d10.dll");
                 void** vtable = *(void***)pSwapChain.Get();
                 MH_CreateHook(vtable[8], hkPresentDXGIGeneric, (LPVOID*)&Data::oPresent);
                 MH_EnableHook(vtable[8]);
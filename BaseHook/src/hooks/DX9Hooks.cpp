@@ -5,6 +5,10 @@
 #include "core/BaseHook.h"
 #include "core/WindowedMode.h"
 #include "util/FramerateLimiter.h"
+#include "util/OverlayFrameGate.h"
+#include "util/AllocationCounter.h"
+#include "util/FrameBoundaryTracker.h"
+#include "FrameArena.h"
 #include "util/ComPtr.h"
 
 namespace BaseHook
@@ -52,26 +56,6 @@ namespace BaseHook
             return hr;
         }
 
-        HRESULT __stdcall hkPresent9(LPDIRECT3DDEVICE9 pDevice, CONST RECT* pSourceRect, CONST RECT* pDestRect, HWND hDestWindowOverride, CONST RGNDATA* pDirtyRegion)
-        {
-            if (Data::g_fakeResetState == BaseHook::FakeResetState::Initiate)
-            {
-                LOG_INFO("hkPresent9: Fake Reset Initiate (DEVICELOST)");
-                return D3DERR_DEVICELOST;
-            }
-
-            // We don't render ImGui here because we hook EndScene for that in DX9.
-            // Present just needs to pass through or fail if resetting.
-
-            g_FramerateLimiter.Wait();
-
-            HRESULT hr = Data::oPresent9(pDevice, pSourceRect, pDestRect, hDestWindowOverride, pDirtyRegion);
-            if (hr == D3DERR_DEVICELOST) {
-                LOG_THROTTLED(5000, "hkPresent9: Result=DEVICELOST");
-            }
-            return hr;
-        }
-
         void InitImGui(LPDIRECT3DDEVICE9 pDevice)
         {
             D3DDEVICE_CREATION_PARAMETERS params;
@@ -109,81 +93,276 @@ namespace BaseHook
             ImGui_ImplDX9_Init(pDevice);
         }
 
-        HRESULT __stdcall hkEndScene(LPDIRECT3DDEVICE9 pDevice)
+        namespace
+        {
+            // The implicit swap chain's back buffer, held between frames so the per-frame checks don't
+            // query it each time. Raw pointers: it must be released before Reset (which fails while a
+            // reference is held) and never from a static destructor after the device is gone.
+            IDirect3DSurface9* s_backBuffer = nullptr;
+            IDirect3DDevice9* s_backBufferDevice = nullptr;
+        }
+
+        void ReleaseCachedBackBuffer()
+        {
+            if (s_backBuffer)
+                s_backBuffer->Release();
+            s_backBuffer = nullptr;
+            s_backBufferDevice = nullptr;
+        }
+
+        namespace
         {
-            // LOG_INFO("hkEndScene: Called"); // Very spammy, use with caution or counter
-            static int logCount = 0;
-            if (logCount < 5) {
-                logCount++;
+            // True while our own draw calls run, so the EndScene/Present calls made by the ImGui
+            // backend (our scene before Present, platform windows) pass straight through.
+            bool s_drawingOverlay = false;
+
+            // Set by a full ImGui frame; platform windows are updated once, outside any scene, at Present.
+            bool s_platformWindowsPending = false;
+
+            // d3d9 may implement the device's Present through the implicit swap chain's; that call
+            // must not count as a second frame.
+            bool s_inDevicePresent = false;
+
+            IDirect3DSurface9* GetCachedBackBuffer(LPDIRECT3DDEVICE9 pDevice)
+            {
+                if (s_backBuffer && s_backBufferDevice == pDevice)
+                    return s_backBuffer;
+
+                ReleaseCachedBackBuffer();
+                if (FAILED(pDevice->GetBackBuffer(0, 0, D3DBACKBUFFER_TYPE_MONO, &s_backBuffer)))
+                {
+                    s_backBuffer = nullptr;
+                    return nullptr;
+                }
+                s_backBufferDevice = pDevice;
+                return s_backBuffer;
             }
 
-            if (Data::bIsDetached)
+            bool IsBackBufferTarget(LPDIRECT3DDEVICE9 pDevice)
             {
-                return Data::oEndScene(pDevice);
+                IDirect3DSurface9* backBuffer = GetCachedBackBuffer(pDevice);
+                ComPtr<IDirect3DSurface9> target;
+                if (!backBuffer || FAILED(pDevice->GetRenderTarget(0, target.GetAddressOf())))
+                    return false;
+                return target.Get() == backBuffer;
             }
 
+            // Builds (or replays) the overlay frame and submits its draw data. Must be inside a scene
+            // with the back buffer bound.
+            void RenderOverlay(LPDIRECT3DDEVICE9 pDevice)
+            {
+                // Only the very first overlay frame is traced; steady-state frames would just flood the buffers.
+                static bool s_firstFrameTraced = false;
+                const int64_t frameStartUs = s_firstFrameTraced ? 0 : Trace::NowUs();
+
+                if (!Data::bIsInitialized)
+                {
+                    TRACE_SCOPE_CAT("InitImGui (DX9)", "render");
+                    LOG_INFO("DX9: Initializing ImGui.");
+                    Data::pDevice = pDevice;
+                    InitImGui(pDevice);
+                    Data::bIsInitialized = true;
+                }
+
+                WindowedMode::TickDX9State();
+
+                // Sync multi-viewport runtime flag
+                ImGuiIO& io = ImGui::GetIO();
+                if (WindowedMode::IsMultiViewportEnabled()) {
+                    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+                }
+                else
+                    io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
+
+                const OverlayFrameMode frameMode = g_OverlayFrameGate.Begin(Data::pSettings);
+                if (frameMode != OverlayFrameMode::Full)
+                {
+                    Hooks::ApplyBufferedInput(); // Keeps controller hotplug/virtual pad (and pad hotkeys) alive
+                    if (frameMode != OverlayFrameMode::Reuse) // Reuse: the next full frame consumes it
+                        g_OverlayFrameGate.DiscardPendingInput();
+
+                    if (Data::pSettings)
+                        Data::pSettings->UpdateWithoutFrame();
+
+                    if (frameMode != OverlayFrameMode::Skip)
+                    {
+                        ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+                        g_FrameBoundary.OnOverlayDrawn();
+                    }
+                    return;
+                }
+
+                ImGui_ImplDX9_NewFrame();
+
+                Data::bCallingImGui = true;
+                ImGui_ImplWin32_NewFrame();
+                Data::bCallingImGui = false;
+
+                Hooks::ApplyBufferedInput(); // Apply thread-safe input after backend updates
+                ImGui::NewFrame();
+                FrameArena::BeginFrame();
+
+                ImGui::GetIO().MouseDrawCursor = Data::bShowMenu;
+
+                if (Data::pSettings)
+                {
+                    Data::pSettings->DrawOverlay();
+                    if (Data::bShowMenu)
+                        Data::pSettings->DrawMenu();
+                }
 
+                ImGui::EndFrame();
+                ImGui::Render();
+                g_FrameBoundary.OnOverlayBuilt();
 
-            if (!Data::bIsInitialized)
+                // ImGui_ImplDX9 captures and restores the device state around its draws.
+                ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+                g_FrameBoundary.OnOverlayDrawn();
+
+                s_platformWindowsPending = (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) != 0;
+
+                if (!s_firstFrameTraced)
+                {
+                    s_firstFrameTraced = true;
+                    const int64_t frameEndUs = Trace::NowUs();
+                    Trace::Record("FirstFrame (DX9)", "render", nullptr, frameStartUs, frameEndUs - frameStartUs, Trace::CurrentThreadId());
+                    Data::firstFrameEndUs = frameEndUs;
+                }
+            }
+
+            // The frame had no back-buffer scene we could draw in: open one of our own.
+            void RenderOverlayInOwnScene(LPDIRECT3DDEVICE9 pDevice)
             {
-                LOG_INFO("hkEndScene: Initializing ImGui.");
-                Data::pDevice = pDevice;
-                InitImGui(pDevice);
-                Data::bIsInitialized = true;
+                IDirect3DSurface9* backBuffer = GetCachedBackBuffer(pDevice);
+                if (!backBuffer)
+                    return;
+                ComPtr<IDirect3DSurface9> previousTarget;
+                pDevice->GetRenderTarget(0, previousTarget.GetAddressOf());
+
+                D3DVIEWPORT9 previousViewport;
+                const bool haveViewport = SUCCEEDED(pDevice->GetViewport(&previousViewport));
+                const bool switchTarget = previousTarget.Get() != backBuffer;
+                if (switchTarget)
+                    pDevice->SetRenderTarget(0, backBuffer);
+
+                if (SUCCEEDED(pDevice->BeginScene()))
+                {
+                    RenderOverlay(pDevice);
+                    Data::oEndScene(pDevice);
+                }
+
+                // SetRenderTarget resets the viewport, so restore both.
+                if (switchTarget && previousTarget)
+                    pDevice->SetRenderTarget(0, previousTarget.Get());
+                if (haveViewport)
+                    pDevice->SetViewport(&previousViewport);
             }
 
-            Data::bIsRendering = true;
+            // Everything the overlay does at a frame boundary. Called before the original Present.
+            void OnFramePresent(LPDIRECT3DDEVICE9 pDevice)
+            {
+                if (Data::bIsDetached)
+                    return;
+
+                Data::bIsRendering = true;
+                s_drawingOverlay = true;
 
-            WindowedMode::TickDX9State();
+                if (g_FrameBoundary.ShouldDrawBeforePresent())
+                    RenderOverlayInOwnScene(pDevice);
 
-            // Sync multi-viewport runtime flag
-            ImGuiIO& io = ImGui::GetIO();
-            if (WindowedMode::IsMultiViewportEnabled()) {
-                io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+                // Multi-viewport: update and render platform windows
+                if (s_platformWindowsPending)
+                {
+                    s_platformWindowsPending = false;
+                    ImGui::UpdatePlatformWindows();
+                    ImGui::RenderPlatformWindowsDefault();
+                }
+
+                g_FrameBoundary.OnPresent();
+                g_AllocationCounter.OnFrame();
+
+                s_drawingOverlay = false;
+                Data::bIsRendering = false;
             }
-            else
-                io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
+        }
 
-            ImGui_ImplDX9_NewFrame();
+        HRESULT __stdcall hkPresent9(LPDIRECT3DDEVICE9 pDevice, CONST RECT* pSourceRect, CONST RECT* pDestRect, HWND hDestWindowOverride, CONST RGNDATA* pDirtyRegion)
+        {
+            if (Data::g_fakeResetState == BaseHook::FakeResetState::Initiate)
+            {
+                LOG_INFO("hkPresent9: Fake Reset Initiate (DEVICELOST)");
+                return D3DERR_DEVICELOST;
+            }
 
-            Data::bCallingImGui = true;
-            ImGui_ImplWin32_NewFrame();
-            Data::bCallingImGui = false;
+            OnFramePresent(pDevice);
 
-            Hooks::ApplyBufferedInput(); // Apply thread-safe input after backend updates
-            ImGui::NewFrame();
+            g_FramerateLimiter.Wait();
+
+            s_inDevicePresent = true;
+            HRESULT hr = Data::oPresent9(pDevice, pSourceRect, pDestRect, hDestWindowOverride, pDirtyRegion);
+            s_inDevicePresent = false;
+            if (hr == D3DERR_DEVICELOST) {
+                LOG_THROTTLED(5000, "hkPresent9: Result=DEVICELOST");
+            }
+            return hr;
+        }
 
-            ImGui::GetIO().MouseDrawCursor = Data::bShowMenu;
+        HRESULT __stdcall hkSwapChainPresent9(IDirect3DSwapChain9* pSwapChain, CONST RECT* pSourceRect, CONST RECT* pDestRect, HWND hDestWindowOverride, CONST RGNDATA* pDirtyRegion, DWORD dwFlags)
+        {
+            // ImGui's platform windows present their own swap chains from inside OnFramePresent.
+            if (s_drawingOverlay || s_inDevicePresent)
+                return Data::oSwapChainPresent9(pSwapChain, pSourceRect, pDestRect, hDestWindowOverride, pDirtyRegion, dwFlags);
+
+            // Only the implicit swap chain ends a game frame.
+            ComPtr<IDirect3DDevice9> device;
+            ComPtr<IDirect3DSwapChain9> implicitSwapChain;
+            const bool isGameFrame = SUCCEEDED(pSwapChain->GetDevice(device.GetAddressOf()))
+                && SUCCEEDED(device->GetSwapChain(0, implicitSwapChain.GetAddressOf()))
+                && implicitSwapChain.Get() == pSwapChain;
+            if (!isGameFrame)
+                return Data::oSwapChainPresent9(pSwapChain, pSourceRect, pDestRect, hDestWindowOverride, pDirtyRegion, dwFlags);
 
-            if (Data::pSettings)
+            if (Data::g_fakeResetState == BaseHook::FakeResetState::Initiate)
             {
-                Data::pSettings->DrawOverlay();
-                if (Data::bShowMenu)
-                    Data::pSettings->DrawMenu();
+                LOG_INFO("hkSwapChainPresent9: Fake Reset Initiate (DEVICELOST)");
+                return D3DERR_DEVICELOST;
             }
 
-            ImGui::EndFrame();
-            ImGui::Render();
-            
-            // DX9 saves state internally in ImGui_ImplDX9 usually, but 
-            // user app should be careful about state blocks. 
-            // Standard ImGui_ImplDX9 is usually robust enough for EndScene.
-            ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+            OnFramePresent(device.Get());
 
-            // Multi-viewport: update and render platform windows
-            if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+            g_FramerateLimiter.Wait();
+
+            HRESULT hr = Data::oSwapChainPresent9(pSwapChain, pSourceRect, pDestRect, hDestWindowOverride, pDirtyRegion, dwFlags);
+            if (hr == D3DERR_DEVICELOST) {
+                LOG_THROTTLED(5000, "hkSwapChainPresent9: Result=DEVICELOST");
+            }
+            return hr;
+        }
+
+        HRESULT __stdcall hkEndScene(LPDIRECT3DDEVICE9 pDevice)
+        {
+            if (Data::bIsDetached || s_drawingOverlay)
             {
-                ImGui::UpdatePlatformWindows();
-                ImGui::RenderPlatformWindowsDefault();
+                return Data::oEndScene(pDevice);
             }
 
-            Data::bIsRendering = false;
+            // Intermediate scenes (shadow maps, reflections, ...) only get counted; the render target
+            // is only looked at in the scene the overlay would go in.
+            if (g_FrameBoundary.OnEndScene([pDevice] { return IsBackBufferTarget(pDevice); }))
+            {
+                Data::bIsRendering = true;
+                s_drawingOverlay = true;
+                RenderOverlay(pDevice);
+                s_drawingOverlay = false;
+                Data::bIsRendering = false;
+            }
 
             return Data::oEndScene(pDevice);
         }
 
         HRESULT __stdcall hkReset(LPDIRECT3DDEVICE9 pDevice, D3DPRESENT_PARAMETERS* pPresentationParameters)
         {
+            TRACE_SCOPE_CAT("hkReset", "render");
             WindowedMode::CheckAndApplyPendingState();
 
             // CRITICAL: Make a local copy. Do NOT modify the game's pointer directly.
@@ -231,6 +410,9 @@ namespace BaseHook
             // Invalidate BEFORE calling original Reset
             if (Data::bIsInitialized)
                 ImGui_ImplDX9_InvalidateDeviceObjects();
+            ReleaseCachedBackBuffer();
+            g_OverlayFrameGate.Invalidate();
+            g_FrameBoundary.Invalidate();
                 
             HRESULT hr = Data::oReset(pDevice, pParamsToUse);
             
@@ -276,6 +458,7 @@ namespace BaseHook
 
         HRESULT __stdcall hkResetEx(IDirect3DDevice9Ex* pDevice, D3DPRESENT_PARAMETERS* pPresentationParameters, D3DDISPLAYMODEEX* pFullscreenDisplayMode)
         {
+            TRACE_SCOPE_CAT("hkResetEx", "render");
             WindowedMode::CheckAndApplyPendingState();
 
             D3DPRESENT_PARAMETERS params = *pPresentationParameters;
@@ -322,6 +505,9 @@ namespace BaseHook
             // Invalidate BEFORE calling original ResetEx
             if (Data::bIsInitialized)
                 ImGui_ImplDX9_InvalidateDeviceObjects();
+            ReleaseCachedBackBuffer();
+            g_OverlayFrameGate.Invalidate();
+            g_FrameBoundary.Invalidate();
 
             HRESULT hr = Data::oResetEx(pDevice, pParamsToUse, pFullscreenModeToUse);
 
@@ -6,6 +6,9 @@
 #include "core/WindowedMode.h"
 #include "log.h"
 #include "util/FramerateLimiter.h"
+#include "util/OverlayFrameGate.h"
+#include "util/AllocationCounter.h"
+#include "FrameArena.h"
 #include "util/ComPtr.h"
 
 #include "imgui.h"
@@ -184,6 +187,7 @@ namespace BaseHook::Hooks
         if (Data::bIsInitialized)
             return true;
 
+        TRACE_SCOPE_CAT("InitImGui (DXGI)", "render");
         Data::pSwapChain = pSwapChain;
         EnsureSwapChainFullscreenHook(pSwapChain);
 
@@ -304,15 +308,14 @@ namespace BaseHook::Hooks
 
         Hooks::ApplyBufferedInput();
         ImGui::NewFrame();
+        FrameArena::BeginFrame();
 
         ImGui::GetIO().MouseDrawCursor = Data::bShowMenu;
     }
 
-    static void EndAndRender(Api api)
+    // Submits the current draw data to the game's back buffer, preserving its render target/viewport.
+    static void RenderDrawData(Api api)
     {
-        ImGui::EndFrame();
-        ImGui::Render();
-
         if (api == Api::D3D10)
         {
             ComPtr<ID3D10RenderTargetView> pOldRTV;
@@ -347,6 +350,13 @@ namespace BaseHook::Hooks
             Data::pContext11->OMSetRenderTargets(1, &oldRtvRaw, pOldDSV.Get());
             Data::pContext11->RSSetViewports(nViewPorts, pOldViewPorts);
         }
+    }
+
+    static void EndAndRender(Api api)
+    {
+        ImGui::EndFrame();
+        ImGui::Render();
+        RenderDrawData(api);
 
         // Multi-viewport: update and render platform windows
         ImGuiIO& io = ImGui::GetIO();
@@ -369,6 +379,34 @@ namespace BaseHook::Hooks
 
         if (Data::bIsInitialized)
         {
+            // Only the very first overlay frame is traced; steady-state frames would just flood the buffers.
+            static bool s_firstFrameTraced = false;
+            const int64_t frameStartUs = s_firstFrameTraced ? 0 : Trace::NowUs();
+
+            g_AllocationCounter.OnFrame();
+            const OverlayFrameMode frameMode = g_OverlayFrameGate.Begin(Data::pSettings);
+            if (frameMode != OverlayFrameMode::Full)
+            {
+                WindowedMode::TickDXGIState();
+                if (WindowedMode::ShouldHandle())
+                    WindowedMode::Apply(Data::hWindow);
+
+                Data::bIsRendering = true;
+                Hooks::ApplyBufferedInput(); // Keeps controller hotplug/virtual pad (and pad hotkeys) alive
+                if (frameMode != OverlayFrameMode::Reuse) // Reuse: the next full frame consumes it
+                    g_OverlayFrameGate.DiscardPendingInput();
+
+                if (Data::pSettings)
+                    Data::pSettings->UpdateWithoutFrame();
+
+                if (frameMode != OverlayFrameMode::Skip)
+                    RenderDrawData(api);
+                Data::bIsRendering = false;
+
+                g_FramerateLimiter.Wait();
+                return Data::oPresent(pSwapChain, SyncInterval, Flags);
+            }
+
             BeginFrame(api);
 
             if (Data::pSettings)
@@ -379,6 +417,14 @@ namespace BaseHook::Hooks
             }
 
             EndAndRender(api);
+
+            if (!s_firstFrameTraced)
+            {
+                s_firstFrameTraced = true;
+                const int64_t frameEndUs = Trace::NowUs();
+                Trace::Record("FirstFrame (DXGI)", "render", nullptr, frameStartUs, frameEndUs - frameStartUs, Trace::CurrentThreadId());
+                Data::firstFrameEndUs = frameEndUs;
+            }
         }
 
         g_FramerateLimiter.Wait();
@@ -388,6 +434,7 @@ namespace BaseHook::Hooks
 
     HRESULT ResizeBuffers(Api api, IDXGISwapChain* pSwapChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT SwapChainFlags)
     {
+        TRACE_SCOPE_CAT("ResizeBuffers", "render");
         WindowedMode::CheckAndApplyPendingState();
         if (WindowedMode::ShouldHandle() || WindowedMode::ShouldApplyResolutionOverride())
         {
@@ -410,6 +457,7 @@ namespace BaseHook::Hooks
                 WindowedMode::Apply(Data::hWindow);
         }
 
+        g_OverlayFrameGate.Invalidate();
         if (Data::bIsInitialized)
         {
             if (api == Api::D3D10)
@@ -2,6 +2,11 @@
 #include "core/BaseHook.h"
 #include "hooks/InputHooks.h"
 #include "hooks/WindowHooks.h"
+#include "util/SonyReportDecoder.h"
+#include "util/VirtualPad.h"
+#include "util/LatencyHistogram.h"
+#include "util/InputRecording.h"
+#include "util/InputEventRing.h"
 #include <unordered_set>
 #include <unordered_map>
 #include <shared_mutex>
@@ -15,6 +20,7 @@
 #include <atomic>
 #include <cmath>
 #include <thread>
+#include <cstddef>
 #include <Dbt.h>
 #include <xinput.h>
 #include <hidclass.h>
@@ -29,7 +35,12 @@
 #define XINPUT_GAMEPAD_GUIDE 0x0400
 #endif
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 using BaseHook::Hooks::GamepadInputSource;
+namespace Sony = BaseHook::Sony;
 
 namespace BaseHook
 {
@@ -190,30 +201,51 @@ static void ApplyHIDStateToDI(const XINPUT_STATE& xState, const DeviceInfo& info
     setBtn(10, (pad.wButtons & XINPUT_GAMEPAD_LEFT_THUMB) != 0); // L3
     setBtn(11, (pad.wButtons & XINPUT_GAMEPAD_RIGHT_THUMB) != 0); // R3
     setBtn(12, (pad.wButtons & XINPUT_GAMEPAD_GUIDE) != 0); // PS
+    setBtn(13, (pad.wButtons & Sony::kTouchpadButton) != 0); // Touchpad click
 }
 
-// Thread-safe Input Buffer
-static std::mutex g_input_queue_mutex;
-struct MouseBuffer {
-    long lX = 0;
-    long lY = 0;
-    long lZ = 0;
-    BYTE rgbButtons[8] = {0};
-} g_mouse_buffer;
+// DirectInput mouse -> ImGui. The game's GetDeviceState calls produce events, ApplyBufferedInput
+// consumes them on the render thread. Producers only serialize among themselves (games poll the
+// mouse from one thread in practice), so the render thread never waits on the input thread.
+static constexpr size_t kMouseQueueCapacity = 1024;
+static BaseHook::InputEventRing<kMouseQueueCapacity> g_mouseEvents;
+static std::mutex g_mouseProducerMutex;
+static uint8_t g_mouseButtons = 0;                  // Last mask pushed (g_mouseProducerMutex)
+static std::atomic<uint64_t> g_mouseMovesCoalesced{ 0 };
+
+static_assert(sizeof(BaseHook::PadState) == sizeof(XINPUT_STATE)
+    && offsetof(BaseHook::PadState, buttons) == offsetof(XINPUT_STATE, Gamepad.wButtons)
+    && offsetof(BaseHook::PadState, thumbLX) == offsetof(XINPUT_STATE, Gamepad.sThumbLX),
+    "PadState must mirror XINPUT_STATE");
+
+static BaseHook::PadState ToPadState(const XINPUT_STATE& state)
+{
+    BaseHook::PadState pad;
+    memcpy(&pad, &state, sizeof(pad));
+    return pad;
+}
 
-struct VirtualPadState
+static XINPUT_STATE ToXInputState(const BaseHook::PadState& pad)
 {
-    XINPUT_STATE state{};
-    GamepadInputSource source = GamepadInputSource::None;
-    void* context = nullptr;
-    bool hasData = false;
-    ULONGLONG lastUpdateMs = 0;
-    DWORD packetCounter = 1;
-};
+    XINPUT_STATE state;
+    memcpy(&state, &pad, sizeof(state));
+    return state;
+}
+
+// Microseconds on the QueryPerformanceCounter clock; what pad updates are stamped with.
+static int64_t QpcNowUs()
+{
+    static const int64_t frequency = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f.QuadPart; }();
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return static_cast<int64_t>(now.QuadPart / frequency * 1000000 + now.QuadPart % frequency * 1000000 / frequency);
+}
 
-static VirtualPadState g_virtualPad;
-static std::mutex g_virtualPadMutex;
 constexpr ULONGLONG kVirtualStateStaleMs = 500;
+static BaseHook::VirtualPadMerger g_virtualPad(kVirtualStateStaleMs);
+// Age of each pad update when the game's XInputGetState first returns it.
+static BaseHook::LatencyHistogram g_padLatency;
+static BaseHook::InputRecording::Writer g_inputRecording;
 
 static int GetSourcePriority(GamepadInputSource source)
 {
@@ -226,47 +258,15 @@ static int GetSourcePriority(GamepadInputSource source)
     }
 }
 
-static bool UpdateVirtualPad(GamepadInputSource source, void* context, const XINPUT_STATE& translated, bool& outSourceChanged)
+static bool UpdateVirtualPad(GamepadInputSource source, void* context, const XINPUT_STATE& translated, int64_t sourceTimeUs, bool& outSourceChanged)
 {
-    outSourceChanged = false;
-
-    std::lock_guard<std::mutex> lock(g_virtualPadMutex);
-    const ULONGLONG now = GetTickCount64();
-    const bool sameContext = g_virtualPad.hasData && g_virtualPad.source == source && g_virtualPad.context == context;
-    const bool stale = !g_virtualPad.hasData || (now - g_virtualPad.lastUpdateMs) > kVirtualStateStaleMs;
-
-    if (g_virtualPad.hasData && !sameContext && !stale)
-    {
-        if (GetSourcePriority(source) < GetSourcePriority(g_virtualPad.source))
-            return false;
-    }
-
-    const bool swappedSource = !sameContext;
-
-    g_virtualPad.state = translated;
-    g_virtualPad.state.dwPacketNumber = ++g_virtualPad.packetCounter;
-    g_virtualPad.source = source;
-    g_virtualPad.context = context;
-    g_virtualPad.hasData = true;
-    g_virtualPad.lastUpdateMs = now;
-
-    outSourceChanged = swappedSource;
-    return true;
+    return g_virtualPad.Submit(static_cast<int>(source), GetSourcePriority(source), context, ToPadState(translated),
+        sourceTimeUs != 0 ? sourceTimeUs : QpcNowUs(), GetTickCount64(), outSourceChanged);
 }
 
 static void ResetVirtualPad(GamepadInputSource sourceFilter = GamepadInputSource::None, void* contextFilter = nullptr)
 {
-    std::lock_guard<std::mutex> lock(g_virtualPadMutex);
-    if (!g_virtualPad.hasData)
-        return;
-
-    if (sourceFilter != GamepadInputSource::None && g_virtualPad.source != sourceFilter)
-        return;
-
-    if (contextFilter && g_virtualPad.context != contextFilter)
-        return;
-
-    g_virtualPad = {};
+    g_virtualPad.Reset(static_cast<int>(sourceFilter), contextFilter);
 }
 
 static SHORT AxisToThumbValue(const AxisRange& range, LONG value, bool invert = false)
@@ -349,18 +349,11 @@ static XINPUT_STATE BuildVirtualXInputState(const DIJOYSTATE2& state, const Devi
 
 static bool TryCopyVirtualPad(XINPUT_STATE* outState)
 {
-    if (!outState)
-        return false;
-
-    std::lock_guard<std::mutex> lock(g_virtualPadMutex);
-    if (!g_virtualPad.hasData)
+    BaseHook::PadState pad;
+    if (!outState || !g_virtualPad.Peek(GetTickCount64(), pad))
         return false;
 
-    ULONGLONG elapsed = GetTickCount64() - g_virtualPad.lastUpdateMs;
-    if (elapsed > kVirtualStateStaleMs)
-        return false;
-
-    *outState = g_virtualPad.state;
+    *outState = ToXInputState(pad);
     return true;
 }
 
@@ -770,7 +763,16 @@ namespace
     constexpr USHORT kDualSenseProductId = 0x0ce6;
     const std::vector<USHORT> kDualShock4ProductIds = { 0x05c4, 0x09cc };
 
-    enum class SonyControllerType { Unknown, DualShock4, DualSense };
+    // ReadFile gets room for this many reports; the HID driver hands over everything queued (up to
+    // kSonyDriverInputBuffers) in one call.
+    constexpr DWORD kSonyReportsPerRead = 8;
+    constexpr ULONG kSonyDriverInputBuffers = 64;
+    // While reports stream in faster than this (DualSense over USB sends 1000 per second), pause after
+    // each read so they pile up and the next read returns several at once, instead of waking the
+    // reader for every one of them. Slower streams, and the first report after a quiet spell (the
+    // DualSense Bluetooth short report is only sent on change), are read without the pause.
+    constexpr LONGLONG kSonyBatchWait100ns = 20000; // 2 ms
+    constexpr uint32_t kSonyMaxIntegrationGapUs = 50000;
 
     struct SonyDevice
     {
@@ -778,10 +780,13 @@ namespace
         HANDLE handle = INVALID_HANDLE_VALUE;
         HIDP_CAPS caps{};
         bool bluetooth = false;
-        SonyControllerType type = SonyControllerType::Unknown;
+        Sony::ControllerType type = Sony::ControllerType::DualShock4;
         USHORT pid = 0;
 
-        std::vector<uint8_t> inputBuffer;
+        std::vector<uint8_t> inputBuffer;       // kSonyReportsPerRead reports
+        std::vector<Sony::DecodedReport> decoded;
+        uint32_t lastSensorTimestamp = 0;       // Guarded by g_sonyMotionMutex
+        bool haveSensorTimestamp = false;
         std::atomic<bool> running{ false };
         std::thread readerThread;
         bool seenInRefresh = false;
@@ -824,196 +829,68 @@ namespace
         return !g_sonyDevices.empty();
     }
 
-    // Common Helpers
-    SHORT SonyStickFromByte(uint8_t value, bool invert = false)
-    {
-        float normalized = (static_cast<float>(value) / 255.0f) * 2.0f - 1.0f;
-        if (invert) normalized = -normalized;
-        float scaled = normalized * 32767.0f;
-        if (scaled > 32767.0f) scaled = 32767.0f;
-        if (scaled < -32767.0f) scaled = -32767.0f;
-        return static_cast<SHORT>(scaled);
-    }
+    // Motion/touch of the controller currently driving the virtual pad.
+    std::mutex g_sonyMotionMutex;
+    ControllerMotionState g_sonyMotion{};
+    const SonyDevice* g_sonyMotionDevice = nullptr;
 
-    void ApplySonyHat(uint8_t hat, WORD& buttons)
+    void PublishSonyMotion(SonyDevice& dev, const Sony::DecodedReport* reports, size_t count)
     {
-        switch (hat)
+        std::lock_guard<std::mutex> lock(g_sonyMotionMutex);
+        if (g_sonyMotionDevice != &dev)
         {
-        case 0: buttons |= XINPUT_GAMEPAD_DPAD_UP; break;
-        case 1: buttons |= XINPUT_GAMEPAD_DPAD_UP | XINPUT_GAMEPAD_DPAD_RIGHT; break;
-        case 2: buttons |= XINPUT_GAMEPAD_DPAD_RIGHT; break;
-        case 3: buttons |= XINPUT_GAMEPAD_DPAD_RIGHT | XINPUT_GAMEPAD_DPAD_DOWN; break;
-        case 4: buttons |= XINPUT_GAMEPAD_DPAD_DOWN; break;
-        case 5: buttons |= XINPUT_GAMEPAD_DPAD_DOWN | XINPUT_GAMEPAD_DPAD_LEFT; break;
-        case 6: buttons |= XINPUT_GAMEPAD_DPAD_LEFT; break;
-        case 7: buttons |= XINPUT_GAMEPAD_DPAD_LEFT | XINPUT_GAMEPAD_DPAD_UP; break;
-        default: break;
+            g_sonyMotionDevice = &dev;
+            dev.haveSensorTimestamp = false;
+            Sony::GetTouchpadSize(dev.type, g_sonyMotion.touchWidth, g_sonyMotion.touchHeight);
         }
-    }
-
-    // --- DualSense Parsing ---
-    struct DualSenseParsedState
-    {
-        uint8_t lx = 128, ly = 128, rx = 128, ry = 128;
-        uint8_t l2 = 0, r2 = 0;
-        uint8_t dpad = 8;
-        bool square = false, cross = false, circle = false, triangle = false;
-        bool l1 = false, r1 = false, l2Button = false, r2Button = false;
-        bool create = false, options = false, l3 = false, r3 = false;
-        bool ps = false, touchpad = false, mute = false;
-    };
 
-    bool ParseDualSenseUsbReport(const uint8_t* data, size_t len, DualSenseParsedState& parsed)
-    {
-        if (len < 64 || data[0] != 0x01) return false;
-        const uint8_t* payload = data + 1;
-        parsed.lx = payload[0]; parsed.ly = payload[1];
-        parsed.rx = payload[2]; parsed.ry = payload[3];
-        parsed.l2 = payload[4]; parsed.r2 = payload[5];
-
-        uint8_t buttons0 = payload[7];
-        uint8_t buttons1 = payload[8];
-        uint8_t buttons2 = payload[9];
-
-        parsed.dpad = buttons0 & 0x0F;
-        parsed.square = (buttons0 & 0x10); parsed.cross = (buttons0 & 0x20);
-        parsed.circle = (buttons0 & 0x40); parsed.triangle = (buttons0 & 0x80);
-
-        parsed.l1 = (buttons1 & 0x01); parsed.r1 = (buttons1 & 0x02);
-        parsed.l2Button = (buttons1 & 0x04); parsed.r2Button = (buttons1 & 0x08);
-        parsed.create = (buttons1 & 0x10); parsed.options = (buttons1 & 0x20);
-        parsed.l3 = (buttons1 & 0x40); parsed.r3 = (buttons1 & 0x80);
-
-        parsed.ps = (buttons2 & 0x01); parsed.touchpad = (buttons2 & 0x02); parsed.mute = (buttons2 & 0x04);
-        return true;
-    }
-
-    bool ParseDualSenseBtShortReport(const uint8_t* data, size_t len, DualSenseParsedState& parsed)
-    {
-        if (len < 10 || data[0] != 0x01) return false;
-        const uint8_t* payload = data + 1;
-        parsed.lx = payload[0]; parsed.ly = payload[1];
-        parsed.rx = payload[2]; parsed.ry = payload[3];
-        parsed.dpad = payload[4] & 0x0F;
-        parsed.square = (payload[4] & 0x10); parsed.cross = (payload[4] & 0x20);
-        parsed.circle = (payload[4] & 0x40); parsed.triangle = (payload[4] & 0x80);
-
-        uint8_t buttons1 = payload[5];
-        parsed.l1 = (buttons1 & 0x01); parsed.r1 = (buttons1 & 0x02);
-        parsed.l2Button = (buttons1 & 0x04); parsed.r2Button = (buttons1 & 0x08);
-        parsed.create = (buttons1 & 0x10); parsed.options = (buttons1 & 0x20);
-        parsed.l3 = (buttons1 & 0x40); parsed.r3 = (buttons1 & 0x80);
-
-        uint8_t buttons2 = payload[6];
-        parsed.ps = (buttons2 & 0x01); parsed.touchpad = (buttons2 & 0x02);
-        parsed.l2 = payload[7]; parsed.r2 = payload[8];
-        return true;
-    }
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Sony::DecodedReport& report = reports[i];
+            if (!report.hasMotion)
+                continue;
 
-    bool ParseDualSenseBtFullReport(const uint8_t* data, size_t len, DualSenseParsedState& parsed)
-    {
-        if (len < 78 || data[0] != 0x31) return false;
-        const uint8_t* payload = data + 1;
-        parsed.lx = payload[1]; parsed.ly = payload[2];
-        parsed.rx = payload[3]; parsed.ry = payload[4];
-        parsed.l2 = payload[5]; parsed.r2 = payload[6];
-
-        uint8_t buttons0 = payload[8];
-        uint8_t buttons1 = payload[9];
-        uint8_t buttons2 = payload[10];
-
-        parsed.dpad = buttons0 & 0x0F;
-        parsed.square = (buttons0 & 0x10); parsed.cross = (buttons0 & 0x20);
-        parsed.circle = (buttons0 & 0x40); parsed.triangle = (buttons0 & 0x80);
-
-        parsed.l1 = (buttons1 & 0x01); parsed.r1 = (buttons1 & 0x02);
-        parsed.l2Button = (buttons1 & 0x04); parsed.r2Button = (buttons1 & 0x08);
-        parsed.create = (buttons1 & 0x10); parsed.options = (buttons1 & 0x20);
-        parsed.l3 = (buttons1 & 0x40); parsed.r3 = (buttons1 & 0x80);
-
-        parsed.ps = (buttons2 & 0x01); parsed.touchpad = (buttons2 & 0x02); parsed.mute = (buttons2 & 0x04);
-        return true;
-    }
+            if (dev.haveSensorTimestamp)
+            {
+                const uint32_t dtUs = Sony::SensorTimestampDeltaUs(dev.type, dev.lastSensorTimestamp, report.sensorTimestamp);
+                g_sonyMotion.timestampUs += dtUs;
+                // A long gap (controller asleep, reader stalled) isn't rotation at the current rate.
+                if (dtUs <= kSonyMaxIntegrationGapUs)
+                {
+                    for (int axis = 0; axis < 3; ++axis)
+                        g_sonyMotion.gyroAngle[axis] += report.gyro[axis] * (dtUs * 1e-6);
+                }
+            }
+            dev.lastSensorTimestamp = report.sensorTimestamp;
+            dev.haveSensorTimestamp = true;
 
-    bool DecodeDualSenseReport(const uint8_t* data, size_t len, XINPUT_STATE& out)
-    {
-        DualSenseParsedState parsed{};
-        bool parsedOk = false;
-
-        if (len >= 78 && data[0] == 0x31) parsedOk = ParseDualSenseBtFullReport(data, len, parsed);
-        else if (len >= 64 && data[0] == 0x01) parsedOk = ParseDualSenseUsbReport(data, len, parsed);
-        else if (len >= 10 && data[0] == 0x01) parsedOk = ParseDualSenseBtShortReport(data, len, parsed);
-
-        if (!parsedOk) return false;
-
-        out = {};
-        XINPUT_GAMEPAD& pad = out.Gamepad;
-        if (parsed.cross) pad.wButtons |= XINPUT_GAMEPAD_A;
-        if (parsed.circle) pad.wButtons |= XINPUT_GAMEPAD_B;
-        if (parsed.triangle) pad.wButtons |= XINPUT_GAMEPAD_Y;
-        if (parsed.square) pad.wButtons |= XINPUT_GAMEPAD_X;
-        if (parsed.l1) pad.wButtons |= XINPUT_GAMEPAD_LEFT_SHOULDER;
-        if (parsed.r1) pad.wButtons |= XINPUT_GAMEPAD_RIGHT_SHOULDER;
-        if (parsed.create) pad.wButtons |= XINPUT_GAMEPAD_BACK;
-        if (parsed.options) pad.wButtons |= XINPUT_GAMEPAD_START;
-        if (parsed.l3) pad.wButtons |= XINPUT_GAMEPAD_LEFT_THUMB;
-        if (parsed.r3) pad.wButtons |= XINPUT_GAMEPAD_RIGHT_THUMB;
-        if (parsed.touchpad) pad.wButtons |= XINPUT_GAMEPAD_BACK;
-#ifdef XINPUT_GAMEPAD_GUIDE
-        if (parsed.ps) pad.wButtons |= XINPUT_GAMEPAD_GUIDE;
-#endif
-        ApplySonyHat(parsed.dpad, pad.wButtons);
-        pad.bLeftTrigger = parsed.l2;
-        pad.bRightTrigger = parsed.r2;
-        pad.sThumbLX = SonyStickFromByte(parsed.lx);
-        pad.sThumbLY = SonyStickFromByte(parsed.ly, true);
-        pad.sThumbRX = SonyStickFromByte(parsed.rx);
-        pad.sThumbRY = SonyStickFromByte(parsed.ry, true);
-        return true;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                g_sonyMotion.gyro[axis] = report.gyro[axis];
+                g_sonyMotion.accel[axis] = report.accel[axis];
+            }
+            for (int t = 0; t < 2; ++t)
+            {
+                g_sonyMotion.touch[t].active = report.touch[t].active;
+                g_sonyMotion.touch[t].id = report.touch[t].id;
+                g_sonyMotion.touch[t].x = report.touch[t].x;
+                g_sonyMotion.touch[t].y = report.touch[t].y;
+            }
+            ++g_sonyMotion.sampleCount;
+        }
     }
 
-    // --- DualShock 4 Parsing ---
-    bool DecodeDualShock4Report(const uint8_t* data, size_t len, XINPUT_STATE& out)
+    void ForgetSonyMotion(const SonyDevice* dev)
     {
-        if (len < 10) return false;
-        const uint8_t* payload = nullptr;
-        if (data[0] == 0x11 && len >= 78) payload = data + 3; // BT
-        else if (data[0] == 0x01 && len >= 9) payload = data + 1; // USB
-        else return false;
-
-        out = {};
-        XINPUT_GAMEPAD& pad = out.Gamepad;
-        pad.sThumbLX = SonyStickFromByte(payload[0]);
-        pad.sThumbLY = SonyStickFromByte(payload[1], true);
-        pad.sThumbRX = SonyStickFromByte(payload[2]);
-        pad.sThumbRY = SonyStickFromByte(payload[3], true);
-
-        uint8_t btn1 = payload[4];
-        uint8_t btn2 = payload[5];
-        uint8_t btn3 = payload[6];
-
-        ApplySonyHat(btn1 & 0x0F, pad.wButtons);
-        if (btn1 & 0x10) pad.wButtons |= XINPUT_GAMEPAD_X; // Square
-        if (btn1 & 0x20) pad.wButtons |= XINPUT_GAMEPAD_A; // Cross
-        if (btn1 & 0x40) pad.wButtons |= XINPUT_GAMEPAD_B; // Circle
-        if (btn1 & 0x80) pad.wButtons |= XINPUT_GAMEPAD_Y; // Triangle
-        if (btn2 & 0x01) pad.wButtons |= XINPUT_GAMEPAD_LEFT_SHOULDER;
-        if (btn2 & 0x02) pad.wButtons |= XINPUT_GAMEPAD_RIGHT_SHOULDER;
-        if (btn2 & 0x10) pad.wButtons |= XINPUT_GAMEPAD_BACK;  // Share
-        if (btn2 & 0x20) pad.wButtons |= XINPUT_GAMEPAD_START; // Options
-        if (btn2 & 0x40) pad.wButtons |= XINPUT_GAMEPAD_LEFT_THUMB;
-        if (btn2 & 0x80) pad.wButtons |= XINPUT_GAMEPAD_RIGHT_THUMB;
-        if (btn3 & 0x01) pad.wButtons |= XINPUT_GAMEPAD_GUIDE; // PS
-
-        pad.bLeftTrigger = payload[7];
-        pad.bRightTrigger = payload[8];
-        return true;
+        std::lock_guard<std::mutex> lock(g_sonyMotionMutex);
+        if (g_sonyMotionDevice == dev)
+            g_sonyMotionDevice = nullptr;
     }
 
     // --- Unified Processing ---
     void ConfigureSonyDevice(SonyDevice& dev)
     {
-        if (dev.type == SonyControllerType::DualSense && dev.bluetooth && dev.caps.FeatureReportByteLength > 0)
+        if (dev.type == Sony::ControllerType::DualSense && dev.bluetooth && dev.caps.FeatureReportByteLength > 0)
         {
             std::vector<uint8_t> feature(dev.caps.FeatureReportByteLength, 0);
             feature[0] = 0x05;
@@ -1024,6 +901,11 @@ namespace
 
     void SonyReadLoop(SonyDevice* dev)
     {
+        // Sleep() would round the batching pause up to the system timer tick (15.6 ms by default).
+        HANDLE batchTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        const size_t reportSize = dev->caps.InputReportByteLength;
+        int64_t previousArrivalUs = 0;
+
         while (dev->running.load())
         {
             DWORD bytesRead = 0;
@@ -1037,27 +919,45 @@ namespace
             }
 
             if (bytesRead == 0) continue;
+            const int64_t arrivalUs = QpcNowUs();
 
-            XINPUT_STATE xState{};
-            bool parsed = false;
-
-            if (dev->type == SonyControllerType::DualSense)
-                parsed = DecodeDualSenseReport(dev->inputBuffer.data(), bytesRead, xState);
-            else if (dev->type == SonyControllerType::DualShock4)
-                parsed = DecodeDualShock4Report(dev->inputBuffer.data(), bytesRead, xState);
+            if (g_inputRecording.IsOpen())
+                g_inputRecording.Append(arrivalUs, static_cast<uint8_t>(dev->type), static_cast<uint16_t>(reportSize), dev->inputBuffer.data(), bytesRead);
 
-            if (parsed)
+            // Normally whole reports; a shorter read is decoded as a single (short) report.
+            const size_t stride = bytesRead >= reportSize ? reportSize : bytesRead;
+            const size_t decoded = Sony::DecodeReports(dev->type, dev->inputBuffer.data(), stride, bytesRead / stride, dev->decoded.data());
+            if (decoded > 0)
             {
+                // The pad only needs the latest state; every sample counts for motion.
                 bool swapped = false;
-                if (BaseHook::Hooks::SubmitVirtualGamepadState(GamepadInputSource::SonyHID, dev, xState, true, &swapped) && swapped)
+                const XINPUT_STATE latest = ToXInputState(Sony::ToPadState(dev->decoded[decoded - 1]));
+                if (BaseHook::Hooks::SubmitVirtualGamepadState(GamepadInputSource::SonyHID, dev, latest, true, &swapped, arrivalUs))
                 {
-                    LOG_INFO("SonyHID: Switched virtual XInput source to %ls (%s)", dev->path.c_str(), dev->bluetooth ? "Bluetooth" : "USB");
+                    if (swapped)
+                        LOG_INFO("SonyHID: Switched virtual XInput source to %ls (%s)", dev->path.c_str(), dev->bluetooth ? "Bluetooth" : "USB");
+                    PublishSonyMotion(*dev, dev->decoded.data(), decoded);
                 }
             }
+
+            // Several reports in one read, or this one within a batch pause of the previous: more are
+            // on the way.
+            const bool streaming = bytesRead / stride > 1 || arrivalUs - previousArrivalUs < kSonyBatchWait100ns / 10; // 100 ns -> us
+            previousArrivalUs = arrivalUs;
+            if (batchTimer && streaming)
+            {
+                LARGE_INTEGER due;
+                due.QuadPart = -kSonyBatchWait100ns;
+                if (SetWaitableTimer(batchTimer, &due, 0, nullptr, nullptr, FALSE))
+                    WaitForSingleObject(batchTimer, INFINITE);
+            }
         }
+        if (batchTimer) CloseHandle(batchTimer);
+        ForgetSonyMotion(dev);
         dev->running = false;
         g_sonyPendingRefresh = true;
         BaseHook::Hooks::ResetVirtualGamepad(GamepadInputSource::SonyHID, dev);
+        BaseHook::Hooks::WakePadPresenceMonitor();
     }
 
     void RefreshSonyDevices()
@@ -1101,11 +1001,10 @@ namespace
                 continue;
             }
 
-            SonyControllerType type = SonyControllerType::Unknown;
-            if (attrs.ProductID == kDualSenseProductId) type = SonyControllerType::DualSense;
-            else if (std::find(kDualShock4ProductIds.begin(), kDualShock4ProductIds.end(), attrs.ProductID) != kDualShock4ProductIds.end()) type = SonyControllerType::DualShock4;
-
-            if (type == SonyControllerType::Unknown)
+            Sony::ControllerType type;
+            if (attrs.ProductID == kDualSenseProductId) type = Sony::ControllerType::DualSense;
+            else if (std::find(kDualShock4ProductIds.begin(), kDualShock4ProductIds.end(), attrs.ProductID) != kDualShock4ProductIds.end()) type = Sony::ControllerType::DualShock4;
+            else
             {
                 CloseHandle(handle);
                 continue;
@@ -1154,10 +1053,12 @@ namespace
             dev->bluetooth = bluetooth;
             dev->type = type;
             dev->pid = attrs.ProductID;
-            dev->inputBuffer.resize(caps.InputReportByteLength);
+            dev->inputBuffer.resize(static_cast<size_t>(caps.InputReportByteLength) * kSonyReportsPerRead);
+            dev->decoded.resize(kSonyReportsPerRead);
             dev->running = true;
             dev->seenInRefresh = true;
 
+            HidD_SetNumInputBuffers(handle, kSonyDriverInputBuffers);
             ConfigureSonyDevice(*dev);
             dev->readerThread = std::thread(SonyReadLoop, dev.get());
 
@@ -1304,22 +1205,19 @@ void ProcessDeviceState(IDirectInputDevice8* pDevice, DWORD cbData, LPVOID lpvDa
             {
                 // --- FIX: Inject HID Data for Wireless PS4/PS5 ---
                 bool bInjected = false;
+                g_virtualPad.Inspect([&](const BaseHook::PadState& state, int source, const void* context)
                 {
-                    std::lock_guard<std::mutex> lock(g_virtualPadMutex);
-                    if (g_virtualPad.hasData)
+                    if (source == static_cast<int>(GamepadInputSource::SonyHID) && info.vid == 0x054C)
                     {
-                        if (g_virtualPad.source == GamepadInputSource::SonyHID && info.vid == 0x054C)
+                        // Verify matching PID to ensure we inject into the correct device
+                        auto* dev = static_cast<const SonyDevice*>(context);
+                        if (dev && dev->pid == info.pid)
                         {
-                            // Verify matching PID to ensure we inject into the correct device
-                            auto* dev = static_cast<SonyDevice*>(g_virtualPad.context);
-                            if (dev && dev->pid == info.pid)
-                            {
-                                ApplyHIDStateToDI(g_virtualPad.state, info, lpvData, cbData);
-                                bInjected = true;
-                            }
+                            ApplyHIDStateToDI(ToXInputState(state), info, lpvData, cbData);
+                            bInjected = true;
                         }
                     }
-                }
+                });
 
                 bool isPrimary = false;
                 if (g_PrimaryDevice == nullptr || g_PrimaryDevice == pDevice) {
@@ -1359,17 +1257,41 @@ void ProcessDeviceState(IDirectInputDevice8* pDevice, DWORD cbData, LPVOID lpvDa
         {
             if (cbData == sizeof(DIMOUSESTATE) || cbData == sizeof(DIMOUSESTATE2))
             {
-                auto* ms = static_cast<DIMOUSESTATE*>(lpvData);
-                std::lock_guard<std::mutex> queueLock(g_input_queue_mutex);
-
-                g_mouse_buffer.lX += ms->lX;
-                g_mouse_buffer.lY += ms->lY;
-                g_mouse_buffer.lZ += ms->lZ;
-
-                for (int i = 0; i < 4; i++) g_mouse_buffer.rgbButtons[i] = ms->rgbButtons[i];
-                if (cbData == sizeof(DIMOUSESTATE2)) {
-                    auto* ms2 = static_cast<DIMOUSESTATE2*>(lpvData);
-                    for (int i = 4; i < 8; i++) g_mouse_buffer.rgbButtons[i] = ms2->rgbButtons[i];
+                // DIMOUSESTATE is DIMOUSESTATE2 with 4 buttons instead of 8.
+                auto* ms = static_cast<DIMOUSESTATE2*>(lpvData);
+                const int buttonCount = (cbData == sizeof(DIMOUSESTATE2)) ? 8 : 4;
+                uint8_t buttons = 0;
+                for (int i = 0; i < buttonCount; i++)
+                    if (ms->rgbButtons[i] & 0x80) buttons |= (uint8_t)(1u << i);
+
+                BaseHook::InputEvent event;
+                event.timeUs = QpcNowUs();
+                std::lock_guard<std::mutex> producerLock(g_mouseProducerMutex);
+
+                // Immediate data has no order within one poll: motion first (with the buttons as
+                // they were), then button changes, then the wheel.
+                if (ms->lX != 0 || ms->lY != 0)
+                {
+                    event.type = BaseHook::InputEvent::Type::Move;
+                    event.buttons = g_mouseButtons;
+                    event.x = ms->lX;
+                    event.y = ms->lY;
+                    g_mouseEvents.Push(event);
+                }
+                for (int i = 0; i < 8; i++)
+                {
+                    const uint8_t bit = (uint8_t)(1u << i);
+                    if ((buttons ^ g_mouseButtons) & bit)
+                    {
+                        g_mouseButtons ^= bit;
+                        event = BaseHook::InputEvent{ BaseHook::InputEvent::Type::Button, g_mouseButtons, (uint8_t)((buttons & bit) != 0), (uint8_t)i, 0, 0, event.timeUs };
+                        g_mouseEvents.Push(event);
+                    }
+                }
+                if (ms->lZ != 0)
+                {
+                    event = BaseHook::InputEvent{ BaseHook::InputEvent::Type::Wheel, g_mouseButtons, 0, 0, 0, ms->lZ, event.timeUs };
+                    g_mouseEvents.Push(event);
                 }
             }
         }
@@ -1732,6 +1654,7 @@ HRESULT WINAPI hkDirectInput8Create(HINSTANCE hinst, DWORD dwVersion, REFIID rii
             LOG_INFO("DI8: Controller change detected (%u).", static_cast<unsigned>(wParam));
             SchedulePrivateRefresh();
             OnSonyDeviceChange();
+            WakePadPresenceMonitor();
             break;
         default:
             break;
@@ -1744,32 +1667,38 @@ HRESULT WINAPI hkDirectInput8Create(HINSTANCE hinst, DWORD dwVersion, REFIID rii
         PollPrivateDevicesFallback();
 
     {
-        std::lock_guard<std::mutex> lock(g_input_queue_mutex);
-        ImGuiIO& io = ImGui::GetIO();
+        // Always drain so the ring doesn't fill up while Win32 drives the overlay.
+        static BaseHook::InputEvent batch[kMouseQueueCapacity];
+        size_t count = 0;
+        g_mouseEvents.Drain([&](const BaseHook::InputEvent& event) { batch[count++] = event; });
 
-        if (BaseHook::Data::bImGuiMouseButtonsFromDirectInput)
+        if (count > 0 && BaseHook::Data::bImGuiMouseButtonsFromDirectInput)
         {
+            const size_t merged = BaseHook::CoalesceMoves(batch, count);
+            g_mouseMovesCoalesced.fetch_add(count - merged, std::memory_order_relaxed);
+
             // Overlay mouse movement is always Win32/WndProc-driven.
-            // Only inject wheel + buttons from DirectInput when configured.
-            if (g_mouse_buffer.lZ != 0)
+            // Only inject wheel + buttons from DirectInput when configured, in the order they happened
+            // (ImGui trickles fast press/release pairs over several frames).
+            ImGuiIO& io = ImGui::GetIO();
+            for (size_t i = 0; i < merged; i++)
             {
-                io.MouseWheel += (float)g_mouse_buffer.lZ / 120.0f;
-
-                g_mouse_buffer.lZ = 0;
+                const BaseHook::InputEvent& event = batch[i];
+                if (event.type == BaseHook::InputEvent::Type::Button && event.code < ImGuiMouseButton_COUNT)
+                    io.AddMouseButtonEvent(event.code, event.down != 0);
+                else if (event.type == BaseHook::InputEvent::Type::Wheel)
+                    io.AddMouseWheelEvent((float)event.x / 120.0f, (float)event.y / 120.0f);
             }
-
-            for (int i = 0; i < 8; i++)
-                io.MouseDown[i] = (g_mouse_buffer.rgbButtons[i] & 0x80) != 0;
         }
     }
 
     ApplyVirtualPadToImGui();
     }
 
-    bool SubmitVirtualGamepadState(GamepadInputSource source, void* context, const XINPUT_STATE& state, bool markAuthoritative, bool* outSourceChanged)
+    bool SubmitVirtualGamepadState(GamepadInputSource source, void* context, const XINPUT_STATE& state, bool markAuthoritative, bool* outSourceChanged, int64_t sourceTimeUs)
     {
         bool swapped = false;
-        bool accepted = UpdateVirtualPad(source, context, state, swapped);
+        bool accepted = UpdateVirtualPad(source, context, state, sourceTimeUs, swapped);
         if (!accepted)
         {
             if (outSourceChanged)
@@ -1802,4 +1731,75 @@ HRESULT WINAPI hkDirectInput8Create(HINSTANCE hinst, DWORD dwVersion, REFIID rii
 
         return TryCopyVirtualPad(pState);
     }
+
+    bool ConsumeVirtualXInputState(DWORD dwUserIndex, XINPUT_STATE* pState)
+    {
+        if (dwUserIndex != 0 || !pState)
+            return false;
+
+        BaseHook::VirtualPadMerger::Delivery delivery;
+        if (!g_virtualPad.Consume(GetTickCount64(), delivery))
+            return false;
+
+        if (delivery.firstDelivery)
+            g_padLatency.Record(QpcNowUs() - delivery.sourceTimeUs);
+        *pState = ToXInputState(delivery.state);
+        return true;
+    }
+
+    bool HasBufferedMouseInput()
+    {
+        return BaseHook::Data::bImGuiMouseButtonsFromDirectInput && !g_mouseEvents.IsEmpty();
+    }
+
+    InputQueueStats GetMouseQueueStats()
+    {
+        InputQueueStats stats;
+        stats.events = g_mouseEvents.GetPushedCount();
+        stats.coalesced = g_mouseMovesCoalesced.load(std::memory_order_relaxed);
+        stats.dropped = g_mouseEvents.GetDroppedCount();
+        return stats;
+    }
+
+    const BaseHook::LatencyHistogram& GetPadLatencyHistogram()
+    {
+        return g_padLatency;
+    }
+
+    void ResetPadLatencyHistogram()
+    {
+        g_padLatency.Reset();
+    }
+
+    bool StartInputRecording(const std::filesystem::path& path)
+    {
+        return g_inputRecording.Open(path);
+    }
+
+    void StopInputRecording()
+    {
+        g_inputRecording.Close();
+    }
+
+    bool IsInputRecordingActive()
+    {
+        return g_inputRecording.IsOpen();
+    }
+
+    uint64_t GetRecordedInputReads()
+    {
+        return g_inputRecording.GetRecordCount();
+    }
+
+    bool TryGetControllerMotion(ControllerMotionState* out)
+    {
+        if (!out)
+            return false;
+
+        std::lock_guard<std::mutex> lock(g_sonyMotionMutex);
+        if (!g_sonyMotionDevice || g_sonyMotion.sampleCount == 0)
+            return false;
+        *out = g_sonyMotion;
+        return true;
+    }
 }}
@@ -180,7 +180,10 @@ namespace BaseHook
             lParam = WindowedMode::ScaleMouseMessage(hWnd, uMsg, lParam);
 
             if (uMsg == WM_NCDESTROY)
+            {
                 RemovePropW(hWnd, L"oWndProc");
+                WindowedMode::ForgetWindow(hWnd);
+            }
 
             return CallWindowProcW(originalWndProc, hWnd, uMsg, wParam, lParam);
         }
@@ -364,6 +367,7 @@ namespace BaseHook
             HWND hWnd = oCreateWindowExA(dwExStyle, lpClassName, lpWindowName, dwStyle, X, Y, nWidth, nHeight, hWndParent, hMenu, hInstance, lpParam);
 
             if (hWnd && bIsImGui) {
+                WindowedMode::RegisterImGuiPlatformWindow(hWnd);
                 WNDPROC oPrec = (WNDPROC)SetWindowLongPtrW(hWnd, GWLP_WNDPROC, (LONG_PTR)ViewportWndProc);
                 SetPropW(hWnd, L"oWndProc", (HANDLE)oPrec);
             }
@@ -410,6 +414,7 @@ namespace BaseHook
             HWND hWnd = oCreateWindowExW(dwExStyle, lpClassName, lpWindowName, dwStyle, X, Y, nWidth, nHeight, hWndParent, hMenu, hInstance, lpParam);
 
             if (hWnd && bIsImGui) {
+                WindowedMode::RegisterImGuiPlatformWindow(hWnd);
                 WNDPROC oPrec = (WNDPROC)SetWindowLongPtrW(hWnd, GWLP_WNDPROC, (LONG_PTR)ViewportWndProc);
                 SetPropW(hWnd, L"oWndProc", (HANDLE)oPrec);
             }
@@ -691,12 +696,7 @@ namespace BaseHook
         {
             HWND hWnd = oGetForegroundWindow();
             if (Data::hWindow && WindowedMode::IsImGuiPlatformWindow(hWnd))
-            {
-                DWORD pid = 0;
-                GetWindowThreadProcessId(hWnd, &pid);
-                if (pid == GetCurrentProcessId())
-                    return Data::hWindow;
-            }
+                return Data::hWindow;
             return hWnd;
         }
 
@@ -704,12 +704,7 @@ namespace BaseHook
         {
             HWND hWnd = oGetActiveWindow();
             if (Data::hWindow && WindowedMode::IsImGuiPlatformWindow(hWnd))
-            {
-                DWORD pid = 0;
-                GetWindowThreadProcessId(hWnd, &pid);
-                if (pid == GetCurrentProcessId())
-                    return Data::hWindow;
-            }
+                return Data::hWindow;
             return hWnd;
         }
 
@@ -717,12 +712,7 @@ namespace BaseHook
         {
             HWND hWnd = oGetFocus();
             if (Data::hWindow && WindowedMode::IsImGuiPlatformWindow(hWnd))
-            {
-                DWORD pid = 0;
-                GetWindowThreadProcessId(hWnd, &pid);
-                if (pid == GetCurrentProcessId())
-                    return Data::hWindow;
-            }
+                return Data::hWindow;
             return hWnd;
         }
 
@@ -731,12 +721,9 @@ namespace BaseHook
             // If the game asks if it's minimized, lie and say no if an ImGui window is in front.
             if (hWnd == Data::hWindow || WindowedMode::IsImGuiPlatformWindow(hWnd)) {
                 HWND fg = oGetForegroundWindow();
-                if (fg && (fg == Data::hWindow || WindowedMode::IsImGuiPlatformWindow(fg))) {
-                    DWORD pid = 0;
-                    GetWindowThreadProcessId(fg, &pid);
-                    if (pid == GetCurrentProcessId())
-                        return FALSE;
-                }
+                // IsImGuiPlatformWindow only matches our own windows, and Data::hWindow is ours.
+                if (fg && (fg == Data::hWindow || WindowedMode::IsImGuiPlatformWindow(fg)))
+                    return FALSE;
             }
             return oIsIconic(hWnd);
         }
@@ -759,13 +746,10 @@ namespace BaseHook
                 {
                     // If game tries to unclip (lpRect=NULL), force clip to window.
                     if (!lpRect) {
-                        RECT clientRect;
-                        if (((GetClientRect_t)Data::oGetClientRect)(Data::hWindow, &clientRect)) {
-                            POINT ul = { clientRect.left, clientRect.top };
-                            POINT lr = { clientRect.right, clientRect.bottom };
-                            ((ClientToScreen_t)Data::oClientToScreen)(Data::hWindow, &ul);
-                            ((ClientToScreen_t)Data::oClientToScreen)(Data::hWindow, &lr);
-                            RECT finalRect = { ul.x, ul.y, lr.x, lr.y };
+                        WindowedMode::GeometrySnapshot geo;
+                        if (WindowedMode::GetGeometry(geo)) {
+                            RECT finalRect = { geo.transform.originX, geo.transform.originY,
+                                geo.transform.originX + geo.transform.clientW, geo.transform.originY + geo.transform.clientH };
                             return oClipCursor(&finalRect);
                         }
                     }
@@ -774,13 +758,10 @@ namespace BaseHook
                 if (!lpRect) return oClipCursor(NULL);
                 
                 // Game clips to Virtual Screen. We clip to Physical Client.
-                RECT clientRect;
-                if (((GetClientRect_t)Data::oGetClientRect)(Data::hWindow, &clientRect)) {
-                    POINT ul = { clientRect.left, clientRect.top };
-                    POINT lr = { clientRect.right, clientRect.bottom };
-                    ((ClientToScreen_t)Data::oClientToScreen)(Data::hWindow, &ul);
-                    ((ClientToScreen_t)Data::oClientToScreen)(Data::hWindow, &lr);
-                    RECT finalRect = { ul.x, ul.y, lr.x, lr.y };
+                WindowedMode::GeometrySnapshot geo;
+                if (WindowedMode::GetGeometry(geo)) {
+                    RECT finalRect = { geo.transform.originX, geo.transform.originY,
+                        geo.transform.originX + geo.transform.clientW, geo.transform.originY + geo.transform.clientH };
                     return oClipCursor(&finalRect);
                 }
             }
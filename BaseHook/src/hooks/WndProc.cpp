@@ -2,6 +2,10 @@
 #include "core/BaseHook.h"
 #include "core/WindowedMode.h"
 
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED 0x02E0
+#endif
+
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 namespace BaseHook
@@ -22,6 +26,13 @@ namespace BaseHook
             lParam = WindowedMode::ScaleMouseMessage(hWnd, uMsg, lParam);
 
             // Handle window resizing to update virtual monitor bounds logic
+            // Anything that can move/resize the client area or change the monitor layout
+            // invalidates the cached geometry used by the coordinate hooks.
+            if (hWnd == Data::hWindow && (uMsg == WM_SIZE || uMsg == WM_MOVE || uMsg == WM_WINDOWPOSCHANGED || uMsg == WM_DPICHANGED))
+                WindowedMode::InvalidateGeometry();
+            else if (uMsg == WM_DISPLAYCHANGE)
+                WindowedMode::InvalidateGeometry();
+
             if (uMsg == WM_SIZE && hWnd == Data::hWindow)
             {
                 int width = LOWORD(lParam);
@@ -1,7 +1,9 @@
 #include "pch.h"
 #include "core/BaseHook.h"
 #include "hooks/InputHooks.h"
+#include "util/PadPresence.h"
 #include <xinput.h>
+#include <atomic>
 
 typedef DWORD(WINAPI* XInputGetState_t)(DWORD, XINPUT_STATE*);
 
@@ -17,7 +19,7 @@ DWORD ProcessXInputInternal(DWORD dwUserIndex, XINPUT_STATE* pState, XInputGetSt
         return ERROR_BAD_ARGUMENTS;
 
     XINPUT_STATE virtualState{};
-    bool haveVirtual = BaseHook::Hooks::TryGetVirtualXInputState(dwUserIndex, &virtualState);
+    bool haveVirtual = BaseHook::Hooks::ConsumeVirtualXInputState(dwUserIndex, &virtualState);
 
     DWORD result = ERROR_DEVICE_NOT_CONNECTED;
     
@@ -66,7 +68,127 @@ DWORD WINAPI hkXInputGetState_9_1_0(DWORD dwUserIndex, XINPUT_STATE* pState) {
     return ProcessXInputInternal(dwUserIndex, pState, oXInputGetState_9_1_0);
 }
 
+// --- Controller presence monitor ---
+// XInputGetState on an empty slot can take milliseconds, so probing for hotplug from the game's pad
+// update stalls the frame. A background thread probes instead and publishes a snapshot: it sleeps
+// until a device change wakes it, probes in a short burst while the change settles, and otherwise
+// only re-checks on a slow timer (for anything WM_DEVICECHANGE doesn't report).
+namespace
+{
+    constexpr DWORD kPresenceDebounceMs = 250;
+    constexpr DWORD kPresenceBurstMs = 2000;    // Probe every debounce interval this long after a wake
+    constexpr DWORD kPresenceFallbackMs = 5000;
+
+    BaseHook::PadPresenceTracker g_presence(kPresenceDebounceMs);
+    HANDLE g_presenceThread = nullptr;     // Native handle: nothing to destroy if the game exits without Stop
+    std::atomic<bool> g_presenceRunning{ false };
+    HANDLE g_presenceWake = nullptr;
+
+    XInputGetState_t GetProbeFunction()
+    {
+        // The trampolines skip our own hook (virtual pad, input blocking).
+        if (oXInputGetState_1_3) return oXInputGetState_1_3;
+        if (oXInputGetState_1_4) return oXInputGetState_1_4;
+        return oXInputGetState_9_1_0;
+    }
+
+    uint8_t ProbeSlots()
+    {
+        uint8_t mask = 0;
+        if (XInputGetState_t probe = GetProbeFunction())
+        {
+            XINPUT_STATE state;
+            for (DWORD i = 0; i < XUSER_MAX_COUNT; ++i)
+            {
+                if (probe(i, &state) == ERROR_SUCCESS)
+                    mask |= static_cast<uint8_t>(1u << i);
+            }
+        }
+
+        // The virtual pad (Sony HID, DirectInput devices) answers for slot 0.
+        XINPUT_STATE state;
+        if (BaseHook::Hooks::TryGetVirtualXInputState(0, &state))
+            mask |= 1;
+        return mask;
+    }
+
+    DWORD WINAPI PresenceLoop(LPVOID)
+    {
+        ULONGLONG burstUntil = 0;
+        DWORD timeout = 0;  // Probe right away
+        while (g_presenceRunning.load(std::memory_order_acquire))
+        {
+            const DWORD wait = WaitForSingleObject(g_presenceWake, timeout);
+            if (!g_presenceRunning.load(std::memory_order_acquire))
+                break;
+
+            const ULONGLONG now = GetTickCount64();
+            if (wait == WAIT_OBJECT_0)
+                burstUntil = now + kPresenceBurstMs;
+
+            if (g_presence.Observe(ProbeSlots(), now))
+            {
+                const BaseHook::PadPresence presence = g_presence.Get();
+                LOG_INFO("XInput: Controllers connected 0x%X, using slot %d.",
+                         static_cast<unsigned>(presence.connectedMask), static_cast<int>(presence.preferredIndex));
+            }
+
+            timeout = (now < burstUntil || g_presence.HasPendingChange()) ? kPresenceDebounceMs : kPresenceFallbackMs;
+        }
+        return 0;
+    }
+}
+
 namespace BaseHook { namespace Hooks {
+
+    void StartPadPresenceMonitor()
+    {
+        if (g_presenceRunning.load()) return;
+
+        g_presenceWake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!g_presenceWake)
+        {
+            LOG_ERROR("XInput: Failed to create the presence monitor event (%lu).", GetLastError());
+            return;
+        }
+        g_presenceRunning = true;
+        g_presenceThread = CreateThread(nullptr, 0, PresenceLoop, nullptr, 0, nullptr);
+        if (!g_presenceThread)
+        {
+            LOG_ERROR("XInput: Failed to start the presence monitor (%lu).", GetLastError());
+            g_presenceRunning = false;
+            CloseHandle(g_presenceWake);
+            g_presenceWake = nullptr;
+        }
+    }
+
+    void StopPadPresenceMonitor()
+    {
+        if (!g_presenceRunning.exchange(false)) return;
+
+        SetEvent(g_presenceWake);
+        WaitForSingleObject(g_presenceThread, INFINITE);
+        CloseHandle(g_presenceThread);
+        g_presenceThread = nullptr;
+        CloseHandle(g_presenceWake);
+        g_presenceWake = nullptr;
+    }
+
+    void WakePadPresenceMonitor()
+    {
+        if (g_presenceRunning.load(std::memory_order_acquire) && g_presenceWake)
+            SetEvent(g_presenceWake);
+    }
+
+    bool GetPadPresence(PadPresence* out)
+    {
+        if (!out) return false;
+        const PadPresence presence = g_presence.Get();
+        if (presence.generation == 0)
+            return false;   // Not probed yet
+        *out = presence;
+        return true;
+    }
     
     void HookXInputModule(const char* moduleName, XInputGetState_t* pTrampoline, void* pDetour)
     {
@@ -103,5 +225,7 @@ namespace BaseHook { namespace Hooks {
         if (!oXInputGetState_1_3 && !oXInputGetState_1_4 && !oXInputGetState_9_1_0) {
              LOG_ERROR("XInput: No XInput modules were successfully hooked!");
         }
+
+        StartPadPresenceMonitor();
     }
 }}
\ No newline at end of file
@@ -27,6 +27,8 @@ namespace BaseHook
 
         void InstallEarlyHooks(HMODULE hModule)
         {
+            TRACE_SCOPE_CAT("InstallEarlyHooks", "basehook");
+
             // Initialize MinHook
             if (MH_Initialize() != MH_OK && MH_Initialize() != MH_ERROR_ALREADY_INITIALIZED)
             {
@@ -91,6 +93,8 @@ namespace BaseHook
 
         bool Init()
         {
+            TRACE_SCOPE_CAT("Hooks::Init", "basehook");
+
             // Double check MinHook init (in case EarlyHooks wasn't called or failed)
             if (MH_Initialize() != MH_OK && MH_Initialize() != MH_ERROR_ALREADY_INITIALIZED) {
                 LOG_ERROR("Failed to initialize MinHook.");
@@ -103,8 +107,11 @@ namespace BaseHook
             }
 
             // Hook Inputs
-            InitDirectInput();
-            InitXInput();
+            {
+                TRACE_SCOPE_CAT("InitInputHooks", "basehook");
+                InitDirectInput();
+                InitXInput();
+            }
 
             // Determine Effective Render Type
             // Centralized: WindowedMode::EarlyInit already resolved Auto (0) to a concrete version.
@@ -128,6 +135,7 @@ namespace BaseHook
             }
 
             // Late-install hooks
+            TRACE_SCOPE_CAT("InstallGraphicsHooksLate", "basehook");
             if (effectiveDX == 9) {
                 BaseHook::WindowedMode::InstallD3D9HooksLate();
             }
@@ -190,6 +198,7 @@ namespace BaseHook
                 auto type = kiero::getRenderType();
                 if (type == kiero::RenderType::D3D9) {
                     ImGui_ImplDX9_Shutdown();
+                    ReleaseCachedBackBuffer();
                 }
                 else if (type == kiero::RenderType::D3D11) {
                     ImGui_ImplDX11_Shutdown();
@@ -206,6 +215,7 @@ namespace BaseHook
                 ImGui::DestroyContext();
             }
 
+            StopPadPresenceMonitor();
             CleanupDirectInput();
             
             // Disable all hooks (since we bypassed kiero::shutdown logic)
@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "util/AllocationCounter.h"
+
+namespace {
+
+    using malloc_t = void* (__cdecl*)(size_t);
+    using calloc_t = void* (__cdecl*)(size_t, size_t);
+    using realloc_t = void* (__cdecl*)(void*, size_t);
+
+    malloc_t oMalloc = nullptr;
+    calloc_t oCalloc = nullptr;
+    realloc_t oRealloc = nullptr;
+
+    // Fed by every allocating thread while the hooks are enabled.
+    BaseHook::AllocationTally g_Tally;
+
+    void* __cdecl hkMalloc(size_t size)
+    {
+        g_Tally.Add(size);
+        return oMalloc(size);
+    }
+
+    void* __cdecl hkCalloc(size_t count, size_t size)
+    {
+        g_Tally.Add(count * size);
+        return oCalloc(count, size);
+    }
+
+    void* __cdecl hkRealloc(void* block, size_t size)
+    {
+        g_Tally.Add(size);
+        return oRealloc(block, size);
+    }
+
+    struct HeapHook {
+        const char* name;
+        void* detour;
+        void** original;
+        void* target;
+    };
+
+    HeapHook g_HeapHooks[] = {
+        { "malloc",  (void*)&hkMalloc,  (void**)&oMalloc,  nullptr },
+        { "calloc",  (void*)&hkCalloc,  (void**)&oCalloc,  nullptr },
+        { "realloc", (void*)&hkRealloc, (void**)&oRealloc, nullptr },
+    };
+}
+
+namespace BaseHook {
+
+    AllocationCounter g_AllocationCounter;
+
+    bool AllocationCounter::InstallHooks()
+    {
+        HMODULE hCrt = GetModuleHandleA("ucrtbase.dll");
+        if (!hCrt) hCrt = GetModuleHandleA("ucrtbased.dll");
+        if (!hCrt)
+        {
+            LOG_ERROR("AllocationCounter: ucrtbase.dll is not loaded.");
+            return false;
+        }
+
+        if (MH_Initialize() != MH_OK && MH_Initialize() != MH_ERROR_ALREADY_INITIALIZED)
+        {
+            LOG_ERROR("AllocationCounter: MinHook initialization failed.");
+            return false;
+        }
+
+        for (HeapHook& hook : g_HeapHooks)
+        {
+            void* target = (void*)GetProcAddress(hCrt, hook.name);
+            if (!target || MH_CreateHook(target, hook.detour, hook.original) != MH_OK)
+            {
+                LOG_ERROR("AllocationCounter: Failed to hook %s.", hook.name);
+                for (HeapHook& created : g_HeapHooks)
+                {
+                    if (created.target)
+                        MH_RemoveHook(created.target);
+                    created.target = nullptr;
+                }
+                return false;
+            }
+            hook.target = target;
+        }
+
+        LOG_INFO("AllocationCounter: Hooked CRT heap functions.");
+        return true;
+    }
+
+    bool AllocationCounter::SetEnabled(bool enabled)
+    {
+        if (enabled == m_enabled)
+            return true;
+
+        if (enabled && !m_hooksInstalled)
+        {
+            if (!InstallHooks())
+                return false;
+            m_hooksInstalled = true;
+        }
+
+        // Hooks stay created but are only active while counting, so the disabled cost is zero.
+        for (HeapHook& hook : g_HeapHooks)
+        {
+            if (enabled)
+                MH_EnableHook(hook.target);
+            else
+                MH_DisableHook(hook.target);
+        }
+
+        g_Tally.Reset();
+        m_enabled = enabled;
+        return true;
+    }
+
+    void AllocationCounter::OnFrame()
+    {
+        if (!m_enabled)
+            return;
+
+        g_Tally.CloseFrame();
+    }
+
+    AllocationCounter::FrameStats AllocationCounter::GetLastFrame() const
+    {
+        return g_Tally.GetLastFrame();
+    }
+
+    uint32_t AllocationCounter::GetPeakAllocations() const
+    {
+        return g_Tally.GetPeakAllocations();
+    }
+}
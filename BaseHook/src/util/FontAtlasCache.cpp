@@ -0,0 +1,594 @@
+#include "pch.h"
+#include "util/FontAtlasCache.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace BaseHook {
+
+namespace {
+
+    constexpr uint32_t kMagic = 0x43464749;     // "IGFC"
+    constexpr uint32_t kFormatVersion = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t formatVersion;
+        uint32_t imguiVersion;
+        uint32_t reserved;
+        uint64_t fontHash;
+        uint64_t payloadSize;
+        uint64_t payloadHash;
+    };
+
+    struct BakeRecord {
+        float size, density, offsetX, offsetY;
+        uint8_t oversampleH, oversampleV;
+        uint16_t reserved;
+        uint32_t glyphCount;
+    };
+
+    struct GlyphRecord {
+        uint32_t codepoint;
+        uint32_t visible;
+        float advanceX, x0, y0, x1, y1;
+        uint16_t width, height;
+    };
+
+    template <typename T>
+    void Append(std::vector<uint8_t>& out, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        template <typename T>
+        bool Read(T& out)
+        {
+            if (m_size - m_offset < sizeof(T))
+                return false;
+            memcpy(&out, m_data + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return true;
+        }
+
+        bool ReadBytes(std::vector<uint8_t>& out, size_t count)
+        {
+            if (m_size - m_offset < count)
+                return false;
+            out.assign(m_data + m_offset, m_data + m_offset + count);
+            m_offset += count;
+            return true;
+        }
+
+        bool AtEnd() const { return m_offset == m_size; }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+    };
+
+} // namespace
+
+bool GlyphCache::BakeKey::operator==(const BakeKey& other) const
+{
+    return size == other.size && density == other.density && offsetX == other.offsetX && offsetY == other.offsetY &&
+           oversampleH == other.oversampleH && oversampleV == other.oversampleV;
+}
+
+uint64_t GlyphCache::Hash(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+const GlyphCache::Glyph* GlyphCache::Find(const BakeKey& key, uint32_t codepoint) const
+{
+    for (const Bake& bake : m_bakes)
+    {
+        if (!(bake.key == key))
+            continue;
+        auto it = bake.glyphs.find(codepoint);
+        return it != bake.glyphs.end() ? &it->second : nullptr;
+    }
+    return nullptr;
+}
+
+void GlyphCache::Add(const BakeKey& key, uint32_t codepoint, Glyph glyph)
+{
+    for (Bake& bake : m_bakes)
+    {
+        if (bake.key == key)
+        {
+            bake.glyphs[codepoint] = std::move(glyph);
+            return;
+        }
+    }
+    m_bakes.push_back(Bake{ key, {} });
+    m_bakes.back().glyphs.emplace(codepoint, std::move(glyph));
+}
+
+size_t GlyphCache::GetGlyphCount() const
+{
+    size_t count = 0;
+    for (const Bake& bake : m_bakes)
+        count += bake.glyphs.size();
+    return count;
+}
+
+std::vector<uint8_t> GlyphCache::Serialize(uint32_t imguiVersion) const
+{
+    std::vector<uint8_t> payload;
+    Append(payload, static_cast<uint32_t>(m_bakes.size()));
+    for (const Bake& bake : m_bakes)
+    {
+        BakeRecord record{};
+        record.size = bake.key.size;
+        record.density = bake.key.density;
+        record.offsetX = bake.key.offsetX;
+        record.offsetY = bake.key.offsetY;
+        record.oversampleH = bake.key.oversampleH;
+        record.oversampleV = bake.key.oversampleV;
+        record.glyphCount = static_cast<uint32_t>(bake.glyphs.size());
+        Append(payload, record);
+
+        for (const auto& [codepoint, glyph] : bake.glyphs)
+        {
+            GlyphRecord g{};
+            g.codepoint = codepoint;
+            g.visible = glyph.visible ? 1 : 0;
+            g.advanceX = glyph.advanceX;
+            g.x0 = glyph.x0; g.y0 = glyph.y0; g.x1 = glyph.x1; g.y1 = glyph.y1;
+            g.width = glyph.width;
+            g.height = glyph.height;
+            Append(payload, g);
+            payload.insert(payload.end(), glyph.pixels.begin(), glyph.pixels.end());
+        }
+    }
+
+    FileHeader header{};
+    header.magic = kMagic;
+    header.formatVersion = kFormatVersion;
+    header.imguiVersion = imguiVersion;
+    header.fontHash = m_fontHash;
+    header.payloadSize = payload.size();
+    header.payloadHash = Hash(payload.data(), payload.size());
+
+    std::vector<uint8_t> out;
+    out.reserve(sizeof(header) + payload.size());
+    Append(out, header);
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+bool GlyphCache::Deserialize(const uint8_t* data, size_t size, uint32_t imguiVersion)
+{
+    if (!data || size < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kMagic || header.formatVersion != kFormatVersion || header.imguiVersion != imguiVersion ||
+        header.reserved != 0 || header.fontHash != m_fontHash || header.payloadSize != size - sizeof(header))
+        return false;
+
+    const uint8_t* payload = data + sizeof(header);
+    if (Hash(payload, static_cast<size_t>(header.payloadSize)) != header.payloadHash)
+        return false;
+
+    Reader reader(payload, static_cast<size_t>(header.payloadSize));
+    uint32_t bakeCount = 0;
+    if (!reader.Read(bakeCount))
+        return false;
+
+    std::vector<Bake> bakes;
+    for (uint32_t b = 0; b < bakeCount; ++b)
+    {
+        BakeRecord record;
+        if (!reader.Read(record))
+            return false;
+
+        Bake bake;
+        bake.key.size = record.size;
+        bake.key.density = record.density;
+        bake.key.offsetX = record.offsetX;
+        bake.key.offsetY = record.offsetY;
+        bake.key.oversampleH = record.oversampleH;
+        bake.key.oversampleV = record.oversampleV;
+
+        for (uint32_t i = 0; i < record.glyphCount; ++i)
+        {
+            GlyphRecord g;
+            if (!reader.Read(g))
+                return false;
+
+            Glyph glyph;
+            glyph.visible = g.visible != 0;
+            glyph.advanceX = g.advanceX;
+            glyph.x0 = g.x0; glyph.y0 = g.y0; glyph.x1 = g.x1; glyph.y1 = g.y1;
+            glyph.width = g.width;
+            glyph.height = g.height;
+            if (glyph.visible && (glyph.width == 0 || glyph.height == 0))
+                return false;
+            if (!reader.ReadBytes(glyph.pixels, static_cast<size_t>(g.width) * g.height))
+                return false;
+            bake.glyphs[g.codepoint] = std::move(glyph);
+        }
+        bakes.push_back(std::move(bake));
+    }
+    if (!reader.AtEnd())
+        return false;
+
+    m_bakes = std::move(bakes);
+    return true;
+}
+
+namespace FontAtlasCache {
+
+namespace {
+
+    // Replaces ImFontConfig::FontLoaderData while our loader owns the source; the wrapped loader's
+    // own data is swapped back in around every call into it. (Sources live in an ImVector, so the
+    // ImFontConfig pointers themselves can't be used as keys.)
+    struct SourceData {
+        void* baseData = nullptr;
+        GlyphCache cache;
+        std::filesystem::path file;
+        bool dirty = false;
+    };
+
+    const ImFontLoader* g_base = nullptr;
+    ImFontLoader g_loader;
+    std::filesystem::path g_directory;
+
+    std::mutex g_mutex;                     // Guards the caches and g_sources
+    std::vector<SourceData*> g_sources;
+
+    std::atomic<uint32_t> g_hits{ 0 };
+    std::atomic<uint32_t> g_misses{ 0 };
+    std::atomic<int64_t> g_loadUs{ 0 };
+
+    struct ScopedBaseData {
+        ImFontConfig* src;
+        SourceData* data;
+        ScopedBaseData(ImFontConfig* s) : src(s), data(static_cast<SourceData*>(s->FontLoaderData)) { src->FontLoaderData = data->baseData; }
+        ~ScopedBaseData() { data->baseData = src->FontLoaderData; src->FontLoaderData = data; }
+    };
+
+    bool WriteCacheFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+            out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!out)
+                return false;
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    bool ReadCacheFile(const std::filesystem::path& path, std::vector<uint8_t>& bytes)
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+            return false;
+        const std::streamsize size = in.tellg();
+        if (size <= 0)
+            return false;
+        bytes.resize(static_cast<size_t>(size));
+        in.seekg(0);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(bytes.data()), size));
+    }
+
+    void SaveLocked(SourceData& data)
+    {
+        if (!data.dirty || data.file.empty())
+            return;
+        data.dirty = false;
+        if (!WriteCacheFile(data.file, data.cache.Serialize(IMGUI_VERSION_NUM)))
+            LOG_WARN("FontAtlasCache: Failed to write %s", data.file.string().c_str());
+    }
+
+    GlyphCache::BakeKey MakeKey(ImFontConfig* src, ImFontBaked* baked)
+    {
+        int oversampleH = 1, oversampleV = 1;
+        ImFontAtlasBuildGetOversampleFactors(src, baked, &oversampleH, &oversampleV);
+
+        // Same placement terms as the stb_truetype loader; merged fonts scale offsets by the first source.
+        const float refSize = baked->OwnerFont->Sources[0]->SizePixels;
+        const float offsetScale = refSize != 0.0f ? baked->Size / refSize : 1.0f;
+
+        GlyphCache::BakeKey key;
+        key.size = baked->Size;
+        key.density = src->RasterizerDensity * baked->RasterizerDensity;
+        key.offsetX = ImFloor(src->GlyphOffset.x * offsetScale + 0.5f);
+        key.offsetY = ImFloor(src->GlyphOffset.y * offsetScale + 0.5f) + IM_ROUND(baked->Ascent);
+        key.oversampleH = static_cast<uint8_t>(oversampleH);
+        key.oversampleV = static_cast<uint8_t>(oversampleV);
+        return key;
+    }
+
+    // Copies a glyph the base loader just rendered back out of the atlas texture.
+    bool ReadBackGlyph(ImFontAtlas* atlas, const ImFontGlyph& glyph, GlyphCache::Glyph& out)
+    {
+        ImTextureData* tex = atlas->TexData;
+        ImTextureRect* r = ImFontAtlasPackGetRectSafe(atlas, glyph.PackId);
+        if (!tex || !tex->Pixels || !r)
+            return false;
+
+        out.width = r->w;
+        out.height = r->h;
+        out.pixels.resize(static_cast<size_t>(r->w) * r->h);
+        for (int y = 0; y < r->h; ++y)
+        {
+            const unsigned char* row = static_cast<const unsigned char*>(tex->GetPixelsAt(r->x, r->y + y));
+            uint8_t* dst = out.pixels.data() + static_cast<size_t>(y) * r->w;
+            if (tex->Format == ImTextureFormat_Alpha8)
+            {
+                memcpy(dst, row, r->w);
+            }
+            else
+            {
+                const ImU32* pixels = reinterpret_cast<const ImU32*>(row);
+                for (int x = 0; x < r->w; ++x)
+                    dst[x] = static_cast<uint8_t>((pixels[x] >> IM_COL32_A_SHIFT) & 0xFF);
+            }
+        }
+        return true;
+    }
+
+    bool LoaderInit(ImFontAtlas* atlas)
+    {
+        return g_base->LoaderInit ? g_base->LoaderInit(atlas) : true;
+    }
+
+    void LoaderShutdown(ImFontAtlas* atlas)
+    {
+        if (g_base->LoaderShutdown)
+            g_base->LoaderShutdown(atlas);
+    }
+
+    bool FontSrcInit(ImFontAtlas* atlas, ImFontConfig* src)
+    {
+        if (g_base->FontSrcInit && !g_base->FontSrcInit(atlas, src))
+            return false;
+
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t fontHash = GlyphCache::Hash(g_base->Name, strlen(g_base->Name));
+        fontHash = GlyphCache::Hash(src->FontData, static_cast<size_t>(src->FontDataSize), fontHash);
+
+        auto* data = new SourceData{ src->FontLoaderData, GlyphCache(fontHash), {}, false };
+        if (!g_directory.empty())
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "font-%016llx.cache", static_cast<unsigned long long>(fontHash));
+            data->file = g_directory / name;
+
+            std::vector<uint8_t> bytes;
+            if (ReadCacheFile(data->file, bytes) && !data->cache.Deserialize(bytes.data(), bytes.size(), IMGUI_VERSION_NUM))
+                LOG_WARN("FontAtlasCache: Ignoring stale or damaged %s", data->file.string().c_str());
+        }
+        g_loadUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        src->FontLoaderData = data;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_sources.push_back(data);
+        return true;
+    }
+
+    void FontSrcDestroy(ImFontAtlas* atlas, ImFontConfig* src)
+    {
+        auto* data = static_cast<SourceData*>(src->FontLoaderData);
+        if (!data)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            SaveLocked(*data);
+            g_sources.erase(std::remove(g_sources.begin(), g_sources.end(), data), g_sources.end());
+        }
+
+        src->FontLoaderData = data->baseData;
+        if (g_base->FontSrcDestroy)
+            g_base->FontSrcDestroy(atlas, src);
+        delete data;
+    }
+
+    bool FontSrcContainsGlyph(ImFontAtlas* atlas, ImFontConfig* src, ImWchar codepoint)
+    {
+        if (!g_base->FontSrcContainsGlyph)
+            return true;
+        ScopedBaseData scope(src);
+        return g_base->FontSrcContainsGlyph(atlas, src, codepoint);
+    }
+
+    bool FontBakedInit(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loaderData)
+    {
+        if (!g_base->FontBakedInit)
+            return true;
+        ScopedBaseData scope(src);
+        return g_base->FontBakedInit(atlas, src, baked, loaderData);
+    }
+
+    void FontBakedDestroy(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loaderData)
+    {
+        if (!g_base->FontBakedDestroy)
+            return;
+        ScopedBaseData scope(src);
+        g_base->FontBakedDestroy(atlas, src, baked, loaderData);
+    }
+
+    bool FontBakedLoadGlyph(ImFontAtlas* atlas, ImFontConfig* src, ImFontBaked* baked, void* loaderData,
+                            ImWchar codepoint, ImFontGlyph* outGlyph, float* outAdvanceX)
+    {
+        auto* data = static_cast<SourceData*>(src->FontLoaderData);
+
+        // Metrics-only requests (very large sizes) don't rasterize anything
+        if (outAdvanceX != nullptr)
+        {
+            ScopedBaseData scope(src);
+            return g_base->FontBakedLoadGlyph(atlas, src, baked, loaderData, codepoint, outGlyph, outAdvanceX);
+        }
+
+        const GlyphCache::BakeKey key = MakeKey(src, baked);
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (const GlyphCache::Glyph* cached = data->cache.Find(key, codepoint))
+            {
+                outGlyph->Codepoint = codepoint;
+                outGlyph->AdvanceX = cached->advanceX;
+                if (cached->visible)
+                {
+                    ImFontAtlasRectId packId = ImFontAtlasPackAddRect(atlas, cached->width, cached->height);
+                    if (packId == ImFontAtlasRectId_Invalid)
+                        return false;
+                    ImTextureRect* r = ImFontAtlasPackGetRect(atlas, packId);
+                    outGlyph->X0 = cached->x0;
+                    outGlyph->Y0 = cached->y0;
+                    outGlyph->X1 = cached->x1;
+                    outGlyph->Y1 = cached->y1;
+                    outGlyph->Visible = true;
+                    outGlyph->PackId = packId;
+                    ImFontAtlasBakedSetFontGlyphBitmap(atlas, baked, src, outGlyph, r, cached->pixels.data(), ImTextureFormat_Alpha8, cached->width);
+                }
+                ++g_hits;
+                return true;
+            }
+        }
+
+        bool loaded;
+        {
+            ScopedBaseData scope(src);
+            loaded = g_base->FontBakedLoadGlyph(atlas, src, baked, loaderData, codepoint, outGlyph, nullptr);
+        }
+        if (!loaded)
+            return false;
+
+        GlyphCache::Glyph glyph;
+        glyph.visible = outGlyph->Visible;
+        glyph.advanceX = outGlyph->AdvanceX;
+        if (glyph.visible)
+        {
+            glyph.x0 = outGlyph->X0;
+            glyph.y0 = outGlyph->Y0;
+            glyph.x1 = outGlyph->X1;
+            glyph.y1 = outGlyph->Y1;
+            if (!ReadBackGlyph(atlas, *outGlyph, glyph))
+                return true;
+        }
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        data->cache.Add(key, codepoint, std::move(glyph));
+        data->dirty = true;
+        ++g_misses;
+        return true;
+    }
+
+} // namespace
+
+void Install(ImFontAtlas* atlas, const std::filesystem::path& directory)
+{
+    if (!atlas || atlas->FontLoader == &g_loader)
+        return;
+
+    g_directory = directory;
+    if (!g_base)
+    {
+        g_base = atlas->FontLoader ? atlas->FontLoader : ImFontAtlasGetFontLoaderForStbTruetype();
+
+        static std::string name = std::string(g_base->Name) + " (cached)";
+        g_loader.Name = name.c_str();
+        g_loader.LoaderInit = LoaderInit;
+        g_loader.LoaderShutdown = LoaderShutdown;
+        g_loader.FontSrcInit = FontSrcInit;
+        g_loader.FontSrcDestroy = FontSrcDestroy;
+        g_loader.FontSrcContainsGlyph = FontSrcContainsGlyph;
+        g_loader.FontBakedInit = FontBakedInit;
+        g_loader.FontBakedDestroy = FontBakedDestroy;
+        g_loader.FontBakedLoadGlyph = FontBakedLoadGlyph;
+        g_loader.FontBakedSrcLoaderDataSize = g_base->FontBakedSrcLoaderDataSize;
+    }
+    atlas->SetFontLoader(&g_loader);
+}
+
+void Preload(ImFontAtlas* atlas, const std::vector<float>& scales)
+{
+    if (!atlas)
+        return;
+
+    for (ImFont* font : atlas->Fonts)
+    {
+        for (float scale : scales)
+        {
+            if (scale <= 0.0f)
+                continue;
+            ImFontBaked* baked = font->GetFontBaked(font->LegacySize * scale);
+            for (ImWchar c = 0x20; c < 0x7F; ++c)
+                baked->FindGlyph(c);
+        }
+    }
+}
+
+void Flush()
+{
+    // Serialize under the lock, write outside it so the render thread never waits on the disk
+    std::vector<std::pair<std::filesystem::path, std::vector<uint8_t>>> pending;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (SourceData* data : g_sources)
+        {
+            if (!data->dirty || data->file.empty())
+                continue;
+            data->dirty = false;
+            pending.emplace_back(data->file, data->cache.Serialize(IMGUI_VERSION_NUM));
+        }
+    }
+    for (const auto& [file, bytes] : pending)
+    {
+        if (!WriteCacheFile(file, bytes))
+            LOG_WARN("FontAtlasCache: Failed to write %s", file.string().c_str());
+    }
+}
+
+Stats GetStats()
+{
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        stats.fonts = static_cast<uint32_t>(g_sources.size());
+        for (const SourceData* data : g_sources)
+            stats.cachedGlyphs += static_cast<uint32_t>(data->cache.GetGlyphCount());
+    }
+    stats.hits = g_hits.load();
+    stats.misses = g_misses.load();
+    stats.loadMs = static_cast<double>(g_loadUs.load()) / 1000.0;
+    return stats;
+}
+
+} // namespace FontAtlasCache
+
+} // namespace BaseHook
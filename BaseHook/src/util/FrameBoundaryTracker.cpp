@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "util/FrameBoundaryTracker.h"
+
+namespace BaseHook {
+
+    FrameBoundaryTracker g_FrameBoundary;
+
+    bool FrameBoundaryTracker::IsDrawCandidate()
+    {
+        ++m_current.endScenes;
+        if (m_current.drawPoint != OverlayDrawPoint::None || !IsAnchoredToEndScene())
+            return false;
+        return m_current.endScenes == m_expectedScenes;
+    }
+
+    bool FrameBoundaryTracker::ShouldDrawBeforePresent()
+    {
+        if (m_current.drawPoint != OverlayDrawPoint::None)
+            return false;
+        m_current.drawPoint = OverlayDrawPoint::Present;
+        return true;
+    }
+
+    void FrameBoundaryTracker::OnPresent()
+    {
+        // Any change in the scene count (including more scenes after the one we drew in, which
+        // may have covered the overlay) starts the learning over.
+        const uint32_t scenes = m_current.endScenes;
+        if (scenes != 0 && scenes == m_expectedScenes)
+        {
+            if (m_stableFrames < kStableFrames)
+                ++m_stableFrames;
+        }
+        else
+        {
+            m_stableFrames = 0;
+        }
+        m_expectedScenes = scenes;
+
+        m_last = m_current;
+        m_current = FrameStats{};
+    }
+
+    void FrameBoundaryTracker::Invalidate()
+    {
+        m_expectedScenes = 0;
+        m_stableFrames = 0;
+        m_current = FrameStats{};
+    }
+}
@@ -0,0 +1,49 @@
+#include "pch.h"
+#include "util/FrameDecimator.h"
+
+namespace BaseHook {
+
+    bool FrameDecimator::ShouldRebuild(int64_t nowUs, bool inputPending)
+    {
+        const int rateHz = m_rateHz.load(std::memory_order_relaxed);
+        const int64_t intervalUs = rateHz > 0 ? 1000000 / rateHz : 0;
+        // Frame pacing jitters by a fraction of a millisecond; don't push a rebuild a whole game frame
+        // out because it came in just short of the grid.
+        const int64_t slackUs = intervalUs / 8;
+
+        bool rebuild = true;
+        if (intervalUs == 0 || !m_valid)
+        {
+            m_settleFrames = 0;
+            m_nextRebuildUs = nowUs + intervalUs;
+        }
+        else if (inputPending)
+        {
+            m_settleFrames = kSettleFrames;
+            m_nextRebuildUs = nowUs + intervalUs;
+        }
+        else if (m_settleFrames > 0)
+        {
+            --m_settleFrames;
+        }
+        else if (nowUs + slackUs >= m_nextRebuildUs)
+        {
+            m_nextRebuildUs += intervalUs;
+            // Fell behind by more than a period (a hitch, or the overlay was paused): restart the grid.
+            if (m_nextRebuildUs <= nowUs)
+                m_nextRebuildUs = nowUs + intervalUs;
+        }
+        else
+        {
+            rebuild = false;
+        }
+
+        m_valid = true;
+        if (rebuild)
+            m_rebuiltFrames++;
+        else
+            m_reusedFrames++;
+        return rebuild;
+    }
+
+} // namespace BaseHook
@@ -86,6 +86,17 @@ namespace BaseHook {
 
     void FramerateLimiter::UpdateStats(LONGLONG nowQPC)
     {
+        if (m_clockStartQPC == 0)
+            m_clockStartQPC = nowQPC;
+        const int64_t clockUs = (nowQPC - m_clockStartQPC) * 1000000 / m_qpcFreq.QuadPart;
+        if (m_deltaSmoother.Tick(clockUs)) {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_timing.frameIndex++;
+            m_timing.time = static_cast<double>(clockUs) / 1000000.0;
+            m_timing.delta = m_deltaSmoother.GetDelta();
+            m_timing.smoothedDelta = m_deltaSmoother.GetSmoothedDelta();
+        }
+
         if (m_lastPresentTime == 0) {
             m_lastPresentTime = nowQPC;
             return;
@@ -99,14 +110,24 @@ namespace BaseHook {
         m_historyIdx = (m_historyIdx + 1) % m_history.size();
     }
 
-    void FramerateLimiter::Wait()
+    void FramerateLimiter::Wait(FrameWaitSite site)
     {
         if (m_qpcFreq.QuadPart == 0) Init();
 
         LARGE_INTEGER now;
         QueryPerformanceCounter(&now);
 
-        UpdateStats(now.QuadPart);
+        if (site == FrameWaitSite::Present) {
+            // Present is the frame boundary for the stats, whichever site waits
+            UpdateStats(now.QuadPart);
+
+            // The game loop already waited for this frame
+            if (m_gameLoopWaited.exchange(false, std::memory_order_acq_rel))
+                return;
+        }
+        else {
+            m_gameLoopWaited.store(true, std::memory_order_release);
+        }
 
         LONGLONG targetQPC = 0;
         LONGLONG ticksPerFrame = 0;
@@ -129,6 +150,7 @@ namespace BaseHook {
 
             m_frameCount++;
             ticksPerFrame = m_ticksPerFrame;
+            m_controllingSite.store(static_cast<uint8_t>(site), std::memory_order_relaxed);
 
             // Calculate absolute target time for this frame
             // Target = Start + (Frames * Ticks) + (Frames * Accum)
@@ -186,9 +208,26 @@ namespace BaseHook {
             }
 
             SetThreadPriority(GetCurrentThread(), oldPriority);
+
+            m_oversleep[static_cast<size_t>(site)].Record((now.QuadPart - targetQPC) * 1000000 / m_qpcFreq.QuadPart);
         }
     }
 
+    bool FramerateLimiter::GetFrameTiming(FrameTiming& out) const
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        if (m_timing.frameIndex == 0)
+            return false;
+        out = m_timing;
+        return true;
+    }
+
+    void FramerateLimiter::ResetOversleep()
+    {
+        for (LatencyHistogram& histogram : m_oversleep)
+            histogram.Reset();
+    }
+
     void FramerateLimiter::RecalculateStats() const
     {
         // Copy history in chronological order (Oldest -> Newest)
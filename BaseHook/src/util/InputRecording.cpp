@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "util/InputRecording.h"
+#include <cstring>
+
+namespace BaseHook::InputRecording {
+
+    namespace {
+        constexpr char kMagic[4] = { 'A', 'C', 'I', 'N' };
+        constexpr size_t kRecordHeaderSize = 16;
+        // Far above any HID report batch; guards against reading garbage as a length.
+        constexpr uint32_t kMaxRecordBytes = 1u << 20;
+
+        void PutLE(uint8_t* out, uint64_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+                out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        uint64_t GetLE(const uint8_t* in, int bytes)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i)
+                value |= static_cast<uint64_t>(in[i]) << (8 * i);
+            return value;
+        }
+    }
+
+    bool Writer::Open(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_file.is_open())
+            m_file.close();
+
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+            return false;
+
+        uint8_t header[8];
+        std::memcpy(header, kMagic, 4);
+        PutLE(header + 4, kVersion, 4);
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        m_startUs = -1;
+        m_records.store(0, std::memory_order_relaxed);
+        m_open.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    void Writer::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open.store(false, std::memory_order_relaxed);
+        if (m_file.is_open())
+            m_file.close();
+    }
+
+    void Writer::Append(int64_t timeUs, uint8_t controllerType, uint16_t reportSize, const uint8_t* data, uint32_t byteCount)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_file.is_open())
+            return;
+
+        if (m_startUs < 0)
+            m_startUs = timeUs;
+
+        uint8_t header[kRecordHeaderSize];
+        PutLE(header, static_cast<uint64_t>(timeUs - m_startUs), 8);
+        header[8] = controllerType;
+        header[9] = 0;
+        PutLE(header + 10, reportSize, 2);
+        PutLE(header + 12, byteCount, 4);
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_file.write(reinterpret_cast<const char*>(data), byteCount);
+        m_records.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool Reader::Open(const std::filesystem::path& path)
+    {
+        m_file.open(path, std::ios::binary);
+        if (!m_file)
+            return false;
+
+        uint8_t header[8];
+        if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            return false;
+        return std::memcmp(header, kMagic, 4) == 0 && GetLE(header + 4, 4) == kVersion;
+    }
+
+    bool Reader::Next(Record& out)
+    {
+        uint8_t header[kRecordHeaderSize];
+        if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            return false;
+
+        const uint32_t byteCount = static_cast<uint32_t>(GetLE(header + 12, 4));
+        if (byteCount > kMaxRecordBytes)
+            return false;
+
+        out.timeUs = static_cast<int64_t>(GetLE(header, 8));
+        out.controllerType = header[8];
+        out.reportSize = static_cast<uint16_t>(GetLE(header + 10, 2));
+        out.data.resize(byteCount);
+        return byteCount == 0 || static_cast<bool>(m_file.read(reinterpret_cast<char*>(out.data.data()), byteCount));
+    }
+}
@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "util/LatencyHistogram.h"
+
+namespace BaseHook {
+
+    namespace {
+        // Value below which `fraction` of the samples fall, interpolated inside the bucket.
+        double Percentile(const LatencyHistogram::Summary& summary, double fraction)
+        {
+            const double target = fraction * static_cast<double>(summary.count);
+            double seen = 0.0;
+            for (int i = 0; i < LatencyHistogram::kBucketCount; ++i)
+            {
+                const double inBucket = static_cast<double>(summary.buckets[i]);
+                if (inBucket > 0.0 && seen + inBucket >= target)
+                {
+                    const double within = (target - seen) / inBucket;
+                    return (i + within) * LatencyHistogram::kBucketWidthUs;
+                }
+                seen += inBucket;
+            }
+            return static_cast<double>(summary.maxUs);
+        }
+    }
+
+    void LatencyHistogram::Record(int64_t us)
+    {
+        if (us < 0)
+            us = 0;
+
+        const int64_t bucket = us / kBucketWidthUs;
+        m_buckets[bucket < kBucketCount ? bucket : kBucketCount].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumUs.fetch_add(us, std::memory_order_relaxed);
+
+        int64_t max = m_maxUs.load(std::memory_order_relaxed);
+        while (us > max && !m_maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumUs.store(0, std::memory_order_relaxed);
+        m_maxUs.store(0, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::Summarize() const
+    {
+        Summary summary;
+        for (int i = 0; i <= kBucketCount; ++i)
+        {
+            summary.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+            summary.count += summary.buckets[i];
+        }
+        summary.maxUs = m_maxUs.load(std::memory_order_relaxed);
+        if (summary.count == 0)
+            return summary;
+
+        summary.meanUs = static_cast<double>(m_sumUs.load(std::memory_order_relaxed)) / static_cast<double>(summary.count);
+        summary.p50Us = Percentile(summary, 0.50);
+        summary.p95Us = Percentile(summary, 0.95);
+        summary.p99Us = Percentile(summary, 0.99);
+        return summary;
+    }
+}
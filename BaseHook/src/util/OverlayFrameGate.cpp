@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "util/OverlayFrameGate.h"
+#include "core/BaseHook.h"
+#include "hooks/InputHooks.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+
+namespace BaseHook {
+
+    OverlayFrameGate g_OverlayFrameGate;
+
+    namespace {
+        // Anything the next ImGui frame would react to: Win32 messages already queued by the backend,
+        // or DirectInput clicks/wheel not applied yet.
+        bool HasPendingInput()
+        {
+            ImGuiContext* ctx = ImGui::GetCurrentContext();
+            return (ctx && !ctx->InputEventsQueue.empty()) || Hooks::HasBufferedMouseInput();
+        }
+    }
+
+    OverlayFrameMode OverlayFrameGate::Begin(Settings* settings)
+    {
+        const OverlayActivity activity = (settings && m_enabled) ? settings->GetOverlayActivity() : OverlayActivity::Active;
+        const ULONGLONG now = GetTickCount64();
+
+        if (activity == OverlayActivity::Active)
+        {
+            m_settled = false;
+            m_inputReleased = false;
+            m_lastFullFrameMs = now;
+            return m_decimator.ShouldRebuild(Trace::NowUs(), HasPendingInput()) ? OverlayFrameMode::Full : OverlayFrameMode::Reuse;
+        }
+
+        // Becoming interactive again starts with a full frame.
+        m_decimator.Invalidate();
+
+        // First quiet frame is still built so ImGui can close windows, destroy platform
+        // windows and leave draw data that matches what should stay on screen.
+        if (!m_settled)
+        {
+            m_settled = true;
+            m_inputReleased = false;
+            m_lastFullFrameMs = now;
+            return OverlayFrameMode::Full;
+        }
+
+        if (activity == OverlayActivity::Static && now - m_lastFullFrameMs >= kStaticRefreshMs)
+        {
+            m_lastFullFrameMs = now;
+            m_inputReleased = false;
+            return OverlayFrameMode::Full;
+        }
+
+        m_skippedFrames++;
+        return (activity == OverlayActivity::Idle) ? OverlayFrameMode::Skip : OverlayFrameMode::Replay;
+    }
+
+    void OverlayFrameGate::DiscardPendingInput()
+    {
+        ImGuiContext* ctx = ImGui::GetCurrentContext();
+        if (!ctx || (m_inputReleased && ctx->InputEventsQueue.empty()))
+            return;
+
+        ImGuiIO& io = ImGui::GetIO();
+        ImGuiInputEventMousePos lastPos = { io.MousePos.x, io.MousePos.y, ImGuiMouseSource_Mouse };
+        for (const ImGuiInputEvent& e : ctx->InputEventsQueue)
+        {
+            if (e.Type == ImGuiInputEventType_MousePos)
+                lastPos = e.MousePos;
+        }
+
+        io.ClearEventsQueue();
+        if (!m_inputReleased)
+        {
+            io.ClearInputKeys();
+            io.ClearInputMouse();
+            m_inputReleased = true;
+        }
+
+        if (lastPos.PosX > -FLT_MAX && lastPos.PosY > -FLT_MAX)
+        {
+            io.AddMouseSourceEvent(lastPos.MouseSource);
+            io.AddMousePosEvent(lastPos.PosX, lastPos.PosY);
+        }
+    }
+}
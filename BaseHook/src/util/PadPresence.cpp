@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "util/PadPresence.h"
+
+namespace BaseHook {
+
+bool PadPresenceTracker::Observe(uint8_t probedMask, uint64_t nowMs)
+{
+    probedMask &= (1u << kSlots) - 1;
+
+    const uint8_t oldMask = m_mask;
+    const int oldPreferred = m_preferred;
+
+    if (!m_observed)
+    {
+        m_observed = true;
+        m_mask = probedMask;
+        for (int slot = 0; slot < kSlots; ++slot)
+            m_connectedSince[slot] = nowMs;
+    }
+    else
+    {
+        for (int slot = 0; slot < kSlots; ++slot)
+        {
+            const uint8_t bit = static_cast<uint8_t>(1u << slot);
+            if ((probedMask & bit) == (m_mask & bit))
+            {
+                m_pendingMask &= ~bit;
+                continue;
+            }
+
+            if (!(m_pendingMask & bit))
+            {
+                m_pendingMask |= bit;
+                m_pendingSince[slot] = nowMs;
+            }
+            if (nowMs - m_pendingSince[slot] < m_debounceMs)
+                continue;
+
+            m_pendingMask &= ~bit;
+            m_mask ^= bit;
+            if (m_mask & bit)
+                m_connectedSince[slot] = nowMs;
+        }
+    }
+
+    if (m_preferred < 0 || !(m_mask & (1u << m_preferred)))
+    {
+        m_preferred = -1;
+        for (int slot = 0; slot < kSlots; ++slot)
+        {
+            if (!(m_mask & (1u << slot)))
+                continue;
+            if (m_preferred < 0 || m_connectedSince[slot] < m_connectedSince[m_preferred])
+                m_preferred = slot;
+        }
+    }
+
+    if (m_mask == oldMask && m_preferred == oldPreferred && m_generation != 0)
+        return false;
+
+    ++m_generation;
+    Publish();
+    return true;
+}
+
+void PadPresenceTracker::Publish()
+{
+    const uint32_t packed = static_cast<uint32_t>(m_mask)
+                          | (static_cast<uint32_t>(m_preferred + 1) << 4)
+                          | (m_generation << 8);
+    m_snapshot.store(packed, std::memory_order_release);
+}
+
+PadPresence PadPresenceTracker::Get() const
+{
+    const uint32_t packed = m_snapshot.load(std::memory_order_acquire);
+    PadPresence presence;
+    presence.connectedMask = static_cast<uint8_t>(packed & 0x0F);
+    presence.preferredIndex = static_cast<int8_t>(static_cast<int>((packed >> 4) & 0x0F) - 1);
+    presence.generation = packed >> 8;
+    return presence;
+}
+
+} // namespace BaseHook
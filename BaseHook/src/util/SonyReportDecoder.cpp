@@ -0,0 +1,242 @@
+#include "pch.h"
+#include "util/SonyReportDecoder.h"
+
+namespace BaseHook::Sony {
+
+namespace {
+
+    // XInput wButtons bits, spelled out so the decoder doesn't depend on <xinput.h>.
+    constexpr uint16_t kDpadUp = 0x0001, kDpadDown = 0x0002, kDpadLeft = 0x0004, kDpadRight = 0x0008;
+    constexpr uint16_t kStart = 0x0010, kBack = 0x0020, kLeftThumb = 0x0040, kRightThumb = 0x0080;
+    constexpr uint16_t kLeftShoulder = 0x0100, kRightShoulder = 0x0200, kGuide = 0x0400;
+    constexpr uint16_t kA = 0x1000, kB = 0x2000, kX = 0x4000, kY = 0x8000;
+
+    // Nominal sensor ranges of both controllers: +-2000 deg/s and +-4 g over the int16 range.
+    constexpr float kGyroDegPerUnit = 2000.0f / 32768.0f;
+    constexpr float kAccelGPerUnit = 1.0f / 8192.0f;
+
+    // `byte` indexes the 3-byte button block; the hat is the low nibble of its first byte.
+    struct ButtonBit { uint8_t byte; uint8_t mask; uint16_t xinput; };
+
+    constexpr ButtonBit kDualSenseButtons[] = {
+        { 0, 0x10, kX }, { 0, 0x20, kA }, { 0, 0x40, kB }, { 0, 0x80, kY },     // Square, Cross, Circle, Triangle
+        { 1, 0x01, kLeftShoulder }, { 1, 0x02, kRightShoulder },
+        { 1, 0x10, kBack }, { 1, 0x20, kStart },                                // Create, Options
+        { 1, 0x40, kLeftThumb }, { 1, 0x80, kRightThumb },
+        { 2, 0x01, kGuide }, { 2, 0x02, kTouchpadButton },                      // PS, touchpad click
+    };
+
+    constexpr ButtonBit kDualShock4Buttons[] = {
+        { 0, 0x10, kX }, { 0, 0x20, kA }, { 0, 0x40, kB }, { 0, 0x80, kY },
+        { 1, 0x01, kLeftShoulder }, { 1, 0x02, kRightShoulder },
+        { 1, 0x10, kBack }, { 1, 0x20, kStart },                                // Share, Options
+        { 1, 0x40, kLeftThumb }, { 1, 0x80, kRightThumb },
+        { 2, 0x01, kGuide }, { 2, 0x02, kTouchpadButton },                      // PS, touchpad click
+    };
+
+    // One report variant. Offsets count from the report ID byte; 0 = not present.
+    struct ReportLayout {
+        const char* name;
+        uint8_t reportId;
+        uint8_t minLength;          // Shortest report accepted with this layout
+        uint8_t sticks;             // LX, LY, RX, RY
+        uint8_t triggers;           // L2, R2
+        uint8_t buttons;            // 3 bytes
+        const ButtonBit* buttonMap;
+        uint8_t buttonCount;
+        uint8_t extendedLength;     // Motion and touch are only read from reports at least this long
+        uint8_t gyro;               // 3 x int16 LE
+        uint8_t accel;              // 3 x int16 LE
+        uint8_t timestamp;
+        uint8_t timestampBytes;
+        uint8_t touch;              // 2 x 4-byte points
+    };
+
+    template <size_t N>
+    constexpr uint8_t CountOf(const ButtonBit (&)[N]) { return static_cast<uint8_t>(N); }
+
+    // Tried in order, first match wins (the DualSense sends the short 0x01 report over Bluetooth
+    // until it has been asked for feature report 0x05).
+    constexpr ReportLayout kDualSenseLayouts[] = {
+        { "DualSense BT",       0x31, 78, 2, 6, 9, kDualSenseButtons, CountOf(kDualSenseButtons), 78, 17, 23, 29, 4, 34 },
+        { "DualSense USB",      0x01, 64, 1, 5, 8, kDualSenseButtons, CountOf(kDualSenseButtons), 64, 16, 22, 28, 4, 33 },
+        { "DualSense BT short", 0x01, 10, 1, 8, 5, kDualSenseButtons, CountOf(kDualSenseButtons),  0,  0,  0,  0, 0,  0 },
+    };
+
+    constexpr ReportLayout kDualShock4Layouts[] = {
+        { "DualShock 4 BT",     0x11, 78, 3, 10, 7, kDualShock4Buttons, CountOf(kDualShock4Buttons), 78, 15, 21, 12, 2, 37 },
+        { "DualShock 4 USB",    0x01, 10, 1,  8, 5, kDualShock4Buttons, CountOf(kDualShock4Buttons), 64, 13, 19, 10, 2, 35 },
+    };
+
+    constexpr uint16_t kHatButtons[16] = {
+        kDpadUp, kDpadUp | kDpadRight, kDpadRight, kDpadRight | kDpadDown,
+        kDpadDown, kDpadDown | kDpadLeft, kDpadLeft, kDpadLeft | kDpadUp,
+        // 8 = released, 9-15 unused
+    };
+
+    int16_t StickFromByte(uint8_t value, bool invert)
+    {
+        float normalized = (static_cast<float>(value) / 255.0f) * 2.0f - 1.0f;
+        if (invert) normalized = -normalized;
+        float scaled = normalized * 32767.0f;
+        if (scaled > 32767.0f) scaled = 32767.0f;
+        if (scaled < -32767.0f) scaled = -32767.0f;
+        return static_cast<int16_t>(scaled);
+    }
+
+    // Byte -> thumb value lookup, so decoding a stick axis is a load instead of float math.
+    struct StickTable {
+        int16_t normal[256];
+        int16_t inverted[256];
+
+        StickTable()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                normal[i] = StickFromByte(static_cast<uint8_t>(i), false);
+                inverted[i] = StickFromByte(static_cast<uint8_t>(i), true);
+            }
+        }
+    };
+
+    const StickTable g_sticks;
+
+    int16_t ReadI16(const uint8_t* p)
+    {
+        return static_cast<int16_t>(p[0] | (p[1] << 8));
+    }
+
+    void ReadTouchPoint(const uint8_t* p, TouchPoint& point)
+    {
+        point.active = (p[0] & 0x80) == 0;
+        point.id = p[0] & 0x7F;
+        point.x = static_cast<uint16_t>(p[1] | ((p[2] & 0x0F) << 8));
+        point.y = static_cast<uint16_t>((p[2] >> 4) | (p[3] << 4));
+    }
+
+    const ReportLayout* FindLayout(ControllerType type, const uint8_t* data, size_t len)
+    {
+        if (!data || len == 0)
+            return nullptr;
+
+        const ReportLayout* begin = type == ControllerType::DualSense ? kDualSenseLayouts : kDualShock4Layouts;
+        const ReportLayout* end = type == ControllerType::DualSense
+            ? kDualSenseLayouts + sizeof(kDualSenseLayouts) / sizeof(kDualSenseLayouts[0])
+            : kDualShock4Layouts + sizeof(kDualShock4Layouts) / sizeof(kDualShock4Layouts[0]);
+
+        for (const ReportLayout* layout = begin; layout != end; ++layout)
+        {
+            if (data[0] == layout->reportId && len >= layout->minLength)
+                return layout;
+        }
+        return nullptr;
+    }
+
+    void Decode(const ReportLayout& layout, const uint8_t* data, size_t len, DecodedReport& out)
+    {
+        out = DecodedReport{};
+
+        const uint8_t* sticks = data + layout.sticks;
+        out.thumbLX = g_sticks.normal[sticks[0]];
+        out.thumbLY = g_sticks.inverted[sticks[1]];
+        out.thumbRX = g_sticks.normal[sticks[2]];
+        out.thumbRY = g_sticks.inverted[sticks[3]];
+        out.leftTrigger = data[layout.triggers];
+        out.rightTrigger = data[layout.triggers + 1];
+
+        const uint8_t* buttons = data + layout.buttons;
+        uint16_t mask = kHatButtons[buttons[0] & 0x0F];
+        for (uint8_t i = 0; i < layout.buttonCount; ++i)
+        {
+            const ButtonBit& bit = layout.buttonMap[i];
+            if (buttons[bit.byte] & bit.mask)
+                mask |= bit.xinput;
+        }
+        out.buttons = mask;
+
+        if (layout.extendedLength == 0 || len < layout.extendedLength)
+            return;
+
+        out.hasMotion = true;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            out.gyro[axis] = ReadI16(data + layout.gyro + axis * 2) * kGyroDegPerUnit;
+            out.accel[axis] = ReadI16(data + layout.accel + axis * 2) * kAccelGPerUnit;
+        }
+
+        const uint8_t* ts = data + layout.timestamp;
+        out.sensorTimestamp = layout.timestampBytes == 4
+            ? static_cast<uint32_t>(ts[0] | (ts[1] << 8) | (ts[2] << 16) | (static_cast<uint32_t>(ts[3]) << 24))
+            : static_cast<uint32_t>(ts[0] | (ts[1] << 8));
+
+        out.hasTouch = true;
+        ReadTouchPoint(data + layout.touch, out.touch[0]);
+        ReadTouchPoint(data + layout.touch + 4, out.touch[1]);
+    }
+
+} // namespace
+
+void GetTouchpadSize(ControllerType type, uint16_t& width, uint16_t& height)
+{
+    width = 1920;
+    height = type == ControllerType::DualSense ? 1080 : 943;
+}
+
+uint32_t SensorTimestampDeltaUs(ControllerType type, uint32_t previous, uint32_t current)
+{
+    // DualSense: 32-bit counter in 1/3 us. DualShock 4: 16-bit counter in 16/3 us.
+    if (type == ControllerType::DualSense)
+        return (current - previous) / 3;
+    return static_cast<uint32_t>(static_cast<uint16_t>(current - previous)) * 16 / 3;
+}
+
+bool DecodeReport(ControllerType type, const uint8_t* data, size_t len, DecodedReport& out)
+{
+    const ReportLayout* layout = FindLayout(type, data, len);
+    if (!layout)
+        return false;
+    Decode(*layout, data, len, out);
+    return true;
+}
+
+size_t DecodeReports(ControllerType type, const uint8_t* data, size_t reportSize, size_t count, DecodedReport* out)
+{
+    if (!data || !out || reportSize == 0)
+        return 0;
+
+    // All reports of one read share the size and almost always the ID, so look the layout up once
+    // and only again when the ID changes.
+    const ReportLayout* layout = nullptr;
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* report = data + i * reportSize;
+        if (!layout || report[0] != layout->reportId)
+            layout = FindLayout(type, report, reportSize);
+        if (!layout)
+            continue;
+        Decode(*layout, report, reportSize, out[decoded++]);
+    }
+    return decoded;
+}
+
+PadState ToPadState(const DecodedReport& report)
+{
+    PadState state;
+    state.buttons = report.buttons;
+    state.leftTrigger = report.leftTrigger;
+    state.rightTrigger = report.rightTrigger;
+    state.thumbLX = report.thumbLX;
+    state.thumbLY = report.thumbLY;
+    state.thumbRX = report.thumbRX;
+    state.thumbRY = report.thumbRY;
+    return state;
+}
+
+const char* GetLayoutName(ControllerType type, const uint8_t* data, size_t len)
+{
+    const ReportLayout* layout = FindLayout(type, data, len);
+    return layout ? layout->name : nullptr;
+}
+
+} // namespace BaseHook::Sony
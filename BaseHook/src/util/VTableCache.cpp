@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "util/VTableCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace BaseHook::VTableCache {
+
+namespace {
+
+    std::string FormatVersion(uint64_t version)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u",
+                 (unsigned)(version >> 48), (unsigned)((version >> 32) & 0xFFFF),
+                 (unsigned)((version >> 16) & 0xFFFF), (unsigned)(version & 0xFFFF));
+        return text;
+    }
+
+    bool ParseVersion(const std::string& text, uint64_t& out)
+    {
+        unsigned parts[4];
+        char tail;
+        if (sscanf(text.c_str(), "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4)
+            return false;
+        out = 0;
+        for (unsigned part : parts)
+        {
+            if (part > 0xFFFF)
+                return false;
+            out = (out << 16) | part;
+        }
+        return true;
+    }
+
+    bool ParseHex(const std::string& text, uint32_t& out)
+    {
+        if (text.empty() || text.size() > 8)
+            return false;
+        char* end = nullptr;
+        const unsigned long value = strtoul(text.c_str(), &end, 16);
+        if (*end != '\0')
+            return false;
+        out = (uint32_t)value;
+        return true;
+    }
+
+    bool IsValid(const Entry& entry)
+    {
+        if (entry.interfaceName.empty() || entry.modules.empty() || entry.rvas.empty())
+            return false;
+        for (uint32_t rva : entry.rvas)
+        {
+            if (rva == 0 || rva >= entry.modules[0].imageSize)
+                return false;
+        }
+        return true;
+    }
+
+    bool SameEntry(const Entry& a, const Entry& b)
+    {
+        return a.interfaceName == b.interfaceName && a.modules.size() == b.modules.size() &&
+               std::equal(a.modules.begin(), a.modules.end(), b.modules.begin()) && a.rvas == b.rvas;
+    }
+
+} // namespace
+
+bool ModuleIdentity::operator==(const ModuleIdentity& other) const
+{
+    return name == other.name && fileVersion == other.fileVersion && timestamp == other.timestamp && imageSize == other.imageSize;
+}
+
+const Entry* Cache::Find(const std::string& interfaceName, const std::vector<ModuleIdentity>& loaded) const
+{
+    for (const Entry& entry : m_entries)
+    {
+        if (entry.interfaceName != interfaceName)
+            continue;
+
+        for (const ModuleIdentity& module : entry.modules)
+        {
+            if (std::find(loaded.begin(), loaded.end(), module) == loaded.end())
+                return nullptr;
+        }
+        return IsValid(entry) ? &entry : nullptr;
+    }
+    return nullptr;
+}
+
+bool Cache::Store(const Entry& entry)
+{
+    if (!IsValid(entry))
+        return false;
+
+    for (Entry& existing : m_entries)
+    {
+        if (existing.interfaceName != entry.interfaceName)
+            continue;
+        if (SameEntry(existing, entry))
+            return false;
+        existing = entry;
+        return true;
+    }
+    m_entries.push_back(entry);
+    return true;
+}
+
+std::string Cache::Serialize() const
+{
+    std::string text;
+    char field[64];
+    for (const Entry& entry : m_entries)
+    {
+        text += entry.interfaceName;
+        for (const ModuleIdentity& module : entry.modules)
+        {
+            snprintf(field, sizeof(field), " %08x %08x", module.timestamp, module.imageSize);
+            text += " module " + module.name + " " + FormatVersion(module.fileVersion) + field;
+        }
+        text += " rva";
+        for (uint32_t rva : entry.rvas)
+        {
+            snprintf(field, sizeof(field), " %x", rva);
+            text += field;
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+bool Cache::Parse(const std::string& text, std::string* error)
+{
+    auto fail = [&](int lineNo, const std::string& what) {
+        if (error)
+            *error = "line " + std::to_string(lineNo) + ": " + what;
+        return false;
+    };
+
+    std::vector<Entry> entries;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(lines, line))
+    {
+        ++lineNo;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream tokens(line);
+        Entry entry;
+        if (!(tokens >> entry.interfaceName))
+            continue;
+
+        std::string key;
+        bool haveRvas = false;
+        while (tokens >> key)
+        {
+            if (key == "rva")
+            {
+                haveRvas = true;
+                break;
+            }
+            if (key != "module")
+                return fail(lineNo, "expected 'module' or 'rva', got '" + key + "'");
+
+            ModuleIdentity module;
+            std::string version, timestamp, size;
+            if (!(tokens >> module.name >> version >> timestamp >> size))
+                return fail(lineNo, "truncated module");
+            if (!ParseVersion(version, module.fileVersion))
+                return fail(lineNo, "bad version '" + version + "'");
+            if (!ParseHex(timestamp, module.timestamp) || !ParseHex(size, module.imageSize))
+                return fail(lineNo, "bad timestamp or size for " + module.name);
+            entry.modules.push_back(module);
+        }
+        if (!haveRvas)
+            return fail(lineNo, "missing rva list");
+
+        std::string value;
+        while (tokens >> value)
+        {
+            uint32_t rva;
+            if (!ParseHex(value, rva))
+                return fail(lineNo, "bad rva '" + value + "'");
+            entry.rvas.push_back(rva);
+        }
+        if (!IsValid(entry))
+            return fail(lineNo, "incomplete entry for " + entry.interfaceName);
+
+        auto duplicate = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) { return e.interfaceName == entry.interfaceName; });
+        if (duplicate != entries.end())
+            return fail(lineNo, "duplicate " + entry.interfaceName);
+        entries.push_back(std::move(entry));
+    }
+
+    m_entries = std::move(entries);
+    return true;
+}
+
+} // namespace BaseHook::VTableCache
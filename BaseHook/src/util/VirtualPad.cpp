@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "util/VirtualPad.h"
+
+namespace BaseHook {
+
+    bool VirtualPadMerger::Submit(int source, int priority, const void* context, const PadState& state,
+                                  int64_t sourceTimeUs, uint64_t nowMs, bool& outSourceChanged)
+    {
+        outSourceChanged = false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const bool sameContext = m_hasData && m_source == source && m_context == context;
+        if (!sameContext && IsFresh(nowMs) && priority < m_priority)
+            return false;
+
+        m_state = state;
+        m_state.packetNumber = ++m_packetCounter;
+        m_source = source;
+        m_priority = priority;
+        m_context = context;
+        m_hasData = true;
+        m_lastUpdateMs = nowMs;
+        m_sourceTimeUs = sourceTimeUs;
+
+        outSourceChanged = !sameContext;
+        return true;
+    }
+
+    void VirtualPadMerger::Reset(int sourceFilter, const void* contextFilter)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasData)
+            return;
+        if (sourceFilter != 0 && m_source != sourceFilter)
+            return;
+        if (contextFilter && m_context != contextFilter)
+            return;
+
+        m_state = {};
+        m_source = 0;
+        m_priority = 0;
+        m_context = nullptr;
+        m_hasData = false;
+        m_lastUpdateMs = 0;
+        m_sourceTimeUs = 0;
+        m_packetCounter = 1;
+        m_deliveredPacket = 0;
+    }
+
+    bool VirtualPadMerger::Peek(uint64_t nowMs, PadState& out) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!IsFresh(nowMs))
+            return false;
+        out = m_state;
+        return true;
+    }
+
+    bool VirtualPadMerger::Consume(uint64_t nowMs, Delivery& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!IsFresh(nowMs))
+            return false;
+        out.state = m_state;
+        out.sourceTimeUs = m_sourceTimeUs;
+        out.firstDelivery = m_deliveredPacket != m_state.packetNumber;
+        m_deliveredPacket = m_state.packetNumber;
+        return true;
+    }
+}
@@ -303,6 +303,8 @@ Example:
 #include <optional>
 #include <variant>
 #include <string_view>
+#include <unordered_map>
+#include <exception>
 #include "PatternScanner.h"
 
 namespace AutoAssemblerKinda {
@@ -546,6 +548,11 @@ private:
     std::vector<Label*> m_LabelsQuickAccess;
     std::vector<AllocatedWriteableSymbol*> m_AllocsQuickAccess;
     std::vector<StaticSymbol*> m_DefinesQuickAccess;
+    // Name -> index into m_Symbols. Keys view the symbols' own m_SymbolName (symbols are heap-allocated, so they stay put).
+    std::unordered_map<std::string_view, size_t> m_SymbolIndex;
+
+    void CheckNewSymbolName(const std::string_view& symbolName) const;
+    void IndexNewSymbol();
 public:
     Label&
         MakeNew_Label(const std::string_view& symbolName);
@@ -757,6 +764,20 @@ public:
 private:
     bool m_IsActive = false;
 };
+// Assembles a script the way `new AutoAssembleWrapper<T>(args...)` would, but a malformed script
+// (duplicate symbol, label never placed, allocation failure) comes back as nullptr with the reason
+// in `outError` instead of an exception unwinding into the game.
+template<class HasAutoAssemblerCodeInConstructor, typename ... Args>
+std::unique_ptr<AutoAssembleWrapper<HasAutoAssemblerCodeInConstructor>> TryAutoAssemble(std::string& outError, Args&& ... args)
+{
+    try {
+        return std::make_unique<AutoAssembleWrapper<HasAutoAssemblerCodeInConstructor>>(std::forward<Args>(args) ...);
+    }
+    catch (const std::exception& e) {
+        outError = e.what();
+        return nullptr;
+    }
+}
 
 // ============================================
 // Hook Utilities
@@ -7,10 +7,13 @@
 #include <sstream>
 #include <cstdio>
 #include <charconv>
+#include <algorithm>
+#include <stdexcept>
 
 #include "AutoAssemblerKinda.h"
 #include <PatternScanner.h>
 #include <log.h>
+#include <Trace.h>
 
 using AutoAssemblerKinda::byte;
 using AutoAssemblerKinda::PatternScanner;
@@ -199,50 +202,6 @@ void AssemblerContext::Unwrite()
         define->Unwrite();
     }
 }
-SymbolWithAnAddress* AssemblerContext::GetSymbol(const std::string_view& symbolName)
-{
-    for (auto& symbol : m_Symbols) {
-        if (symbol->m_SymbolName == symbolName) {
-            return symbol.get();
-        }
-    }
-    return nullptr;
-}
-StaticSymbol& AssemblerContext::MakeNew_Define(uintptr_t addr, const std::string_view& symbolName)
-{
-    auto& newItem = m_Symbols.emplace_back(std::make_unique<StaticSymbol>(addr, this));
-    newItem->m_SymbolName = symbolName;
-    StaticSymbol* asDef = static_cast<StaticSymbol*>(newItem.get());
-    m_DefinesQuickAccess.push_back(asDef);
-    return *asDef;
-}
-Label& AssemblerContext::MakeNew_Label(const std::string_view& symbolName)
-{
-    auto& newItem = m_Symbols.emplace_back(std::make_unique<Label>(std::optional<uintptr_t>()));
-    newItem->m_SymbolName = symbolName;
-    Label* asLabel = static_cast<Label*>(newItem.get());
-    m_LabelsQuickAccess.push_back(asLabel);
-    return *asLabel;
-}
-AllocatedWriteableSymbol& AssemblerContext::MakeNew_Alloc(uint32_t size, const std::string_view& symbolName, uintptr_t preferredAddr)
-{
-    auto& newItem = m_Symbols.emplace_back(std::make_unique<AllocatedWriteableSymbol>(std::optional<uintptr_t>(), this));
-    newItem->m_SymbolName = symbolName;
-    AllocatedWriteableSymbol* asAlloc = static_cast<AllocatedWriteableSymbol*>(newItem.get());
-    asAlloc->m_SizeToAllocate = size;
-    asAlloc->m_PreferredAddr = preferredAddr;
-    m_AllocsQuickAccess.push_back(asAlloc);
-    return *asAlloc;
-}
-void AssemblerContext::AddSymbolRef(SymbolWithAnAddress& symbol, const SymbolMention& newRef)
-{
-    symbol.m_ReferencesToResolve.push_back(newRef);
-}
-void AssemblerContext::AssignLabel(Label& label, WriteableSymbol& assignedInWhichSymbol, uint32_t offset)
-{
-    label.m_AssignedInWhichSymbol = &assignedInWhichSymbol;
-    label.m_Offset = offset;
-}
 ByteVector SymbolWithAnAddress::CopyCurrentBytes(size_t numBytes)
 {
     ByteVector result;
@@ -255,122 +214,6 @@ ByteVector SymbolWithAnAddress::CopyCurrentBytes(size_t numBytes)
     VirtualProtect((void*)readFrom, numBytes, oldProtect, &oldProtect);
     return result;
 }
-void WriteableSymbol::ProcessNewCodeElements(size_t idxToStartProcessingFrom)
-{
-    using _2bytes_t = byte[2];
-    using _4bytes_t = byte[4];
-    using _8bytes_t = byte[8];
-    m_resultantCode.reserve(m_codeElements.size() * 4);
-    for (auto i = idxToStartProcessingFrom; i < m_codeElements.size(); i++)
-    {
-        CodeElement& block = m_codeElements[i];
-        if (db* data = std::get_if<db>(&block)) {
-            for (auto& b : data->m_Values)
-            {
-                m_resultantCode.push_back(b);
-            }
-        }
-        else if (dw* data = std::get_if<dw>(&block)) {
-            for (auto& w : data->m_Values) {
-                for (byte b : (_2bytes_t&)w) {
-                    m_resultantCode.push_back(b);
-                }
-            }
-        }
-        else if (dd* data = std::get_if<dd>(&block)) {
-            for (auto& d : data->m_Values) {
-                for (byte b : (_4bytes_t&)d) {
-                    m_resultantCode.push_back(b);
-                }
-            }
-        }
-        else if (dq* data = std::get_if<dq>(&block)) {
-            for (auto& q : data->m_Values) {
-                for (byte b : (_8bytes_t&)q) {
-                    m_resultantCode.push_back(b);
-                }
-            }
-        }
-        else if (nop* nops = std::get_if<nop>(&block)) {
-            for (size_t i = 0; i < nops->m_HowManyBytes; i++) {
-                m_resultantCode.push_back(0x90);
-            }
-        }
-        else if (std::string_view* hexString = std::get_if<std::string_view>(&block))
-        {
-            const char* p = hexString->data();
-            const char* const end = p + hexString->size();
-
-            while (p < end) {
-                // 1. Skip whitespace
-                if (std::isspace(static_cast<unsigned char>(*p))) {
-                    ++p;
-                    continue;
-                }
-
-                // 2. Check for at least 2 remaining characters
-                if (p + 1 >= end) {
-                     // We could log a warning here for trailing single character if desired
-                     break; 
-                }
-
-                // 3. Parse exactly 2 characters
-                uint8_t val;
-                auto [ptr, ec] = std::from_chars(p, p + 2, val, 16);
-
-                if (ec == std::errc{}) {
-                    m_resultantCode.push_back(static_cast<byte>(val));
-                    p = ptr; 
-                } else {
-                    LOG_ERROR("[AutoAssemblerKinda] Invalid hex sequence at offset %td: %c%c", (p - hexString->data()), *p, *(p+1));
-                    break;
-                }
-            }
-        }
-        else if (RIP* relAddr = std::get_if<RIP>(&block)) {
-            m_ctx->AddSymbolRef(relAddr->m_Symbol, SymbolMention(*this, (int)m_resultantCode.size(), SymbolMentionTypeRelative{ relAddr->m_HowManyBytesUntilTheEndOfOpcodeIncludingThese4bytes }));
-            _4bytes_t relativeAddrPlaceholderZeros = { 0 };
-            for (byte b : relativeAddrPlaceholderZeros) {
-                m_resultantCode.push_back(b);
-            }
-        }
-        else if (ABS* absAddr = std::get_if<ABS>(&block)) {
-            m_ctx->AddSymbolRef(absAddr->m_Symbol, SymbolMention(*this, (int)m_resultantCode.size(), SymbolMentionTypeAbsolute{ absAddr->m_AbsoluteAddrWidth }));
-            for (size_t i = 0; i < absAddr->m_AbsoluteAddrWidth; i++) {
-                m_resultantCode.push_back(0);
-            }
-        }
-        else if (LabelPlacement* labelAssignment = std::get_if<LabelPlacement>(&block)) {
-            m_ctx->AssignLabel(labelAssignment->m_Label, *this, (uint32_t)m_resultantCode.size());
-        }
-    }
-}
-void WriteableSymbol::SetCodeElements(const std::vector<CodeElement>& codeElements)
-{
-    m_codeElements = codeElements;
-    ProcessNewCodeElements(0);
-}
-void WriteableSymbol::AppendCodeElements(const std::vector<CodeElement>& codeElements)
-{
-    size_t firstNewElementIdx = m_codeElements.size();
-    m_codeElements.reserve(m_codeElements.size() + codeElements.size() * 4);
-    for (auto& codeElem : codeElements) {
-        m_codeElements.push_back(codeElem);
-    }
-    ProcessNewCodeElements(firstNewElementIdx);
-}
-std::string WriteableSymbol::GetResultBytesString()
-{
-    std::stringstream ss;
-    ss << std::hex;
-    for (byte b : m_resultantCode)
-    {
-        ss.width(2);
-        ss.fill('0');
-        ss << (unsigned short)b << ' ';
-    }
-    return ss.str();
-}
 
 
 void AssemblerContext::AllocateVariables()
@@ -392,69 +235,13 @@ void AssemblerContext::AllocateVariables()
         }
         if (!allocBase)
         {
-            throw(std::exception("AssemblerContext::AllocateVariables(): Failed to allocate."));
+            throw std::runtime_error("AssemblerContext::AllocateVariables(): Failed to allocate.");
         }
         currentAlloc->m_SuccessfulAllocBase = (uintptr_t)allocBase;
         currentAlloc->m_ResolvedAddr = currentAlloc->m_SuccessfulAllocBase;
     }
 }
-void AssemblerContext::ResolveSymbolAddresses()
-{
-    for (auto& currentLabel : m_LabelsQuickAccess)
-    {
-        if (!currentLabel->m_AssignedInWhichSymbol) {
-            throw std::runtime_error("Label not placed with PutLabel(): " + currentLabel->m_SymbolName);
-        }
-        currentLabel->m_ResolvedAddr = currentLabel->m_AssignedInWhichSymbol->m_ResolvedAddr.value() + currentLabel->m_Offset;
-    }
-}
-void AssemblerContext::ResolveSymbolReferences()
-{
-    // The addresses of all symbols are already established, now I go through code blocks
-    // that reference them, and update the `m_resultantCode` arrays with correct addresses (absolute or relative).
-    for (auto& currentSymbol : m_Symbols)
-    {
-        for (SymbolMention& ref : currentSymbol->m_ReferencesToResolve)
-        {
-            uintptr_t writeAt = (uintptr_t)&ref.m_Symbol.m_resultantCode[ref.m_OffsetFromSymbolStart];
-            uintptr_t whereTheReferenceWillBePlacedWhenActivated = ref.m_Symbol.m_ResolvedAddr.value() + ref.m_OffsetFromSymbolStart;
-            int32_t writeWhat;
-            if (SymbolMentionTypeRelative* relativeRef = std::get_if<SymbolMentionTypeRelative>(&ref.m_ReferenceOption))
-            {
-                // Relative reference. Calculate the correct offset between the referenced symbol and
-                // the location where the reference will be written.
-                uintptr_t calculateOffsetRelativeToWhere = whereTheReferenceWillBePlacedWhenActivated + relativeRef->m_HowManyBytesUntilTheEndOfOpcodeIncludingThese4bytes;
-                writeWhat = (int32_t)(currentSymbol->m_ResolvedAddr.value() - calculateOffsetRelativeToWhere);
-                *(int32_t*)writeAt = writeWhat;
-            }
-            else if (SymbolMentionTypeAbsolute* absoluteRef = std::get_if<SymbolMentionTypeAbsolute>(&ref.m_ReferenceOption))
-            {
-                switch (absoluteRef->m_AbsoluteAddressWidth)
-                {
-                case 4:
-                {
-                    uint32_t writeWhat = (uint32_t)currentSymbol->m_ResolvedAddr.value();
-                    *(uint32_t*)writeAt = writeWhat;
-                    break;
-                }
-                case 8:
-                {
-                    uint64_t writeWhat = (uint64_t)currentSymbol->m_ResolvedAddr.value();
-                    *(uint64_t*)writeAt = writeWhat;
-                    break;
-                }
-                default:
-                    break;
-                }
-            }
-        }
-    }
-}
 
-std::optional<uintptr_t> AutoAssemblerCodeHolder_Base::RETURN_TO_RIGHT_AFTER_STOLEN_BYTES;
-AutoAssemblerCodeHolder_Base::AutoAssemblerCodeHolder_Base()
-    : m_ctx(std::make_unique<AssemblerContext>())
-{}
 #ifndef _WIN64
 // Static wrapper to handle register saving/restoring
 void __declspec(naked) CCodeInTheMiddle_Wrapper_x86()
@@ -684,9 +471,14 @@ bool NakedHook::Install() {
     if (m_Installed) return true;
     if (!m_Resolved) return false;
     
-    auto* wrapper = new AutoAssembleWrapper<NakedHookInjectHelper>(
+    std::string error;
+    auto* wrapper = TryAutoAssemble<NakedHookInjectHelper>(error,
         m_ResolvedAddress, (void*)m_Desc.hookFunction, m_Desc.stolenBytes, m_Desc.returnAddress
-    );
+    ).release();
+    if (!wrapper) {
+        LOG_ERROR("[NakedHook] %s: Assemble failed: %s", m_Desc.name, error.c_str());
+        return false;
+    }
     wrapper->Activate();
     
     m_WrapperInstance = wrapper;
@@ -774,7 +566,12 @@ bool CCodeHook::Install() {
     
     // Lazy creation of wrapper - only create when installing and after address is resolved
     if (!m_Wrapper) {
-        m_Wrapper = new AutoAssembleWrapper<HookLogic>(m_Desc, m_ResolvedAddress);
+        std::string error;
+        m_Wrapper = TryAutoAssemble<HookLogic>(error, m_Desc, m_ResolvedAddress).release();
+        if (!m_Wrapper) {
+            LOG_ERROR("[CCodeHook] %s: Assemble failed: %s", m_Desc.name, error.c_str());
+            return false;
+        }
     }
     
     m_Wrapper->Activate();
@@ -911,10 +708,13 @@ void HookManager::Register(IHook* hook) {
 
 bool HookManager::Resolve(IHook* hook, bool requireUnique) {
     if (!hook) return false;
+    if (hook->IsResolved()) return true;
+    TRACE_SCOPE_DETAIL("Resolve", "hooks", hook->GetName());
     return hook->Resolve(requireUnique);
 }
 
 size_t HookManager::ResolveAll(bool requireUnique) {
+    TRACE_SCOPE_CAT("HookManager::ResolveAll", "hooks");
     size_t count = 0;
     for (auto* hook : GetHooks()) {
         if (Resolve(hook, requireUnique)) count++;
@@ -923,9 +723,12 @@ size_t HookManager::ResolveAll(bool requireUnique) {
 }
 
 size_t HookManager::InstallAll() {
+    TRACE_SCOPE_CAT("HookManager::InstallAll", "hooks");
     size_t count = 0;
     for (auto* hook : GetHooks()) {
-        if (hook->Resolve(false) && hook->Install()) count++; 
+        if (!Resolve(hook, false)) continue;
+        TRACE_SCOPE_DETAIL("Install", "hooks", hook->GetName());
+        if (hook->Install()) count++;
     }
     return count;
 }
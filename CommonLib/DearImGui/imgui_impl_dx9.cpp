@@ -18,6 +18,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: DirectX9: Save/restore only the states the backend touches (imgui_impl_dx9_state.h) instead of a D3DSBT_ALL state block per frame. Pure devices, and draw data with user callbacks, use one persistent state block. Empty draw data is skipped.
 //  2025-XX-XX: Platform: Added support for multiple windows via the ImGuiPlatformIO interface.
 //  2025-09-18: Call platform_io.ClearRendererHandlers() on shutdown.
 //  2025-06-11: DirectX9: Added support for ImGuiBackendFlags_RendererHasTextures, for dynamic font atlas.
@@ -48,6 +49,7 @@
 
 // DirectX
 #include <d3d9.h>
+#include "imgui_impl_dx9_state.h"
 
 // Clang/GCC warnings with -Weverything
 #if defined(__clang__)
@@ -64,6 +66,10 @@ struct ImGui_ImplDX9_Data
     int                         VertexBufferSize;
     int                         IndexBufferSize;
     bool                        HasRgbaSupport;
+    bool                        IsPureDevice;       // Get* calls fail: save state with pStateBlock instead of Backup
+    bool                        HasDrawn;           // At least one non-empty draw submitted (see #2560 workaround)
+    IDirect3DStateBlock9*       pStateBlock;        // D3DSBT_ALL, created once and re-captured (pure devices, user callbacks)
+    ImGui_ImplDX9_StateBackup   Backup;
 
     ImGui_ImplDX9_Data()        { memset((void*)this, 0, sizeof(*this)); VertexBufferSize = 5000; IndexBufferSize = 10000; }
 };
@@ -108,45 +114,6 @@ static void ImGui_ImplDX9_SetupRenderState(ImDrawData* draw_data)
     vp.MinZ = 0.0f;
     vp.MaxZ = 1.0f;
 
-    LPDIRECT3DDEVICE9 device = bd->pd3dDevice;
-    device->SetViewport(&vp);
-
-    // Setup render state: fixed-pipeline, alpha-blending, no face culling, no depth testing, shade mode (for gradient), bilinear sampling.
-    device->SetPixelShader(nullptr);
-    device->SetVertexShader(nullptr);
-    device->SetRenderState(D3DRS_FILLMODE, D3DFILL_SOLID);
-    device->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
-    device->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-    device->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    device->SetRenderState(D3DRS_ZENABLE, FALSE);
-    device->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    device->SetRenderState(D3DRS_BLENDOP, D3DBLENDOP_ADD);
-    device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-    device->SetRenderState(D3DRS_SEPARATEALPHABLENDENABLE, TRUE);
-    device->SetRenderState(D3DRS_SRCBLENDALPHA, D3DBLEND_ONE);
-    device->SetRenderState(D3DRS_DESTBLENDALPHA, D3DBLEND_INVSRCALPHA);
-    device->SetRenderState(D3DRS_SCISSORTESTENABLE, TRUE);
-    device->SetRenderState(D3DRS_FOGENABLE, FALSE);
-    device->SetRenderState(D3DRS_RANGEFOGENABLE, FALSE);
-    device->SetRenderState(D3DRS_SPECULARENABLE, FALSE);
-    device->SetRenderState(D3DRS_STENCILENABLE, FALSE);
-    device->SetRenderState(D3DRS_CLIPPING, TRUE);
-    device->SetRenderState(D3DRS_LIGHTING, FALSE);
-    device->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    device->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    device->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-    device->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-    device->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-    device->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
-    device->SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    device->SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-    device->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
-    device->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
-    device->SetSamplerState(0, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP);
-    device->SetSamplerState(0, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP);
-
     // Setup orthographic projection matrix
     // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
     // Being agnostic of whether <d3dx9.h> or <DirectXMath.h> can be used, we aren't relying on D3DXMatrixIdentity()/D3DXMatrixOrthoOffCenterLH() or DirectX::XMMatrixIdentity()/DirectX::XMMatrixOrthographicOffCenterLH()
@@ -155,7 +122,6 @@ static void ImGui_ImplDX9_SetupRenderState(ImDrawData* draw_data)
         float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x + 0.5f;
         float T = draw_data->DisplayPos.y + 0.5f;
         float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y + 0.5f;
-        D3DMATRIX mat_identity = { { { 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f } } };
         D3DMATRIX mat_projection =
         { { {
             2.0f/(R-L),   0.0f,         0.0f,  0.0f,
@@ -163,12 +129,59 @@ static void ImGui_ImplDX9_SetupRenderState(ImDrawData* draw_data)
             0.0f,         0.0f,         0.5f,  0.0f,
             (L+R)/(L-R),  (T+B)/(B-T),  0.5f,  1.0f
         } } };
-        device->SetTransform(D3DTS_WORLD, &mat_identity);
-        device->SetTransform(D3DTS_VIEW, &mat_identity);
-        device->SetTransform(D3DTS_PROJECTION, &mat_projection);
+
+        // Setup render state: see imgui_impl_dx9_state.h
+        ImGui_ImplDX9_ApplyDeviceState(bd->pd3dDevice, vp, mat_projection);
     }
 }
 
+// User callbacks can change any state, not just what ImGui_ImplDX9_StateBackup covers.
+// (ImDrawCallback_ResetRenderState only re-applies our own state, so it doesn't count.)
+static bool ImGui_ImplDX9_HasUserCallbacks(ImDrawData* draw_data)
+{
+    for (const ImDrawList* draw_list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : draw_list->CmdBuffer)
+            if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                return true;
+    return false;
+}
+
+// Saves the device state the backend (and any user callback) is about to change. Returns false if it couldn't be saved.
+static bool ImGui_ImplDX9_BackupState(ImGui_ImplDX9_Data* bd, bool full_state, bool* used_state_block)
+{
+    LPDIRECT3DDEVICE9 device = bd->pd3dDevice;
+    *used_state_block = false;
+    if (!bd->IsPureDevice && !full_state && bd->Backup.Capture(device))
+        return true;
+
+    // Pure device or user callbacks: one D3DSBT_ALL block for the lifetime of the device objects, re-captured per frame.
+    if (!bd->pStateBlock && device->CreateStateBlock(D3DSBT_ALL, &bd->pStateBlock) < 0)
+        return false;
+    if (bd->pStateBlock->Capture() < 0)
+        return false;
+
+    // Transforms don't appear to be included in the StateBlock, and Get* works for them on pure devices.
+    device->GetTransform(D3DTS_WORLD, &bd->Backup.World);
+    device->GetTransform(D3DTS_VIEW, &bd->Backup.View);
+    device->GetTransform(D3DTS_PROJECTION, &bd->Backup.Projection);
+    *used_state_block = true;
+    return true;
+}
+
+static void ImGui_ImplDX9_RestoreState(ImGui_ImplDX9_Data* bd, bool used_state_block)
+{
+    LPDIRECT3DDEVICE9 device = bd->pd3dDevice;
+    if (!used_state_block)
+    {
+        bd->Backup.Restore(device);
+        return;
+    }
+    device->SetTransform(D3DTS_WORLD, &bd->Backup.World);
+    device->SetTransform(D3DTS_VIEW, &bd->Backup.View);
+    device->SetTransform(D3DTS_PROJECTION, &bd->Backup.Projection);
+    bd->pStateBlock->Apply();
+}
+
 // Render function.
 void ImGui_ImplDX9_RenderDrawData(ImDrawData* draw_data)
 {
@@ -186,6 +199,11 @@ void ImGui_ImplDX9_RenderDrawData(ImDrawData* draw_data)
             if (tex->Status != ImTextureStatus_OK)
                 ImGui_ImplDX9_UpdateTexture(tex);
 
+    // Nothing to draw: skip the state save/restore entirely. (The very first draw still goes through,
+    // for the multi-viewport workaround at the end of this function.)
+    if (draw_data->TotalVtxCount == 0 && bd->HasDrawn)
+        return;
+
     // Create and grow buffers if needed
     if (!bd->pVB || bd->VertexBufferSize < draw_data->TotalVtxCount)
     {
@@ -202,34 +220,14 @@ void ImGui_ImplDX9_RenderDrawData(ImDrawData* draw_data)
             return;
     }
 
-    // Backup the DX9 state
-    IDirect3DStateBlock9* state_block = nullptr;
-    if (device->CreateStateBlock(D3DSBT_ALL, &state_block) < 0)
-        return;
-    if (state_block->Capture() < 0)
-    {
-        state_block->Release();
-        return;
-    }
-
-    // Backup the DX9 transform (DX9 documentation suggests that it is included in the StateBlock but it doesn't appear to)
-    D3DMATRIX last_world, last_view, last_projection;
-    device->GetTransform(D3DTS_WORLD, &last_world);
-    device->GetTransform(D3DTS_VIEW, &last_view);
-    device->GetTransform(D3DTS_PROJECTION, &last_projection);
-
     // Allocate buffers
     CUSTOMVERTEX* vtx_dst;
     ImDrawIdx* idx_dst;
     if (bd->pVB->Lock(0, (UINT)(draw_data->TotalVtxCount * sizeof(CUSTOMVERTEX)), (void**)&vtx_dst, D3DLOCK_DISCARD) < 0)
-    {
-        state_block->Release();
         return;
-    }
     if (bd->pIB->Lock(0, (UINT)(draw_data->TotalIdxCount * sizeof(ImDrawIdx)), (void**)&idx_dst, D3DLOCK_DISCARD) < 0)
     {
         bd->pVB->Unlock();
-        state_block->Release();
         return;
     }
 
@@ -256,6 +254,12 @@ void ImGui_ImplDX9_RenderDrawData(ImDrawData* draw_data)
     }
     bd->pVB->Unlock();
     bd->pIB->Unlock();
+
+    // Backup the DX9 state
+    bool used_state_block = false;
+    if (!ImGui_ImplDX9_BackupState(bd, ImGui_ImplDX9_HasUserCallbacks(draw_data), &used_state_block))
+        return;
+
     device->SetStreamSource(0, bd->pVB, 0, sizeof(CUSTOMVERTEX));
     device->SetIndices(bd->pIB);
     device->SetFVF(D3DFVF_CUSTOMVERTEX);
@@ -308,15 +312,11 @@ void ImGui_ImplDX9_RenderDrawData(ImDrawData* draw_data)
     // from rendering until the first window submits at least one draw call, even once. That's our workaround. (see #2560)
     if (global_vtx_offset == 0)
         bd->pd3dDevice->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, 0, 0, 0);
-
-    // Restore the DX9 transform
-    device->SetTransform(D3DTS_WORLD, &last_world);
-    device->SetTransform(D3DTS_VIEW, &last_view);
-    device->SetTransform(D3DTS_PROJECTION, &last_projection);
+    else
+        bd->HasDrawn = true;
 
     // Restore the DX9 state
-    state_block->Apply();
-    state_block->Release();
+    ImGui_ImplDX9_RestoreState(bd, used_state_block);
 }
 
 static bool ImGui_ImplDX9_CheckFormatSupport(LPDIRECT3DDEVICE9 pDevice, D3DFORMAT format)
@@ -357,6 +357,8 @@ bool ImGui_ImplDX9_Init(IDirect3DDevice9* device)
     bd->pd3dDevice = device;
     bd->pd3dDevice->AddRef();
     bd->HasRgbaSupport = ImGui_ImplDX9_CheckFormatSupport(bd->pd3dDevice, D3DFMT_A8B8G8R8);
+    D3DDEVICE_CREATION_PARAMETERS creation_params;
+    bd->IsPureDevice = device->GetCreationParameters(&creation_params) >= 0 && (creation_params.BehaviorFlags & D3DCREATE_PUREDEVICE) != 0;
 
     ImGui_ImplDX9_InitMultiViewportSupport();
 
@@ -484,6 +486,7 @@ void ImGui_ImplDX9_InvalidateDeviceObjects()
         }
     if (bd->pVB) { bd->pVB->Release(); bd->pVB = nullptr; }
     if (bd->pIB) { bd->pIB->Release(); bd->pIB = nullptr; }
+    if (bd->pStateBlock) { bd->pStateBlock->Release(); bd->pStateBlock = nullptr; }
     ImGui_ImplDX9_InvalidateDeviceObjectsForPlatformWindows();
 }
 
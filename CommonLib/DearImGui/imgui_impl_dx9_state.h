@@ -0,0 +1,168 @@
+// dear imgui: DirectX9 renderer state table (used by imgui_impl_dx9.cpp)
+// Lists every piece of device state the DX9 backend changes, so RenderDrawData can save and restore
+// exactly that instead of capturing a D3DSBT_ALL state block every frame.
+// Include after <d3d9.h>. Only uses IDirect3DDevice9 Get/Set calls, so it can be exercised against a
+// mock device.
+
+#pragma once
+
+struct ImGui_ImplDX9_RenderStateValue  { D3DRENDERSTATETYPE State; DWORD Value; };
+struct ImGui_ImplDX9_StageStateValue   { DWORD Stage; D3DTEXTURESTAGESTATETYPE Type; DWORD Value; };
+struct ImGui_ImplDX9_SamplerStateValue { DWORD Sampler; D3DSAMPLERSTATETYPE Type; DWORD Value; };
+
+// Fixed-pipeline, alpha-blending, no face culling, no depth testing, shade mode (for gradient), bilinear sampling.
+static const ImGui_ImplDX9_RenderStateValue ImGui_ImplDX9_RenderStates[] =
+{
+    { D3DRS_FILLMODE, D3DFILL_SOLID },
+    { D3DRS_SHADEMODE, D3DSHADE_GOURAUD },
+    { D3DRS_ZWRITEENABLE, FALSE },
+    { D3DRS_ALPHATESTENABLE, FALSE },
+    { D3DRS_CULLMODE, D3DCULL_NONE },
+    { D3DRS_ZENABLE, FALSE },
+    { D3DRS_ALPHABLENDENABLE, TRUE },
+    { D3DRS_BLENDOP, D3DBLENDOP_ADD },
+    { D3DRS_SRCBLEND, D3DBLEND_SRCALPHA },
+    { D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA },
+    { D3DRS_SEPARATEALPHABLENDENABLE, TRUE },
+    { D3DRS_SRCBLENDALPHA, D3DBLEND_ONE },
+    { D3DRS_DESTBLENDALPHA, D3DBLEND_INVSRCALPHA },
+    { D3DRS_SCISSORTESTENABLE, TRUE },
+    { D3DRS_FOGENABLE, FALSE },
+    { D3DRS_RANGEFOGENABLE, FALSE },
+    { D3DRS_SPECULARENABLE, FALSE },
+    { D3DRS_STENCILENABLE, FALSE },
+    { D3DRS_CLIPPING, TRUE },
+    { D3DRS_LIGHTING, FALSE },
+};
+
+static const ImGui_ImplDX9_StageStateValue ImGui_ImplDX9_StageStates[] =
+{
+    { 0, D3DTSS_COLOROP, D3DTOP_MODULATE },
+    { 0, D3DTSS_COLORARG1, D3DTA_TEXTURE },
+    { 0, D3DTSS_COLORARG2, D3DTA_DIFFUSE },
+    { 0, D3DTSS_ALPHAOP, D3DTOP_MODULATE },
+    { 0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE },
+    { 0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE },
+    { 1, D3DTSS_COLOROP, D3DTOP_DISABLE },
+    { 1, D3DTSS_ALPHAOP, D3DTOP_DISABLE },
+};
+
+static const ImGui_ImplDX9_SamplerStateValue ImGui_ImplDX9_SamplerStates[] =
+{
+    { 0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR },
+    { 0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR },
+    { 0, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP },
+    { 0, D3DSAMP_ADDRESSV, D3DTADDRESS_CLAMP },
+};
+
+#define IMGUI_DX9_COUNTOF(_ARR) ((int)(sizeof(_ARR) / sizeof(*(_ARR))))
+
+// Sets up everything ImGui_ImplDX9_SetupRenderState() needs, except the geometry bindings (stream 0,
+// indices, FVF) and per-command state (scissor rect, texture 0) which RenderDrawData sets itself.
+static inline void ImGui_ImplDX9_ApplyDeviceState(IDirect3DDevice9* device, const D3DVIEWPORT9& vp, const D3DMATRIX& projection)
+{
+    static const D3DMATRIX mat_identity = { { { 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f } } };
+
+    device->SetViewport(&vp);
+    device->SetPixelShader(nullptr);
+    device->SetVertexShader(nullptr);
+    for (const ImGui_ImplDX9_RenderStateValue& rs : ImGui_ImplDX9_RenderStates)
+        device->SetRenderState(rs.State, rs.Value);
+    for (const ImGui_ImplDX9_StageStateValue& ts : ImGui_ImplDX9_StageStates)
+        device->SetTextureStageState(ts.Stage, ts.Type, ts.Value);
+    for (const ImGui_ImplDX9_SamplerStateValue& ss : ImGui_ImplDX9_SamplerStates)
+        device->SetSamplerState(ss.Sampler, ss.Type, ss.Value);
+    device->SetTransform(D3DTS_WORLD, &mat_identity);
+    device->SetTransform(D3DTS_VIEW, &mat_identity);
+    device->SetTransform(D3DTS_PROJECTION, &projection);
+}
+
+// The game's values of everything in the tables above, plus the bindings RenderDrawData changes.
+// Capture() holds references to the bound objects until Restore() (or Release() if the draw is abandoned).
+// Get* calls don't work on pure devices (D3DCREATE_PUREDEVICE); use a state block there.
+// Nothing else is saved, so draw data with user callbacks (ImDrawList::AddCallback, other than
+// ImDrawCallback_ResetRenderState) goes through a D3DSBT_ALL state block too. Even then, what a
+// state block doesn't record (render targets, depth-stencil surface) is the callback's to restore.
+struct ImGui_ImplDX9_StateBackup
+{
+    DWORD                           RenderStates[IMGUI_DX9_COUNTOF(ImGui_ImplDX9_RenderStates)];
+    DWORD                           StageStates[IMGUI_DX9_COUNTOF(ImGui_ImplDX9_StageStates)];
+    DWORD                           SamplerStates[IMGUI_DX9_COUNTOF(ImGui_ImplDX9_SamplerStates)];
+    IDirect3DPixelShader9*          PixelShader;
+    IDirect3DVertexShader9*         VertexShader;
+    IDirect3DVertexDeclaration9*    VertexDecl;
+    DWORD                           FVF;
+    IDirect3DVertexBuffer9*         StreamData;
+    UINT                            StreamOffset;
+    UINT                            StreamStride;
+    IDirect3DIndexBuffer9*          Indices;
+    IDirect3DBaseTexture9*          Texture;
+    D3DVIEWPORT9                    Viewport;
+    RECT                            ScissorRect;
+    D3DMATRIX                       World, View, Projection;
+
+    ImGui_ImplDX9_StateBackup()     { memset((void*)this, 0, sizeof(*this)); }
+
+    bool Capture(IDirect3DDevice9* device)
+    {
+        bool ok = true;
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_RenderStates); i++)
+            ok &= device->GetRenderState(ImGui_ImplDX9_RenderStates[i].State, &RenderStates[i]) >= 0;
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_StageStates); i++)
+            ok &= device->GetTextureStageState(ImGui_ImplDX9_StageStates[i].Stage, ImGui_ImplDX9_StageStates[i].Type, &StageStates[i]) >= 0;
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_SamplerStates); i++)
+            ok &= device->GetSamplerState(ImGui_ImplDX9_SamplerStates[i].Sampler, ImGui_ImplDX9_SamplerStates[i].Type, &SamplerStates[i]) >= 0;
+        ok &= device->GetPixelShader(&PixelShader) >= 0;
+        ok &= device->GetVertexShader(&VertexShader) >= 0;
+        ok &= device->GetVertexDeclaration(&VertexDecl) >= 0;
+        ok &= device->GetFVF(&FVF) >= 0;
+        ok &= device->GetStreamSource(0, &StreamData, &StreamOffset, &StreamStride) >= 0;
+        ok &= device->GetIndices(&Indices) >= 0;
+        ok &= device->GetTexture(0, &Texture) >= 0;
+        ok &= device->GetViewport(&Viewport) >= 0;
+        ok &= device->GetScissorRect(&ScissorRect) >= 0;
+        ok &= device->GetTransform(D3DTS_WORLD, &World) >= 0;
+        ok &= device->GetTransform(D3DTS_VIEW, &View) >= 0;
+        ok &= device->GetTransform(D3DTS_PROJECTION, &Projection) >= 0;
+        if (!ok)
+            Release();
+        return ok;
+    }
+
+    void Restore(IDirect3DDevice9* device)
+    {
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_RenderStates); i++)
+            device->SetRenderState(ImGui_ImplDX9_RenderStates[i].State, RenderStates[i]);
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_StageStates); i++)
+            device->SetTextureStageState(ImGui_ImplDX9_StageStates[i].Stage, ImGui_ImplDX9_StageStates[i].Type, StageStates[i]);
+        for (int i = 0; i < IMGUI_DX9_COUNTOF(ImGui_ImplDX9_SamplerStates); i++)
+            device->SetSamplerState(ImGui_ImplDX9_SamplerStates[i].Sampler, ImGui_ImplDX9_SamplerStates[i].Type, SamplerStates[i]);
+        device->SetPixelShader(PixelShader);
+        device->SetVertexShader(VertexShader);
+        // SetFVF replaces the vertex declaration and SetVertexDeclaration clears the FVF, so only one
+        // of them describes the game's input layout.
+        if (FVF != 0)
+            device->SetFVF(FVF);
+        else if (VertexDecl != nullptr)
+            device->SetVertexDeclaration(VertexDecl);
+        device->SetStreamSource(0, StreamData, StreamOffset, StreamStride);
+        device->SetIndices(Indices);
+        device->SetTexture(0, Texture);
+        device->SetViewport(&Viewport);
+        device->SetScissorRect(&ScissorRect);
+        device->SetTransform(D3DTS_WORLD, &World);
+        device->SetTransform(D3DTS_VIEW, &View);
+        device->SetTransform(D3DTS_PROJECTION, &Projection);
+        Release();
+    }
+
+    void Release()
+    {
+        if (PixelShader)  { PixelShader->Release(); PixelShader = nullptr; }
+        if (VertexShader) { VertexShader->Release(); VertexShader = nullptr; }
+        if (VertexDecl)   { VertexDecl->Release(); VertexDecl = nullptr; }
+        if (StreamData)   { StreamData->Release(); StreamData = nullptr; }
+        if (Indices)      { Indices->Release(); Indices = nullptr; }
+        if (Texture)      { Texture->Release(); Texture = nullptr; }
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+// Frame timing helpers. The loader feeds FrameDeltaSmoother from the frame limiter and hands the
+// result to plugins (GetFrameTiming, API 1.9); plugins step movement with FixedStepAccumulator.
+// No Windows dependency.
+
+// Turns per-frame timestamps into deltas. The smoothed delta follows the average frame time but
+// a single hitch only pulls it up by a bounded amount.
+class FrameDeltaSmoother
+{
+public:
+    static constexpr double kMaxDelta = 0.25;       // Longer gaps (loading, debugger) count as this
+    static constexpr double kSpikeFactor = 2.0;     // A frame counts at most this many times the average
+    static constexpr double kWeight = 0.1;          // Exponential average weight of the newest frame
+
+    // False for the first timestamp, which only starts the clock.
+    bool Tick(int64_t nowUs)
+    {
+        if (!m_started)
+        {
+            m_started = true;
+            m_lastUs = nowUs;
+            return false;
+        }
+
+        double delta = static_cast<double>(nowUs - m_lastUs) / 1000000.0;
+        m_lastUs = nowUs;
+        if (delta < 0.0) delta = 0.0;
+        if (delta > kMaxDelta) delta = kMaxDelta;
+        m_delta = delta;
+
+        if (m_smoothed <= 0.0)
+        {
+            m_smoothed = delta;
+        }
+        else
+        {
+            const double bounded = delta < m_smoothed * kSpikeFactor ? delta : m_smoothed * kSpikeFactor;
+            m_smoothed += (bounded - m_smoothed) * kWeight;
+        }
+        return true;
+    }
+
+    void Reset() { *this = FrameDeltaSmoother(); }
+
+    double GetDelta() const { return m_delta; }
+    double GetSmoothedDelta() const { return m_smoothed; }
+
+private:
+    bool m_started = false;
+    int64_t m_lastUs = 0;
+    double m_delta = 0.0;
+    double m_smoothed = 0.0;
+};
+
+// Fixed-timestep simulation driven by variable frame deltas: Advance() says how many steps of
+// GetStep() seconds to run this frame, Alpha() how far the frame is into the next step (for
+// interpolating between the last two simulated states). The same total time gives the same number
+// of steps (up to rounding), however it is split into frames.
+class FixedStepAccumulator
+{
+public:
+    explicit FixedStepAccumulator(double step, int maxSteps = 8) : m_step(step), m_maxSteps(maxSteps) {}
+
+    // Time beyond maxSteps (a long hitch) is dropped rather than caught up over later frames.
+    int Advance(double delta)
+    {
+        if (delta > 0.0)
+            m_accumulated += delta;
+
+        int steps = static_cast<int>(m_accumulated / m_step);
+        if (steps > m_maxSteps)
+        {
+            m_accumulated -= static_cast<double>(steps - m_maxSteps) * m_step;
+            steps = m_maxSteps;
+        }
+        m_accumulated -= static_cast<double>(steps) * m_step;
+        if (m_accumulated < 0.0)
+            m_accumulated = 0.0;
+        return steps;
+    }
+
+    // 0 = at the last step, approaching 1 = almost at the next one.
+    double Alpha() const { return m_accumulated / m_step; }
+
+    double GetStep() const { return m_step; }
+
+    void Reset() { m_accumulated = 0.0; }
+
+private:
+    double m_step;
+    int m_maxSteps;
+    double m_accumulated = 0.0;
+};
@@ -6,7 +6,7 @@
 struct ImGuiContext;
 
 #define MAKE_PLUGIN_API_VERSION(major, minor) ((major << 16) | minor)
-constexpr uint32_t g_PluginLoaderAPIVersion = MAKE_PLUGIN_API_VERSION(1, 0);
+constexpr uint32_t g_PluginLoaderAPIVersion = MAKE_PLUGIN_API_VERSION(1, 9);
 
 // Game identifiers
 enum class Game
@@ -23,6 +23,118 @@ enum class Game
 // Forward declaration
 class PluginLoaderInterface;
 
+// --- Update scheduling (API 1.2) ---
+// Instead of doing everything in OnUpdate() every frame, a plugin can register tasks that
+// run at the rate they actually need, and off the render thread if they don't touch ImGui/D3D.
+enum class UpdateFrequency : uint32_t
+{
+    EveryFrame, // Once per rendered frame
+    FixedRate,  // rateHz times per second (never more than once per frame on the render thread)
+    OnEvent,    // Once after each SignalUpdateEvent(eventName); multiple signals coalesce
+};
+
+enum class UpdateAffinity : uint32_t
+{
+    RenderThread, // Runs inside the Present/EndScene hook, like OnUpdate()
+    Worker,       // Runs on the loader's update worker thread
+};
+
+struct UpdateTaskDesc
+{
+    const char* name = nullptr;
+    void (*callback)(void* userData) = nullptr;
+    void* userData = nullptr;
+    UpdateFrequency frequency = UpdateFrequency::EveryFrame;
+    float rateHz = 0.0f;             // FixedRate only
+    const char* eventName = nullptr; // OnEvent only
+    UpdateAffinity affinity = UpdateAffinity::RenderThread;
+};
+
+using UpdateTaskHandle = uint32_t; // 0 = invalid
+
+// Events signaled by the loader itself.
+namespace UpdateEvents
+{
+    constexpr const char* MenuOpened = "loader.menu_opened";
+    constexpr const char* MenuClosed = "loader.menu_closed";
+    constexpr const char* ConfigReloaded = "loader.config_reloaded";
+}
+
+// --- Hotkeys (API 1.5) ---
+// The loader tracks key messages and the pad once per frame and matches every registered bind in a
+// single pass, so plugins subscribe to edges instead of polling GetAsyncKeyState per bind per frame.
+using HotkeyHandle = uint32_t; // 0 = invalid
+
+namespace HotkeyEvents
+{
+    constexpr uint32_t Pressed = 1;
+    constexpr uint32_t Released = 2;
+    constexpr uint32_t Held = 4;     // Once per frame while down
+}
+
+struct HotkeyEventInfo
+{
+    HotkeyHandle handle;
+    uint32_t event;     // One of HotkeyEvents
+    uint32_t heldMs;    // Released/Held: how long the bind has been down
+};
+
+struct HotkeyDesc
+{
+    // Same meaning as the KeyBind fields (see PluginHotkey.h to register a KeyBind directly)
+    uint32_t keyboardKey = 0;
+    bool ctrl = false;
+    bool shift = false;
+    bool alt = false;
+    uint32_t controllerKey = 0;
+    bool strict = false;    // Modifiers must match exactly
+
+    uint32_t events = HotkeyEvents::Pressed;
+    void (*callback)(void* userData, const HotkeyEventInfo& info) = nullptr; // Render thread, before OnUpdate()
+    void* userData = nullptr;
+};
+
+// --- Controller motion (API 1.6) ---
+// DualShock 4 / DualSense sensors, decoded from the same HID reports that drive the virtual pad.
+struct ControllerTouchPoint
+{
+    bool active;
+    uint8_t id;         // Changes with every new finger-down
+    uint16_t x, y;      // 0 .. touchWidth/touchHeight - 1
+};
+
+struct ControllerMotionState
+{
+    uint32_t sampleCount;   // Increases with every report; unchanged = nothing new
+    uint64_t timestampUs;   // Controller sensor clock
+    float gyro[3];          // deg/s around the pad's x (pitch), y (yaw), z (roll) axes, latest sample
+    float accel[3];         // g, latest sample
+    double gyroAngle[3];    // Degrees, gyro integrated over every sample (several arrive per frame).
+                            // Subtract the previous read's value to get the rotation in between.
+    ControllerTouchPoint touch[2];
+    uint16_t touchWidth, touchHeight;
+};
+
+// --- Controller presence (API 1.7) ---
+// Maintained by a loader thread that probes XInput when devices change, so reading it is free.
+struct ControllerPresence
+{
+    uint32_t connectedMask;     // Bit n = XInput slot n (the virtual Sony/DirectInput pad counts as slot 0)
+    int32_t preferredIndex;     // Slot the game should read, -1 = none. Only changes when that controller goes away.
+    uint32_t generation;        // Changes whenever connectedMask or preferredIndex does
+};
+
+// --- Frame clock (API 1.9) ---
+// Taken at each Present, from QueryPerformanceCounter. See FrameClock.h for the smoothing and a
+// fixed-step helper.
+struct FrameTiming
+{
+    uint64_t frameIndex;    // Presented frames so far
+    double time;            // Seconds since the first Present
+    double delta;           // Seconds between the last two Presents (capped at 0.25)
+    double smoothedDelta;   // delta averaged, with single-frame spikes damped
+};
+
 struct ImGuiShared
 {
     ImGuiContext& m_ctx;
@@ -48,10 +160,19 @@ public:
     virtual void OnGuiRender() {}
 
     // Called every frame, regardless of menu state.
+    // While the overlay is idle this runs outside of an ImGui frame, so don't draw from here.
+    // Prefer PluginLoaderInterface::RegisterUpdateTask for work that doesn't need to run every frame.
     virtual void OnUpdate() {}
 
     // Optional: Expose a pointer to an interface/controller for other plugins to use.
     virtual void* GetInterface() { return nullptr; }
+
+    // API 1.4: Called on the render thread before the plugin is unloaded or hot-reloaded at runtime.
+    // Undo everything that lets game threads reach this module: HookManager::UninstallAll(),
+    // AutoAssembleWrapper::Deactivate(), unregister update tasks. Once it returns true the plugin is
+    // no longer updated or drawn; the instance is destroyed and the module freed after no thread has
+    // been seen executing in it for a while. Return false (the default) to stay loaded.
+    virtual bool OnPluginShutdown() { return false; }
 };
 
 // The interface the loader provides to plugins.
@@ -59,12 +180,50 @@ class PluginLoaderInterface
 {
 public:
     uint32_t m_LoaderAPIVersion = g_PluginLoaderAPIVersion;
+    // Queues an unload (implemented since API 1.4). Plugins that got the module's interface through
+    // GetPluginInterface go down with it, first; nothing is unloaded unless all accept OnPluginShutdown().
     void (*RequestUnloadPlugin)(HMODULE pluginHandle) = nullptr;
     Game (*GetCurrentGame)() = nullptr;
     void (*LogToConsole)(const char* text) = nullptr;
     ImGuiContext* m_ImGuiContext = nullptr;
     ImGuiContext* (*GetImGuiContext)() = nullptr;
     void* (*GetPluginInterface)(const char* pluginName) = nullptr;
+
+    // API 1.1: Forward a finished trace span into the loader's recorder (pass to Trace::InitSink).
+    void (*SubmitTraceSpan)(const char* name, const char* category, const char* detail,
+                            int64_t startUs, int64_t durationUs, uint32_t threadId) = nullptr;
+
+    // API 1.2: Scheduled update tasks. Tasks are removed automatically when the plugin is destroyed.
+    // UnregisterUpdateTask waits for a running invocation to finish (unless called from inside it).
+    UpdateTaskHandle (*RegisterUpdateTask)(IPlugin* owner, const UpdateTaskDesc& desc) = nullptr;
+    void (*UnregisterUpdateTask)(UpdateTaskHandle handle) = nullptr;
+    void (*SignalUpdateEvent)(const char* eventName) = nullptr;
+
+    // API 1.3: Redraw this plugin's OnGuiRender() panel at most `hz` times per second (0 = every frame).
+    // In between, the loader re-submits the last output. The panel still refreshes every frame while
+    // hovered or interacted with. Not supported for panels that open child windows.
+    void (*SetGuiRefreshRate)(IPlugin* owner, float hz) = nullptr;
+
+    // API 1.5: Hotkeys. Removed automatically when the plugin is unloaded. UpdateHotkey rebinds
+    // (a bind that is already held when changed fires only after it's released and pressed again).
+    HotkeyHandle (*RegisterHotkey)(IPlugin* owner, const HotkeyDesc& desc) = nullptr;
+    bool (*UpdateHotkey)(HotkeyHandle handle, const HotkeyDesc& desc) = nullptr;
+    void (*UnregisterHotkey)(HotkeyHandle handle) = nullptr;
+    bool (*IsHotkeyDown)(HotkeyHandle handle) = nullptr;
+
+    // API 1.6: Motion/touch data of the Sony controller currently in use. False if there is none.
+    bool (*GetControllerMotion)(ControllerMotionState* out) = nullptr;
+
+    // API 1.7: Connected XInput slots. False until the loader's first probe has finished.
+    bool (*GetControllerPresence)(ControllerPresence* out) = nullptr;
+
+    // API 1.8: Runs the loader's frame limiter wait from the game's own throttle point (call it once
+    // per frame, in place of the game's Sleep). Frames that waited here skip the wait in Present.
+    // False, without waiting, if the limiter is off; keep the game's own throttling then.
+    bool (*WaitForFrameLimit)() = nullptr;
+
+    // API 1.9: Frame clock. False before the second Present.
+    bool (*GetFrameTiming)(FrameTiming* out) = nullptr;
 };
 
 // Each plugin must export this function. It should return a new instance of your plugin's main class.
@@ -6,6 +6,7 @@
 #include <Serialization/Utils/FileSystem.h>
 
 #include "PluginUtils.h"
+#include "Trace.h"
 
 namespace PluginConfig
 {
@@ -17,6 +18,7 @@ namespace PluginConfig
     template <class ConfigT>
     inline std::filesystem::path Load(ConfigT& config, const void* pluginEntryAddress)
     {
+        TRACE_SCOPE_CAT("PluginConfig::Load", "config");
         const auto hMod = PluginUtils::ModuleFromAddress(pluginEntryAddress);
         const auto modPath = PluginUtils::ModulePath(hMod);
         const auto rootDir = PluginUtils::ConfigRootDir(pluginEntryAddress);
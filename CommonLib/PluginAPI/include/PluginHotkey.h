@@ -0,0 +1,61 @@
+#pragma once
+
+#include "IPlugin.h"
+#include "KeyBind.h"
+
+// Keeps one loader hotkey registration in sync with a KeyBind that can be edited at runtime
+// (config UI, hot-reloaded config). Sync() is cheap when nothing changed, so call it every frame.
+class PluginHotkey
+{
+public:
+    using Callback = void (*)(void* userData, const HotkeyEventInfo& info);
+
+    PluginHotkey() = default;
+    ~PluginHotkey() { Reset(); }
+    PluginHotkey(const PluginHotkey&) = delete;
+    PluginHotkey& operator=(const PluginHotkey&) = delete;
+
+    static HotkeyDesc MakeDesc(const KeyBind& bind, uint32_t events, Callback callback, void* userData)
+    {
+        HotkeyDesc desc;
+        desc.keyboardKey = bind.KeyboardKey;
+        desc.ctrl = bind.Ctrl;
+        desc.shift = bind.Shift;
+        desc.alt = bind.Alt;
+        desc.controllerKey = bind.ControllerKey;
+        desc.events = events;
+        desc.callback = callback;
+        desc.userData = userData;
+        return desc;
+    }
+
+    // Registers on the first call and rebinds whenever `bind` differs from the previous call.
+    void Sync(const PluginLoaderInterface& loader, IPlugin* owner, const KeyBind& bind,
+              uint32_t events = HotkeyEvents::Pressed, Callback callback = nullptr, void* userData = nullptr)
+    {
+        if (m_handle && bind == m_bind)
+            return;
+        if (!loader.RegisterHotkey)
+            return;
+
+        m_loader = &loader;
+        m_bind = bind;
+        const HotkeyDesc desc = MakeDesc(bind, events, callback, userData);
+        if (!m_handle || !loader.UpdateHotkey(m_handle, desc))
+            m_handle = loader.RegisterHotkey(owner, desc);
+    }
+
+    bool IsDown() const { return m_handle && m_loader->IsHotkeyDown(m_handle); }
+
+    void Reset()
+    {
+        if (m_handle && m_loader && m_loader->UnregisterHotkey)
+            m_loader->UnregisterHotkey(m_handle);
+        m_handle = 0;
+    }
+
+private:
+    const PluginLoaderInterface* m_loader = nullptr;
+    HotkeyHandle m_handle = 0;
+    KeyBind m_bind;
+};
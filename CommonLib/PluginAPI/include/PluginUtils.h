@@ -15,11 +15,21 @@ namespace PluginUtils
         return hMod;
     }
 
+    // With hot reload the loader runs plugins from <plugins>/.shadow/<n>/<name>.asi; map that back
+    // to <plugins>/<name>.asi so configs and other files are found next to the original.
+    inline std::filesystem::path UnshadowPath(const std::filesystem::path& path)
+    {
+        const std::filesystem::path generationDir = path.parent_path();
+        if (generationDir.parent_path().filename() == ".shadow")
+            return generationDir.parent_path().parent_path() / path.filename();
+        return path;
+    }
+
     inline std::filesystem::path ModulePath(HMODULE module)
     {
         char buf[MAX_PATH]{};
         GetModuleFileNameA(module, buf, MAX_PATH);
-        return std::filesystem::path(buf);
+        return UnshadowPath(std::filesystem::path(buf));
     }
 
     inline std::filesystem::path ConfigRootDir(const void* anyAddressInModule)
@@ -1,9 +1,18 @@
 #pragma once
 #include <cstdint>
+#include "CpuTopology.h"
 
 namespace CpuAffinity
 {
     uint64_t GetSystemAffinityMask();
     uint64_t GetCurrentProcessMask();
     void Apply(uint64_t mask);
-}
\ No newline at end of file
+
+    // Layout of the logical processors in the process's group, from GetLogicalProcessorInformationEx.
+    // Read once; empty if the query failed.
+    const CpuTopology::Topology& GetTopology();
+
+    // CpuTopology::PlanAffinity over the system mask (default policy unless given). Falls back to
+    // the system mask if the topology is unknown.
+    uint64_t GetRecommendedMask(const CpuTopology::Policy& policy = {});
+}
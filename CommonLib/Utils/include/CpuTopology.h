@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Processor topology model and the affinity planner that works on it. No Windows dependency:
+// CpuAffinity fills a Topology from GetLogicalProcessorInformationEx, and recorded dumps
+// (Serialize/Parse) can be fed in on any platform.
+namespace CpuTopology
+{
+    struct LogicalProcessor
+    {
+        uint32_t index = 0;         // Bit in the affinity mask
+        uint32_t core = 0;          // Physical core; SMT siblings share it
+        uint32_t package = 0;
+        uint32_t l3 = 0;            // L3 domain (AMD CCX, or the whole die on most Intel parts)
+        uint32_t l3SizeKB = 0;      // 0 = unknown
+        uint8_t efficiencyClass = 0; // Higher = faster core (Intel P-cores > E-cores); 0 on non-hybrid CPUs
+    };
+
+    struct Topology
+    {
+        std::vector<LogicalProcessor> processors;
+
+        uint32_t CountCores() const;
+        bool HasSmt() const;
+        bool IsHybrid() const;
+    };
+
+    struct Policy
+    {
+        bool sameL3 = true;             // Keep all threads in one L3 domain
+        bool preferPerformance = true;  // Only the highest efficiency class
+        bool onePerCore = true;         // One logical processor per physical core
+        bool reserveFirstCore = true;   // Leave the core of CPU 0 (interrupts, DPCs) to the OS
+        uint32_t minCores = 4;          // Constraints are dropped in turn (sameL3, preferPerformance,
+                                        // reserveFirstCore) until at least this many cores are left
+    };
+
+    // The default with SMT siblings kept, for EaglePatch's affinity fix (AC2/ACB/ACR). The fix it
+    // replaced only took CPU 0 away; one thread per core would also halve what the game can run
+    // on (7 of 16 threads on an 8c/16t CPU instead of 14).
+    inline constexpr Policy kKeepSmtPolicy{ .onePerCore = false };
+
+    struct Plan
+    {
+        uint64_t mask = 0;
+        uint32_t cores = 0;
+        bool sameL3 = false;            // The constraints that were actually kept
+        bool preferPerformance = false;
+        bool reserveFirstCore = false;
+    };
+
+    // Only processors in `allowedMask` are considered. Never returns an empty mask while any
+    // allowed processor exists; falls back to `allowedMask` if the topology doesn't cover it.
+    Plan PlanAffinity(const Topology& topology, const Policy& policy, uint64_t allowedMask);
+
+    // Text dump, one logical processor per line:
+    //   cpu <index> core <n> package <n> l3 <n> l3kb <n> class <n>
+    // '#' starts a comment. Parse returns false (and sets `error`) on malformed input.
+    std::string Serialize(const Topology& topology);
+    bool Parse(const std::string& text, Topology& out, std::string* error = nullptr);
+
+    // One line for logs/tooltips, e.g. "1 package, 16 cores / 32 threads, 2 L3 domains".
+    std::string Describe(const Topology& topology);
+}
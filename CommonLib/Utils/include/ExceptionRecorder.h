@@ -0,0 +1,192 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free recorder for first-chance exceptions. The vectored handler runs on the faulting thread,
+// and code that probes memory (IsBadReadPtr) or uses SEH for control flow can raise thousands of
+// these a second, so recording must not lock, allocate or touch the disk. Two structures:
+// - Sites: per-(code, address) counters. A background drain turns them into one summary line per
+//   site per interval ("0xC0000005 at X x4123").
+// - Recent: an overwrite ring of the last raw records (code, address, thread, timestamp), only
+//   dumped when a crash goes unhandled.
+// Both are preallocated. Timestamps and thread ids come from the caller, so this is platform-free.
+class ExceptionRecorder
+{
+public:
+    static constexpr size_t kSiteCount = 512;
+    static constexpr size_t kRecentCount = 64;
+
+    struct Entry
+    {
+        uint32_t code = 0;
+        uint32_t threadId = 0;
+        uint64_t address = 0;
+        uint64_t timestamp = 0;
+    };
+
+    struct SiteSummary
+    {
+        uint32_t code;
+        uint64_t address;
+        uint32_t count;         // Since the previous drain
+        uint64_t total;         // Since the site was first seen
+        uint32_t lastThreadId;
+    };
+
+    // Producer side. Safe from any number of threads at once; never blocks.
+    void Add(uint32_t code, uint64_t address, uint32_t threadId, uint64_t timestamp)
+    {
+        m_added.fetch_add(1, std::memory_order_relaxed);
+        AddRecent(code, address, threadId, timestamp);
+        AddSite(code, address, threadId);
+    }
+
+    // Calls fn(const SiteSummary&) for every site hit since the previous drain and resets its counter.
+    // Single consumer: only one thread may drain.
+    template <typename Fn>
+    size_t DrainSites(Fn&& fn)
+    {
+        size_t reported = 0;
+        for (Site& site : m_sites)
+        {
+            if (site.state.load(std::memory_order_acquire) != kReady)
+                continue;
+
+            const uint32_t count = site.count.exchange(0, std::memory_order_relaxed);
+            if (count == 0)
+                continue;
+
+            site.total += count;
+            fn(SiteSummary{ site.code, site.address, count, site.total, site.lastThreadId.load(std::memory_order_relaxed) });
+            ++reported;
+        }
+        return reported;
+    }
+
+    // Calls fn(const Entry&) for the most recent records, oldest first. Slots being written
+    // concurrently are skipped rather than read torn.
+    template <typename Fn>
+    size_t ForEachRecent(Fn&& fn) const
+    {
+        const uint64_t head = m_recentHead.load(std::memory_order_acquire);
+        const uint64_t first = head > kRecentCount ? head - kRecentCount : 0;
+
+        size_t visited = 0;
+        for (uint64_t ticket = first; ticket < head; ++ticket)
+        {
+            const RecentSlot& slot = m_recent[ticket & (kRecentCount - 1)];
+            const uint64_t published = ticket * 2 + 2;
+            if (slot.seq.load(std::memory_order_acquire) != published)
+                continue;
+
+            // Acquire loads rather than a fence keep the re-check below after the reads; ThreadSanitizer
+            // understands these, and on x86 they are plain moves either way.
+            Entry entry;
+            entry.code = slot.code.load(std::memory_order_acquire);
+            entry.threadId = slot.threadId.load(std::memory_order_acquire);
+            entry.address = slot.address.load(std::memory_order_acquire);
+            entry.timestamp = slot.timestamp.load(std::memory_order_acquire);
+
+            if (slot.seq.load(std::memory_order_relaxed) != published)
+                continue;
+
+            fn(entry);
+            ++visited;
+        }
+        return visited;
+    }
+
+    uint64_t GetAddedCount() const { return m_added.load(std::memory_order_relaxed); }
+
+    // Exceptions whose site couldn't get a slot (table full), since the previous call.
+    uint64_t TakeUntrackedCount() { return m_untracked.exchange(0, std::memory_order_relaxed); }
+
+private:
+    static_assert((kSiteCount & (kSiteCount - 1)) == 0, "kSiteCount must be a power of two");
+    static_assert((kRecentCount & (kRecentCount - 1)) == 0, "kRecentCount must be a power of two");
+
+    static constexpr uint32_t kEmpty = 0;
+    static constexpr uint32_t kClaiming = 1;
+    static constexpr uint32_t kReady = 2;
+    static constexpr size_t kMaxProbes = 32;
+
+    struct Site
+    {
+        std::atomic<uint32_t> state{ kEmpty };
+        uint32_t code = 0;      // Written once while claiming, published by state = kReady
+        uint64_t address = 0;
+        std::atomic<uint32_t> count{ 0 };
+        std::atomic<uint32_t> lastThreadId{ 0 };
+        uint64_t total = 0;     // Drain-owned
+    };
+
+    // seq is 2 * ticket + 1 while a producer fills the slot and 2 * ticket + 2 once it's published.
+    struct RecentSlot
+    {
+        std::atomic<uint64_t> seq{ 0 };
+        std::atomic<uint32_t> code{ 0 };
+        std::atomic<uint32_t> threadId{ 0 };
+        std::atomic<uint64_t> address{ 0 };
+        std::atomic<uint64_t> timestamp{ 0 };
+    };
+
+    static size_t Hash(uint32_t code, uint64_t address)
+    {
+        const uint64_t h = (address ^ ((uint64_t)code << 32)) * 0x9E3779B97F4A7C15ull;
+        return (size_t)(h >> 32) & (kSiteCount - 1);
+    }
+
+    void AddRecent(uint32_t code, uint64_t address, uint32_t threadId, uint64_t timestamp)
+    {
+        const uint64_t ticket = m_recentHead.fetch_add(1, std::memory_order_relaxed);
+        RecentSlot& slot = m_recent[ticket & (kRecentCount - 1)];
+
+        // A producer that wrapped onto a slot still being written by a stalled one just drops its
+        // record; the site counters still see it.
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, ticket * 2 + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return;
+
+        slot.code.store(code, std::memory_order_relaxed);
+        slot.threadId.store(threadId, std::memory_order_relaxed);
+        slot.address.store(address, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        slot.seq.store(ticket * 2 + 2, std::memory_order_release);
+    }
+
+    void AddSite(uint32_t code, uint64_t address, uint32_t threadId)
+    {
+        size_t index = Hash(code, address);
+        for (size_t probe = 0; probe < kMaxProbes; ++probe, index = (index + 1) & (kSiteCount - 1))
+        {
+            Site& site = m_sites[index];
+            uint32_t state = site.state.load(std::memory_order_acquire);
+            if (state == kEmpty && site.state.compare_exchange_strong(state, kClaiming, std::memory_order_acquire))
+            {
+                site.code = code;
+                site.address = address;
+                site.state.store(kReady, std::memory_order_release);
+                state = kReady;
+            }
+
+            // Another producer is between claiming the slot and publishing its key: two plain stores.
+            for (int spin = 0; state == kClaiming && spin < 4096; ++spin)
+                state = site.state.load(std::memory_order_acquire);
+
+            if (state == kReady && site.code == code && site.address == address)
+            {
+                site.count.fetch_add(1, std::memory_order_relaxed);
+                site.lastThreadId.store(threadId, std::memory_order_relaxed);
+                return;
+            }
+        }
+        m_untracked.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Site m_sites[kSiteCount];
+    RecentSlot m_recent[kRecentCount];
+    std::atomic<uint64_t> m_recentHead{ 0 };
+    std::atomic<uint64_t> m_added{ 0 };
+    std::atomic<uint64_t> m_untracked{ 0 };
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdarg>
+#include <string_view>
+
+// Bump allocator for data that only has to live until the end of the current UI frame
+// (labels, formatted values, temporary ids). Allocation is a pointer increment; nothing
+// is freed individually. Reset() rewinds everything at once.
+//
+// When a frame needs more than one block, the extra blocks are merged into a single larger
+// block on the next Reset(), so a steady-state frame does no heap allocations at all.
+//
+// Not thread-safe: use the per-frame instance (FrameArena::Get()) from the render thread only.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t initialCapacity = 16 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Never returns nullptr. `align` must be a power of two.
+    void* Alloc(size_t size, size_t align = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocArray(size_t count) { return static_cast<T*>(Alloc(sizeof(T) * count, alignof(T))); }
+
+    // printf-style formatting into the arena. The result stays valid until the next Reset().
+    const char* Format(const char* fmt, ...);
+    const char* FormatV(const char* fmt, va_list args);
+
+    // Null-terminated copy of `str`.
+    const char* Copy(std::string_view str);
+
+    void Reset();
+
+    size_t GetUsed() const { return m_used; }
+    size_t GetPeakUsed() const { return m_peakUsed; }
+    size_t GetCapacity() const { return m_capacity; }
+    // Times a frame ran out of space and had to take another block from the heap.
+    size_t GetOverflowCount() const { return m_overflows; }
+
+    // The calling module's frame arena. Reset by BaseHook right after ImGui::NewFrame(); plugin
+    // modules have their own instance, which resets itself the first time it is used in a new
+    // ImGui frame.
+    static FrameArena& Get();
+
+    // Called by the render hooks after ImGui::NewFrame().
+    static void BeginFrame();
+
+private:
+    struct Block
+    {
+        Block* prev;
+        size_t size;
+        size_t offset;
+        // Payload follows the header.
+    };
+
+    Block* NewBlock(size_t minPayload);
+    static char* Payload(Block* block);
+
+    Block* m_current = nullptr;
+    size_t m_initialCapacity;
+    size_t m_used = 0;         // Bytes handed out since the last Reset()
+    size_t m_peakUsed = 0;
+    size_t m_capacity = 0;     // Sum of all block payloads
+    size_t m_overflows = 0;
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Edge-triggered hotkey matching over a packed input state. Platform-free: the loader feeds it key
+// messages and the pad state (see HotkeyRegistry); here it's just bits.
+
+// Everything a bind can refer to, as of one frame.
+struct InputSnapshot
+{
+    uint64_t keys[4] = {};     // One bit per virtual-key code
+    uint32_t padButtons = 0;   // XInput wButtons plus KeyBind::PAD_L_TRIGGER / PAD_R_TRIGGER
+
+    // Generic modifier codes (Shift/Ctrl/Alt) also count as down when either side is.
+    bool IsKeyDown(uint32_t vk) const;
+};
+
+// Key state written from the window thread, one message at a time, and read once per frame.
+// A key pressed and released between two snapshots still shows up as down in the next one, so
+// short taps aren't lost.
+class KeyStateTracker
+{
+public:
+    void SetKey(uint32_t vk, bool down);
+    void SetPadButtons(uint32_t buttons) { m_padButtons.store(buttons, std::memory_order_relaxed); }
+    // Focus lost: key-up messages won't arrive anymore.
+    void ReleaseAll();
+
+    InputSnapshot TakeSnapshot();
+
+private:
+    std::atomic<uint64_t> m_down[4] = {};
+    std::atomic<uint64_t> m_pressed[4] = {};   // Went down since the previous snapshot
+    std::atomic<uint32_t> m_padButtons{ 0 };
+};
+
+// Same fields and meaning as KeyBind.
+struct HotkeyChord
+{
+    uint32_t keyboardKey = 0;
+    bool ctrl = false;
+    bool shift = false;
+    bool alt = false;
+    uint32_t controllerKey = 0;
+    bool strict = false;    // Modifiers must match exactly instead of "at least"
+
+    bool operator==(const HotkeyChord& other) const
+    {
+        return keyboardKey == other.keyboardKey && ctrl == other.ctrl && shift == other.shift && alt == other.alt
+            && controllerKey == other.controllerKey && strict == other.strict;
+    }
+    bool operator!=(const HotkeyChord& other) const { return !(*this == other); }
+
+    // Keyboard part (key + modifiers) OR controller part (all buttons) held.
+    bool IsDown(const InputSnapshot& input) const;
+};
+
+namespace HotkeyMatchEvents
+{
+    constexpr uint32_t Pressed = 1;
+    constexpr uint32_t Released = 2;
+    constexpr uint32_t Held = 4;     // Every Match() while down, with the time held so far
+}
+
+class HotkeyMatcher
+{
+public:
+    struct Event
+    {
+        uint32_t id;
+        uint32_t event;     // One of HotkeyMatchEvents
+        uint64_t heldMs;    // Released/Held: how long the chord has been down
+    };
+
+    // Returns the new bind's id (never 0). `eventMask` selects which events Match() reports.
+    uint32_t Add(const HotkeyChord& chord, uint32_t eventMask);
+    // Rebinds. A chord that is already held when it's changed (e.g. right after capturing it in the
+    // UI) only fires once it has been released and pressed again.
+    bool SetChord(uint32_t id, const HotkeyChord& chord);
+    bool SetEventMask(uint32_t id, uint32_t eventMask);
+    bool Remove(uint32_t id);
+    bool IsDown(uint32_t id) const;
+    size_t GetCount() const { return m_binds.size(); }
+
+    // One pass over every bind: calls emit(const Event&) for each transition (and Held if asked for).
+    template <typename Fn>
+    void Match(const InputSnapshot& input, uint64_t nowMs, Fn&& emit)
+    {
+        for (Bind& bind : m_binds)
+        {
+            const bool active = bind.chord.IsDown(input);
+            if (bind.suppressed)
+            {
+                bind.suppressed = active;
+                continue;
+            }
+
+            if (active && !bind.down)
+            {
+                bind.down = true;
+                bind.downSinceMs = nowMs;
+                if (bind.eventMask & HotkeyMatchEvents::Pressed)
+                    emit(Event{ bind.id, HotkeyMatchEvents::Pressed, 0 });
+            }
+            else if (active)
+            {
+                if (bind.eventMask & HotkeyMatchEvents::Held)
+                    emit(Event{ bind.id, HotkeyMatchEvents::Held, nowMs - bind.downSinceMs });
+            }
+            else if (bind.down)
+            {
+                bind.down = false;
+                if (bind.eventMask & HotkeyMatchEvents::Released)
+                    emit(Event{ bind.id, HotkeyMatchEvents::Released, nowMs - bind.downSinceMs });
+            }
+        }
+    }
+
+private:
+    struct Bind
+    {
+        uint32_t id = 0;
+        uint32_t eventMask = 0;
+        HotkeyChord chord;
+        bool down = false;
+        bool suppressed = false;    // Wait for the chord to be released before reporting anything
+        uint64_t downSinceMs = 0;
+    };
+
+    Bind* Find(uint32_t id);
+    const Bind* Find(uint32_t id) const;
+
+    std::vector<Bind> m_binds;
+    uint32_t m_nextId = 1;
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include <imgui.h>
 #include <string_view>
+#include <cstdarg>
+#include "FrameArena.h"
 
 /*
 "CTX" as in "context manager".
@@ -260,4 +262,15 @@ namespace ImGuiCTX
             ImGui::EndDisabled();
         }
     };
+
+    // printf into the frame arena, for labels and ids that only live for this frame:
+    //   ImGui::Button(ImGuiCTX::Format("Save [%s]", bind.ToFrameString()))
+    inline const char* Format(const char* fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        const char* result = FrameArena::Get().FormatV(fmt, args);
+        va_end(args);
+        return result;
+    }
 }
\ No newline at end of file
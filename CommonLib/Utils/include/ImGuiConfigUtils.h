@@ -10,6 +10,9 @@ namespace ImGui {
 
 bool KeyBindInput(const char* label, KeyBind& keybind);
 
+// "<text> [<bind>]" in the frame arena, e.g. for buttons that show their hotkey.
+const char* KeyBindLabel(const char* text, const KeyBind& keybind);
+
 template<typename EnumType>
 bool DrawEnumPicker(const char* label, EnumType& currentValueInOut, ImGuiComboFlags flags = 0)
 {
@@ -1,6 +1,8 @@
 #pragma once
 #include <imgui.h>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 
 // Adapted from ImGui Demo's "Example App: Debug Console" & ACUFixes
 
@@ -24,6 +26,8 @@ public:
     void    DrawEmbedded(const char* title);
     void    DrawIfVisible(const char* title);
     void ToggleVisibility();
+    // Bumped whenever the log contents change; lets the overlay tell when a redraw is needed.
+    uint32_t GetRevision() const { return m_Revision.load(std::memory_order_relaxed); }
 
 private:
     void ExecCommand(const char* command_line);
@@ -44,6 +48,7 @@ private:
     ImVec2                m_LastWindowPos = ImVec2(100, 100);
     ImVec2                m_LastWindowSize = ImVec2(520, 600);
     bool                  m_IsTabbed = false;
+    std::atomic<uint32_t> m_Revision = 0;
 public:
     ConsoleMode           mode = ConsoleMode::Hidden;
 };
@@ -13,6 +13,8 @@ struct KeyBind
     // Pseudo-keys for Triggers (handled manually)
     static constexpr unsigned int PAD_L_TRIGGER = 0x10000;
     static constexpr unsigned int PAD_R_TRIGGER = 0x20000;
+    // DualShock 4 / DualSense touchpad click, reported by the Sony HID reader in a bit XInput doesn't use.
+    static constexpr unsigned int PAD_TOUCHPAD = 0x0800;
 
     unsigned int KeyboardKey = 0; // Virtual Key Code
     bool Ctrl = false;
@@ -48,6 +50,13 @@ struct KeyBind
     // Returns human readable string (e.g. "Ctrl + A / Pad LT+RT")
     std::string ToString() const;
 
+    // Same text as ToString() without heap allocations. Writes into `buf` (always null-terminated,
+    // truncated if needed) and returns the untruncated length.
+    size_t Format(char* buf, size_t bufSize) const;
+
+    // ToString() into the current frame arena. Valid until the next UI frame; for per-frame labels.
+    const char* ToFrameString() const;
+
     // Helper: Get human readable name for a VK code
     static std::string GetKeyName(unsigned int vk);
 
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Startup timeline built from trace spans (see Trace.h): nests them per thread, attributes each one
+// to the plugin it ran under, finds the chain of work that led to the first presented frame and
+// compares the result with the previous run. Platform-free; the loader feeds it a span snapshot.
+namespace StartupTimeline
+{
+    struct Span
+    {
+        std::string name;
+        std::string category;
+        std::string detail;
+        int64_t startUs = 0;
+        int64_t durationUs = 0;
+        uint32_t threadId = 0;
+
+        int64_t EndUs() const { return startUs + durationUs; }
+    };
+
+    struct Node
+    {
+        Span span;
+        std::string path;       // Labels of the ancestors and this span, " / " separated
+        std::string owner;      // Detail of the outermost "plugins" span around this one (the plugin file)
+        int parent = -1;
+        int depth = 0;
+        int64_t selfUs = 0;     // Duration minus the children's
+    };
+
+    // One stretch of the critical path. node is -1 for time no recorded span covers (the game's own
+    // startup, or threads we don't trace).
+    struct PathEntry
+    {
+        int node = -1;
+        int64_t startUs = 0;
+        int64_t durationUs = 0;
+    };
+
+    // What's stored between runs: time to the first frame, and the summed duration of every path.
+    struct Totals
+    {
+        int64_t totalUs = 0;
+        std::map<std::string, int64_t> pathUs;
+    };
+
+    class Timeline
+    {
+    public:
+        // Spans starting after endUs (the end of the first frame) are left out. The timeline starts
+        // at the earliest remaining span.
+        Timeline(std::vector<Span> spans, int64_t endUs);
+
+        const std::vector<Node>& GetNodes() const { return m_nodes; }
+        int64_t GetStartUs() const { return m_startUs; }
+        int64_t GetEndUs() const { return m_endUs; }
+
+        // Walks back from the end: at each point, the top-level span (any thread) that started
+        // before it and ran the longest into it is what startup was waiting on. In time order.
+        std::vector<PathEntry> GetCriticalPath() const;
+
+        Totals GetTotals() const;
+
+    private:
+        std::vector<Node> m_nodes;      // Grouped by thread, parents before children
+        int64_t m_startUs = 0;
+        int64_t m_endUs = 0;
+    };
+
+    // Text, one path per line: "<microseconds> <path>", after a "total <microseconds>" line.
+    std::string SerializeTotals(const Totals& totals);
+    bool ParseTotals(const std::string& text, Totals& out, std::string* error = nullptr);
+
+    struct DiffOptions
+    {
+        int64_t minDeltaUs = 20000;     // Both must be exceeded to count as a regression
+        double minRatio = 0.10;
+    };
+
+    struct Regression
+    {
+        std::string path;               // "(total)" for the time to the first frame
+        int64_t previousUs = 0;         // 0 if the path is new
+        int64_t currentUs = 0;
+    };
+
+    // Largest slowdown first, innermost span first among equal ones.
+    std::vector<Regression> FindRegressions(const Totals& previous, const Totals& current, const DiffOptions& options);
+
+    // Human-readable report: critical path ranked by how long it held up the first frame, the
+    // slowest spans on it, time per plugin and per hook, and regressions when `previous` is given.
+    std::string FormatReport(const Timeline& timeline, const Totals* previous, const DiffOptions& options);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <filesystem>
+#include <vector>
+
+// Lightweight scoped-span tracing.
+// Spans are recorded into per-thread buffers (no locking on the hot path) and can be
+// exported as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Usage:
+//   TRACE_SCOPE("LoadPlugins");
+//   TRACE_SCOPE_CAT("ResolveAll", "hooks");
+//   TRACE_SCOPE_DETAIL("OnPluginInit", "plugins", plugin.name.c_str());
+namespace Trace
+{
+    // Plugins forward their spans into the loader's recorder through this (see Log::InitSink).
+    using TraceSink = void(*)(const char* name, const char* category, const char* detail,
+                              int64_t startUs, int64_t durationUs, uint32_t threadId);
+
+    struct Event
+    {
+        char name[48];
+        char category[16];
+        char detail[64];
+        int64_t startUs;
+        int64_t durationUs;
+        uint32_t threadId;
+    };
+
+    // Monotonic microseconds. Shared by all modules in the process, so spans from plugins line up.
+    int64_t NowUs();
+    uint32_t CurrentThreadId();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+
+    // Route all spans recorded in this module to `sink` instead of the local buffers.
+    void InitSink(TraceSink sink);
+
+    // Names the calling thread in the exported trace.
+    void SetThreadName(const char* name);
+
+    void Record(const char* name, const char* category, const char* detail,
+                int64_t startUs, int64_t durationUs, uint32_t threadId);
+
+    size_t GetEventCount();
+    size_t GetDroppedCount();
+    // Copy of every span recorded so far, grouped by thread.
+    std::vector<Event> GetEvents();
+
+    std::string SerializeChromeJSON();
+    bool WriteChromeJSON(const std::filesystem::path& path);
+
+    class Scope
+    {
+    public:
+        Scope(const char* name, const char* category = nullptr, const char* detail = nullptr)
+            : m_name(name), m_category(category), m_detail(detail),
+              m_startUs(IsEnabled() ? NowUs() : -1) {}
+
+        ~Scope()
+        {
+            if (m_startUs >= 0)
+                Record(m_name, m_category, m_detail, m_startUs, NowUs() - m_startUs, CurrentThreadId());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        const char* m_detail;
+        int64_t m_startUs;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(_traceScope, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) Trace::Scope TRACE_CONCAT(_traceScope, __LINE__)(name, category)
+#define TRACE_SCOPE_DETAIL(name, category, detail) Trace::Scope TRACE_CONCAT(_traceScope, __LINE__)(name, category, detail)
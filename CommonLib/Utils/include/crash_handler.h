@@ -6,6 +6,9 @@ namespace CrashHandler
 {
 	void Init();
 	void Shutdown();
+	// Resolve crash call stacks in-process with dbghelp (on by default). When off, crash reports
+	// only contain raw frames and the module list, for symbolize_crash.py to resolve offline.
+	void SetSymbolizeCrashes(bool enabled);
 }
 
 #endif
@@ -50,4 +50,109 @@ namespace CpuAffinity
             LOG_INFO("CpuAffinity: Applied mask 0x%llX (Active Cores: %d).", mask, count);
         }
     }
+
+    namespace
+    {
+        // Only group 0: the affinity masks handled here are single-group masks anyway.
+        template<typename Fn>
+        void ForEachBit(const GROUP_AFFINITY& affinity, Fn&& fn)
+        {
+            if (affinity.Group != 0)
+                return;
+            for (uint32_t i = 0; i < sizeof(KAFFINITY) * 8; ++i)
+            {
+                if ((affinity.Mask >> i) & 1)
+                    fn(i);
+            }
+        }
+
+        CpuTopology::Topology QueryTopology()
+        {
+            CpuTopology::Topology topology;
+
+            DWORD size = 0;
+            GetLogicalProcessorInformationEx(RelationAll, nullptr, &size);
+            if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || size == 0)
+            {
+                LOG_WARN("CpuAffinity: GetLogicalProcessorInformationEx failed. Error: %lu", GetLastError());
+                return topology;
+            }
+
+            std::vector<uint8_t> buffer(size);
+            auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+            if (!GetLogicalProcessorInformationEx(RelationAll, info, &size))
+            {
+                LOG_WARN("CpuAffinity: GetLogicalProcessorInformationEx failed. Error: %lu", GetLastError());
+                return topology;
+            }
+
+            // Indexed by logical processor; filled in by whichever relationship mentions it.
+            CpuTopology::LogicalProcessor processors[64] = {};
+            bool present[64] = {};
+            uint32_t coreId = 0, packageId = 0, l3Id = 0;
+
+            for (DWORD offset = 0; offset < size;)
+            {
+                const auto* entry = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+                switch (entry->Relationship)
+                {
+                case RelationProcessorCore:
+                    ForEachBit(entry->Processor.GroupMask[0], [&](uint32_t i) {
+                        present[i] = true;
+                        processors[i].index = i;
+                        processors[i].core = coreId;
+                        processors[i].efficiencyClass = entry->Processor.EfficiencyClass;
+                    });
+                    ++coreId;
+                    break;
+                case RelationProcessorPackage:
+                    for (WORD g = 0; g < entry->Processor.GroupCount; ++g)
+                        ForEachBit(entry->Processor.GroupMask[g], [&](uint32_t i) { processors[i].package = packageId; });
+                    ++packageId;
+                    break;
+                case RelationCache:
+                    if (entry->Cache.Level == 3)
+                    {
+                        ForEachBit(entry->Cache.GroupMask, [&](uint32_t i) {
+                            processors[i].l3 = l3Id;
+                            processors[i].l3SizeKB = entry->Cache.CacheSize / 1024;
+                        });
+                        ++l3Id;
+                    }
+                    break;
+                default:
+                    break;
+                }
+                offset += entry->Size;
+            }
+
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                if (present[i])
+                    topology.processors.push_back(processors[i]);
+            }
+            return topology;
+        }
+    }
+
+    const CpuTopology::Topology& GetTopology()
+    {
+        static const CpuTopology::Topology topology = [] {
+            CpuTopology::Topology t = QueryTopology();
+            LOG_INFO("CpuAffinity: %s.", CpuTopology::Describe(t).c_str());
+            return t;
+        }();
+        return topology;
+    }
+
+    uint64_t GetRecommendedMask(const CpuTopology::Policy& policy)
+    {
+        const uint64_t systemMask = GetSystemAffinityMask();
+        const CpuTopology::Plan plan = CpuTopology::PlanAffinity(GetTopology(), policy, systemMask);
+        LOG_INFO("CpuAffinity: Planned mask 0x%llX (%u cores%s%s%s).", plan.mask, plan.cores,
+                 plan.sameL3 ? ", one L3" : "",
+                 plan.preferPerformance ? ", fastest class" : "",
+                 plan.reserveFirstCore ? ", core 0 left free" : "");
+        return plan.mask;
+    }
 }
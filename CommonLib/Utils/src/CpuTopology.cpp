@@ -0,0 +1,288 @@
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <sstream>
+
+namespace CpuTopology
+{
+    namespace
+    {
+        struct Core
+        {
+            uint32_t id = 0;
+            uint32_t l3 = 0;
+            uint32_t l3SizeKB = 0;
+            uint8_t efficiencyClass = 0;
+            uint64_t threads = 0;   // Allowed logical processors of this core
+        };
+
+        uint64_t LowestBit(uint64_t mask) { return mask & (~mask + 1); }
+
+        // Physical cores with at least one allowed logical processor, in core id order.
+        std::vector<Core> CollectCores(const Topology& topology, uint64_t allowedMask)
+        {
+            std::vector<Core> cores;
+            for (const LogicalProcessor& lp : topology.processors)
+            {
+                if (lp.index >= 64 || !((allowedMask >> lp.index) & 1ULL))
+                    continue;
+
+                auto it = std::find_if(cores.begin(), cores.end(), [&](const Core& c) { return c.id == lp.core; });
+                if (it == cores.end())
+                {
+                    Core core;
+                    core.id = lp.core;
+                    core.l3 = lp.l3;
+                    core.l3SizeKB = lp.l3SizeKB;
+                    core.efficiencyClass = lp.efficiencyClass;
+                    cores.push_back(core);
+                    it = cores.end() - 1;
+                }
+                it->threads |= 1ULL << lp.index;
+            }
+            std::sort(cores.begin(), cores.end(), [](const Core& a, const Core& b) { return a.id < b.id; });
+            return cores;
+        }
+
+        std::vector<const Core*> Select(const std::vector<Core>& cores, uint32_t firstCore, bool haveFirstCore,
+                                        bool sameL3, bool preferPerformance, bool reserveFirstCore, uint32_t minCores)
+        {
+            std::vector<const Core*> picked;
+            for (const Core& core : cores)
+            {
+                if (reserveFirstCore && haveFirstCore && core.id == firstCore)
+                    continue;
+                picked.push_back(&core);
+            }
+
+            if (preferPerformance && !picked.empty())
+            {
+                uint8_t best = 0;
+                for (const Core* core : picked)
+                    best = std::max(best, core->efficiencyClass);
+                picked.erase(std::remove_if(picked.begin(), picked.end(),
+                    [best](const Core* c) { return c->efficiencyClass != best; }), picked.end());
+            }
+
+            if (sameL3 && !picked.empty())
+            {
+                // Among the domains that are big enough, the one with the most cache (X3D CCDs),
+                // then the most cores.
+                std::set<uint32_t> domains;
+                for (const Core* core : picked)
+                    domains.insert(core->l3);
+
+                uint32_t bestDomain = *domains.begin();
+                bool bestBigEnough = false;
+                uint32_t bestSize = 0, bestCount = 0;
+                for (uint32_t domain : domains)
+                {
+                    uint32_t count = 0, size = 0;
+                    for (const Core* core : picked)
+                    {
+                        if (core->l3 != domain) continue;
+                        ++count;
+                        size = std::max(size, core->l3SizeKB);
+                    }
+                    const bool bigEnough = count >= minCores;
+                    const bool better = bigEnough != bestBigEnough ? bigEnough
+                                      : size != bestSize ? size > bestSize
+                                      : count > bestCount;
+                    if (domain == *domains.begin() || better)
+                    {
+                        bestDomain = domain;
+                        bestBigEnough = bigEnough;
+                        bestSize = size;
+                        bestCount = count;
+                    }
+                }
+                picked.erase(std::remove_if(picked.begin(), picked.end(),
+                    [bestDomain](const Core* c) { return c->l3 != bestDomain; }), picked.end());
+            }
+            return picked;
+        }
+    }
+
+    uint32_t Topology::CountCores() const
+    {
+        std::set<uint32_t> cores;
+        for (const LogicalProcessor& lp : processors)
+            cores.insert(lp.core);
+        return static_cast<uint32_t>(cores.size());
+    }
+
+    bool Topology::HasSmt() const
+    {
+        return CountCores() < processors.size();
+    }
+
+    bool Topology::IsHybrid() const
+    {
+        for (const LogicalProcessor& lp : processors)
+        {
+            if (lp.efficiencyClass != processors.front().efficiencyClass)
+                return true;
+        }
+        return false;
+    }
+
+    Plan PlanAffinity(const Topology& topology, const Policy& policy, uint64_t allowedMask)
+    {
+        Plan plan;
+        const std::vector<Core> cores = CollectCores(topology, allowedMask);
+        if (cores.empty())
+        {
+            plan.mask = allowedMask;
+            return plan;
+        }
+
+        // "Core 0" is whichever physical core holds the lowest-numbered logical processor.
+        uint32_t firstCore = 0;
+        uint32_t firstIndex = UINT32_MAX;
+        for (const LogicalProcessor& lp : topology.processors)
+        {
+            if (lp.index < firstIndex)
+            {
+                firstIndex = lp.index;
+                firstCore = lp.core;
+            }
+        }
+        const bool haveFirstCore = firstIndex != UINT32_MAX;
+
+        bool sameL3 = policy.sameL3;
+        bool preferPerformance = policy.preferPerformance;
+        bool reserveFirstCore = policy.reserveFirstCore;
+        std::vector<const Core*> picked;
+        for (;;)
+        {
+            picked = Select(cores, firstCore, haveFirstCore, sameL3, preferPerformance, reserveFirstCore, policy.minCores);
+            if (picked.size() >= policy.minCores)
+                break;
+
+            if (sameL3) sameL3 = false;
+            else if (preferPerformance) preferPerformance = false;
+            else if (reserveFirstCore) reserveFirstCore = false;
+            else break;
+        }
+
+        for (const Core* core : picked)
+            plan.mask |= policy.onePerCore ? LowestBit(core->threads) : core->threads;
+
+        if (plan.mask == 0)
+        {
+            plan.mask = allowedMask;
+            return plan;
+        }
+
+        plan.cores = static_cast<uint32_t>(picked.size());
+        plan.sameL3 = sameL3;
+        plan.preferPerformance = preferPerformance;
+        plan.reserveFirstCore = reserveFirstCore;
+        return plan;
+    }
+
+    std::string Serialize(const Topology& topology)
+    {
+        std::string text;
+        char line[128];
+        for (const LogicalProcessor& lp : topology.processors)
+        {
+            snprintf(line, sizeof(line), "cpu %u core %u package %u l3 %u l3kb %u class %u\n",
+                     lp.index, lp.core, lp.package, lp.l3, lp.l3SizeKB, static_cast<unsigned>(lp.efficiencyClass));
+            text += line;
+        }
+        return text;
+    }
+
+    bool Parse(const std::string& text, Topology& out, std::string* error)
+    {
+        auto fail = [&](int lineNo, const std::string& what) {
+            if (error)
+                *error = "line " + std::to_string(lineNo) + ": " + what;
+            return false;
+        };
+
+        Topology topology;
+        std::istringstream lines(text);
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(lines, line))
+        {
+            ++lineNo;
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos)
+                line.erase(comment);
+
+            std::istringstream tokens(line);
+            std::string key;
+            if (!(tokens >> key))
+                continue;
+            if (key != "cpu")
+                return fail(lineNo, "expected 'cpu', got '" + key + "'");
+
+            LogicalProcessor lp;
+            unsigned long long value = 0;
+            if (!(tokens >> value) || value >= 64)
+                return fail(lineNo, "bad cpu index");
+            lp.index = static_cast<uint32_t>(value);
+
+            while (tokens >> key)
+            {
+                if (!(tokens >> value))
+                    return fail(lineNo, "missing value for '" + key + "'");
+
+                if (key == "core") lp.core = static_cast<uint32_t>(value);
+                else if (key == "package") lp.package = static_cast<uint32_t>(value);
+                else if (key == "l3") lp.l3 = static_cast<uint32_t>(value);
+                else if (key == "l3kb") lp.l3SizeKB = static_cast<uint32_t>(value);
+                else if (key == "class" && value <= 255) lp.efficiencyClass = static_cast<uint8_t>(value);
+                else return fail(lineNo, "unknown field '" + key + "'");
+            }
+
+            for (const LogicalProcessor& existing : topology.processors)
+            {
+                if (existing.index == lp.index)
+                    return fail(lineNo, "duplicate cpu " + std::to_string(lp.index));
+            }
+            topology.processors.push_back(lp);
+        }
+
+        std::sort(topology.processors.begin(), topology.processors.end(),
+                  [](const LogicalProcessor& a, const LogicalProcessor& b) { return a.index < b.index; });
+        out = std::move(topology);
+        return true;
+    }
+
+    std::string Describe(const Topology& topology)
+    {
+        if (topology.processors.empty())
+            return "unknown topology";
+
+        std::set<uint32_t> packages, l3Domains, performanceCores, allCores;
+        uint8_t best = 0;
+        for (const LogicalProcessor& lp : topology.processors)
+            best = std::max(best, lp.efficiencyClass);
+        for (const LogicalProcessor& lp : topology.processors)
+        {
+            packages.insert(lp.package);
+            l3Domains.insert(lp.l3);
+            allCores.insert(lp.core);
+            if (lp.efficiencyClass == best)
+                performanceCores.insert(lp.core);
+        }
+
+        char text[160];
+        int len = snprintf(text, sizeof(text), "%zu package%s, %zu cores / %zu threads, %zu L3 domain%s",
+                           packages.size(), packages.size() == 1 ? "" : "s",
+                           allCores.size(), topology.processors.size(),
+                           l3Domains.size(), l3Domains.size() == 1 ? "" : "s");
+        if (topology.IsHybrid() && len > 0 && static_cast<size_t>(len) < sizeof(text))
+        {
+            snprintf(text + len, sizeof(text) - len, " (%zuP + %zuE)",
+                     performanceCores.size(), allCores.size() - performanceCores.size());
+        }
+        return text;
+    }
+}
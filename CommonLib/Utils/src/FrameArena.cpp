@@ -0,0 +1,172 @@
+#include "FrameArena.h"
+#include "imgui.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    constexpr size_t kMaxAlign = alignof(std::max_align_t);
+
+    constexpr size_t AlignUp(size_t value, size_t align) { return (value + align - 1) & ~(align - 1); }
+
+    int g_ArenaFrame = -1; // ImGui frame the arena was last reset for
+}
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : m_initialCapacity(initialCapacity ? initialCapacity : 1024)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    while (m_current)
+    {
+        Block* prev = m_current->prev;
+        std::free(m_current);
+        m_current = prev;
+    }
+}
+
+char* FrameArena::Payload(Block* block)
+{
+    return reinterpret_cast<char*>(block) + AlignUp(sizeof(Block), kMaxAlign);
+}
+
+FrameArena::Block* FrameArena::NewBlock(size_t minPayload)
+{
+    const size_t payload = AlignUp(minPayload, kMaxAlign);
+    Block* block = static_cast<Block*>(std::malloc(AlignUp(sizeof(Block), kMaxAlign) + payload));
+    if (!block)
+        throw std::bad_alloc();
+
+    block->prev = m_current;
+    block->size = payload;
+    block->offset = 0;
+    m_current = block;
+    m_capacity += payload;
+    return block;
+}
+
+void* FrameArena::Alloc(size_t size, size_t align)
+{
+    if (align < 1)
+        align = 1;
+
+    if (!m_current)
+        NewBlock(m_initialCapacity > size + align ? m_initialCapacity : size + align);
+
+    char* base = Payload(m_current);
+    uintptr_t start = reinterpret_cast<uintptr_t>(base) + m_current->offset;
+    size_t padding = AlignUp(start, align) - start;
+
+    if (m_current->offset + padding + size > m_current->size)
+    {
+        // Grow geometrically so a frame that keeps overflowing settles after a few blocks.
+        const size_t grown = m_current->size * 2;
+        NewBlock(grown > size + align ? grown : size + align);
+        ++m_overflows;
+
+        base = Payload(m_current);
+        start = reinterpret_cast<uintptr_t>(base);
+        padding = AlignUp(start, align) - start;
+    }
+
+    char* result = base + m_current->offset + padding;
+    m_current->offset += padding + size;
+    m_used += padding + size;
+    if (m_used > m_peakUsed)
+        m_peakUsed = m_used;
+    return result;
+}
+
+const char* FrameArena::Format(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const char* result = FormatV(fmt, args);
+    va_end(args);
+    return result;
+}
+
+const char* FrameArena::FormatV(const char* fmt, va_list args)
+{
+    va_list retry;
+    va_copy(retry, args);
+
+    // Try to format straight into the free tail of the current block; only fall back to
+    // measuring + a real allocation when it doesn't fit.
+    char* dst = m_current ? Payload(m_current) + m_current->offset : nullptr;
+    const size_t avail = m_current ? m_current->size - m_current->offset : 0;
+    const int len = std::vsnprintf(dst, avail, fmt, args);
+
+    const char* result = "";
+    if (len >= 0 && static_cast<size_t>(len) < avail)
+    {
+        result = static_cast<const char*>(Alloc(static_cast<size_t>(len) + 1, 1)); // == dst
+    }
+    else if (len >= 0)
+    {
+        char* buf = static_cast<char*>(Alloc(static_cast<size_t>(len) + 1, 1));
+        std::vsnprintf(buf, static_cast<size_t>(len) + 1, fmt, retry);
+        result = buf;
+    }
+
+    va_end(retry);
+    return result;
+}
+
+const char* FrameArena::Copy(std::string_view str)
+{
+    char* buf = static_cast<char*>(Alloc(str.size() + 1, 1));
+    std::memcpy(buf, str.data(), str.size());
+    buf[str.size()] = '\0';
+    return buf;
+}
+
+void FrameArena::Reset()
+{
+    if (m_current && m_current->prev)
+    {
+        // Last frame overflowed: replace the chain with one block big enough for all of it.
+        const size_t total = m_capacity;
+        while (m_current)
+        {
+            Block* prev = m_current->prev;
+            std::free(m_current);
+            m_current = prev;
+        }
+        m_capacity = 0;
+        NewBlock(total);
+    }
+    else if (m_current)
+    {
+        m_current->offset = 0;
+    }
+    m_used = 0;
+}
+
+FrameArena& FrameArena::Get()
+{
+    static FrameArena s_arena;
+
+    // Plugins never see BeginFrame() (it runs in the loader's copy of this code), so follow
+    // the shared ImGui frame counter instead.
+    if (ImGui::GetCurrentContext())
+    {
+        const int frame = ImGui::GetFrameCount();
+        if (frame != g_ArenaFrame)
+        {
+            g_ArenaFrame = frame;
+            s_arena.Reset();
+        }
+    }
+    return s_arena;
+}
+
+void FrameArena::BeginFrame()
+{
+    Get();
+}
@@ -0,0 +1,135 @@
+#include "HotkeyMatcher.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Virtual-key codes, spelled out so this file doesn't need <windows.h>.
+    constexpr uint32_t kVkShift = 0x10, kVkControl = 0x11, kVkMenu = 0x12;
+    constexpr uint32_t kVkLShift = 0xA0, kVkRShift = 0xA1;
+    constexpr uint32_t kVkLControl = 0xA2, kVkRControl = 0xA3;
+    constexpr uint32_t kVkLMenu = 0xA4, kVkRMenu = 0xA5;
+
+    bool TestBit(const uint64_t (&keys)[4], uint32_t vk)
+    {
+        return vk < 256 && (keys[vk >> 6] >> (vk & 63)) & 1;
+    }
+}
+
+bool InputSnapshot::IsKeyDown(uint32_t vk) const
+{
+    switch (vk)
+    {
+    case kVkShift:   return TestBit(keys, kVkShift) || TestBit(keys, kVkLShift) || TestBit(keys, kVkRShift);
+    case kVkControl: return TestBit(keys, kVkControl) || TestBit(keys, kVkLControl) || TestBit(keys, kVkRControl);
+    case kVkMenu:    return TestBit(keys, kVkMenu) || TestBit(keys, kVkLMenu) || TestBit(keys, kVkRMenu);
+    default:         return TestBit(keys, vk);
+    }
+}
+
+void KeyStateTracker::SetKey(uint32_t vk, bool down)
+{
+    if (vk >= 256)
+        return;
+
+    const uint64_t bit = 1ull << (vk & 63);
+    if (down)
+    {
+        m_down[vk >> 6].fetch_or(bit, std::memory_order_relaxed);
+        m_pressed[vk >> 6].fetch_or(bit, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_down[vk >> 6].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+void KeyStateTracker::ReleaseAll()
+{
+    for (auto& word : m_down)
+        word.store(0, std::memory_order_relaxed);
+}
+
+InputSnapshot KeyStateTracker::TakeSnapshot()
+{
+    InputSnapshot snapshot;
+    for (size_t i = 0; i < 4; ++i)
+        snapshot.keys[i] = m_down[i].load(std::memory_order_relaxed) | m_pressed[i].exchange(0, std::memory_order_relaxed);
+    snapshot.padButtons = m_padButtons.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+bool HotkeyChord::IsDown(const InputSnapshot& input) const
+{
+    if (controllerKey != 0 && (input.padButtons & controllerKey) == controllerKey)
+        return true;
+
+    if (keyboardKey == 0 || !input.IsKeyDown(keyboardKey))
+        return false;
+
+    const bool c = input.IsKeyDown(kVkControl);
+    const bool s = input.IsKeyDown(kVkShift);
+    const bool a = input.IsKeyDown(kVkMenu);
+    if (strict)
+        return ctrl == c && shift == s && alt == a;
+    return (!ctrl || c) && (!shift || s) && (!alt || a);
+}
+
+uint32_t HotkeyMatcher::Add(const HotkeyChord& chord, uint32_t eventMask)
+{
+    Bind bind;
+    bind.id = m_nextId++;
+    bind.eventMask = eventMask;
+    bind.chord = chord;
+    m_binds.push_back(bind);
+    return bind.id;
+}
+
+bool HotkeyMatcher::SetChord(uint32_t id, const HotkeyChord& chord)
+{
+    Bind* bind = Find(id);
+    if (!bind)
+        return false;
+    if (bind->chord == chord)
+        return true;
+
+    bind->chord = chord;
+    bind->down = false;
+    bind->suppressed = true;
+    return true;
+}
+
+bool HotkeyMatcher::SetEventMask(uint32_t id, uint32_t eventMask)
+{
+    Bind* bind = Find(id);
+    if (!bind)
+        return false;
+    bind->eventMask = eventMask;
+    return true;
+}
+
+bool HotkeyMatcher::Remove(uint32_t id)
+{
+    auto it = std::find_if(m_binds.begin(), m_binds.end(), [id](const Bind& bind) { return bind.id == id; });
+    if (it == m_binds.end())
+        return false;
+    m_binds.erase(it);
+    return true;
+}
+
+bool HotkeyMatcher::IsDown(uint32_t id) const
+{
+    const Bind* bind = Find(id);
+    return bind && bind->down;
+}
+
+HotkeyMatcher::Bind* HotkeyMatcher::Find(uint32_t id)
+{
+    auto it = std::find_if(m_binds.begin(), m_binds.end(), [id](const Bind& bind) { return bind.id == id; });
+    return it != m_binds.end() ? &*it : nullptr;
+}
+
+const HotkeyMatcher::Bind* HotkeyMatcher::Find(uint32_t id) const
+{
+    return const_cast<HotkeyMatcher*>(this)->Find(id);
+}
@@ -1,20 +1,20 @@
 #include "ImGuiConfigUtils.h"
 #include "imgui_internal.h"
 #include "KeyBind.h"
+#include "FrameArena.h"
 #include <Windows.h>
 #include <xinput.h>
 #include <vector>
 #include <cstring>
-#include <string>
 
 namespace ImGui {
 
     bool KeyBindInput(const char* label, KeyBind& keybind)
     {
         bool changed = false;
-        std::string labelStr = label;
-        std::string idStr = "##" + labelStr;
-        ImGuiID id = ImGui::GetID(idStr.c_str());
+        FrameArena& arena = FrameArena::Get();
+        const char* idStr = arena.Format("##%s", label);
+        ImGuiID id = ImGui::GetID(idStr);
 
         // Shared state for live preview during capture
         static unsigned int s_accumulatedButtons = 0;
@@ -38,29 +38,25 @@ namespace ImGui {
         }
 
         // Determine display string for preview
-        std::string valueStr;
+        char buf[128];
         if (is_active && s_capturingPad && s_accumulatedButtons != 0)
         {
             // Create a temp object with current real KB bind + accumulated Pad bind for visualization
             KeyBind temp = keybind;
             temp.ControllerKey = s_accumulatedButtons;
-            valueStr = temp.ToString();
+            temp.Format(buf, sizeof(buf));
         }
         else
         {
-            valueStr = keybind.ToString();
+            keybind.Format(buf, sizeof(buf));
         }
 
-        char buf[128];
-        // Use standard copy to avoid MSVC specific warnings if compiling elsewhere, but keep simple
-        strncpy_s(buf, valueStr.c_str(), _TRUNCATE);
-
         // Pre-emptive blocking of Gamepad Navigation
         // If we are currently active (based on previous frame), we block ImGui from seeing gamepad keys
         // so it doesn't navigate away or consume 'A'/'B'.
         if (s_currentActiveID == id)
         {
-            ImGuiID blockerId = ImGui::GetID((idStr + "_Blocker").c_str());
+            ImGuiID blockerId = ImGui::GetID(arena.Format("%s_Blocker", idStr));
             for (int key = ImGuiKey_Gamepad_BEGIN; key < ImGuiKey_Gamepad_END; key++)
             {
                 ImGui::SetKeyOwner((ImGuiKey)key, blockerId, ImGuiInputFlags_LockThisFrame);
@@ -68,7 +64,7 @@ namespace ImGui {
         }
 
         // Read-only input box. Used to capture focus and display text.
-        ImGui::InputText(idStr.c_str(), buf, sizeof(buf), ImGuiInputTextFlags_ReadOnly | ImGuiInputTextFlags_NoUndoRedo);
+        ImGui::InputText(idStr, buf, sizeof(buf), ImGuiInputTextFlags_ReadOnly | ImGuiInputTextFlags_NoUndoRedo);
         
         // Tooltip
         if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
@@ -162,4 +158,11 @@ namespace ImGui {
 
         return changed;
     }
+
+    const char* KeyBindLabel(const char* text, const KeyBind& keybind)
+    {
+        char bindBuf[128];
+        keybind.Format(bindBuf, sizeof(bindBuf));
+        return FrameArena::Get().Format("%s [%s]", text, bindBuf);
+    }
 }
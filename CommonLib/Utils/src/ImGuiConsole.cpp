@@ -1,5 +1,6 @@
 #include "ImGuiConsole.h"
 #include <imgui_internal.h>
+#include "FrameArena.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstdarg>
@@ -37,12 +38,14 @@ void ImGuiConsole::ClearLog()
     for (int i = 0; i < m_Items.Size; i++)
         free(m_Items[i]);
     m_Items.clear();
+    m_Revision++;
 }
 
 void ImGuiConsole::AddLog(const char* s)
 {
     std::lock_guard<std::recursive_mutex> lock(m_Mutex);
     m_Items.push_back(_strdup(s));
+    m_Revision++;
 }
 
 void ImGuiConsole::AddLogF(const char* fmt, ...)
@@ -277,11 +280,11 @@ void ImGuiConsole::DrawIfVisible(const char* title)
 
     // Ensure unique ID for the window so it doesn't conflict if we have multiple instances (though this is a singleton)
     // We also use a different ID for the background mode so that it doesn't mess up the docking state of the main window.
-    std::string windowTitle = title;
+    const char* windowTitle = title;
     if (mode == ConsoleMode::BackgroundSemitransparentAndUnfocusable)
-        windowTitle += "##Overlay";
+        windowTitle = FrameArena::Get().Format("%s##Overlay", title);
 
-    if (!ImGui::Begin(windowTitle.c_str(), nullptr, window_flags))
+    if (!ImGui::Begin(windowTitle, nullptr, window_flags))
     {
         ImGui::End();
         return;
@@ -1,4 +1,5 @@
 #include "KeyBind.h"
+#include "FrameArena.h"
 #include <Windows.h>
 #include <xinput.h>
 #include <cstdio>
@@ -52,40 +53,96 @@ static const char* g_KeyNames[256] = {
     "", "", "", "", "", "", "Attn", "CrSel", "ExSel", "Erase EOF", "Play", "Zoom", "", "PA1", "OEM Clear", ""
 };
 
-std::string KeyBind::GetKeyName(unsigned int vk)
+// Writes the key name for `vk` into `buf` (falls back to the hex code)
+static const char* KeyNameOrHex(unsigned int vk, char (&buf)[16])
 {
     if (vk >= 256) return "Unknown";
     const char* name = g_KeyNames[vk];
     if (name && *name) return name;
-    
-    char buf[16];
+
     snprintf(buf, sizeof(buf), "0x%02X", vk);
     return buf;
 }
 
+std::string KeyBind::GetKeyName(unsigned int vk)
+{
+    char buf[16];
+    return KeyNameOrHex(vk, buf);
+}
+
+namespace
+{
+    // Appends into a fixed buffer, keeping track of the length the full string would have.
+    struct TextWriter
+    {
+        char* buf;
+        size_t size;
+        size_t len = 0;
+
+        void Append(const char* s)
+        {
+            for (; *s; ++s, ++len)
+            {
+                if (len + 1 < size)
+                    buf[len] = *s;
+            }
+            if (size)
+                buf[len < size ? len : size - 1] = '\0';
+        }
+    };
+}
+
 std::string KeyBind::ToString() const
 {
-    std::string str;
-    
+    char buf[128];
+    const size_t len = Format(buf, sizeof(buf));
+    if (len < sizeof(buf))
+        return buf;
+
+    std::string str(len, '\0');
+    Format(str.data(), len + 1);
+    return str;
+}
+
+const char* KeyBind::ToFrameString() const
+{
+    FrameArena& arena = FrameArena::Get();
+    char buf[128];
+    const size_t len = Format(buf, sizeof(buf));
+    if (len < sizeof(buf))
+        return arena.Copy(std::string_view(buf, len));
+
+    char* str = arena.AllocArray<char>(len + 1);
+    Format(str, len + 1);
+    return str;
+}
+
+size_t KeyBind::Format(char* buf, size_t bufSize) const
+{
+    TextWriter str{ buf, bufSize };
+    if (bufSize)
+        buf[0] = '\0';
+
     // Keyboard Part
     if (KeyboardKey != 0)
     {
-        if (Ctrl) str += "Ctrl + ";
-        if (Shift) str += "Shift + ";
-        if (Alt) str += "Alt + ";
-        str += GetKeyName(KeyboardKey);
+        if (Ctrl) str.Append("Ctrl + ");
+        if (Shift) str.Append("Shift + ");
+        if (Alt) str.Append("Alt + ");
+        char nameBuf[16];
+        str.Append(KeyNameOrHex(KeyboardKey, nameBuf));
     }
 
     // Controller Part
     if (ControllerKey != 0)
     {
-        if (!str.empty()) str += " / ";
+        if (str.len != 0) str.Append(" / ");
         
-        str += "Pad ";
+        str.Append("Pad ");
         bool first = true;
         auto add = [&](const char* name) {
-            if (!first) str += "+";
-            str += name;
+            if (!first) str.Append("+");
+            str.Append(name);
             first = false;
         };
 
@@ -101,6 +158,7 @@ std::string KeyBind::ToString() const
         if (k & XINPUT_GAMEPAD_LEFT_THUMB) add("L3");
         if (k & XINPUT_GAMEPAD_RIGHT_THUMB) add("R3");
         if (k & XINPUT_GAMEPAD_GUIDE) add("Guide");
+        if (k & PAD_TOUCHPAD) add("Touchpad");
         if (k & XINPUT_GAMEPAD_LEFT_SHOULDER) add("LB");
         if (k & XINPUT_GAMEPAD_RIGHT_SHOULDER) add("RB");
         if (k & XINPUT_GAMEPAD_A) add("A");
@@ -108,11 +166,11 @@ std::string KeyBind::ToString() const
         if (k & XINPUT_GAMEPAD_X) add("X");
         if (k & XINPUT_GAMEPAD_Y) add("Y");
         
-        if (first) str += "Unknown";
+        if (first) str.Append("Unknown");
     }
 
-    if (str.empty()) return "None";
-    return str;
+    if (str.len == 0) str.Append("None");
+    return str.len;
 }
 
 bool KeyBind::IsPressed(bool strict) const
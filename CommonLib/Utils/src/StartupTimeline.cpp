@@ -0,0 +1,310 @@
+#include "StartupTimeline.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    constexpr const char* kTotalKey = "(total)";
+    constexpr size_t kReportRows = 10;
+
+    std::string Label(const StartupTimeline::Span& span)
+    {
+        return span.detail.empty() ? span.name : span.name + " [" + span.detail + "]";
+    }
+
+    double Ms(int64_t us)
+    {
+        return us / 1000.0;
+    }
+
+    void AppendLine(std::string& out, const char* format, ...)
+    {
+        char line[512];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        out += line;
+        out += '\n';
+    }
+}
+
+namespace StartupTimeline
+{
+    Timeline::Timeline(std::vector<Span> spans, int64_t endUs)
+        : m_endUs(endUs)
+    {
+        spans.erase(std::remove_if(spans.begin(), spans.end(), [&](const Span& s) { return s.startUs > endUs || s.durationUs < 0; }),
+            spans.end());
+
+        // Per thread, outer spans first: a span recorded when its scope closes lands in the buffer
+        // after everything nested in it.
+        std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+            if (a.threadId != b.threadId) return a.threadId < b.threadId;
+            if (a.startUs != b.startUs) return a.startUs < b.startUs;
+            return a.durationUs > b.durationUs;
+        });
+
+        m_startUs = endUs;
+        m_nodes.reserve(spans.size());
+        std::vector<int> stack;
+        for (Span& span : spans)
+        {
+            m_startUs = std::min(m_startUs, span.startUs);
+            if (!stack.empty() && m_nodes[stack.back()].span.threadId != span.threadId)
+                stack.clear();
+            while (!stack.empty() && span.EndUs() > m_nodes[stack.back()].span.EndUs())
+                stack.pop_back();
+
+            Node node;
+            node.selfUs = span.durationUs;
+            if (stack.empty())
+            {
+                node.path = Label(span);
+                if (span.category == "plugins" && !span.detail.empty())
+                    node.owner = span.detail;
+            }
+            else
+            {
+                Node& parent = m_nodes[stack.back()];
+                parent.selfUs -= span.durationUs;
+                node.parent = stack.back();
+                node.depth = parent.depth + 1;
+                node.path = parent.path + " / " + Label(span);
+                node.owner = parent.owner;
+                if (node.owner.empty() && span.category == "plugins" && !span.detail.empty())
+                    node.owner = span.detail;
+            }
+            node.span = std::move(span);
+
+            stack.push_back((int)m_nodes.size());
+            m_nodes.push_back(std::move(node));
+        }
+
+        // Rounding to whole microseconds can leave children a tick longer than their parent.
+        for (Node& node : m_nodes)
+            node.selfUs = std::max<int64_t>(node.selfUs, 0);
+    }
+
+    std::vector<PathEntry> Timeline::GetCriticalPath() const
+    {
+        std::vector<PathEntry> path;
+        int64_t cursor = m_endUs;
+        while (true)
+        {
+            int best = -1;
+            int64_t bestEnd = 0;
+            for (size_t i = 0; i < m_nodes.size(); ++i)
+            {
+                const Span& span = m_nodes[i].span;
+                if (m_nodes[i].parent != -1 || span.startUs >= cursor)
+                    continue;
+                const int64_t end = std::min(span.EndUs(), cursor);
+                if (best == -1 || end > bestEnd || (end == bestEnd && span.startUs < m_nodes[best].span.startUs))
+                {
+                    best = (int)i;
+                    bestEnd = end;
+                }
+            }
+            if (best == -1)
+                break;
+
+            if (bestEnd < cursor)
+                path.push_back({ -1, bestEnd, cursor - bestEnd });
+            const int64_t start = m_nodes[best].span.startUs;
+            path.push_back({ best, start, bestEnd - start });
+            cursor = start;
+        }
+
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    Totals Timeline::GetTotals() const
+    {
+        Totals totals;
+        totals.totalUs = m_endUs - m_startUs;
+        for (const Node& node : m_nodes)
+            totals.pathUs[node.path] += node.span.durationUs;
+        return totals;
+    }
+
+    std::string SerializeTotals(const Totals& totals)
+    {
+        std::string out = "total " + std::to_string(totals.totalUs) + "\n";
+        for (const auto& [path, us] : totals.pathUs)
+            out += std::to_string(us) + " " + path + "\n";
+        return out;
+    }
+
+    bool ParseTotals(const std::string& text, Totals& out, std::string* error)
+    {
+        auto fail = [&](int lineNo, const std::string& what) {
+            if (error)
+                *error = "line " + std::to_string(lineNo) + ": " + what;
+            return false;
+        };
+
+        Totals totals;
+        bool haveTotal = false;
+        std::istringstream lines(text);
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(lines, line))
+        {
+            ++lineNo;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty())
+                continue;
+
+            const size_t space = line.find(' ');
+            if (space == std::string::npos || space + 1 == line.size())
+                return fail(lineNo, "expected '<value> <path>'");
+            const std::string key = line.substr(0, space);
+            const std::string rest = line.substr(space + 1);
+
+            if (key == "total")
+            {
+                char* end = nullptr;
+                totals.totalUs = strtoll(rest.c_str(), &end, 10);
+                if (*end != '\0' || totals.totalUs < 0)
+                    return fail(lineNo, "bad total '" + rest + "'");
+                haveTotal = true;
+                continue;
+            }
+
+            char* end = nullptr;
+            const long long us = strtoll(key.c_str(), &end, 10);
+            if (*end != '\0' || us < 0)
+                return fail(lineNo, "bad duration '" + key + "'");
+            totals.pathUs[rest] += us;
+        }
+        if (!haveTotal)
+            return fail(lineNo, "missing total");
+
+        out = std::move(totals);
+        return true;
+    }
+
+    std::vector<Regression> FindRegressions(const Totals& previous, const Totals& current, const DiffOptions& options)
+    {
+        std::vector<Regression> regressions;
+        auto check = [&](const std::string& path, int64_t before, int64_t now) {
+            const int64_t delta = now - before;
+            if (delta > options.minDeltaUs && delta > before * options.minRatio)
+                regressions.push_back({ path, before, now });
+        };
+
+        check(kTotalKey, previous.totalUs, current.totalUs);
+        for (const auto& [path, us] : current.pathUs)
+        {
+            auto it = previous.pathUs.find(path);
+            check(path, it != previous.pathUs.end() ? it->second : 0, us);
+        }
+
+        // A slowdown shows up in every span around it too; on ties the innermost one goes first.
+        std::stable_sort(regressions.begin(), regressions.end(), [](const Regression& a, const Regression& b) {
+            const int64_t deltaA = a.currentUs - a.previousUs, deltaB = b.currentUs - b.previousUs;
+            return deltaA != deltaB ? deltaA > deltaB : a.path.size() > b.path.size();
+        });
+        return regressions;
+    }
+
+    std::string FormatReport(const Timeline& timeline, const Totals* previous, const DiffOptions& options)
+    {
+        const std::vector<Node>& nodes = timeline.GetNodes();
+        const Totals totals = timeline.GetTotals();
+        std::string out;
+
+        if (previous)
+            AppendLine(out, "Startup: %.1f ms to the first frame (previous run: %.1f ms, %+.1f ms)",
+                Ms(totals.totalUs), Ms(previous->totalUs), Ms(totals.totalUs - previous->totalUs));
+        else
+            AppendLine(out, "Startup: %.1f ms to the first frame (no previous run to compare with)", Ms(totals.totalUs));
+
+        // Critical path, ranked by how much of the wait each stretch accounts for.
+        std::vector<PathEntry> path = timeline.GetCriticalPath();
+        std::vector<bool> critical(nodes.size(), false);
+        for (const PathEntry& entry : path)
+            if (entry.node >= 0)
+                critical[entry.node] = true;
+        for (size_t i = 0; i < nodes.size(); ++i)
+            if (nodes[i].parent >= 0 && critical[nodes[i].parent])
+                critical[i] = true;     // Parents come first, so this reaches every descendant
+
+        std::stable_sort(path.begin(), path.end(), [](const PathEntry& a, const PathEntry& b) { return a.durationUs > b.durationUs; });
+        AppendLine(out, "\nCritical path:");
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            const PathEntry& entry = path[i];
+            const double share = totals.totalUs > 0 ? 100.0 * entry.durationUs / totals.totalUs : 0.0;
+            if (entry.node < 0)
+                AppendLine(out, "  %2zu. %9.1f ms %5.1f%%  (untraced) at +%.1f ms", i + 1, Ms(entry.durationUs), share,
+                    Ms(entry.startUs - timeline.GetStartUs()));
+            else
+                AppendLine(out, "  %2zu. %9.1f ms %5.1f%%  %s (thread %u) at +%.1f ms", i + 1, Ms(entry.durationUs), share,
+                    nodes[entry.node].path.c_str(), nodes[entry.node].span.threadId, Ms(entry.startUs - timeline.GetStartUs()));
+        }
+
+        std::vector<int> order;
+        for (size_t i = 0; i < nodes.size(); ++i)
+            if (critical[i] && nodes[i].selfUs > 0)
+                order.push_back((int)i);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return nodes[a].selfUs > nodes[b].selfUs; });
+        AppendLine(out, "\nSlowest spans on the critical path (self time):");
+        for (size_t i = 0; i < order.size() && i < kReportRows; ++i)
+            AppendLine(out, "  %9.1f ms  %s", Ms(nodes[order[i]].selfUs), nodes[order[i]].path.c_str());
+
+        // Per plugin: the outermost span attributed to it covers everything it did on that thread.
+        std::map<std::string, int64_t> plugins;
+        for (const Node& node : nodes)
+            if (!node.owner.empty() && (node.parent < 0 || nodes[node.parent].owner.empty()))
+                plugins[node.owner] += node.span.durationUs;
+        if (!plugins.empty())
+        {
+            std::vector<std::pair<std::string, int64_t>> ranked(plugins.begin(), plugins.end());
+            std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+            AppendLine(out, "\nPlugins:");
+            for (const auto& [owner, us] : ranked)
+                AppendLine(out, "  %9.1f ms  %s", Ms(us), owner.c_str());
+        }
+
+        order.clear();
+        for (size_t i = 0; i < nodes.size(); ++i)
+            if (nodes[i].span.category == "hooks" && !nodes[i].span.detail.empty())
+                order.push_back((int)i);
+        if (!order.empty())
+        {
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return nodes[a].span.durationUs > nodes[b].span.durationUs; });
+            AppendLine(out, "\nSlowest hooks:");
+            for (size_t i = 0; i < order.size() && i < kReportRows; ++i)
+            {
+                const Node& node = nodes[order[i]];
+                AppendLine(out, "  %9.1f ms  %s%s%s", Ms(node.span.durationUs), Label(node.span).c_str(),
+                    node.owner.empty() ? "" : "  <- ", node.owner.c_str());
+            }
+        }
+
+        if (previous)
+        {
+            const std::vector<Regression> regressions = FindRegressions(*previous, totals, options);
+            AppendLine(out, "\nRegressions (over %.1f ms and %.0f%% slower than the previous run): %zu",
+                Ms(options.minDeltaUs), options.minRatio * 100.0, regressions.size());
+            for (const Regression& r : regressions)
+            {
+                if (r.previousUs == 0)
+                    AppendLine(out, "  %+9.1f ms  %s (new, %.1f ms)", Ms(r.currentUs), r.path.c_str(), Ms(r.currentUs));
+                else
+                    AppendLine(out, "  %+9.1f ms  %s (%.1f -> %.1f ms)", Ms(r.currentUs - r.previousUs), r.path.c_str(),
+                        Ms(r.previousUs), Ms(r.currentUs));
+            }
+        }
+
+        return out;
+    }
+}
@@ -0,0 +1,298 @@
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <functional>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr size_t kChunkSize = 256;
+    constexpr size_t kMaxChunks = 256; // 64K spans per thread before we start dropping
+
+    struct Chunk
+    {
+        Trace::Event events[kChunkSize];
+    };
+
+    // Owned by the registry, never freed while the process runs: threads may exit
+    // before a dump and their spans should still be exported.
+    struct ThreadBuffer
+    {
+        uint32_t threadId = 0;
+        char threadName[32] = {};
+        std::atomic<Chunk*> chunks[kMaxChunks] = {};
+        std::atomic<size_t> count = 0;
+
+        ~ThreadBuffer()
+        {
+            for (auto& c : chunks)
+                delete c.load(std::memory_order_relaxed);
+        }
+    };
+
+    std::mutex g_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+    std::atomic<bool> g_enabled = true;
+    std::atomic<size_t> g_dropped = 0;
+    std::atomic<Trace::TraceSink> g_sink = nullptr;
+
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer* GetThreadBuffer()
+    {
+        if (!t_buffer)
+        {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->threadId = Trace::CurrentThreadId();
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            t_buffer = buffer.get();
+            g_buffers.push_back(std::move(buffer));
+        }
+        return t_buffer;
+    }
+
+    void CopyTruncated(char* dst, size_t dstSize, const char* src)
+    {
+        if (!src) { dst[0] = '\0'; return; }
+        size_t n = strlen(src);
+        if (n >= dstSize) n = dstSize - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+
+    void AppendEscaped(std::string& out, const char* s)
+    {
+        for (; *s; ++s)
+        {
+            const unsigned char c = (unsigned char)*s;
+            switch (c)
+            {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20)
+                {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                }
+                else
+                {
+                    out += (char)c;
+                }
+                break;
+            }
+        }
+    }
+
+    uint32_t CurrentProcessId()
+    {
+#ifdef _WIN32
+        return (uint32_t)GetCurrentProcessId();
+#else
+        return (uint32_t)getpid();
+#endif
+    }
+}
+
+namespace Trace
+{
+    int64_t NowUs()
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint32_t CurrentThreadId()
+    {
+#ifdef _WIN32
+        return (uint32_t)GetCurrentThreadId();
+#else
+        return (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+    }
+
+    void SetEnabled(bool enabled)
+    {
+        g_enabled = enabled;
+    }
+
+    bool IsEnabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void InitSink(TraceSink sink)
+    {
+        g_sink = sink;
+    }
+
+    void SetThreadName(const char* name)
+    {
+        ThreadBuffer* buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        CopyTruncated(buffer->threadName, sizeof(buffer->threadName), name);
+    }
+
+    void Record(const char* name, const char* category, const char* detail,
+                int64_t startUs, int64_t durationUs, uint32_t threadId)
+    {
+        if (!IsEnabled() || !name)
+            return;
+
+        if (TraceSink sink = g_sink.load(std::memory_order_relaxed))
+        {
+            sink(name, category, detail, startUs, durationUs, threadId);
+            return;
+        }
+
+        ThreadBuffer* buffer = GetThreadBuffer();
+        const size_t index = buffer->count.load(std::memory_order_relaxed);
+        const size_t chunkIndex = index / kChunkSize;
+        if (chunkIndex >= kMaxChunks)
+        {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Chunk* chunk = buffer->chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk)
+        {
+            chunk = new Chunk();
+            buffer->chunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+
+        Event& e = chunk->events[index % kChunkSize];
+        CopyTruncated(e.name, sizeof(e.name), name);
+        CopyTruncated(e.category, sizeof(e.category), category ? category : "default");
+        CopyTruncated(e.detail, sizeof(e.detail), detail);
+        e.startUs = startUs;
+        e.durationUs = durationUs;
+        e.threadId = threadId;
+
+        // Publish after the slot is fully written so a concurrent dump never sees a torn event.
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    size_t GetEventCount()
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        size_t total = 0;
+        for (const auto& buffer : g_buffers)
+            total += buffer->count.load(std::memory_order_acquire);
+        return total;
+    }
+
+    size_t GetDroppedCount()
+    {
+        return g_dropped.load(std::memory_order_relaxed);
+    }
+
+    std::vector<Event> GetEvents()
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        std::vector<Event> events;
+        for (const auto& buffer : g_buffers)
+        {
+            const size_t count = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+                events.push_back(buffer->chunks[i / kChunkSize].load(std::memory_order_acquire)->events[i % kChunkSize]);
+        }
+        return events;
+    }
+
+    std::string SerializeChromeJSON()
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+
+        // Chrome accepts absolute timestamps, but rebasing to the earliest span keeps the numbers readable.
+        int64_t baseUs = INT64_MAX;
+        size_t total = 0;
+        for (const auto& buffer : g_buffers)
+        {
+            const size_t count = buffer->count.load(std::memory_order_acquire);
+            total += count;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Chunk* chunk = buffer->chunks[i / kChunkSize].load(std::memory_order_acquire);
+                if (chunk->events[i % kChunkSize].startUs < baseUs)
+                    baseUs = chunk->events[i % kChunkSize].startUs;
+            }
+        }
+        if (baseUs == INT64_MAX)
+            baseUs = 0;
+
+        const uint32_t pid = CurrentProcessId();
+        std::string out;
+        out.reserve(64 + total * 160);
+        out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+        char num[128];
+        for (const auto& buffer : g_buffers)
+        {
+            if (buffer->threadName[0])
+            {
+                if (!first) out += ",";
+                first = false;
+                snprintf(num, sizeof(num), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"", pid, buffer->threadId);
+                out += num;
+                AppendEscaped(out, buffer->threadName);
+                out += "\"}}";
+            }
+
+            const size_t count = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Chunk* chunk = buffer->chunks[i / kChunkSize].load(std::memory_order_acquire);
+                const Event& e = chunk->events[i % kChunkSize];
+
+                if (!first) out += ",";
+                first = false;
+
+                out += "{\"ph\":\"X\",\"name\":\"";
+                AppendEscaped(out, e.name);
+                out += "\",\"cat\":\"";
+                AppendEscaped(out, e.category);
+                snprintf(num, sizeof(num), "\",\"ts\":%lld,\"dur\":%lld,\"pid\":%u,\"tid\":%u",
+                    (long long)(e.startUs - baseUs), (long long)e.durationUs, pid, e.threadId);
+                out += num;
+                if (e.detail[0])
+                {
+                    out += ",\"args\":{\"detail\":\"";
+                    AppendEscaped(out, e.detail);
+                    out += "\"}";
+                }
+                out += "}";
+            }
+        }
+
+        out += "]}";
+        return out;
+    }
+
+    bool WriteChromeJSON(const std::filesystem::path& path)
+    {
+        const std::string json = SerializeChromeJSON();
+        std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.write(json.data(), (std::streamsize)json.size());
+        return file.good();
+    }
+}
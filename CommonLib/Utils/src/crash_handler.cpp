@@ -1,10 +1,15 @@
 #include "crash_handler.h"
 #include "log.h"
+#include "Trace.h"
+#include "ExceptionRecorder.h"
 #include <Windows.h>
 #include <DbgHelp.h>
+#include <Psapi.h>
 #include <stdio.h>
+#include <string.h>
 
 #pragma comment(lib, "dbghelp.lib")
+#pragma comment(lib, "psapi.lib")
 
 namespace
 {
@@ -23,7 +28,241 @@ namespace
 		}
 	}
 
-	// Vectored exception handler: logs first/second-chance exceptions but lets them continue.
+	// Crash-time buffers, preallocated so the unhandled path doesn't depend on the heap.
+	constexpr int kMaxCrashFrames = 64;
+	constexpr DWORD kMaxCrashModules = 512;
+	DWORD64 g_CrashFrames[kMaxCrashFrames];
+	HMODULE g_CrashModules[kMaxCrashModules];
+	alignas(SYMBOL_INFO) char g_SymbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+
+	// Symbol engine state. Nothing is loaded up front: the engine starts on first use (normally a crash)
+	// without invading the process, and modules are added only for addresses actually on the stack.
+	bool g_SymbolEngineReady = false;
+	bool g_SymbolizeCrashes = true;
+
+	// First-chance exceptions are recorded here and summarized by the drain thread once per interval.
+	ExceptionRecorder g_FirstChance;
+	constexpr DWORD kDrainIntervalMs = 1000;
+
+	PVOID g_VehHandle = nullptr;
+	// Native handles rather than std::thread: nothing may need destroying when the process exits
+	// without Shutdown (a joinable std::thread global would call std::terminate).
+	HANDLE g_DrainThread = nullptr;
+	HANDLE g_DrainStopEvent = nullptr;
+
+	LARGE_INTEGER g_QpcFrequency = {};
+
+	uint64_t QpcNow()
+	{
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		return (uint64_t)now.QuadPart;
+	}
+
+	// "module.dll+0x1234", or just the address if it isn't inside a module.
+	void DescribeAddress(uint64_t address, char* out, size_t outSize)
+	{
+		HMODULE hModule = NULL;
+		char path[MAX_PATH];
+		if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)(uintptr_t)address, &hModule)
+			&& GetModuleFileNameA(hModule, path, sizeof(path)))
+		{
+			const char* name = strrchr(path, '\\');
+			sprintf_s(out, outSize, "%s+0x%llX", name ? name + 1 : path, address - (uint64_t)(uintptr_t)hModule);
+		}
+		else
+		{
+			sprintf_s(out, outSize, "0x%llX", address);
+		}
+	}
+
+	// SizeOfImage and link timestamp from the module's in-memory PE headers.
+	bool GetImageInfo(HMODULE hModule, DWORD& size, DWORD& timestamp)
+	{
+		const auto* dos = (const IMAGE_DOS_HEADER*)hModule;
+		if (!dos || dos->e_magic != IMAGE_DOS_SIGNATURE)
+			return false;
+		const auto* nt = (const IMAGE_NT_HEADERS*)((const BYTE*)hModule + dos->e_lfanew);
+		if (nt->Signature != IMAGE_NT_SIGNATURE)
+			return false;
+		size = nt->OptionalHeader.SizeOfImage;
+		timestamp = nt->FileHeader.TimeDateStamp;
+		return true;
+	}
+
+	bool EnsureSymbolEngine(HANDLE hProcess)
+	{
+		if (!g_SymbolEngineReady)
+		{
+			SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_FAIL_CRITICAL_ERRORS);
+			g_SymbolEngineReady = SymInitialize(hProcess, NULL, FALSE) != FALSE;
+		}
+		return g_SymbolEngineReady;
+	}
+
+	// Registers the module containing `address` with dbghelp if it isn't yet. With deferred loads this
+	// only maps headers/unwind data; PDBs are read when SymFromAddr first asks for a name.
+	DWORD64 LoadModuleForAddress(HANDLE hProcess, DWORD64 address)
+	{
+		if (DWORD64 base = SymGetModuleBase64(hProcess, address))
+			return base;
+
+		HMODULE hModule = NULL;
+		if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)(uintptr_t)address, &hModule))
+			return 0;
+
+		char path[MAX_PATH];
+		DWORD size = 0, timestamp = 0;
+		if (!GetModuleFileNameA(hModule, path, sizeof(path)) || !GetImageInfo(hModule, size, timestamp))
+			return 0;
+
+		SymLoadModuleEx(hProcess, NULL, path, NULL, (DWORD64)(uintptr_t)hModule, size, NULL, 0);
+		return SymGetModuleBase64(hProcess, address);
+	}
+
+	PVOID CALLBACK FunctionTableAccessOnDemand(HANDLE hProcess, DWORD64 addrBase)
+	{
+		LoadModuleForAddress(hProcess, addrBase);
+		return SymFunctionTableAccess64(hProcess, addrBase);
+	}
+
+	DWORD64 CALLBACK GetModuleBaseOnDemand(HANDLE hProcess, DWORD64 address)
+	{
+		return LoadModuleForAddress(hProcess, address);
+	}
+
+	int CaptureCrashStack(CONTEXT* context)
+	{
+		STACKFRAME64 stackFrame = {};
+#ifdef _WIN64
+		stackFrame.AddrPC.Offset = context->Rip;
+		stackFrame.AddrPC.Mode = AddrModeFlat;
+		stackFrame.AddrStack.Offset = context->Rsp;
+		stackFrame.AddrStack.Mode = AddrModeFlat;
+		stackFrame.AddrFrame.Offset = context->Rbp;
+		stackFrame.AddrFrame.Mode = AddrModeFlat;
+		DWORD machineType = IMAGE_FILE_MACHINE_AMD64;
+#else
+		stackFrame.AddrPC.Offset = context->Eip;
+		stackFrame.AddrPC.Mode = AddrModeFlat;
+		stackFrame.AddrStack.Offset = context->Esp;
+		stackFrame.AddrStack.Mode = AddrModeFlat;
+		stackFrame.AddrFrame.Offset = context->Ebp;
+		stackFrame.AddrFrame.Mode = AddrModeFlat;
+		DWORD machineType = IMAGE_FILE_MACHINE_I386;
+#endif
+		HANDLE hThread = GetCurrentThread();
+		HANDLE hProcess = GetCurrentProcess();
+		if (!EnsureSymbolEngine(hProcess))
+		{
+			// No unwinder without dbghelp; at least keep the faulting frame.
+			g_CrashFrames[0] = stackFrame.AddrPC.Offset;
+			return 1;
+		}
+
+		int count = 0;
+		while (count < kMaxCrashFrames)
+		{
+			if (!StackWalk64(machineType, hProcess, hThread, &stackFrame, context, NULL, FunctionTableAccessOnDemand, GetModuleBaseOnDemand, NULL))
+				break;
+			if (stackFrame.AddrPC.Offset == 0)
+				break;
+			g_CrashFrames[count++] = stackFrame.AddrPC.Offset;
+		}
+		return count;
+	}
+
+	// Raw return addresses and the module list (base, size, PE timestamp). Enough to symbolize the
+	// crash offline with symbolize_crash.py, without loading any symbols in the game process.
+	void WriteRawCrashData(int frameCount)
+	{
+		Log::Write("----------------------------------------------------------------");
+		Log::Write("                          RAW FRAMES                            ");
+		Log::Write("----------------------------------------------------------------");
+		for (int i = 0; i < frameCount; ++i)
+		{
+			char where[MAX_PATH + 32];
+			DescribeAddress(g_CrashFrames[i], where, sizeof(where));
+			Log::Write("[frame] #%02d 0x%llX %s", i, g_CrashFrames[i], where);
+		}
+
+		Log::Write("----------------------------------------------------------------");
+		Log::Write("                           MODULES                              ");
+		Log::Write("----------------------------------------------------------------");
+		DWORD needed = 0;
+		if (!EnumProcessModules(GetCurrentProcess(), g_CrashModules, sizeof(g_CrashModules), &needed))
+			return;
+
+		DWORD moduleCount = needed / (DWORD)sizeof(HMODULE);
+		if (moduleCount > kMaxCrashModules)
+			moduleCount = kMaxCrashModules;
+		for (DWORD i = 0; i < moduleCount; ++i)
+		{
+			char path[MAX_PATH];
+			DWORD size = 0, timestamp = 0;
+			if (!GetModuleFileNameA(g_CrashModules[i], path, sizeof(path)) || !GetImageInfo(g_CrashModules[i], size, timestamp))
+				continue;
+			Log::Write("[module] base=0x%llX size=0x%X timestamp=0x%08X %s", (uint64_t)(uintptr_t)g_CrashModules[i], size, timestamp, path);
+		}
+	}
+
+	void WriteSymbolizedStack(int frameCount)
+	{
+		Log::Write("----------------------------------------------------------------");
+		Log::Write("                          CALL STACK                            ");
+		Log::Write("----------------------------------------------------------------");
+
+		HANDLE hProcess = GetCurrentProcess();
+		PSYMBOL_INFO pSymbol = (PSYMBOL_INFO)g_SymbolBuffer;
+		pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		pSymbol->MaxNameLen = MAX_SYM_NAME;
+
+		for (int i = 0; i < frameCount; ++i)
+		{
+			const DWORD64 address = g_CrashFrames[i];
+			DWORD64 displacement = 0;
+			if (g_SymbolEngineReady && LoadModuleForAddress(hProcess, address) && SymFromAddr(hProcess, address, &displacement, pSymbol))
+				Log::Write("0x%llX %s + 0x%llX", address, pSymbol->Name, displacement);
+			else
+				Log::Write("0x%llX (No symbols found)", address);
+		}
+	}
+
+	void DrainFirstChance(double intervalSec)
+	{
+		g_FirstChance.DrainSites([intervalSec](const ExceptionRecorder::SiteSummary& site)
+		{
+			char where[MAX_PATH + 32];
+			DescribeAddress(site.address, where, sizeof(where));
+			Log::Write("[VEH] Exception 0x%X (%s) at %s x%u in last %.1fs (thread %u, %llu total)",
+				site.code, GetExceptionDescription(site.code), where, site.count, intervalSec, site.lastThreadId, site.total);
+		});
+
+		if (uint64_t untracked = g_FirstChance.TakeUntrackedCount())
+			Log::Write("[VEH] %llu exceptions at untracked sites in last %.1fs (site table full)", untracked, intervalSec);
+	}
+
+	DWORD WINAPI DrainThreadMain(LPVOID)
+	{
+		Trace::SetThreadName("Exception drain");
+
+		uint64_t last = QpcNow();
+		while (true)
+		{
+			const bool stopping = WaitForSingleObject(g_DrainStopEvent, kDrainIntervalMs) == WAIT_OBJECT_0;
+
+			const uint64_t now = QpcNow();
+			DrainFirstChance((double)(now - last) / (double)g_QpcFrequency.QuadPart);
+			last = now;
+
+			if (stopping)
+				break;
+		}
+		return 0;
+	}
+
+	// Vectored exception handler: runs for every first-chance exception on the faulting thread.
+	// Only records into g_FirstChance (no locks, no I/O); the drain thread does the logging.
 	LONG WINAPI VectoredExceptionHandler(EXCEPTION_POINTERS* pExceptionPointers)
 	{
 		DWORD code = pExceptionPointers->ExceptionRecord->ExceptionCode;
@@ -31,16 +270,35 @@ namespace
 		{
 			return EXCEPTION_CONTINUE_SEARCH;
 		}
-		void* addr = pExceptionPointers->ExceptionRecord->ExceptionAddress;
-		DWORD threadId = GetCurrentThreadId();
 
-		Log::Write("[VEH] Exception 0x%X (%s) at address 0x%p on thread %u",
-			code, GetExceptionDescription(code), addr, threadId);
+		g_FirstChance.Add(code, (uint64_t)(uintptr_t)pExceptionPointers->ExceptionRecord->ExceptionAddress,
+			GetCurrentThreadId(), QpcNow());
 
 		// Continue search so normal SEH / unhandled filter still run.
 		return EXCEPTION_CONTINUE_SEARCH;
 	}
 
+	void WriteRecentFirstChance()
+	{
+		Log::Write("----------------------------------------------------------------");
+		Log::Write("              RECENT FIRST-CHANCE EXCEPTIONS                    ");
+		Log::Write("----------------------------------------------------------------");
+
+		const uint64_t now = QpcNow();
+		const size_t written = g_FirstChance.ForEachRecent([now](const ExceptionRecorder::Entry& entry)
+		{
+			char where[MAX_PATH + 32];
+			DescribeAddress(entry.address, where, sizeof(where));
+			const double agoMs = g_QpcFrequency.QuadPart
+				? (double)(now - entry.timestamp) * 1000.0 / (double)g_QpcFrequency.QuadPart : 0.0;
+			Log::Write("-%.3f ms: 0x%X (%s) at %s on thread %u", agoMs, entry.code, GetExceptionDescription(entry.code), where, entry.threadId);
+		});
+
+		if (written == 0)
+			Log::Write("(none)");
+		Log::Write("%llu first-chance exceptions recorded this session", g_FirstChance.GetAddedCount());
+	}
+
 	LONG WINAPI UnhandledExceptionHandler(EXCEPTION_POINTERS* pExceptionPointers)
 	{
 		DWORD code = pExceptionPointers->ExceptionRecord->ExceptionCode;
@@ -78,56 +336,15 @@ namespace
 			Log::Write("Faulting module: (unknown)");
 		}
 
-		Log::Write("----------------------------------------------------------------");
-		Log::Write("                          CALL STACK                            ");
-		Log::Write("----------------------------------------------------------------");
+		// Raw data first: it needs no symbols, so it's on disk even if symbolization fails or hangs.
+		const int frameCount = CaptureCrashStack(pExceptionPointers->ContextRecord);
+		WriteRawCrashData(frameCount);
+		Log::Flush();
 
-		CONTEXT* context = pExceptionPointers->ContextRecord;
-		STACKFRAME64 stackFrame = {};
-#ifdef _WIN64
-		stackFrame.AddrPC.Offset = context->Rip;
-		stackFrame.AddrPC.Mode = AddrModeFlat;
-		stackFrame.AddrStack.Offset = context->Rsp;
-		stackFrame.AddrStack.Mode = AddrModeFlat;
-		stackFrame.AddrFrame.Offset = context->Rbp;
-		stackFrame.AddrFrame.Mode = AddrModeFlat;
-		DWORD machineType = IMAGE_FILE_MACHINE_AMD64;
-#else
-		stackFrame.AddrPC.Offset = context->Eip;
-		stackFrame.AddrPC.Mode = AddrModeFlat;
-		stackFrame.AddrStack.Offset = context->Esp;
-		stackFrame.AddrStack.Mode = AddrModeFlat;
-		stackFrame.AddrFrame.Offset = context->Ebp;
-		stackFrame.AddrFrame.Mode = AddrModeFlat;
-		DWORD machineType = IMAGE_FILE_MACHINE_I386;
-#endif
-		HANDLE hThread = GetCurrentThread();
-		HANDLE hProcess = GetCurrentProcess();
+		if (g_SymbolizeCrashes)
+			WriteSymbolizedStack(frameCount);
 
-		char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
-		PSYMBOL_INFO pSymbol = (PSYMBOL_INFO)symbolBuffer;
-		pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-		pSymbol->MaxNameLen = MAX_SYM_NAME;
-
-		for (int i = 0; i < 25; ++i)
-		{
-			if (!StackWalk64(machineType, hProcess, hThread, &stackFrame, context, NULL, SymFunctionTableAccess64, SymGetModuleBase64, NULL))
-				break;
-			if (stackFrame.AddrPC.Offset == 0)
-				break;
-
-			char line[1024];
-			DWORD64 displacement = 0;
-			if (SymFromAddr(hProcess, stackFrame.AddrPC.Offset, &displacement, pSymbol))
-			{
-				sprintf_s(line, sizeof(line), "0x%llX %s + 0x%llX", stackFrame.AddrPC.Offset, pSymbol->Name, displacement);
-			}
-			else
-			{
-				sprintf_s(line, sizeof(line), "0x%llX (No symbols found)", stackFrame.AddrPC.Offset);
-			}
-			Log::Write("%s", line);
-		}
+		WriteRecentFirstChance();
 
 		Log::Write("================================================================");
 		Log::Flush(); // Ensure log is written
@@ -138,11 +355,15 @@ namespace
 
 void CrashHandler::Init()
 {
-	// Initialize symbols upfront to avoid memory allocation during a crash
-	SymInitialize(GetCurrentProcess(), NULL, TRUE);
+	// No SymInitialize here: invading the process loads symbols for every module at injection time.
+	// The symbol engine is started at crash time and only loads modules that are on the stack.
+	QueryPerformanceFrequency(&g_QpcFrequency);
 
-	// Vectored handler for first/second-chance exceptions.
-	AddVectoredExceptionHandler(1, VectoredExceptionHandler);
+	// Vectored handler for first-chance exceptions, plus the thread that logs their summaries.
+	g_DrainStopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	if (g_DrainStopEvent)
+		g_DrainThread = CreateThread(nullptr, 0, DrainThreadMain, nullptr, 0, nullptr);
+	g_VehHandle = AddVectoredExceptionHandler(1, VectoredExceptionHandler);
 
 	// Unhandled exception filter as last-resort handler.
 	SetUnhandledExceptionFilter(UnhandledExceptionHandler);
@@ -150,5 +371,33 @@ void CrashHandler::Init()
 
 void CrashHandler::Shutdown()
 {
-	SymCleanup(GetCurrentProcess());
+	if (g_VehHandle)
+	{
+		RemoveVectoredExceptionHandler(g_VehHandle);
+		g_VehHandle = nullptr;
+	}
+
+	if (g_DrainThread)
+	{
+		SetEvent(g_DrainStopEvent);
+		WaitForSingleObject(g_DrainThread, INFINITE); // Final drain flushes whatever was recorded since the last interval
+		CloseHandle(g_DrainThread);
+		g_DrainThread = nullptr;
+	}
+	if (g_DrainStopEvent)
+	{
+		CloseHandle(g_DrainStopEvent);
+		g_DrainStopEvent = nullptr;
+	}
+
+	if (g_SymbolEngineReady)
+	{
+		SymCleanup(GetCurrentProcess());
+		g_SymbolEngineReady = false;
+	}
+}
+
+void CrashHandler::SetSymbolizeCrashes(bool enabled)
+{
+	g_SymbolizeCrashes = enabled;
 }
@@ -0,0 +1,49 @@
+#pragma once
+#include <Windows.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "IPlugin.h"
+#include "HotkeyMatcher.h"
+
+// Every hotkey of the loader and its plugins. Key and mouse-button messages are fed in as they arrive
+// (window thread); once per frame the pad is sampled and all binds are matched in one pass (render
+// thread), and the subscribers' callbacks run.
+// Keyboard state only comes from the game window's messages, so keyboard binds don't fire while
+// another window has focus (GetAsyncKeyState polling used to see keys typed anywhere).
+class HotkeyRegistry
+{
+public:
+    HotkeyHandle Register(IPlugin* owner, const HotkeyDesc& desc);
+    bool Update(HotkeyHandle handle, const HotkeyDesc& desc);
+    void Unregister(HotkeyHandle handle);
+    void RemovePlugin(IPlugin* owner);
+    bool IsDown(HotkeyHandle handle) const;
+
+    // Window thread. Lock-free; only touches the key bitset.
+    void OnWindowMessage(UINT msg, WPARAM wParam, LPARAM lParam);
+    // Render thread, once per frame.
+    void Poll();
+
+private:
+    struct Subscription
+    {
+        IPlugin* owner = nullptr;
+        void (*callback)(void* userData, const HotkeyEventInfo& info) = nullptr;
+        void* userData = nullptr;
+    };
+
+    struct PendingCall
+    {
+        Subscription sub;
+        HotkeyEventInfo info;
+    };
+
+    static HotkeyChord ToChord(const HotkeyDesc& desc);
+
+    KeyStateTracker m_keys;
+    mutable std::mutex m_mutex; // m_matcher, m_subscriptions
+    HotkeyMatcher m_matcher;
+    std::unordered_map<HotkeyHandle, Subscription> m_subscriptions;
+    std::vector<PendingCall> m_pending; // Render thread only; reused every frame
+};
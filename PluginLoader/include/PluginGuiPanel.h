@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "imgui.h"
+#include "IPlugin.h"
+
+// Hosts one plugin's OnGuiRender(): times it and, if the plugin asked for a reduced GUI
+// refresh rate, re-submits the draw commands recorded at the last refresh in between.
+// Replayed frames have no live widgets, so the panel is refreshed every frame while it is
+// hovered, focused for navigation, or while any item/popup is active.
+class PluginGuiPanel
+{
+public:
+    struct Stats
+    {
+        double lastMs = 0.0;
+        double avgMs = 0.0;   // smoothed over rendered frames
+        double peakMs = 0.0;
+        uint32_t rendered = 0;
+        uint32_t replayed = 0;
+        bool replayUnsupported = false; // panel opened child windows or used draw callbacks
+    };
+
+    // 0 = refresh every frame (default).
+    void SetRefreshRate(float hz) { m_refreshHz = hz > 0.0f ? hz : 0.0f; }
+    float GetRefreshRate() const { return m_refreshHz; }
+
+    // Call where OnGuiRender() would be called, inside the host window.
+    void Render(IPlugin* plugin);
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct CachedCmd
+    {
+        ImVec4 clipRect;
+        ImTextureRef texRef;
+        int vtxStart;
+        int vtxCount;
+    };
+
+    bool CanReplay() const;
+    void Record(ImDrawList* drawList, int idxStart, const ImVec2& origin, const ImVec2& size);
+    void Replay(ImDrawList* drawList, const ImVec2& origin) const;
+
+    std::atomic<float> m_refreshHz = 0.0f;
+    Stats m_stats;
+
+    // Last recorded output, de-indexed (one vertex per index) so it can be appended anywhere.
+    ImVector<ImDrawVert> m_vertices;
+    ImVector<CachedCmd> m_cmds;
+    bool m_hasRecording = false;
+    ImVec2 m_origin;
+    ImVec2 m_size;
+    float m_availWidth = 0.0f;
+    float m_fontSize = 0.0f;
+    ImTextureData* m_atlasTex = nullptr;
+    int m_atlasWidth = 0;
+    int m_atlasHeight = 0;
+    double m_lastRefreshTime = 0.0;
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+// Bookkeeping for unloading and hot-reloading plugins at runtime. Kept free of Win32 (PluginManager
+// drives it with real modules) so the state machine can be exercised with mock plugins:
+// - Interface refcounts: which plugin obtained which other plugin's GetInterface() pointer.
+// - Ordering: a plugin goes down only after every plugin holding its interface (transitively) went
+//   down first, and on reload comes back up before them.
+// - Quiescence: a detached module may only be freed after consecutive samples found no thread in it.
+//
+// Per plugin: Active -> Detaching -> Quiescing -> Free -> (removed | Loading -> Active)
+class PluginLifecycle
+{
+public:
+    enum class Action { Unload, Reload };
+
+    enum class Stage
+    {
+        Active,     // Loaded and called every frame
+        Detaching,  // Waiting for OnPluginShutdown and to be dropped from the update/render lists
+        Quiescing,  // Detached; waiting until no thread executes inside the module
+        Free,       // Safe to destroy the instance and free the module
+        Loading,    // Freed as part of a reload; waiting to be loaded again
+        Failed,     // Didn't quiesce in time; left loaded but detached
+    };
+
+    struct QuiescencePolicy
+    {
+        uint32_t requiredCleanSamples = 3;
+        int64_t sampleIntervalMs = 50;
+        int64_t timeoutMs = 5000;
+    };
+
+    void SetPolicy(const QuiescencePolicy& policy) { m_policy = policy; }
+
+    void AddPlugin(const std::string& name);
+
+    // `holder` obtained `target`'s interface pointer. Holders are unloaded before their targets.
+    void AddInterfaceRef(const std::string& holder, const std::string& target);
+    uint32_t GetInterfaceRefs(const std::string& target) const;
+
+    // Queues `name` plus every plugin that (transitively) holds its interface. Only one request
+    // can be in flight; returns false with a reason otherwise.
+    bool Request(const std::string& name, Action action, std::string* error = nullptr);
+    bool IsBusy() const;
+
+    // Render thread: the next plugin to call OnPluginShutdown on, holders first. Empty if none.
+    std::string NextToDetach() const;
+    void OnDetached(const std::string& name, int64_t nowMs);
+    // The plugin refused (or can't be unloaded): it stays Active, and so does everything in the request
+    // not yet detached (the target can't go while a holder stays). Plugins already detached carry on.
+    void OnDetachRefused(const std::string& name);
+
+    // Loader thread: feed "is any thread inside the module" samples while NeedsSample() says so.
+    bool NeedsSample(const std::string& name, int64_t nowMs) const;
+    Stage OnQuiescenceSample(const std::string& name, bool busy, int64_t nowMs);
+
+    // Next Free plugin to destroy, holders first. Empty if none is ready.
+    std::string NextToFree() const;
+    // Drops the plugin's interface refs. Unloaded plugins are forgotten; reloaded ones become Loading.
+    void OnFreed(const std::string& name);
+
+    // Once everything in the request is freed: the next plugin to load again, dependencies first.
+    std::string NextToLoad() const;
+    void OnLoaded(const std::string& name, bool success);
+
+    bool Has(const std::string& name) const { return m_plugins.count(name) != 0; }
+    Stage GetStage(const std::string& name) const;
+    static const char* StageName(Stage stage);
+
+private:
+    struct Entry
+    {
+        Stage stage = Stage::Active;
+        Action action = Action::Unload;
+        uint32_t order = 0;         // Position within the current request; lower goes down first
+        int64_t quiesceStartMs = 0;
+        int64_t lastSampleMs = 0;
+        uint32_t cleanSamples = 0;
+    };
+
+    void CollectHolders(const std::string& name, std::map<std::string, bool>& visited, uint32_t& order);
+    bool AnyInStage(Stage a, Stage b, Stage c) const;
+
+    std::map<std::string, Entry> m_plugins;
+    std::map<std::pair<std::string, std::string>, uint32_t> m_refs; // (holder, target) -> count
+    QuiescencePolicy m_policy;
+};
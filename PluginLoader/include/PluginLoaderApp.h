@@ -23,6 +23,11 @@ public:
 
     void Shutdown();
 
+    // Dumps recorded trace spans next to the loader as <loader>.trace.json (Chrome/Perfetto format).
+    bool WriteTraceFile();
+    // Starts or stops recording raw controller reads to <loader>.input.bin, for offline replay.
+    bool ToggleInputRecording();
+
     PluginManager& GetPluginManager() { return m_pluginManager; }
     ImGuiConsole& GetConsole() { return m_console; }
     PluginLoaderInterface& GetLoaderInterface() { return m_loaderInterface; }
@@ -33,10 +38,15 @@ public:
 private:
     struct LoaderSettings;
 
+    // Once the first frame is up: ranks what startup waited on into <loader>.startup.txt and
+    // compares it with the previous run's <loader>.startup.timeline.
+    void WriteStartupReport(int64_t firstFrameEndUs);
+
     static PluginLoaderApp* s_instance;
 
     HMODULE m_module = nullptr;
     bool m_shutdownRequested = false;
+    bool m_startupReportWritten = false;
 
     PluginManager m_pluginManager;
     ImGuiConsole m_console;
@@ -32,6 +32,10 @@ namespace PluginLoaderConfig {
         PROPERTY(hotkey_ToggleMenu, KeyBind, Serialization::KeyBindAdapter, KeyBind(VK_INSERT));
         PROPERTY(hotkey_ToggleConsole, KeyBind, Serialization::KeyBindAdapter, KeyBind(VK_OEM_3)); // Tilde
         PROPERTY(fontSize, int, Serialization::IntegerAdapter_template<int>, 20);
+        // Keep rasterized glyphs in <loader>.fontcache so later runs skip stb_truetype
+        PROPERTY(FontCache, bool, Serialization::BooleanAdapter, true);
+        // Extra font sizes to bake at startup besides fontSize, comma-separated (e.g. "16, 24")
+        PROPERTY(FontPreloadSizes, std::string, Serialization::StringAdapter, "");
 
         // CPU Settings
         PROPERTY(CpuAffinityMask, uint64_t, Serialization::HexStringAdapter, 0);
@@ -59,6 +63,25 @@ namespace PluginLoaderConfig {
         PROPERTY(EnableFPSLimit, bool, Serialization::BooleanAdapter, false);
         PROPERTY(FPSLimit, int, Serialization::NumericAdapter_template<int>, 60);
 
+        // Skip ImGui frame building while nothing of the overlay is visible
+        PROPERTY(IdleOverlayFastPath, bool, Serialization::BooleanAdapter, true);
+        // Rebuild the interactive overlay (menu, console, plugin windows) at most this often, re-drawing
+        // the last frame in between; input rebuilds at once. 0 = every frame.
+        PROPERTY(OverlayUiRateHz, int, Serialization::NumericAdapter_template<int>, 0);
+
+        // Diagnostics
+        PROPERTY(WriteTraceOnShutdown, bool, Serialization::BooleanAdapter, false);
+        // Startup report: spans that got this much (and 10%) slower than the previous run are flagged.
+        PROPERTY(StartupRegressionMs, int, Serialization::NumericAdapter_template<int>, 20);
+        // Per-plugin render-thread update budget; overruns are logged and shown in the Plugins menu.
+        PROPERTY(PluginUpdateBudgetMs, float, Serialization::NumericAdapter_template<float>, 2.0f);
+        // Hooks the CRT heap to count allocations per frame (shown under Diagnostics). Off by default.
+        PROPERTY(CountFrameAllocations, bool, Serialization::BooleanAdapter, false);
+        // Resolve crash call stacks in-process. Off: raw frames + module list only (symbolize_crash.py).
+        PROPERTY(SymbolizeCrashes, bool, Serialization::BooleanAdapter, true);
+        // Load plugins from shadow copies and offer Unload/Reload in the Plugins menu.
+        PROPERTY(PluginHotReload, bool, Serialization::BooleanAdapter, false);
+
 
         // Overlay mouse *buttons/wheel* routing (overlay only).
         // - Keyboard + mouse movement for overlay stays Win32/WndProc always.
@@ -72,5 +95,6 @@ namespace PluginLoaderConfig {
     void Init(HMODULE hModule);
     void Load();
     void Save();
-    void CheckHotReload();
+    // Returns true if the config was reloaded from disk.
+    bool CheckHotReload();
 }
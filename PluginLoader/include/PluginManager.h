@@ -1,15 +1,27 @@
 #pragma once
 #include <Windows.h>
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <filesystem>
+#include <unordered_map>
 #include "IPlugin.h"
+#include "UpdateScheduler.h"
+#include "PluginGuiPanel.h"
+#include "PluginLifecycle.h"
+#include "HotkeyRegistry.h"
 
 struct LoadedPlugin {
     HMODULE handle = NULL;
     std::unique_ptr<IPlugin> instance;
     std::string name;
     bool showWindow = false;
+    bool ready = false;                    // OnPluginInit has returned
+    uint32_t apiVersion = 0;
+    std::filesystem::path sourcePath;      // The .asi in the plugins folder
+    std::filesystem::path shadowPath;      // The copy actually loaded (hot reload), empty otherwise
 
     LoadedPlugin(HMODULE h, std::unique_ptr<IPlugin> i, std::string n)
         : handle(h), instance(std::move(i)), name(std::move(n)), showWindow(false) {}
@@ -28,6 +40,10 @@ struct LoadedPlugin {
         instance = std::move(other.instance);
         name = std::move(other.name);
         showWindow = other.showWindow;
+        ready = other.ready;
+        apiVersion = other.apiVersion;
+        sourcePath = std::move(other.sourcePath);
+        shadowPath = std::move(other.shadowPath);
         other.handle = NULL; // Steal ownership so other doesn't FreeLibrary
     }
 
@@ -45,12 +61,40 @@ public:
     void RenderPluginMenus();
     void DrawPluginMenu();
     Game GetCurrentGame() const { return m_currentGame; }
-    void* GetPluginInterface(const std::string& name) const;
+    // `caller` is the module asking; if it's a plugin, it now holds a ref on `name` (see PluginLifecycle).
+    void* GetPluginInterface(const std::string& name, HMODULE caller = NULL);
+    UpdateScheduler& GetScheduler() { return m_scheduler; }
+    HotkeyRegistry& GetHotkeys() { return m_hotkeys; }
+    void SetGuiRefreshRate(IPlugin* owner, float hz);
+
+    // Hot reload: load plugins from shadow copies (so the .asi can be rebuilt in place) and offer
+    // Unload/Reload in the Plugins menu. Affects plugins loaded after the call.
+    void SetHotReloadEnabled(bool enabled) { m_hotReload = enabled; }
+    // Queues an unload (or reload) of `name` and every plugin holding its interface.
+    bool RequestUnload(const std::string& name, bool reload);
+    bool RequestUnload(HMODULE module, bool reload);
+    // Loader thread: waits for detached plugins to go quiet, frees them and loads reloaded ones.
+    void ProcessUnloads();
 
 private:
-    void LoadPlugins(PluginLoaderInterface& loaderInterface);
+    void LoadPlugins();
+    // Returns the plugin's name, or an empty string if it couldn't be loaded.
+    std::string LoadPlugin(const std::filesystem::path& path);
+    void ProcessDetaches();
+    std::filesystem::path MakeShadowCopy(const std::filesystem::path& source);
 
+    mutable std::recursive_mutex m_pluginsMutex; // m_plugins, m_detached, m_lifecycle, m_guiPanels
     std::vector<LoadedPlugin> m_plugins;
+    std::vector<LoadedPlugin> m_detached;        // Off the update/render lists, waiting to be freed
+    PluginLifecycle m_lifecycle;
+    PluginLoaderInterface* m_loaderInterface = nullptr;
+    std::filesystem::path m_pluginDir;
+    std::unordered_map<std::string, std::filesystem::path> m_sourcePaths; // Plugin name -> .asi, for reloads
+    uint32_t m_shadowGeneration = 0;
+    std::atomic<bool> m_hotReload{ false };
+    UpdateScheduler m_scheduler;
+    HotkeyRegistry m_hotkeys;
+    std::unordered_map<IPlugin*, PluginGuiPanel> m_guiPanels;
     Game m_currentGame = Game::Unknown;
     HMODULE m_loaderModule = NULL;
 };
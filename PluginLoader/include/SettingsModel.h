@@ -71,6 +71,7 @@ public:
     void DrawAppearanceSection();
     void DrawFramerateSection();
     void DrawInputSection();
+    void DrawDiagnosticsSection();
 
     bool DrawSaveRow(); // returns true if saved
 
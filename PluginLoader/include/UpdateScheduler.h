@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include "IPlugin.h"
+
+// Runs plugin update work: the legacy per-frame OnUpdate() plus tasks registered through
+// PluginLoaderInterface::RegisterUpdateTask. Render-thread tasks run from UpdatePlugins(),
+// worker tasks on a dedicated thread. Time spent is accounted per plugin against a budget.
+class UpdateScheduler
+{
+public:
+    struct PluginStats
+    {
+        std::string name;
+        double lastFrameMs = 0.0; // render thread, last frame
+        double avgFrameMs = 0.0;  // render thread, smoothed
+        double peakFrameMs = 0.0;
+        double workerAvgMs = 0.0; // per worker task run, smoothed
+        uint32_t overruns = 0;
+        uint32_t deferredRuns = 0; // rate/event tasks pushed to a later frame by the budget
+        size_t taskCount = 0;
+    };
+
+    ~UpdateScheduler();
+
+    void Start();
+    void Stop();
+
+    void AddPlugin(IPlugin* owner, const std::string& name);
+    // Unregisters all tasks of `owner` and waits until none of them is running.
+    void RemovePlugin(IPlugin* owner);
+
+    UpdateTaskHandle Register(IPlugin* owner, const UpdateTaskDesc& desc);
+    void Unregister(UpdateTaskHandle handle);
+    void Signal(const char* eventName);
+
+    void SetBudgetMs(double budgetMs) { m_budgetUs = (int64_t)(budgetMs * 1000.0); }
+    double GetBudgetMs() const { return m_budgetUs.load() / 1000.0; }
+
+    // Render thread. Calls OnUpdate() on each plugin, then the due render-thread tasks,
+    // all counted against the owning plugin's budget for this frame.
+    void RunRenderThread(const std::vector<IPlugin*>& plugins);
+
+    bool GetStats(IPlugin* owner, PluginStats& out) const;
+
+private:
+    struct Task
+    {
+        UpdateTaskHandle handle = 0;
+        IPlugin* owner = nullptr;
+        std::string name;
+        void (*callback)(void*) = nullptr;
+        void* userData = nullptr;
+        UpdateFrequency frequency = UpdateFrequency::EveryFrame;
+        UpdateAffinity affinity = UpdateAffinity::RenderThread;
+        int64_t periodUs = 0;
+        std::string eventName;
+
+        int64_t nextDueUs = 0;
+        bool eventPending = false;
+        int64_t deferredSinceUs = 0;     // First frame the budget held this task back; 0 = not deferred
+        uint64_t lastFrame = 0;
+        bool removed = false;
+        int running = 0;
+        std::thread::id runningThread;
+    };
+
+    struct Budget
+    {
+        std::string name;
+        int64_t frameUs = 0;
+        int64_t taskUs = 0;              // frameUs without OnUpdate(), which the deferral test ignores
+        double avgFrameMs = 0.0;
+        double lastFrameMs = 0.0;
+        double peakFrameMs = 0.0;
+        double workerAvgMs = 0.0;
+        uint32_t overruns = 0;
+        uint32_t deferredRuns = 0;
+    };
+
+    static int64_t NowUs();
+
+    bool IsDue(const Task& task, int64_t nowUs, uint64_t frame) const;
+    // Whether a due rate/event task of a plugin over its budget waits another frame. A task that
+    // has already waited kMaxDeferral (or a whole period, if longer) runs regardless.
+    bool Defer(Task& task, const Budget& budget, int64_t budgetUs, int64_t nowUs);
+    void MarkRan(Task& task, int64_t nowUs, uint64_t frame);
+    Task* FindTask(UpdateTaskHandle handle);
+    // Runs one task if it is still registered. Returns the elapsed time in microseconds, or -1 if skipped.
+    int64_t Execute(UpdateTaskHandle handle, uint64_t frame);
+    void WorkerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;        // wakes the worker (new frame, signal, stop)
+    std::condition_variable m_idleCv;    // notified whenever a task finishes running
+    std::vector<Task> m_tasks;
+    std::unordered_map<IPlugin*, Budget> m_budgets;
+    UpdateTaskHandle m_nextHandle = 1;
+    uint64_t m_frame = 0;
+
+    std::atomic<int64_t> m_budgetUs = 2000;
+    std::thread m_worker;
+    bool m_stop = false;
+};
@@ -0,0 +1,133 @@
+#include "HotkeyRegistry.h"
+#include "KeyBind.h"
+
+HotkeyChord HotkeyRegistry::ToChord(const HotkeyDesc& desc)
+{
+    HotkeyChord chord;
+    chord.keyboardKey = desc.keyboardKey;
+    chord.ctrl = desc.ctrl;
+    chord.shift = desc.shift;
+    chord.alt = desc.alt;
+    chord.controllerKey = desc.controllerKey;
+    chord.strict = desc.strict;
+    return chord;
+}
+
+HotkeyHandle HotkeyRegistry::Register(IPlugin* owner, const HotkeyDesc& desc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const HotkeyHandle handle = m_matcher.Add(ToChord(desc), desc.events);
+    m_subscriptions[handle] = Subscription{ owner, desc.callback, desc.userData };
+    return handle;
+}
+
+bool HotkeyRegistry::Update(HotkeyHandle handle, const HotkeyDesc& desc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_subscriptions.find(handle);
+    if (it == m_subscriptions.end())
+        return false;
+
+    m_matcher.SetChord(handle, ToChord(desc));
+    m_matcher.SetEventMask(handle, desc.events);
+    it->second.callback = desc.callback;
+    it->second.userData = desc.userData;
+    return true;
+}
+
+void HotkeyRegistry::Unregister(HotkeyHandle handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_subscriptions.erase(handle))
+        m_matcher.Remove(handle);
+}
+
+void HotkeyRegistry::RemovePlugin(IPlugin* owner)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();)
+    {
+        if (it->second.owner == owner)
+        {
+            m_matcher.Remove(it->first);
+            it = m_subscriptions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool HotkeyRegistry::IsDown(HotkeyHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_matcher.IsDown(handle);
+}
+
+void HotkeyRegistry::OnWindowMessage(UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    switch (msg)
+    {
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+    {
+        const bool down = (msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN);
+        UINT vk = (UINT)wParam;
+        // Track modifiers per side, so releasing one Shift while the other is held keeps Shift down.
+        const bool extended = (lParam & (1 << 24)) != 0;
+        if (vk == VK_SHIFT)
+            vk = MapVirtualKeyW((lParam >> 16) & 0xFF, MAPVK_VSC_TO_VK_EX);
+        else if (vk == VK_CONTROL)
+            vk = extended ? VK_RCONTROL : VK_LCONTROL;
+        else if (vk == VK_MENU)
+            vk = extended ? VK_RMENU : VK_LMENU;
+        m_keys.SetKey(vk, down);
+        break;
+    }
+    case WM_LBUTTONDOWN: case WM_LBUTTONDBLCLK: m_keys.SetKey(VK_LBUTTON, true); break;
+    case WM_LBUTTONUP:                          m_keys.SetKey(VK_LBUTTON, false); break;
+    case WM_RBUTTONDOWN: case WM_RBUTTONDBLCLK: m_keys.SetKey(VK_RBUTTON, true); break;
+    case WM_RBUTTONUP:                          m_keys.SetKey(VK_RBUTTON, false); break;
+    case WM_MBUTTONDOWN: case WM_MBUTTONDBLCLK: m_keys.SetKey(VK_MBUTTON, true); break;
+    case WM_MBUTTONUP:                          m_keys.SetKey(VK_MBUTTON, false); break;
+    case WM_XBUTTONDOWN:
+    case WM_XBUTTONDBLCLK:
+    case WM_XBUTTONUP:
+        m_keys.SetKey(GET_XBUTTON_WPARAM(wParam) == XBUTTON1 ? VK_XBUTTON1 : VK_XBUTTON2, msg != WM_XBUTTONUP);
+        break;
+    case WM_KILLFOCUS:
+        m_keys.ReleaseAll();
+        break;
+    case WM_ACTIVATEAPP:
+        if (!wParam)
+            m_keys.ReleaseAll();
+        break;
+    default:
+        break;
+    }
+}
+
+void HotkeyRegistry::Poll()
+{
+    // One provider call per frame, however many binds use the pad.
+    XINPUT_STATE state{};
+    m_keys.SetPadButtons(KeyBind::GetControllerState(0, &state) ? KeyBind::GetGamepadFlags(state) : 0);
+    const InputSnapshot input = m_keys.TakeSnapshot();
+
+    m_pending.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_matcher.Match(input, GetTickCount64(), [&](const HotkeyMatcher::Event& e) {
+            auto it = m_subscriptions.find(e.id);
+            if (it != m_subscriptions.end() && it->second.callback)
+                m_pending.push_back(PendingCall{ it->second, HotkeyEventInfo{ e.id, e.event, (uint32_t)e.heldMs } });
+        });
+    }
+
+    // Outside the lock: callbacks may (un)register hotkeys.
+    for (const PendingCall& call : m_pending)
+        call.sub.callback(call.sub.userData, call.info);
+}
@@ -68,6 +68,11 @@ namespace Ui
                         m_settings.DrawInputSection();
                     }
 
+                    if (ImGui::CollapsingHeader("Diagnostics"))
+                    {
+                        m_settings.DrawDiagnosticsSection();
+                    }
+
                     m_settings.DrawSaveRow();
                 }
 
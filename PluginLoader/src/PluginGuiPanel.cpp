@@ -0,0 +1,196 @@
+#include "PluginGuiPanel.h"
+#include "imgui_internal.h"
+#include <chrono>
+
+namespace
+{
+    constexpr double kAvgSmoothing = 0.05;
+    // Keep each replayed chunk well below the 16-bit index limit.
+    constexpr int kMaxVerticesPerChunk = 30000;
+
+    // What the panel can draw outside the host window's list: other windows (popups, tooltips,
+    // overlays) and the viewports' background/foreground lists. Compared before and after the call.
+    struct ExternalDrawState
+    {
+        int windowsActive = 0;
+        int bgFgVertices = 0;
+
+        static ExternalDrawState Capture()
+        {
+            const ImGuiContext& g = *ImGui::GetCurrentContext();
+            ExternalDrawState state;
+            state.windowsActive = g.WindowsActiveCount;
+            for (const ImGuiViewportP* viewport : g.Viewports)
+                for (const ImDrawList* list : viewport->BgFgDrawLists)
+                    state.bgFgVertices += list ? list->VtxBuffer.Size : 0;
+            return state;
+        }
+
+        bool operator!=(const ExternalDrawState& other) const
+        {
+            return windowsActive != other.windowsActive || bgFgVertices != other.bgFgVertices;
+        }
+    };
+}
+
+bool PluginGuiPanel::CanReplay() const
+{
+    if (m_refreshHz <= 0.0f || !m_hasRecording || m_stats.replayUnsupported)
+        return false;
+
+    if (ImGui::GetTime() - m_lastRefreshTime >= 1.0 / m_refreshHz)
+        return false;
+
+    // Anything interactive needs real widgets.
+    const ImGuiIO& io = ImGui::GetIO();
+    if (ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows | ImGuiHoveredFlags_AllowWhenBlockedByActiveItem) ||
+        (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) && io.NavVisible) ||
+        ImGui::IsAnyItemActive() ||
+        ImGui::IsPopupOpen("", ImGuiPopupFlags_AnyPopupId | ImGuiPopupFlags_AnyPopupLevel))
+        return false;
+
+    // Layout or font texture changed since the recording.
+    const ImFontAtlas* atlas = io.Fonts;
+    if (ImGui::GetContentRegionAvail().x != m_availWidth || ImGui::GetFontSize() != m_fontSize ||
+        atlas->TexData != m_atlasTex || (atlas->TexData && (atlas->TexData->Width != m_atlasWidth || atlas->TexData->Height != m_atlasHeight)))
+        return false;
+
+    return true;
+}
+
+void PluginGuiPanel::Render(IPlugin* plugin)
+{
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    ImDrawList* drawList = window->DrawList;
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+
+    if (CanReplay())
+    {
+        Replay(drawList, origin);
+        if (m_size.y > 0.0f)    // A panel that submitted nothing left the cursor where it was
+            ImGui::Dummy(m_size);
+        m_stats.replayed++;
+        return;
+    }
+
+    const float availWidth = ImGui::GetContentRegionAvail().x;
+    const int idxStart = drawList->IdxBuffer.Size;
+    const int childWindowsBefore = window->DC.ChildWindows.Size;
+    const ExternalDrawState externalBefore = ExternalDrawState::Capture();
+
+    // CursorMaxPos covers everything the host drew before the panel; measure the panel on its own
+    // and merge the host's extent back afterwards.
+    const ImVec2 hostMaxPos = window->DC.CursorMaxPos;
+    window->DC.CursorMaxPos = origin;
+
+    const auto start = std::chrono::steady_clock::now();
+    plugin->OnGuiRender();
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const ImVec2 panelMaxPos = window->DC.CursorMaxPos;
+    const ImVec2 endCursor = window->DC.CursorPos;
+    window->DC.CursorMaxPos = ImMax(hostMaxPos, panelMaxPos);
+
+    m_stats.lastMs = elapsedMs;
+    m_stats.avgMs = (m_stats.avgMs == 0.0) ? elapsedMs : m_stats.avgMs + (elapsedMs - m_stats.avgMs) * kAvgSmoothing;
+    m_stats.peakMs = (std::max)(m_stats.peakMs * 0.999, elapsedMs);
+    m_stats.rendered++;
+
+    if (m_refreshHz <= 0.0f || m_stats.replayUnsupported)
+        return;
+
+    // Child windows (and scrolling tables) draw into their own lists, which we don't capture.
+    if (window->DC.ChildWindows.Size != childWindowsBefore)
+    {
+        m_stats.replayUnsupported = true;
+        m_hasRecording = false;
+        return;
+    }
+
+    // Popups, tooltips or overlay drawing this frame: a replay would drop them, so keep rendering
+    // live until a refresh draws only into the host window again.
+    if (ExternalDrawState::Capture() != externalBefore)
+    {
+        m_hasRecording = false;
+        return;
+    }
+
+    m_availWidth = availWidth;
+    m_fontSize = ImGui::GetFontSize();
+    m_atlasTex = ImGui::GetIO().Fonts->TexData;
+    m_atlasWidth = m_atlasTex ? m_atlasTex->Width : 0;
+    m_atlasHeight = m_atlasTex ? m_atlasTex->Height : 0;
+    m_lastRefreshTime = ImGui::GetTime();
+    // The cursor ends one item spacing below the last item, which the Dummy() on replay adds back.
+    Record(drawList, idxStart, origin, ImVec2(panelMaxPos.x - origin.x, endCursor.y - origin.y - ImGui::GetStyle().ItemSpacing.y));
+}
+
+void PluginGuiPanel::Record(ImDrawList* drawList, int idxStart, const ImVec2& origin, const ImVec2& size)
+{
+    m_vertices.resize(0);
+    m_cmds.resize(0);
+    m_origin = origin;
+    m_size = ImVec2((std::max)(size.x, 0.0f), (std::max)(size.y, 0.0f));
+    m_hasRecording = true;
+
+    // Walk by index range rather than command index: ImDrawList may merge commands as it goes.
+    const int idxEnd = drawList->IdxBuffer.Size;
+    for (const ImDrawCmd& cmd : drawList->CmdBuffer)
+    {
+        const int cmdStart = (int)cmd.IdxOffset;
+        const int cmdEnd = cmdStart + (int)cmd.ElemCount;
+        const int from = (std::max)(cmdStart, idxStart);
+        const int to = (std::min)(cmdEnd, idxEnd);
+        if (from >= to)
+            continue;
+
+        if (cmd.UserCallback != nullptr)
+        {
+            m_stats.replayUnsupported = true;
+            m_hasRecording = false;
+            return;
+        }
+
+        CachedCmd cached;
+        cached.clipRect = cmd.ClipRect;
+        cached.texRef = cmd.TexRef;
+        cached.vtxStart = m_vertices.Size;
+        cached.vtxCount = to - from;
+        for (int i = from; i < to; i++)
+            m_vertices.push_back(drawList->VtxBuffer[cmd.VtxOffset + drawList->IdxBuffer[i]]);
+        m_cmds.push_back(cached);
+    }
+}
+
+void PluginGuiPanel::Replay(ImDrawList* drawList, const ImVec2& origin) const
+{
+    // The host may have scrolled or moved since the recording.
+    const ImVec2 delta(origin.x - m_origin.x, origin.y - m_origin.y);
+
+    for (const CachedCmd& cmd : m_cmds)
+    {
+        drawList->PushClipRect(ImVec2(cmd.clipRect.x + delta.x, cmd.clipRect.y + delta.y),
+                               ImVec2(cmd.clipRect.z + delta.x, cmd.clipRect.w + delta.y), true);
+        drawList->PushTexture(cmd.texRef);
+
+        for (int chunkStart = 0; chunkStart < cmd.vtxCount; chunkStart += kMaxVerticesPerChunk)
+        {
+            const int count = (std::min)(kMaxVerticesPerChunk, cmd.vtxCount - chunkStart);
+            drawList->PrimReserve(count, count);
+            const ImDrawVert* src = m_vertices.Data + cmd.vtxStart + chunkStart;
+            for (int i = 0; i < count; i++)
+            {
+                drawList->_VtxWritePtr[i] = src[i];
+                drawList->_VtxWritePtr[i].pos.x += delta.x;
+                drawList->_VtxWritePtr[i].pos.y += delta.y;
+                drawList->_IdxWritePtr[i] = (ImDrawIdx)(drawList->_VtxCurrentIdx + i);
+            }
+            drawList->_VtxWritePtr += count;
+            drawList->_IdxWritePtr += count;
+            drawList->_VtxCurrentIdx += count;
+        }
+
+        drawList->PopTexture();
+        drawList->PopClipRect();
+    }
+}
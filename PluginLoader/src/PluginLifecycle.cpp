@@ -0,0 +1,250 @@
+#include "PluginLifecycle.h"
+
+void PluginLifecycle::AddPlugin(const std::string& name)
+{
+    Entry& entry = m_plugins[name];
+    entry = Entry{};
+}
+
+void PluginLifecycle::AddInterfaceRef(const std::string& holder, const std::string& target)
+{
+    if (holder.empty() || holder == target || !Has(holder) || !Has(target))
+        return;
+    ++m_refs[{ holder, target }];
+}
+
+uint32_t PluginLifecycle::GetInterfaceRefs(const std::string& target) const
+{
+    uint32_t total = 0;
+    for (const auto& [key, count] : m_refs)
+    {
+        if (key.second == target)
+            total += count;
+    }
+    return total;
+}
+
+bool PluginLifecycle::AnyInStage(Stage a, Stage b, Stage c) const
+{
+    for (const auto& [name, entry] : m_plugins)
+    {
+        if (entry.stage == a || entry.stage == b || entry.stage == c)
+            return true;
+    }
+    return false;
+}
+
+bool PluginLifecycle::IsBusy() const
+{
+    return AnyInStage(Stage::Detaching, Stage::Quiescing, Stage::Free) || AnyInStage(Stage::Loading, Stage::Loading, Stage::Loading);
+}
+
+// Post-order walk over "who holds my interface": holders get lower orders, so they go down first.
+void PluginLifecycle::CollectHolders(const std::string& name, std::map<std::string, bool>& visited, uint32_t& order)
+{
+    visited[name] = true;
+    for (const auto& [key, count] : m_refs)
+    {
+        const std::string& holder = key.first;
+        if (key.second != name || count == 0 || visited.count(holder))
+            continue;
+
+        auto it = m_plugins.find(holder);
+        if (it == m_plugins.end() || it->second.stage != Stage::Active)
+            continue;
+
+        CollectHolders(holder, visited, order);
+    }
+    m_plugins[name].order = order++;
+}
+
+bool PluginLifecycle::Request(const std::string& name, Action action, std::string* error)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end() || it->second.stage != Stage::Active)
+    {
+        if (error) *error = "plugin is not loaded";
+        return false;
+    }
+    if (IsBusy())
+    {
+        if (error) *error = "another unload/reload is still in progress";
+        return false;
+    }
+
+    std::map<std::string, bool> visited;
+    uint32_t order = 0;
+    CollectHolders(name, visited, order);
+
+    for (const auto& [member, unused] : visited)
+    {
+        Entry& entry = m_plugins[member];
+        entry.stage = Stage::Detaching;
+        entry.action = action;
+        entry.cleanSamples = 0;
+    }
+    return true;
+}
+
+std::string PluginLifecycle::NextToDetach() const
+{
+    const std::string* next = nullptr;
+    uint32_t best = UINT32_MAX;
+    for (const auto& [name, entry] : m_plugins)
+    {
+        if (entry.stage == Stage::Detaching && entry.order < best)
+        {
+            best = entry.order;
+            next = &name;
+        }
+    }
+    return next ? *next : std::string();
+}
+
+void PluginLifecycle::OnDetached(const std::string& name, int64_t nowMs)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end() || it->second.stage != Stage::Detaching)
+        return;
+
+    Entry& entry = it->second;
+    entry.stage = Stage::Quiescing;
+    entry.quiesceStartMs = nowMs;
+    entry.lastSampleMs = nowMs - m_policy.sampleIntervalMs; // First sample right away
+    entry.cleanSamples = 0;
+}
+
+void PluginLifecycle::OnDetachRefused(const std::string& name)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end() || it->second.stage != Stage::Detaching)
+        return;
+
+    // Whatever is still waiting to detach is either a dependency of this plugin or the request's
+    // target; neither can go while this one stays.
+    for (auto& [member, entry] : m_plugins)
+    {
+        if (entry.stage == Stage::Detaching)
+            entry.stage = Stage::Active;
+    }
+}
+
+bool PluginLifecycle::NeedsSample(const std::string& name, int64_t nowMs) const
+{
+    auto it = m_plugins.find(name);
+    return it != m_plugins.end() && it->second.stage == Stage::Quiescing
+        && nowMs - it->second.lastSampleMs >= m_policy.sampleIntervalMs;
+}
+
+PluginLifecycle::Stage PluginLifecycle::OnQuiescenceSample(const std::string& name, bool busy, int64_t nowMs)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end())
+        return Stage::Failed;
+
+    Entry& entry = it->second;
+    if (entry.stage != Stage::Quiescing)
+        return entry.stage;
+
+    entry.lastSampleMs = nowMs;
+    entry.cleanSamples = busy ? 0 : entry.cleanSamples + 1;
+
+    if (entry.cleanSamples >= m_policy.requiredCleanSamples)
+        entry.stage = Stage::Free;
+    else if (nowMs - entry.quiesceStartMs >= m_policy.timeoutMs)
+        entry.stage = Stage::Failed;
+    return entry.stage;
+}
+
+std::string PluginLifecycle::NextToFree() const
+{
+    const std::string* next = nullptr;
+    uint32_t best = UINT32_MAX;
+    for (const auto& [name, entry] : m_plugins)
+    {
+        if (entry.stage == Stage::Free && entry.order < best)
+        {
+            best = entry.order;
+            next = &name;
+        }
+    }
+    if (!next)
+        return std::string();
+
+    // Holders first: wait for anything ahead of it that is still on its way down.
+    for (const auto& [name, entry] : m_plugins)
+    {
+        if ((entry.stage == Stage::Detaching || entry.stage == Stage::Quiescing) && entry.order < best)
+            return std::string();
+    }
+    return *next;
+}
+
+void PluginLifecycle::OnFreed(const std::string& name)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end())
+        return;
+
+    for (auto ref = m_refs.begin(); ref != m_refs.end();)
+    {
+        const bool involved = ref->first.first == name || (it->second.action == Action::Unload && ref->first.second == name);
+        ref = involved ? m_refs.erase(ref) : std::next(ref);
+    }
+
+    if (it->second.action == Action::Reload)
+        it->second.stage = Stage::Loading;
+    else
+        m_plugins.erase(it);
+}
+
+std::string PluginLifecycle::NextToLoad() const
+{
+    if (AnyInStage(Stage::Detaching, Stage::Quiescing, Stage::Free))
+        return std::string();
+
+    // Reverse of the unload order: the plugin whose interface others use comes back first.
+    const std::string* next = nullptr;
+    uint32_t best = 0;
+    for (const auto& [name, entry] : m_plugins)
+    {
+        if (entry.stage == Stage::Loading && (!next || entry.order > best))
+        {
+            best = entry.order;
+            next = &name;
+        }
+    }
+    return next ? *next : std::string();
+}
+
+void PluginLifecycle::OnLoaded(const std::string& name, bool success)
+{
+    auto it = m_plugins.find(name);
+    if (it == m_plugins.end() || it->second.stage != Stage::Loading)
+        return;
+
+    if (success)
+        it->second = Entry{};
+    else
+        m_plugins.erase(it);
+}
+
+PluginLifecycle::Stage PluginLifecycle::GetStage(const std::string& name) const
+{
+    auto it = m_plugins.find(name);
+    return it != m_plugins.end() ? it->second.stage : Stage::Failed;
+}
+
+const char* PluginLifecycle::StageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::Active:    return "Active";
+    case Stage::Detaching: return "Detaching";
+    case Stage::Quiescing: return "Waiting for threads";
+    case Stage::Free:      return "Freeing";
+    case Stage::Loading:   return "Reloading";
+    case Stage::Failed:    return "Unload failed";
+    }
+    return "?";
+}
@@ -4,12 +4,29 @@
 #include "core/WindowedMode.h"
 #include "core/BaseHook.h"
 #include "log.h"
+#include "Trace.h"
 
 #include <windows.h>
 
+// Everything the process did before the loader was mapped (the game's own startup, other injected
+// DLLs), so the startup report covers the whole way to the first frame.
+static void RecordProcessStart()
+{
+    FILETIME creation, exitTime, kernelTime, userTime, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernelTime, &userTime))
+        return;
+    GetSystemTimePreciseAsFileTime(&now);
+
+    auto toUs = [](const FILETIME& ft) { return (int64_t)(((uint64_t)ft.dwHighDateTime << 32 | ft.dwLowDateTime) / 10); };
+    const int64_t elapsedUs = toUs(now) - toUs(creation);
+    if (elapsedUs > 0)
+        Trace::Record("ProcessStart", "loader", nullptr, Trace::NowUs() - elapsedUs, elapsedUs, Trace::CurrentThreadId());
+}
+
 static DWORD WINAPI MainThread(LPVOID lpReserved)
 {
     auto hMod = (HMODULE)lpReserved;
+    Trace::SetThreadName("Loader");
 
     PluginLoaderApp app(hMod);
     app.Init();
@@ -31,6 +48,10 @@ BOOL WINAPI DllMain(HMODULE hMod, DWORD dwReason, LPVOID lpReserved)
     {
         DisableThreadLibraryCalls(hMod);
 
+        Trace::SetThreadName("Game (DllMain)");
+        RecordProcessStart();
+        TRACE_SCOPE_CAT("DllMain", "loader");
+
         Log::Init(hMod);
 
         // Initialize config early so all hooks can use it
@@ -6,13 +6,23 @@
 #include "ImGuiCTX.h"
 #include "ImGuiConfigUtils.h"
 #include "KeyBind.h"
+#include "PluginHotkey.h"
 #include "core/WindowedMode.h"
 #include "crash_handler.h"
 #include "log.h"
+#include "Trace.h"
+#include "StartupTimeline.h"
 #include "InputCapture.h"
 #include "util/FramerateLimiter.h"
+#include "util/OverlayFrameGate.h"
+#include "util/AllocationCounter.h"
+#include "util/FontAtlasCache.h"
 
 #include <windows.h>
+#include <intrin.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
@@ -77,39 +87,110 @@ namespace
     void* GetPluginInterface_Impl(const char* pluginName)
     {
         auto* app = PluginLoaderApp::Get();
-        return app ? app->GetPluginManager().GetPluginInterface(pluginName) : nullptr;
+        if (!app)
+            return nullptr;
+
+        // Remember who asked, so the caller is unloaded before the plugin it holds a pointer into.
+        HMODULE caller = NULL;
+        GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (LPCSTR)_ReturnAddress(), &caller);
+        return app->GetPluginManager().GetPluginInterface(pluginName, caller);
     }
 
-    void PluginLoaderInterface_RequestUnload(HMODULE /*pluginHandle*/)
+    void SubmitTraceSpan_Impl(const char* name, const char* category, const char* detail,
+                              int64_t startUs, int64_t durationUs, uint32_t threadId)
     {
-        LOG_WARN("RequestUnload is not implemented. Plugins cannot be unloaded at runtime.");
+        Trace::Record(name, category, detail, startUs, durationUs, threadId);
     }
 
-    // Helper for polling hotkeys with "rising edge" detection
-    struct HotkeyPoller
+    UpdateTaskHandle RegisterUpdateTask_Impl(IPlugin* owner, const UpdateTaskDesc& desc)
     {
-        KeyBind lastBind;
-        bool wasDown = false;
+        auto* app = PluginLoaderApp::Get();
+        return app ? app->GetPluginManager().GetScheduler().Register(owner, desc) : 0;
+    }
 
-        // Returns true if the action should trigger (pressed this frame, wasn't pressed last frame)
-        bool Update(const KeyBind& currentBind)
-        {
-            // Reset state if bind changes to prevent accidental triggers
-            if (currentBind != lastBind)
-            {
-                if (currentBind.IsPressed()) wasDown = true;
-                lastBind = currentBind;
-            }
+    void UnregisterUpdateTask_Impl(UpdateTaskHandle handle)
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().GetScheduler().Unregister(handle);
+    }
 
-            bool pressed = currentBind.IsPressed();
-            bool triggered = pressed && !wasDown;
-            wasDown = pressed;
-            return triggered;
-        }
-    };
+    void SignalUpdateEvent_Impl(const char* eventName)
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().GetScheduler().Signal(eventName);
+    }
+
+    void SetGuiRefreshRate_Impl(IPlugin* owner, float hz)
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().SetGuiRefreshRate(owner, hz);
+    }
+
+    HotkeyHandle RegisterHotkey_Impl(IPlugin* owner, const HotkeyDesc& desc)
+    {
+        auto* app = PluginLoaderApp::Get();
+        return app ? app->GetPluginManager().GetHotkeys().Register(owner, desc) : 0;
+    }
+
+    bool UpdateHotkey_Impl(HotkeyHandle handle, const HotkeyDesc& desc)
+    {
+        auto* app = PluginLoaderApp::Get();
+        return app && app->GetPluginManager().GetHotkeys().Update(handle, desc);
+    }
+
+    void UnregisterHotkey_Impl(HotkeyHandle handle)
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().GetHotkeys().Unregister(handle);
+    }
+
+    bool IsHotkeyDown_Impl(HotkeyHandle handle)
+    {
+        auto* app = PluginLoaderApp::Get();
+        return app && app->GetPluginManager().GetHotkeys().IsDown(handle);
+    }
+
+    bool GetControllerMotion_Impl(ControllerMotionState* out)
+    {
+        return BaseHook::Hooks::TryGetControllerMotion(out);
+    }
+
+    bool GetControllerPresence_Impl(ControllerPresence* out)
+    {
+        BaseHook::PadPresence presence;
+        if (!out || !BaseHook::Hooks::GetPadPresence(&presence))
+            return false;
+        out->connectedMask = presence.connectedMask;
+        out->preferredIndex = presence.preferredIndex;
+        out->generation = presence.generation;
+        return true;
+    }
+
+    bool WaitForFrameLimit_Impl()
+    {
+        if (!BaseHook::g_FramerateLimiter.IsEnabled())
+            return false;
+        BaseHook::g_FramerateLimiter.Wait(BaseHook::FrameWaitSite::GameLoop);
+        return true;
+    }
+
+    bool GetFrameTiming_Impl(FrameTiming* out)
+    {
+        return out && BaseHook::g_FramerateLimiter.GetFrameTiming(*out);
+    }
+
+    void PluginLoaderInterface_RequestUnload(HMODULE pluginHandle)
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().RequestUnload(pluginHandle, false);
+    }
 
     LRESULT __stdcall LoaderWndProc(const HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     {
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().GetHotkeys().OnWindowMessage(uMsg, wParam, lParam);
+
         bool renderInBackground = PluginLoaderConfig::g_Config.RenderInBackground.get();
         const bool configuredExclusiveFullscreen =
             (PluginLoaderConfig::g_Config.WindowedMode.get() == PluginLoaderConfig::WindowedMode::ExclusiveFullscreen);
@@ -173,6 +254,11 @@ struct PluginLoaderApp::LoaderSettings : public BaseHook::Settings
         m_DirectXVersion = (int)PluginLoaderConfig::g_Config.DirectXVersion.get();
         m_CursorClipMode = (int)PluginLoaderConfig::g_Config.CursorClipMode.get();
         m_RenderInBackground = PluginLoaderConfig::g_Config.RenderInBackground.get();
+
+        if (PluginLoaderConfig::g_Config.FontCache.get())
+            m_FontCacheDir = std::filesystem::path(PluginLoaderConfig::g_ConfigFilepath).replace_extension(".fontcache");
+        m_FontPreloadScales = GetFontPreloadScales();
+        m_VTableCachePath = std::filesystem::path(PluginLoaderConfig::g_ConfigFilepath).replace_extension(".vtables");
         
         // Sync multi-viewport setting
         BaseHook::WindowedMode::SetMultiViewportEnabled(PluginLoaderConfig::g_Config.EnableMultiViewport.get());
@@ -182,6 +268,24 @@ struct PluginLoaderApp::LoaderSettings : public BaseHook::Settings
     void OnActivate() override {}
     void OnDetach() override {}
 
+    // The configured font size first, then FontPreloadSizes (same units as fontSize).
+    static std::vector<float> GetFontPreloadScales()
+    {
+        std::vector<float> scales = { (float)PluginLoaderConfig::g_Config.fontSize.get() / 13.0f };
+        const std::string& sizes = PluginLoaderConfig::g_Config.FontPreloadSizes.get();
+        for (size_t pos = 0; pos < sizes.size();)
+        {
+            size_t end = sizes.find(',', pos);
+            if (end == std::string::npos)
+                end = sizes.size();
+            const int size = atoi(sizes.substr(pos, end - pos).c_str());
+            if (size >= 8 && size <= 64)
+                scales.push_back((float)size / 13.0f);
+            pos = end + 1;
+        }
+        return scales;
+    }
+
     void DrawOverlay() override
     {
         ImGuiIO& io = ImGui::GetIO();
@@ -193,34 +297,104 @@ struct PluginLoaderApp::LoaderSettings : public BaseHook::Settings
                 app->GetLoaderInterface().m_ImGuiContext = ImGui::GetCurrentContext();
         }
 
-        const HWND foreground = GetForegroundWindow();
-        const bool is_focused = (foreground == BaseHook::Data::hWindow);
+        const bool is_focused = (GetForegroundWindow() == BaseHook::Data::hWindow);
+        PollHotkeys(is_focused);
+
+        ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetConsole().Draw("Console");
+
+        UpdateInputState(is_focused);
+        UpdatePlugins();
+    }
+
+    BaseHook::OverlayActivity GetOverlayActivity() override
+    {
+        if (BaseHook::Data::bShowMenu)
+            return BaseHook::OverlayActivity::Active;
+
+        auto* app = PluginLoaderApp::Get();
+        const ConsoleMode cm = app ? app->GetConsole().mode : ConsoleMode::Hidden;
+        if (cm == ConsoleMode::ForegroundAndFocusable)
+            return BaseHook::OverlayActivity::Active;
 
-        // --- Controller/Keyboard Hotkey Polling ---
-        // Only poll if window is focused and ImGui doesn't want keyboard input
-        if (is_focused && !io.WantCaptureKeyboard)
+        // Still holding focus or capture from the last frame: let ImGui finish with it.
+        const ImGuiIO& io = ImGui::GetIO();
+        if (io.WantCaptureMouse || io.WantCaptureKeyboard || io.WantTextInput || ImGui::IsAnyItemActive())
+            return BaseHook::OverlayActivity::Active;
+
+        if (cm == ConsoleMode::BackgroundSemitransparentAndUnfocusable)
         {
-             static HotkeyPoller s_menuPoller;
-             static HotkeyPoller s_consolePoller;
-
-             if (s_menuPoller.Update(PluginLoaderConfig::g_Config.hotkey_ToggleMenu.get()))
-             {
-                 BaseHook::Data::bShowMenu = !BaseHook::Data::bShowMenu;
-             }
-
-             if (s_consolePoller.Update(PluginLoaderConfig::g_Config.hotkey_ToggleConsole.get()))
-             {
-                 if (auto* app = PluginLoaderApp::Get())
-                     app->GetConsole().ToggleVisibility();
-             }
+            // The background console only changes when a line is logged.
+            const uint32_t revision = app->GetConsole().GetRevision();
+            if (revision != m_consoleRevision)
+            {
+                m_consoleRevision = revision;
+                return BaseHook::OverlayActivity::Active;
+            }
+            return BaseHook::OverlayActivity::Static;
         }
-        // --------------------------------
 
-        ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+        return BaseHook::OverlayActivity::Idle;
+    }
 
+    void UpdateWithoutFrame() override
+    {
+        const bool is_focused = (GetForegroundWindow() == BaseHook::Data::hWindow);
+        PollHotkeys(is_focused);
+        UpdateInputState(is_focused);
+        UpdatePlugins();
+    }
+
+    void DrawMenu() override
+    {
+        auto* app = PluginLoaderApp::Get();
+        if (!app)
+            return;
+        static Ui::MainMenu menu;
+        menu.Draw(app->GetPluginManager());
+    }
+
+private:
+    uint32_t m_consoleRevision = 0;
+    PluginHotkey m_menuHotkey;
+    PluginHotkey m_consoleHotkey;
+    bool m_acceptHotkeys = false;
+
+    static void OnToggleMenu(void* userData, const HotkeyEventInfo&)
+    {
+        if (static_cast<LoaderSettings*>(userData)->m_acceptHotkeys)
+            BaseHook::Data::bShowMenu = !BaseHook::Data::bShowMenu;
+    }
+
+    static void OnToggleConsole(void* userData, const HotkeyEventInfo&)
+    {
+        if (!static_cast<LoaderSettings*>(userData)->m_acceptHotkeys)
+            return;
         if (auto* app = PluginLoaderApp::Get())
-            app->GetConsole().Draw("Console");
+            app->GetConsole().ToggleVisibility();
+    }
+
+    // Matches every registered hotkey (loader and plugins) against this frame's input and runs
+    // their callbacks. The loader's own binds only act while the window is focused and ImGui
+    // doesn't want the keyboard.
+    void PollHotkeys(bool is_focused)
+    {
+        auto* app = PluginLoaderApp::Get();
+        if (!app)
+            return;
 
+        const PluginLoaderInterface& loader = app->GetLoaderInterface();
+        m_menuHotkey.Sync(loader, nullptr, PluginLoaderConfig::g_Config.hotkey_ToggleMenu.get(), HotkeyEvents::Pressed, &OnToggleMenu, this);
+        m_consoleHotkey.Sync(loader, nullptr, PluginLoaderConfig::g_Config.hotkey_ToggleConsole.get(), HotkeyEvents::Pressed, &OnToggleConsole, this);
+
+        m_acceptHotkeys = is_focused && !ImGui::GetIO().WantCaptureKeyboard;
+        app->GetPluginManager().GetHotkeys().Poll();
+    }
+
+    void UpdateInputState(bool is_focused)
+    {
         const ConsoleMode cm = (PluginLoaderApp::Get() ? PluginLoaderApp::Get()->GetConsole().mode : ConsoleMode::Hidden);
         BaseHook::Data::bShowConsole = (cm == ConsoleMode::ForegroundAndFocusable);
 
@@ -269,19 +443,23 @@ struct PluginLoaderApp::LoaderSettings : public BaseHook::Settings
             // Explicitly unclip when unclip mode is active
             ClipCursor(NULL);
         }
+    }
 
+    void UpdatePlugins()
+    {
         if (auto* app = PluginLoaderApp::Get())
+        {
+            static bool s_wasMenuShown = false;
+            if (s_wasMenuShown != BaseHook::Data::bShowMenu)
+            {
+                s_wasMenuShown = BaseHook::Data::bShowMenu;
+                app->GetPluginManager().GetScheduler().Signal(s_wasMenuShown ? UpdateEvents::MenuOpened : UpdateEvents::MenuClosed);
+            }
+
             app->GetPluginManager().UpdatePlugins();
+        }
     }
 
-    void DrawMenu() override
-    {
-        auto* app = PluginLoaderApp::Get();
-        if (!app)
-            return;
-        static Ui::MainMenu menu;
-        menu.Draw(app->GetPluginManager());
-    }
 };
 
 PluginLoaderApp::PluginLoaderApp(HMODULE module)
@@ -303,8 +481,14 @@ PluginLoaderApp* PluginLoaderApp::Get()
 
 void PluginLoaderApp::Init()
 {
+    TRACE_SCOPE_CAT("PluginLoaderApp::Init", "loader");
+
     Log::AddSink(LogConsoleSink);
-    CrashHandler::Init();
+    {
+        TRACE_SCOPE_CAT("CrashHandler::Init", "loader");
+        CrashHandler::Init();
+    }
+    CrashHandler::SetSymbolizeCrashes(PluginLoaderConfig::g_Config.SymbolizeCrashes);
 
     LOG_INFO("Plugin Loader Attached.");
 
@@ -313,6 +497,19 @@ void PluginLoaderApp::Init()
     m_loaderInterface.RequestUnloadPlugin = PluginLoaderInterface_RequestUnload;
     m_loaderInterface.GetImGuiContext = GetImGuiContext_Impl;
     m_loaderInterface.GetPluginInterface = GetPluginInterface_Impl;
+    m_loaderInterface.SubmitTraceSpan = SubmitTraceSpan_Impl;
+    m_loaderInterface.RegisterUpdateTask = RegisterUpdateTask_Impl;
+    m_loaderInterface.UnregisterUpdateTask = UnregisterUpdateTask_Impl;
+    m_loaderInterface.SignalUpdateEvent = SignalUpdateEvent_Impl;
+    m_loaderInterface.SetGuiRefreshRate = SetGuiRefreshRate_Impl;
+    m_loaderInterface.RegisterHotkey = RegisterHotkey_Impl;
+    m_loaderInterface.UpdateHotkey = UpdateHotkey_Impl;
+    m_loaderInterface.UnregisterHotkey = UnregisterHotkey_Impl;
+    m_loaderInterface.IsHotkeyDown = IsHotkeyDown_Impl;
+    m_loaderInterface.GetControllerMotion = GetControllerMotion_Impl;
+    m_loaderInterface.GetControllerPresence = GetControllerPresence_Impl;
+    m_loaderInterface.WaitForFrameLimit = WaitForFrameLimit_Impl;
+    m_loaderInterface.GetFrameTiming = GetFrameTiming_Impl;
 
     // Apply CPU affinity if a custom mask is set. 
     // If 0, we do nothing here and let plugins (like EaglePatch) handle defaults.
@@ -324,6 +521,9 @@ void PluginLoaderApp::Init()
     // Init default framerate settings
     BaseHook::g_FramerateLimiter.SetEnabled(PluginLoaderConfig::g_Config.EnableFPSLimit);
     BaseHook::g_FramerateLimiter.SetTargetFPS(static_cast<double>(PluginLoaderConfig::g_Config.FPSLimit));
+    BaseHook::g_OverlayFrameGate.SetEnabled(PluginLoaderConfig::g_Config.IdleOverlayFastPath);
+    BaseHook::g_OverlayFrameGate.SetUiRateHz(PluginLoaderConfig::g_Config.OverlayUiRateHz);
+    BaseHook::g_AllocationCounter.SetEnabled(PluginLoaderConfig::g_Config.CountFrameAllocations);
 
     // Initialize BaseHook (and hooks) BEFORE loading plugins.
     // This prevents race conditions where a plugin initializes controllers/input
@@ -334,16 +534,132 @@ void PluginLoaderApp::Init()
     // Connect KeyBind system to BaseHook's Virtual Input
     KeyBind::SetInputProvider(BaseHook::Hooks::TryGetVirtualXInputState);
 
-    BaseHook::Start(m_settings.get());
+    {
+        TRACE_SCOPE_CAT("BaseHook::Start", "basehook");
+        BaseHook::Start(m_settings.get());
+    }
     LOG_INFO("Basehook initialized successfully.");
 
     // Now load plugins
+    m_pluginManager.GetScheduler().SetBudgetMs(PluginLoaderConfig::g_Config.PluginUpdateBudgetMs.get());
+    m_pluginManager.SetHotReloadEnabled(PluginLoaderConfig::g_Config.PluginHotReload);
     m_pluginManager.Init(m_module, m_loaderInterface);
 }
 
+bool PluginLoaderApp::WriteTraceFile()
+{
+    wchar_t modulePath[MAX_PATH];
+    GetModuleFileNameW(m_module, modulePath, MAX_PATH);
+    const std::filesystem::path tracePath = std::filesystem::path(modulePath).replace_extension(".trace.json");
+
+    if (!Trace::WriteChromeJSON(tracePath))
+    {
+        LOG_ERROR("Failed to write trace file: %s", tracePath.string().c_str());
+        return false;
+    }
+
+    LOG_INFO("Trace written: %s (%zu spans, %zu dropped)", tracePath.string().c_str(), Trace::GetEventCount(), Trace::GetDroppedCount());
+    return true;
+}
+
+void PluginLoaderApp::WriteStartupReport(int64_t firstFrameEndUs)
+{
+    std::vector<StartupTimeline::Span> spans;
+    for (const Trace::Event& e : Trace::GetEvents())
+        spans.push_back({ e.name, e.category, e.detail, e.startUs, e.durationUs, e.threadId });
+    const StartupTimeline::Timeline timeline(std::move(spans), firstFrameEndUs);
+
+    wchar_t modulePath[MAX_PATH];
+    GetModuleFileNameW(m_module, modulePath, MAX_PATH);
+    const std::filesystem::path timelinePath = std::filesystem::path(modulePath).replace_extension(".startup.timeline");
+    const std::filesystem::path reportPath = std::filesystem::path(modulePath).replace_extension(".startup.txt");
+
+    StartupTimeline::Totals previous;
+    bool havePrevious = false;
+    if (std::ifstream file{ timelinePath, std::ios::binary })
+    {
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::string error;
+        havePrevious = StartupTimeline::ParseTotals(text, previous, &error);
+        if (!havePrevious)
+            LOG_WARN("Ignoring previous startup timeline %s: %s", timelinePath.string().c_str(), error.c_str());
+    }
+
+    StartupTimeline::DiffOptions options;
+    options.minDeltaUs = (int64_t)std::max(0, PluginLoaderConfig::g_Config.StartupRegressionMs.get()) * 1000;
+    const StartupTimeline::Totals totals = timeline.GetTotals();
+    const size_t regressions = havePrevious ? StartupTimeline::FindRegressions(previous, totals, options).size() : 0;
+
+    const std::string report = StartupTimeline::FormatReport(timeline, havePrevious ? &previous : nullptr, options);
+    std::ofstream reportFile(reportPath, std::ios::out | std::ios::trunc | std::ios::binary);
+    reportFile.write(report.data(), (std::streamsize)report.size());
+    if (!reportFile.good())
+    {
+        LOG_ERROR("Failed to write startup report: %s", reportPath.string().c_str());
+        return;
+    }
+
+    // Only replaced once the report is out, so a failed write still compares against the last good run.
+    const std::string stored = StartupTimeline::SerializeTotals(totals);
+    std::ofstream timelineFile(timelinePath, std::ios::out | std::ios::trunc | std::ios::binary);
+    timelineFile.write(stored.data(), (std::streamsize)stored.size());
+
+    if (regressions > 0)
+        LOG_WARN("Startup took %.1f ms to the first frame, %zu regression(s) vs the previous run. See %s",
+            totals.totalUs / 1000.0, regressions, reportPath.string().c_str());
+    else
+        LOG_INFO("Startup took %.1f ms to the first frame. Report: %s", totals.totalUs / 1000.0, reportPath.string().c_str());
+}
+
+bool PluginLoaderApp::ToggleInputRecording()
+{
+    if (BaseHook::Hooks::IsInputRecordingActive())
+    {
+        const uint64_t records = BaseHook::Hooks::GetRecordedInputReads();
+        BaseHook::Hooks::StopInputRecording();
+        LOG_INFO("Input recording stopped (%llu reads recorded)", records);
+        return true;
+    }
+
+    wchar_t modulePath[MAX_PATH];
+    GetModuleFileNameW(m_module, modulePath, MAX_PATH);
+    const std::filesystem::path recordingPath = std::filesystem::path(modulePath).replace_extension(".input.bin");
+
+    if (!BaseHook::Hooks::StartInputRecording(recordingPath))
+    {
+        LOG_ERROR("Failed to open input recording file: %s", recordingPath.string().c_str());
+        return false;
+    }
+
+    LOG_INFO("Recording controller input to %s", recordingPath.string().c_str());
+    return true;
+}
+
 void PluginLoaderApp::Tick()
 {
-    PluginLoaderConfig::CheckHotReload();
+    if (PluginLoaderConfig::CheckHotReload())
+    {
+        m_pluginManager.GetScheduler().SetBudgetMs(PluginLoaderConfig::g_Config.PluginUpdateBudgetMs.get());
+        BaseHook::g_OverlayFrameGate.SetEnabled(PluginLoaderConfig::g_Config.IdleOverlayFastPath);
+        BaseHook::g_OverlayFrameGate.SetUiRateHz(PluginLoaderConfig::g_Config.OverlayUiRateHz);
+        BaseHook::g_AllocationCounter.SetEnabled(PluginLoaderConfig::g_Config.CountFrameAllocations);
+        CrashHandler::SetSymbolizeCrashes(PluginLoaderConfig::g_Config.SymbolizeCrashes);
+        m_pluginManager.SetHotReloadEnabled(PluginLoaderConfig::g_Config.PluginHotReload);
+        m_pluginManager.GetScheduler().Signal(UpdateEvents::ConfigReloaded);
+    }
+
+    m_pluginManager.ProcessUnloads();
+    BaseHook::FontAtlasCache::Flush();
+
+    if (!m_startupReportWritten && Trace::IsEnabled())
+    {
+        const int64_t firstFrameEndUs = BaseHook::Data::firstFrameEndUs.load();
+        if (firstFrameEndUs != 0)
+        {
+            m_startupReportWritten = true;
+            WriteStartupReport(firstFrameEndUs);
+        }
+    }
 }
 
 void PluginLoaderApp::RequestShutdown()
@@ -361,6 +677,8 @@ void PluginLoaderApp::Shutdown()
     LOG_INFO("Shutdown initiated.");
     m_pluginManager.ShutdownPlugins();
     BaseHook::Detach();
+    if (PluginLoaderConfig::g_Config.WriteTraceOnShutdown.get())
+        WriteTraceFile();
     Log::RemoveSink(LogConsoleSink);
     CrashHandler::Shutdown();
     Log::Shutdown();
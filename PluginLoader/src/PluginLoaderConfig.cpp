@@ -2,6 +2,7 @@
 #include "Serialization/Serialization.h"
 #include "Serialization/Utils/FileSystem.h"
 #include "log.h"
+#include "Trace.h"
 #include <chrono>
 #include "util/FramerateLimiter.h"
 
@@ -25,6 +26,7 @@ namespace PluginLoaderConfig {
     void Load()
     {
         if (g_ConfigFilepath.empty()) return;
+        TRACE_SCOPE_CAT("Config::Load", "config");
         if (fs::exists(g_ConfigFilepath))
         {
             std::error_code ec;
@@ -69,6 +71,7 @@ namespace PluginLoaderConfig {
     void Save()
     {
         if (g_ConfigFilepath.empty()) return;
+        TRACE_SCOPE_CAT("Config::Save", "config");
         Serialization::JSON cfg;
         g_Config.SectionToJSON(cfg);
         Serialization::Utils::SaveJSONToFile(cfg, g_ConfigFilepath);
@@ -82,15 +85,15 @@ namespace PluginLoaderConfig {
         }
     }
 
-    void CheckHotReload()
+    bool CheckHotReload()
     {
-        if (g_ConfigFilepath.empty()) return;
+        if (g_ConfigFilepath.empty()) return false;
         
         std::error_code ec;
         if (fs::exists(g_ConfigFilepath, ec))
         {
             const auto currentWriteTime = fs::last_write_time(g_ConfigFilepath, ec);
-            if (ec) return;
+            if (ec) return false;
 
             // Detect a new write and start (or restart) debounce window.
             if (currentWriteTime > g_LastObservedWriteTime)
@@ -98,20 +101,21 @@ namespace PluginLoaderConfig {
                 g_LastObservedWriteTime = currentWriteTime;
                 g_HasPendingReload = true;
                 g_PendingSince = std::chrono::steady_clock::now();
-                return;
+                return false;
             }
 
             if (g_HasPendingReload)
             {
                 const auto now = std::chrono::steady_clock::now();
                 if ((now - g_PendingSince) < kReloadDebounce)
-                    return;
+                    return false;
 
                 // Only reload if file is still newer than last-good.
                 if (g_LastObservedWriteTime > g_LastWriteTime)
                 {
                     LOG_INFO("Config change detected on disk. Reloading...");
                     Load();
+                    return true;
                 }
                 else
                 {
@@ -119,5 +123,6 @@ namespace PluginLoaderConfig {
                 }
             }
         }
+        return false;
     }
 }
\ No newline at end of file
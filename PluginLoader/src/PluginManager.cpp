@@ -1,37 +1,368 @@
 #include "PluginManager.h"
 #include "log.h"
+#include "Trace.h"
 #include "imgui.h"
 #include <filesystem>
 #include <algorithm>
+#include <TlHelp32.h>
 #include "imgui_internal.h"
 #include "util/GameDetection.h"
 
+namespace
+{
+    constexpr const char* kShadowDirName = ".shadow";
+    constexpr size_t kStackChunkBytes = 16 * 1024;
+
+    // winternl.h only declares an opaque THREAD_BASIC_INFORMATION; TebBaseAddress is all we need.
+    struct ThreadBasicInformation
+    {
+        LONG ExitStatus;
+        PVOID TebBaseAddress;
+        struct { HANDLE UniqueProcess; HANDLE UniqueThread; } ClientId;
+        ULONG_PTR AffinityMask;
+        LONG Priority;
+        LONG BasePriority;
+    };
+    using NtQueryInformationThread_t = LONG(NTAPI*)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+    constexpr ULONG kThreadBasicInformation = 0;
+
+    // Top of the thread's stack from NT_TIB::StackBase, or 0 if it can't be read.
+    uintptr_t GetStackBase(HANDLE thread, NtQueryInformationThread_t query)
+    {
+        ThreadBasicInformation info{};
+        if (!query || query(thread, kThreadBasicInformation, &info, sizeof(info), nullptr) < 0 || !info.TebBaseAddress)
+            return 0;
+        NT_TIB tib{};
+        SIZE_T read = 0;
+        if (!ReadProcessMemory(GetCurrentProcess(), info.TebBaseAddress, &tib, sizeof(tib), &read) || read != sizeof(tib))
+            return 0;
+        return (uintptr_t)tib.StackBase;
+    }
+
+    std::pair<uintptr_t, uintptr_t> GetModuleRange(HMODULE module)
+    {
+        const auto* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(module);
+        const auto* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(reinterpret_cast<const uint8_t*>(module) + dos->e_lfanew);
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(module);
+        return { begin, begin + nt->OptionalHeader.SizeOfImage };
+    }
+
+    // True if any other thread currently executes in [begin, end) or has a return address into it
+    // anywhere on its stack, from the stack pointer up to the stack base in its TEB. A plugin frame
+    // can sit arbitrarily deep under game code (a hooked function calling back into the engine), so
+    // the whole used stack is scanned. Conservative: a stale pointer or an unreadable stack counts
+    // as busy. Nothing between SuspendThread and ResumeThread may take a lock (the suspended thread
+    // could own it).
+    bool IsModuleBusy(uintptr_t begin, uintptr_t end)
+    {
+        static std::vector<uintptr_t> stack(kStackChunkBytes / sizeof(uintptr_t));
+        static const auto query = reinterpret_cast<NtQueryInformationThread_t>(
+            GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtQueryInformationThread"));
+
+        const DWORD selfId = GetCurrentThreadId();
+        const DWORD pid = GetCurrentProcessId();
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return true;
+
+        bool busy = false;
+        THREADENTRY32 te{};
+        te.dwSize = sizeof(te);
+        for (BOOL ok = Thread32First(snapshot, &te); ok && !busy; ok = Thread32Next(snapshot, &te))
+        {
+            if (te.th32OwnerProcessID != pid || te.th32ThreadID == selfId)
+                continue;
+
+            HANDLE thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, te.th32ThreadID);
+            if (!thread)
+                continue;
+
+            if (SuspendThread(thread) != (DWORD)-1)
+            {
+                CONTEXT ctx{};
+                ctx.ContextFlags = CONTEXT_CONTROL;
+                if (GetThreadContext(thread, &ctx))
+                {
+#ifdef _WIN64
+                    const uintptr_t ip = ctx.Rip, sp = ctx.Rsp;
+#else
+                    const uintptr_t ip = ctx.Eip, sp = ctx.Esp;
+#endif
+                    busy = (ip >= begin && ip < end);
+
+                    // Without the TEB, fall back to the committed region around sp: the used part of
+                    // a stack is committed in one piece up to its base.
+                    uintptr_t stackTop = GetStackBase(thread, query);
+                    MEMORY_BASIC_INFORMATION mbi{};
+                    if (stackTop <= sp && VirtualQuery((LPCVOID)sp, &mbi, sizeof(mbi)) && mbi.State == MEM_COMMIT)
+                        stackTop = (uintptr_t)mbi.BaseAddress + mbi.RegionSize;
+                    if (stackTop <= sp)
+                        busy = true;
+
+                    for (uintptr_t at = sp & ~(uintptr_t)(sizeof(uintptr_t) - 1); !busy && at < stackTop; at += kStackChunkBytes)
+                    {
+                        const size_t bytes = (std::min)(kStackChunkBytes, (size_t)(stackTop - at)) & ~(sizeof(uintptr_t) - 1);
+                        SIZE_T read = 0;
+                        if (!ReadProcessMemory(GetCurrentProcess(), (LPCVOID)at, stack.data(), bytes, &read) || read != bytes)
+                        {
+                            busy = true;
+                            break;
+                        }
+                        for (size_t i = 0; i < read / sizeof(uintptr_t) && !busy; ++i)
+                            busy = (stack[i] >= begin && stack[i] < end);
+                    }
+                }
+                else
+                {
+                    busy = true;
+                }
+                ResumeThread(thread);
+            }
+            CloseHandle(thread);
+        }
+        CloseHandle(snapshot);
+        return busy;
+    }
+}
+
 void PluginManager::Init(HMODULE loaderModule, PluginLoaderInterface& loaderInterface)
 {
     m_loaderModule = loaderModule;
+    m_loaderInterface = &loaderInterface;
     m_currentGame = BaseHook::Util::GetCurrentGame();
     LOG_INFO("Detected game: %d", (int)m_currentGame);
-    LoadPlugins(loaderInterface);
+
+    char loaderPath[MAX_PATH];
+    GetModuleFileNameA(m_loaderModule, loaderPath, MAX_PATH);
+    m_pluginDir = std::filesystem::path(loaderPath).parent_path() / "plugins";
+
+    // Shadow copies of the previous session; nothing has them loaded anymore.
+    std::error_code ec;
+    std::filesystem::remove_all(m_pluginDir / kShadowDirName, ec);
+
+    m_scheduler.Start();
+    LoadPlugins();
 }
 
 void PluginManager::ShutdownPlugins()
 {
+    std::vector<IPlugin*> plugins;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        for (auto& plugin : m_plugins)
+            plugins.push_back(plugin.instance.get());
+    }
+
+    // Tasks point into plugin code; make sure none is running before the DLLs go away.
+    // Not under the lock: a running task may be waiting for it in GetPluginInterface().
+    for (IPlugin* plugin : plugins)
+    {
+        m_scheduler.RemovePlugin(plugin);
+        m_hotkeys.RemovePlugin(plugin);
+    }
+    m_scheduler.Stop();
+
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+    m_guiPanels.clear();
     m_plugins.clear(); // Destructors will be called
+    m_detached.clear();
 }
 
 void PluginManager::UpdatePlugins()
 {
-    for (auto& plugin : m_plugins)
+    ProcessDetaches();
+
+    // Instances are only destroyed after ProcessDetaches() took them off m_plugins on this thread,
+    // so the pointers stay valid without holding the lock while plugin code runs.
+    std::vector<IPlugin*> plugins;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        plugins.reserve(m_plugins.size());
+        for (auto& plugin : m_plugins)
+        {
+            if (plugin.ready)
+                plugins.push_back(plugin.instance.get());
+        }
+    }
+
+    m_scheduler.RunRenderThread(plugins);
+}
+
+void PluginManager::ProcessDetaches()
+{
+    for (;;)
+    {
+        std::string name;
+        IPlugin* instance = nullptr;
+        uint32_t apiVersion = 0;
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+            name = m_lifecycle.NextToDetach();
+            if (name.empty())
+                return;
+
+            auto it = std::find_if(m_plugins.begin(), m_plugins.end(), [&](const LoadedPlugin& p) { return p.name == name && p.ready; });
+            if (it == m_plugins.end())
+            {
+                m_lifecycle.OnDetachRefused(name);
+                return;
+            }
+            instance = it->instance.get();
+            apiVersion = it->apiVersion;
+        }
+
+        // Plugins predating API 1.4 never agreed to having their hooks removed.
+        bool accepted = false;
+        if (apiVersion >= MAKE_PLUGIN_API_VERSION(1, 4))
+        {
+            TRACE_SCOPE_DETAIL("OnPluginShutdown", "plugins", name.c_str());
+            accepted = instance->OnPluginShutdown();
+        }
+
+        if (!accepted)
+        {
+            LOG_WARN("Plugin %s can't be unloaded at runtime (API %d.%d).", name.c_str(), apiVersion >> 16, apiVersion & 0xFFFF);
+            std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+            m_lifecycle.OnDetachRefused(name);
+            return;
+        }
+
+        m_scheduler.RemovePlugin(instance);
+        m_hotkeys.RemovePlugin(instance);
+
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        auto it = std::find_if(m_plugins.begin(), m_plugins.end(), [&](const LoadedPlugin& p) { return p.instance.get() == instance; });
+        m_detached.push_back(std::move(*it));
+        m_plugins.erase(it);
+        m_guiPanels.erase(instance);
+        m_lifecycle.OnDetached(name, (int64_t)GetTickCount64());
+        LOG_INFO("Plugin %s detached, waiting for its code to go idle.", name.c_str());
+    }
+}
+
+void PluginManager::ProcessUnloads()
+{
+    std::vector<std::pair<std::string, std::pair<uintptr_t, uintptr_t>>> toSample;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        if (!m_lifecycle.IsBusy())
+            return;
+
+        const int64_t nowMs = (int64_t)GetTickCount64();
+        for (const auto& plugin : m_detached)
+        {
+            if (m_lifecycle.NeedsSample(plugin.name, nowMs))
+                toSample.push_back({ plugin.name, GetModuleRange(plugin.handle) });
+        }
+    }
+
+    for (const auto& [name, range] : toSample)
+    {
+        const bool busy = IsModuleBusy(range.first, range.second);
+
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        if (m_lifecycle.OnQuiescenceSample(name, busy, (int64_t)GetTickCount64()) == PluginLifecycle::Stage::Failed)
+            LOG_ERROR("Plugin %s kept running code after it was detached; leaving it loaded.", name.c_str());
+    }
+
+    for (;;)
+    {
+        std::unique_ptr<LoadedPlugin> plugin;
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+            const std::string name = m_lifecycle.NextToFree();
+            if (name.empty())
+                break;
+
+            auto it = std::find_if(m_detached.begin(), m_detached.end(), [&](const LoadedPlugin& p) { return p.name == name; });
+            if (it != m_detached.end())
+            {
+                plugin = std::make_unique<LoadedPlugin>(std::move(*it));
+                m_detached.erase(it);
+            }
+            m_lifecycle.OnFreed(name);
+        }
+        if (!plugin)
+            continue;
+
+        // Outside the lock: the plugin's destructor may call back into the loader.
+        const std::string name = plugin->name;
+        const std::filesystem::path shadowPath = plugin->shadowPath;
+        {
+            TRACE_SCOPE_DETAIL("FreePlugin", "plugins", name.c_str());
+            plugin.reset();
+        }
+        if (!shadowPath.empty())
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(shadowPath.parent_path(), ec);
+        }
+        LOG_INFO("Plugin %s unloaded.", name.c_str());
+    }
+
+    for (;;)
+    {
+        std::string name;
+        std::filesystem::path sourcePath;
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+            name = m_lifecycle.NextToLoad();
+            if (name.empty())
+                break;
+            auto it = m_sourcePaths.find(name);
+            if (it != m_sourcePaths.end())
+                sourcePath = it->second;
+        }
+
+        const std::string loadedName = sourcePath.empty() ? std::string() : LoadPlugin(sourcePath);
+        if (loadedName != name)
+        {
+            LOG_ERROR("Plugin %s failed to reload.", name.c_str());
+            std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+            m_lifecycle.OnLoaded(name, false);
+        }
+    }
+}
+
+bool PluginManager::RequestUnload(const std::string& name, bool reload)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+
+    std::string error;
+    if (!m_lifecycle.Request(name, reload ? PluginLifecycle::Action::Reload : PluginLifecycle::Action::Unload, &error))
+    {
+        LOG_WARN("Can't %s plugin %s: %s", reload ? "reload" : "unload", name.c_str(), error.c_str());
+        return false;
+    }
+    LOG_INFO("%s of plugin %s requested.", reload ? "Reload" : "Unload", name.c_str());
+    return true;
+}
+
+bool PluginManager::RequestUnload(HMODULE module, bool reload)
+{
+    std::string name;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        for (const auto& plugin : m_plugins)
+        {
+            if (plugin.handle == module)
+                name = plugin.name;
+        }
+    }
+    if (name.empty())
     {
-        plugin.instance->OnUpdate();
+        LOG_WARN("RequestUnload: module %p is not a loaded plugin.", (void*)module);
+        return false;
     }
+    return RequestUnload(name, reload);
 }
 
 void PluginManager::RenderPluginMenus()
 {
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
     for (auto& plugin : m_plugins)
     {
-        if (plugin.showWindow)
+        if (plugin.showWindow && plugin.ready)
         {
             // Set default size/pos for new windows
             ImGui::SetNextWindowPos(ImVec2(100, 100), ImGuiCond_FirstUseEver);
@@ -40,7 +371,7 @@ void PluginManager::RenderPluginMenus()
             // Render in a separate window
             if (ImGui::Begin(plugin.name.c_str(), &plugin.showWindow, ImGuiWindowFlags_NoFocusOnAppearing))
             {
-                plugin.instance->OnGuiRender();
+                m_guiPanels[plugin.instance.get()].Render(plugin.instance.get());
             }
             ImGui::End();
         }
@@ -50,10 +381,13 @@ void PluginManager::RenderPluginMenus()
 void PluginManager::DrawPluginMenu()
 {
     // Use a child region for the list to keep it tidy if list is long
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
     if (ImGui::BeginChild("PluginList", ImVec2(0, 0), false, ImGuiWindowFlags_None))
     {
         for (auto& plugin : m_plugins)
         {
+            if (!plugin.ready)
+                continue;
             ImGui::PushID(plugin.name.c_str());
 
             const bool poppedOut = plugin.showWindow;
@@ -118,6 +452,54 @@ void PluginManager::DrawPluginMenu()
 
             if (isNodeOpen)
             {
+                UpdateScheduler::PluginStats stats;
+                if (m_scheduler.GetStats(plugin.instance.get(), stats))
+                {
+                    ImGui::TextDisabled("Update: %.2f ms avg, %.2f ms peak, %zu task(s), %u overrun(s)",
+                        stats.avgFrameMs, stats.peakFrameMs, stats.taskCount, stats.overruns);
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("Render-thread time per frame (OnUpdate + scheduled tasks).\n"
+                            "Worker task avg: %.2f ms\nDeferred by budget: %u\nBudget: %.2f ms",
+                            stats.workerAvgMs, stats.deferredRuns, m_scheduler.GetBudgetMs());
+                    }
+                }
+
+                const PluginGuiPanel& panel = m_guiPanels[plugin.instance.get()];
+                const PluginGuiPanel::Stats& guiStats = panel.GetStats();
+                if (panel.GetRefreshRate() > 0.0f && !guiStats.replayUnsupported)
+                {
+                    const uint32_t total = guiStats.rendered + guiStats.replayed;
+                    ImGui::TextDisabled("GUI: %.2f ms avg, %.2f ms peak, %.0f Hz refresh (%u%% replayed)",
+                        guiStats.avgMs, guiStats.peakMs, panel.GetRefreshRate(), total ? (guiStats.replayed * 100u) / total : 0u);
+                }
+                else
+                {
+                    ImGui::TextDisabled("GUI: %.2f ms avg, %.2f ms peak", guiStats.avgMs, guiStats.peakMs);
+                }
+
+                if (m_hotReload)
+                {
+                    const PluginLifecycle::Stage stage = m_lifecycle.GetStage(plugin.name);
+                    if (stage != PluginLifecycle::Stage::Active)
+                    {
+                        ImGui::TextDisabled("%s", PluginLifecycle::StageName(stage));
+                    }
+                    else
+                    {
+                        if (ImGui::SmallButton("Unload"))
+                            RequestUnload(plugin.name, false);
+                        ImGui::SameLine();
+                        if (ImGui::SmallButton("Reload"))
+                            RequestUnload(plugin.name, true);
+                        if (const uint32_t refs = m_lifecycle.GetInterfaceRefs(plugin.name))
+                        {
+                            ImGui::SameLine();
+                            ImGui::TextDisabled("(interface used by %u plugin(s), they go too)", refs);
+                        }
+                    }
+                }
+
                 if (!poppedOut)
                 {
                     // Inline render
@@ -125,7 +507,7 @@ void PluginManager::DrawPluginMenu()
                     if (ImGui::BeginChild("embedded", ImVec2(0.0f, 0.0f), ImGuiChildFlags_Borders | ImGuiChildFlags_AutoResizeY))
                     {
                         ImGui::Dummy(ImVec2(0, 2.0f));
-                        plugin.instance->OnGuiRender();
+                        m_guiPanels[plugin.instance.get()].Render(plugin.instance.get());
                         ImGui::Dummy(ImVec2(0, 2.0f));
                     }
                     ImGui::EndChild();
@@ -134,36 +516,73 @@ void PluginManager::DrawPluginMenu()
             }
             ImGui::PopID();
         }
+
+        for (const auto& plugin : m_detached)
+            ImGui::TextDisabled("%s: %s", plugin.name.c_str(), PluginLifecycle::StageName(m_lifecycle.GetStage(plugin.name)));
     }
     ImGui::EndChild();
 }
 
-void* PluginManager::GetPluginInterface(const std::string& name) const
+void PluginManager::SetGuiRefreshRate(IPlugin* owner, float hz)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+    auto it = m_guiPanels.find(owner);
+    if (it != m_guiPanels.end())
+        it->second.SetRefreshRate(hz);
+}
+
+void* PluginManager::GetPluginInterface(const std::string& name, HMODULE caller)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
     for (const auto& plugin : m_plugins)
     {
         if (plugin.name == name)
         {
-            return plugin.instance->GetInterface();
+            void* iface = plugin.instance->GetInterface();
+            if (!iface || !caller)
+                return iface;
+
+            for (const auto& holder : m_plugins)
+            {
+                if (holder.handle == caller)
+                    m_lifecycle.AddInterfaceRef(holder.name, name);
+            }
+            return iface;
         }
     }
     return nullptr;
 }
 
-void PluginManager::LoadPlugins(PluginLoaderInterface& loaderInterface)
+std::filesystem::path PluginManager::MakeShadowCopy(const std::filesystem::path& source)
 {
-    char loaderPath[MAX_PATH];
-    GetModuleFileNameA(m_loaderModule, loaderPath, MAX_PATH);
-    std::filesystem::path pluginDir = std::filesystem::path(loaderPath).parent_path() / "plugins";
+    // A fresh directory per load: a plugin that failed to unload may still have the previous copy mapped.
+    const std::filesystem::path dir = m_pluginDir / kShadowDirName / std::to_string(++m_shadowGeneration);
+    const std::filesystem::path shadow = dir / source.filename();
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (!ec)
+        std::filesystem::copy_file(source, shadow, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec)
+    {
+        LOG_WARN("Could not shadow-copy %s (%s); loading it in place.", source.string().c_str(), ec.message().c_str());
+        return {};
+    }
+    return shadow;
+}
+
+void PluginManager::LoadPlugins()
+{
+    TRACE_SCOPE_CAT("LoadPlugins", "plugins");
 
-    if (!std::filesystem::exists(pluginDir))
+    if (!std::filesystem::exists(m_pluginDir))
     {
         LOG_INFO("Plugins directory does not exist, no plugins will be loaded.");
         return;
     }
 
     std::vector<std::filesystem::path> pluginFiles;
-    for (const auto& entry : std::filesystem::directory_iterator(pluginDir))
+    for (const auto& entry : std::filesystem::directory_iterator(m_pluginDir))
     {
         if (entry.path().extension() == ".asi")
         {
@@ -174,48 +593,90 @@ void PluginManager::LoadPlugins(PluginLoaderInterface& loaderInterface)
     std::sort(pluginFiles.begin(), pluginFiles.end());
 
     for (const auto& path : pluginFiles)
+        LoadPlugin(path);
+}
+
+std::string PluginManager::LoadPlugin(const std::filesystem::path& path)
+{
+    const std::string fileName = path.filename().string();
+    TRACE_SCOPE_DETAIL("LoadPlugin", "plugins", fileName.c_str());
+
+    LOG_INFO("Attempting to load plugin: %s", path.string().c_str());
+    const std::filesystem::path shadowPath = m_hotReload ? MakeShadowCopy(path) : std::filesystem::path();
+    const std::filesystem::path& loadPath = shadowPath.empty() ? path : shadowPath;
+
+    HMODULE hPlugin = nullptr;
     {
-        LOG_INFO("Attempting to load plugin: %s", path.string().c_str());
-        HMODULE hPlugin = LoadLibraryW(path.wstring().c_str());
-        if (!hPlugin)
-        {
-            LOG_ERROR("Could not load plugin: %s. Error: %lu", path.string().c_str(), GetLastError());
-            continue;
-        }
+        TRACE_SCOPE_DETAIL("LoadLibrary", "plugins", fileName.c_str());
+        hPlugin = LoadLibraryW(loadPath.wstring().c_str());
+    }
+    if (!hPlugin)
+    {
+        LOG_ERROR("Could not load plugin: %s. Error: %lu", path.string().c_str(), GetLastError());
+        return {};
+    }
 
-        auto pluginEntry = (PluginEntrypoint)GetProcAddress(hPlugin, "PluginEntry");
-        if (!pluginEntry)
-        {
-            LOG_ERROR("Could not find PluginEntry export in %s", path.string().c_str());
-            FreeLibrary(hPlugin);
-            continue;
-        }
+    auto pluginEntry = (PluginEntrypoint)GetProcAddress(hPlugin, "PluginEntry");
+    if (!pluginEntry)
+    {
+        LOG_ERROR("Could not find PluginEntry export in %s", path.string().c_str());
+        FreeLibrary(hPlugin);
+        return {};
+    }
 
-        IPlugin* plugin_instance = pluginEntry();
-        if (!plugin_instance)
-        {
-            LOG_ERROR("PluginEntry for %s returned nullptr.", path.string().c_str());
-            FreeLibrary(hPlugin);
-            continue;
-        }
+    IPlugin* plugin_instance = pluginEntry();
+    if (!plugin_instance)
+    {
+        LOG_ERROR("PluginEntry for %s returned nullptr.", path.string().c_str());
+        FreeLibrary(hPlugin);
+        return {};
+    }
 
-        uint32_t pluginVersion = plugin_instance->GetPluginAPIVersion();
-        uint32_t loaderVersion = g_PluginLoaderAPIVersion;
+    uint32_t pluginVersion = plugin_instance->GetPluginAPIVersion();
+    uint32_t loaderVersion = g_PluginLoaderAPIVersion;
 
-        // Check for Major version mismatch (ABI break) or if plugin is newer than loader
-        if ((pluginVersion >> 16) != (loaderVersion >> 16) || pluginVersion > loaderVersion)
-        {
-            LOG_ERROR("Plugin %s is incompatible. Plugin Version: %d.%d, Loader Version: %d.%d",
-                path.string().c_str(),
-                pluginVersion >> 16, pluginVersion & 0xFFFF,
-                loaderVersion >> 16, loaderVersion & 0xFFFF);
-            delete plugin_instance;
-            FreeLibrary(hPlugin);
-            continue;
-        }
+    // Check for Major version mismatch (ABI break) or if plugin is newer than loader
+    if ((pluginVersion >> 16) != (loaderVersion >> 16) || pluginVersion > loaderVersion)
+    {
+        LOG_ERROR("Plugin %s is incompatible. Plugin Version: %d.%d, Loader Version: %d.%d",
+            path.string().c_str(),
+            pluginVersion >> 16, pluginVersion & 0xFFFF,
+            loaderVersion >> 16, loaderVersion & 0xFFFF);
+        delete plugin_instance;
+        FreeLibrary(hPlugin);
+        return {};
+    }
+
+    const std::string name = plugin_instance->GetPluginName();
+    LOG_INFO("Loaded plugin: %s", name.c_str());
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+        LoadedPlugin& loaded = m_plugins.emplace_back(hPlugin, std::unique_ptr<IPlugin>(plugin_instance), name);
+        loaded.apiVersion = pluginVersion;
+        loaded.sourcePath = path;
+        loaded.shadowPath = shadowPath;
+        m_sourcePaths[name] = path;
+        m_scheduler.AddPlugin(plugin_instance, name);
+        m_guiPanels[plugin_instance];
+
+        // Before OnPluginInit, so interfaces it asks for are attributed to it.
+        if (m_lifecycle.Has(name) && m_lifecycle.GetStage(name) == PluginLifecycle::Stage::Loading)
+            m_lifecycle.OnLoaded(name, true);
+        else
+            m_lifecycle.AddPlugin(name);
+    }
 
-        LOG_INFO("Loaded plugin: %s", plugin_instance->GetPluginName());
-        m_plugins.emplace_back(hPlugin, std::unique_ptr<IPlugin>(plugin_instance), std::string(plugin_instance->GetPluginName()));
-        plugin_instance->OnPluginInit(loaderInterface);
+    // Not under the lock: init may take a while, and the render thread skips the plugin until it's ready.
+    {
+        TRACE_SCOPE_DETAIL("OnPluginInit", "plugins", name.c_str());
+        plugin_instance->OnPluginInit(*m_loaderInterface);
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(m_pluginsMutex);
+    for (auto& plugin : m_plugins)
+    {
+        if (plugin.instance.get() == plugin_instance)
+            plugin.ready = true;
     }
+    return name;
 }
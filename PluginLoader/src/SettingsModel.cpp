@@ -2,10 +2,20 @@
 #include "CpuAffinity.h"
 #include "ImGuiConfigUtils.h"
 #include "log.h"
+#include "Trace.h"
+#include "PluginLoaderApp.h"
 #include "util/FramerateLimiter.h"
+#include "util/OverlayFrameGate.h"
+#include "util/AllocationCounter.h"
+#include "util/FrameBoundaryTracker.h"
+#include "util/FontAtlasCache.h"
+#include "FrameArena.h"
+#include "crash_handler.h"
 #include "core/BaseHook.h"
+#include "hooks/InputHooks.h"
 
 #include "imgui.h"
+#include <cfloat>
 
 namespace
 {
@@ -501,6 +511,29 @@ void SettingsModel::DrawFramerateSection()
         ImGui::EndTable();
     }
 
+    if (m_draft.enableFpsLimit)
+    {
+        const bool gameLoop = BaseHook::g_FramerateLimiter.GetControllingSite() == BaseHook::FrameWaitSite::GameLoop;
+        ImGui::Text("Frame wait: %s", gameLoop ? "game loop (plugin hook)" : "Present");
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Where the limiter waits. Plugins that hook the game's own frame throttle\n"
+                "(AC2 Unlock FPS) wait there instead of Sleep, and the Present wait is skipped.");
+
+        static const char* const kSiteNames[] = { "Present", "Game loop" };
+        for (int i = 0; i < (int)BaseHook::FrameWaitSite::Count; ++i)
+        {
+            const BaseHook::LatencyHistogram::Summary oversleep =
+                BaseHook::g_FramerateLimiter.GetOversleep((BaseHook::FrameWaitSite)i).Summarize();
+            if (oversleep.count == 0)
+                continue;
+            ImGui::Text("%s oversleep: p50 %.3f / p95 %.3f / p99 %.3f / max %.3f ms (%llu waits)", kSiteNames[i],
+                oversleep.p50Us / 1000.0, oversleep.p95Us / 1000.0, oversleep.p99Us / 1000.0, oversleep.maxUs / 1000.0,
+                (unsigned long long)oversleep.count);
+        }
+        if (ImGui::SmallButton("Reset Oversleep"))
+            BaseHook::g_FramerateLimiter.ResetOversleep();
+    }
+
     ImGui::Separator();
 
     if (ImGui::Checkbox("Enable FPS Limiter", &m_draft.enableFpsLimit)) {
@@ -561,6 +594,20 @@ void SettingsModel::DrawCpuAffinitySection()
         m_draft.cpuAffinityMask = m_systemAffinityMask & ~1ULL;
         ApplyCpuAffinityToRuntime();
     }
+    ImGui::SameLine();
+    if (ImGui::Button("Recommended"))
+    {
+        m_draft.cpuAffinityMask = CpuAffinity::GetRecommendedMask();
+        ApplyCpuAffinityToRuntime();
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("%s\nOne L3 domain, fastest cores, one thread per core, core 0 left free.\n"
+                          "Right-click to copy the topology dump.",
+                          CpuTopology::Describe(CpuAffinity::GetTopology()).c_str());
+        if (ImGui::IsMouseClicked(ImGuiMouseButton_Right))
+            ImGui::SetClipboardText(CpuTopology::Serialize(CpuAffinity::GetTopology()).c_str());
+    }
 
     ImGui::Dummy(ImVec2(0, 5));
     ImGui::Text("Manual Core Selection:");
@@ -616,12 +663,178 @@ void SettingsModel::DrawAppearanceSection()
     if (ImGui::DragInt("Font Size", &m_draft.fontSize, 1, 8, 32))
         PluginLoaderConfig::g_Config.fontSize = m_draft.fontSize;
 
+    bool fontCache = PluginLoaderConfig::g_Config.FontCache.get();
+    if (ImGui::Checkbox("Cache Font Glyphs", &fontCache))
+        PluginLoaderConfig::g_Config.FontCache = fontCache;
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Keeps rasterized glyphs in <loader>.fontcache so later runs skip font rasterization.\n"
+                          "Requires restart to take effect.");
+
+    char preloadSizes[64];
+    snprintf(preloadSizes, sizeof(preloadSizes), "%s", PluginLoaderConfig::g_Config.FontPreloadSizes.get().c_str());
+    if (ImGui::InputText("Preload Font Sizes", preloadSizes, sizeof(preloadSizes)))
+        PluginLoaderConfig::g_Config.FontPreloadSizes = std::string(preloadSizes);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Extra font sizes to bake at startup, comma-separated (e.g. \"16, 24\").\n"
+                          "Requires restart to take effect.");
+
+    const BaseHook::FontAtlasCache::Stats fontStats = BaseHook::FontAtlasCache::GetStats();
+    if (fontStats.fonts > 0)
+        ImGui::TextDisabled("Glyph cache: %u glyphs; this run %u cached, %u rasterized", fontStats.cachedGlyphs, fontStats.hits, fontStats.misses);
+
     if (ImGui::Button("Reset to Default##Appearance"))
     {
         PluginLoaderConfig::Config defaults;
         m_draft.fontSize = defaults.fontSize.get();
         PluginLoaderConfig::g_Config.fontSize = m_draft.fontSize;
+        PluginLoaderConfig::g_Config.FontCache = defaults.FontCache.get();
+        PluginLoaderConfig::g_Config.FontPreloadSizes = defaults.FontPreloadSizes.get();
+    }
+}
+
+void SettingsModel::DrawDiagnosticsSection()
+{
+    ImGui::Text("Trace spans: %zu (dropped: %zu)", Trace::GetEventCount(), Trace::GetDroppedCount());
+
+    bool writeOnShutdown = PluginLoaderConfig::g_Config.WriteTraceOnShutdown.get();
+    if (ImGui::Checkbox("Write Trace on Shutdown", &writeOnShutdown))
+        PluginLoaderConfig::g_Config.WriteTraceOnShutdown = writeOnShutdown;
+
+    if (ImGui::Button("Write Trace Now"))
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->WriteTraceFile();
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Writes <loader>.trace.json next to the loader.\nOpen it in chrome://tracing or ui.perfetto.dev.");
+
+    bool idleFastPath = PluginLoaderConfig::g_Config.IdleOverlayFastPath.get();
+    if (ImGui::Checkbox("Skip Overlay Frames When Idle", &idleFastPath))
+    {
+        PluginLoaderConfig::g_Config.IdleOverlayFastPath = idleFastPath;
+        BaseHook::g_OverlayFrameGate.SetEnabled(idleFastPath);
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Skips ImGui entirely while the menu and console are hidden.\nFrames skipped so far: %llu",
+            BaseHook::g_OverlayFrameGate.GetSkippedFrames());
+
+    int uiRate = PluginLoaderConfig::g_Config.OverlayUiRateHz.get();
+    if (ImGui::DragInt("Menu UI Rate", &uiRate, 1.0f, 0, 240, uiRate == 0 ? "Every Frame" : "%d Hz"))
+    {
+        PluginLoaderConfig::g_Config.OverlayUiRateHz = uiRate;
+        BaseHook::g_OverlayFrameGate.SetUiRateHz(uiRate);
+    }
+    if (ImGui::IsItemHovered())
+    {
+        const BaseHook::FrameDecimator& decimator = BaseHook::g_OverlayFrameGate.GetDecimator();
+        ImGui::SetTooltip("Rebuilds the menu, console and plugin windows at most this often and re-draws\n"
+            "the last frame in between. Input always rebuilds right away.\n"
+            "Interactive frames so far: %llu rebuilt, %llu reused",
+            (unsigned long long)decimator.GetRebuiltFrames(), (unsigned long long)decimator.GetReusedFrames());
     }
+
+    // DX9 only: EndScene is not a frame boundary there.
+    const BaseHook::FrameBoundaryTracker::FrameStats& frame = BaseHook::g_FrameBoundary.GetLastFrame();
+    if (frame.endScenes > 0 || frame.drawPoint != BaseHook::OverlayDrawPoint::None)
+    {
+        ImGui::Text("Last frame: %u EndScene (%u target check), %u overlay build(s), %u draw(s), drawn %s",
+            frame.endScenes, frame.targetChecks, frame.builds, frame.draws,
+            frame.drawPoint == BaseHook::OverlayDrawPoint::EndScene ? "in last scene" : "before Present");
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("The overlay is built once per presented frame. It is drawn inside the game's last\n"
+                              "scene once the scene count is stable and that scene targets the back buffer,\n"
+                              "otherwise in a scene of its own.");
+    }
+
+    float budgetMs = PluginLoaderConfig::g_Config.PluginUpdateBudgetMs.get();
+    if (ImGui::SliderFloat("Plugin Update Budget (ms)", &budgetMs, 0.1f, 16.0f, "%.1f"))
+    {
+        PluginLoaderConfig::g_Config.PluginUpdateBudgetMs = budgetMs;
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().GetScheduler().SetBudgetMs(budgetMs);
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Render-thread time each plugin may spend per frame before its\nrate-limited tasks are deferred and an overrun is reported.");
+
+    const FrameArena& arena = FrameArena::Get();
+    ImGui::Text("Frame arena: %.1f / %.1f KB (peak %.1f KB, %zu overflow(s))",
+        arena.GetUsed() / 1024.0, arena.GetCapacity() / 1024.0, arena.GetPeakUsed() / 1024.0, arena.GetOverflowCount());
+
+    bool countAllocations = BaseHook::g_AllocationCounter.IsEnabled();
+    if (ImGui::Checkbox("Count Allocations Per Frame", &countAllocations))
+    {
+        if (BaseHook::g_AllocationCounter.SetEnabled(countAllocations))
+            PluginLoaderConfig::g_Config.CountFrameAllocations = countAllocations;
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Counts malloc/calloc/realloc in the shared CRT (all threads, including operator new).\n"
+            "The game's own allocator is not included. Adds a small cost to every allocation while enabled.");
+
+    if (BaseHook::g_AllocationCounter.IsEnabled())
+    {
+        const BaseHook::AllocationCounter::FrameStats last = BaseHook::g_AllocationCounter.GetLastFrame();
+        ImGui::Text("Allocations: %u last frame (%.1f KB), peak %u",
+            last.allocations, last.bytes / 1024.0, BaseHook::g_AllocationCounter.GetPeakAllocations());
+    }
+
+    const BaseHook::LatencyHistogram::Summary padLatency = BaseHook::Hooks::GetPadLatencyHistogram().Summarize();
+    ImGui::Text("Pad latency: p50 %.2f / p95 %.2f / p99 %.2f / max %.2f ms (%llu updates)",
+        padLatency.p50Us / 1000.0, padLatency.p95Us / 1000.0, padLatency.p99Us / 1000.0, padLatency.maxUs / 1000.0,
+        (unsigned long long)padLatency.count);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Time from a controller report arriving to the game's XInputGetState first returning it.\n"
+            "Covers the virtual pad (Sony HID and DirectInput pads), not native XInput controllers.");
+    if (padLatency.count > 0)
+    {
+        float buckets[BaseHook::LatencyHistogram::kBucketCount];
+        for (int i = 0; i < BaseHook::LatencyHistogram::kBucketCount; ++i)
+            buckets[i] = (float)padLatency.buckets[i];
+        ImGui::PlotHistogram("##PadLatency", buckets, BaseHook::LatencyHistogram::kBucketCount, 0, "0 - 32 ms", 0.0f, FLT_MAX, ImVec2(0, 60));
+    }
+    const BaseHook::Hooks::InputQueueStats mouseQueue = BaseHook::Hooks::GetMouseQueueStats();
+    ImGui::Text("Mouse queue: %llu events, %llu coalesced, %llu dropped",
+        (unsigned long long)mouseQueue.events, (unsigned long long)mouseQueue.coalesced, (unsigned long long)mouseQueue.dropped);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("DirectInput mouse events handed to the overlay in order.\n"
+            "Drops mean the render thread fell too far behind the game's mouse polling.");
+
+    if (ImGui::SmallButton("Reset Latency"))
+        BaseHook::Hooks::ResetPadLatencyHistogram();
+    ImGui::SameLine();
+    const bool recording = BaseHook::Hooks::IsInputRecordingActive();
+    if (ImGui::SmallButton(recording ? "Stop Input Recording" : "Record Controller Input"))
+    {
+        if (auto* app = PluginLoaderApp::Get())
+            app->ToggleInputRecording();
+    }
+    if (ImGui::IsItemHovered())
+    {
+        if (recording)
+            ImGui::SetTooltip("%llu reads recorded to <loader>.input.bin", (unsigned long long)BaseHook::Hooks::GetRecordedInputReads());
+        else
+            ImGui::SetTooltip("Records raw DualShock 4 / DualSense reports to <loader>.input.bin,\nso a session can be replayed through the decoder offline.");
+    }
+
+    bool symbolizeCrashes = PluginLoaderConfig::g_Config.SymbolizeCrashes.get();
+    if (ImGui::Checkbox("Symbolize Crash Stacks", &symbolizeCrashes))
+    {
+        PluginLoaderConfig::g_Config.SymbolizeCrashes = symbolizeCrashes;
+        CrashHandler::SetSymbolizeCrashes(symbolizeCrashes);
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Resolves crash call stacks with dbghelp in the game process.\n"
+            "When off, crash logs only list raw frames and modules; resolve them with symbolize_crash.py.");
+
+    bool hotReload = PluginLoaderConfig::g_Config.PluginHotReload.get();
+    if (ImGui::Checkbox("Plugin Hot Reload", &hotReload))
+    {
+        PluginLoaderConfig::g_Config.PluginHotReload = hotReload;
+        if (auto* app = PluginLoaderApp::Get())
+            app->GetPluginManager().SetHotReloadEnabled(hotReload);
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Adds Unload/Reload buttons to the Plugins menu. Plugins (re)loaded while this is on\n"
+            "run from a copy under plugins\\.shadow, so the original .asi can be rebuilt in place.");
 }
 
 bool SettingsModel::DrawSaveRow()
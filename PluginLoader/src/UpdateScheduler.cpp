@@ -0,0 +1,390 @@
+#include "UpdateScheduler.h"
+#include "log.h"
+#include "Trace.h"
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    constexpr int64_t kWorkerIdleWaitUs = 100000;
+    constexpr int64_t kMaxDeferralUs = 100000;
+    constexpr double kAvgSmoothing = 0.05;
+
+    void Smooth(double& avg, double sample)
+    {
+        avg = (avg == 0.0) ? sample : avg + (sample - avg) * kAvgSmoothing;
+    }
+}
+
+UpdateScheduler::~UpdateScheduler()
+{
+    Stop();
+}
+
+int64_t UpdateScheduler::NowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void UpdateScheduler::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_worker.joinable())
+        return;
+    m_stop = false;
+    m_worker = std::thread(&UpdateScheduler::WorkerLoop, this);
+}
+
+void UpdateScheduler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void UpdateScheduler::AddPlugin(IPlugin* owner, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budgets[owner].name = name;
+}
+
+void UpdateScheduler::RemovePlugin(IPlugin* owner)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (auto& task : m_tasks)
+    {
+        if (task.owner == owner)
+            task.removed = true;
+    }
+
+    m_idleCv.wait(lock, [&] {
+        return std::none_of(m_tasks.begin(), m_tasks.end(), [&](const Task& t) {
+            return t.owner == owner && t.running > 0 && t.runningThread != std::this_thread::get_id();
+        });
+    });
+
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(),
+        [&](const Task& t) { return t.owner == owner && t.running == 0; }), m_tasks.end());
+    m_budgets.erase(owner);
+}
+
+UpdateTaskHandle UpdateScheduler::Register(IPlugin* owner, const UpdateTaskDesc& desc)
+{
+    if (!owner || !desc.callback)
+        return 0;
+
+    if (desc.frequency == UpdateFrequency::FixedRate && desc.rateHz <= 0.0f)
+    {
+        LOG_WARN("Update task '%s': FixedRate requires rateHz > 0.", desc.name ? desc.name : "?");
+        return 0;
+    }
+    if (desc.frequency == UpdateFrequency::OnEvent && (!desc.eventName || !desc.eventName[0]))
+    {
+        LOG_WARN("Update task '%s': OnEvent requires an event name.", desc.name ? desc.name : "?");
+        return 0;
+    }
+
+    Task task;
+    task.owner = owner;
+    task.name = desc.name ? desc.name : "unnamed";
+    task.callback = desc.callback;
+    task.userData = desc.userData;
+    task.frequency = desc.frequency;
+    task.affinity = desc.affinity;
+    task.periodUs = (desc.frequency == UpdateFrequency::FixedRate) ? (int64_t)(1000000.0 / desc.rateHz) : 0;
+    task.eventName = desc.eventName ? desc.eventName : "";
+    task.nextDueUs = NowUs();
+
+    UpdateTaskHandle handle = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        handle = m_nextHandle++;
+        task.handle = handle;
+        // Tasks can only be registered by known plugins; the budget entry carries the display name.
+        if (m_budgets.find(owner) == m_budgets.end())
+            m_budgets[owner].name = owner->GetPluginName();
+        LOG_INFO("Update task registered: %s/%s (%s, %s)", m_budgets[owner].name.c_str(), task.name.c_str(),
+            task.frequency == UpdateFrequency::EveryFrame ? "every frame" :
+            task.frequency == UpdateFrequency::FixedRate ? "fixed rate" : "on event",
+            task.affinity == UpdateAffinity::Worker ? "worker" : "render thread");
+        m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_all();
+    return handle;
+}
+
+void UpdateScheduler::Unregister(UpdateTaskHandle handle)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Task* task = FindTask(handle);
+    if (!task)
+        return;
+
+    task->removed = true;
+    // Wait for an in-flight invocation on another thread; unregistering from inside the callback is fine.
+    m_idleCv.wait(lock, [&] {
+        Task* t = FindTask(handle);
+        return !t || t->running == 0 || t->runningThread == std::this_thread::get_id();
+    });
+
+    task = FindTask(handle);
+    if (task && task->running == 0)
+        m_tasks.erase(m_tasks.begin() + (task - m_tasks.data()));
+}
+
+void UpdateScheduler::Signal(const char* eventName)
+{
+    if (!eventName)
+        return;
+    bool wakeWorker = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& task : m_tasks)
+        {
+            if (task.frequency == UpdateFrequency::OnEvent && task.eventName == eventName)
+            {
+                task.eventPending = true;
+                wakeWorker |= (task.affinity == UpdateAffinity::Worker);
+            }
+        }
+    }
+    if (wakeWorker)
+        m_cv.notify_all();
+}
+
+UpdateScheduler::Task* UpdateScheduler::FindTask(UpdateTaskHandle handle)
+{
+    for (auto& task : m_tasks)
+    {
+        if (task.handle == handle)
+            return &task;
+    }
+    return nullptr;
+}
+
+bool UpdateScheduler::IsDue(const Task& task, int64_t nowUs, uint64_t frame) const
+{
+    if (task.removed || task.running > 0)
+        return false;
+
+    switch (task.frequency)
+    {
+    case UpdateFrequency::EveryFrame: return task.lastFrame != frame;
+    case UpdateFrequency::FixedRate:  return nowUs >= task.nextDueUs && task.lastFrame != frame;
+    case UpdateFrequency::OnEvent:    return task.eventPending;
+    }
+    return false;
+}
+
+bool UpdateScheduler::Defer(Task& task, const Budget& budget, int64_t budgetUs, int64_t nowUs)
+{
+    if (budget.taskUs < budgetUs)
+        return false;
+    if (task.deferredSinceUs == 0)
+        task.deferredSinceUs = nowUs;
+    return nowUs - task.deferredSinceUs < (std::max)(task.periodUs, kMaxDeferralUs);
+}
+
+void UpdateScheduler::MarkRan(Task& task, int64_t nowUs, uint64_t frame)
+{
+    task.lastFrame = frame;
+    task.deferredSinceUs = 0;
+    if (task.frequency == UpdateFrequency::FixedRate)
+    {
+        task.nextDueUs += task.periodUs;
+        // Fell behind by more than a period (hitch, breakpoint, loading screen): don't burst to catch up.
+        if (task.nextDueUs <= nowUs)
+            task.nextDueUs = nowUs + task.periodUs;
+    }
+}
+
+int64_t UpdateScheduler::Execute(UpdateTaskHandle handle, uint64_t frame)
+{
+    void (*callback)(void*) = nullptr;
+    void* userData = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Task* task = FindTask(handle);
+        if (!task || task->removed || task->running > 0)
+            return -1;
+
+        task->running++;
+        task->runningThread = std::this_thread::get_id();
+        task->eventPending = false; // signals raised while running queue another run
+        callback = task->callback;
+        userData = task->userData;
+    }
+
+    const int64_t startUs = NowUs();
+    callback(userData);
+    const int64_t endUs = NowUs();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (Task* task = FindTask(handle))
+        {
+            task->running--;
+            MarkRan(*task, endUs, frame);
+            if (task->removed && task->running == 0)
+                m_tasks.erase(m_tasks.begin() + (task - m_tasks.data()));
+        }
+    }
+    m_idleCv.notify_all();
+    return endUs - startUs;
+}
+
+void UpdateScheduler::RunRenderThread(const std::vector<IPlugin*>& plugins)
+{
+    const int64_t budgetUs = m_budgetUs.load();
+    uint64_t frame = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        frame = ++m_frame;
+        for (auto& [owner, budget] : m_budgets)
+            budget.frameUs = budget.taskUs = 0;
+    }
+    m_cv.notify_all(); // EveryFrame worker tasks
+
+    // Legacy per-frame hook. Counts towards the overrun stats but not towards deferring tasks: a
+    // plugin with a heavy OnUpdate() would otherwise never get its rate/event tasks run.
+    for (IPlugin* plugin : plugins)
+    {
+        const int64_t startUs = NowUs();
+        plugin->OnUpdate();
+        const int64_t elapsedUs = NowUs() - startUs;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budgets[plugin].frameUs += elapsedUs;
+    }
+
+    struct DueTask { UpdateTaskHandle handle; IPlugin* owner; UpdateFrequency frequency; };
+    std::vector<DueTask> due;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const int64_t nowUs = NowUs();
+        for (const auto& task : m_tasks)
+        {
+            if (task.affinity == UpdateAffinity::RenderThread && IsDue(task, nowUs, frame))
+                due.push_back({ task.handle, task.owner, task.frequency });
+        }
+    }
+
+    for (const auto& d : due)
+    {
+        if (d.frequency != UpdateFrequency::EveryFrame)
+        {
+            // Rate/event tasks of a plugin whose tasks already used up its budget wait for the next frame.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& budget = m_budgets[d.owner];
+            Task* task = FindTask(d.handle);
+            if (task && Defer(*task, budget, budgetUs, NowUs()))
+            {
+                budget.deferredRuns++;
+                continue;
+            }
+        }
+
+        const int64_t elapsedUs = Execute(d.handle, frame);
+        if (elapsedUs >= 0)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& budget = m_budgets[d.owner];
+            budget.frameUs += elapsedUs;
+            budget.taskUs += elapsedUs;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [owner, budget] : m_budgets)
+    {
+        const double frameMs = budget.frameUs / 1000.0;
+        budget.lastFrameMs = frameMs;
+        Smooth(budget.avgFrameMs, frameMs);
+        budget.peakFrameMs = (std::max)(budget.peakFrameMs * 0.999, frameMs);
+
+        if (budget.frameUs > budgetUs)
+        {
+            budget.overruns++;
+            LOG_THROTTLED(5000, "Plugin '%s' overran its update budget: %.2f ms (budget %.2f ms, %u overruns).",
+                budget.name.c_str(), frameMs, budgetUs / 1000.0, budget.overruns);
+        }
+    }
+}
+
+void UpdateScheduler::WorkerLoop()
+{
+    Trace::SetThreadName("Plugin Update Worker");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop)
+    {
+        const int64_t nowUs = NowUs();
+        const uint64_t frame = m_frame;
+
+        std::vector<std::pair<UpdateTaskHandle, IPlugin*>> due;
+        int64_t nextWakeUs = nowUs + kWorkerIdleWaitUs;
+        for (const auto& task : m_tasks)
+        {
+            if (task.affinity != UpdateAffinity::Worker)
+                continue;
+            if (IsDue(task, nowUs, frame))
+                due.emplace_back(task.handle, task.owner);
+            else if (task.frequency == UpdateFrequency::FixedRate && !task.removed)
+                nextWakeUs = (std::min)(nextWakeUs, task.nextDueUs);
+        }
+
+        if (due.empty())
+        {
+            const auto wakeAt = std::chrono::steady_clock::time_point(std::chrono::microseconds(nextWakeUs));
+            m_cv.wait_until(lock, wakeAt);
+            continue;
+        }
+
+        lock.unlock();
+        const int64_t budgetUs = m_budgetUs.load();
+        for (const auto& [handle, owner] : due)
+        {
+            const int64_t elapsedUs = Execute(handle, frame);
+            if (elapsedUs < 0)
+                continue;
+
+            std::lock_guard<std::mutex> statsLock(m_mutex);
+            auto it = m_budgets.find(owner);
+            if (it == m_budgets.end())
+                continue;
+            Smooth(it->second.workerAvgMs, elapsedUs / 1000.0);
+            if (elapsedUs > budgetUs)
+            {
+                it->second.overruns++;
+                LOG_THROTTLED(5000, "Plugin '%s' worker task overran the update budget: %.2f ms (budget %.2f ms).",
+                    it->second.name.c_str(), elapsedUs / 1000.0, budgetUs / 1000.0);
+            }
+        }
+        lock.lock();
+    }
+}
+
+bool UpdateScheduler::GetStats(IPlugin* owner, PluginStats& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_budgets.find(owner);
+    if (it == m_budgets.end())
+        return false;
+
+    const Budget& b = it->second;
+    out.name = b.name;
+    out.lastFrameMs = b.lastFrameMs;
+    out.avgFrameMs = b.avgFrameMs;
+    out.peakFrameMs = b.peakFrameMs;
+    out.workerAvgMs = b.workerAvgMs;
+    out.overruns = b.overruns;
+    out.deferredRuns = b.deferredRuns;
+    out.taskCount = (size_t)std::count_if(m_tasks.begin(), m_tasks.end(),
+        [&](const Task& t) { return t.owner == owner && !t.removed; });
+    return true;
+}
@@ -10,6 +10,7 @@
 #include <CpuAffinity.h>
 #include <filesystem>
 #include "log.h"
+#include "Trace.h"
 #include <AutoAssemblerKinda.h>
 
 // Define the global loader reference here
@@ -30,6 +31,8 @@ public:
         
         // Configure logging
         Log::InitSink(g_loader_ref->LogToConsole);
+        if (g_loader_ref->SubmitTraceSpan)
+            Trace::InitSink(g_loader_ref->SubmitTraceSpan);
 
         LOG_INFO("[AC1 EaglePatch] Initializing...");
 
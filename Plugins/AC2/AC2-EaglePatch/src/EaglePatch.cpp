@@ -11,6 +11,7 @@
 #include <CpuAffinity.h>
 #include <filesystem>
 #include "log.h"
+#include "Trace.h"
 #include <AutoAssemblerKinda.h>
 
 // Define the global loader reference here
@@ -31,6 +32,8 @@ public:
         
         // Configure logging
         Log::InitSink(g_loader_ref->LogToConsole);
+        if (g_loader_ref->SubmitTraceSpan)
+            Trace::InitSink(g_loader_ref->SubmitTraceSpan);
 
         LOG_INFO("[AC2 EaglePatch] Initializing...");
 
@@ -56,7 +59,7 @@ public:
 
             if (g_config.FixCpuAffinity)
             {
-                uint64_t mask = CpuAffinity::GetSystemAffinityMask() & ~1ULL;
+                uint64_t mask = CpuAffinity::GetRecommendedMask(CpuTopology::kKeepSmtPolicy);
                 CpuAffinity::Apply(mask);
             }
         }
@@ -80,6 +83,8 @@ public:
             {
                 AC2EaglePatch::SetFPSUnlock(g_config.UnlockFPS);
             }
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("With the loader's FPS limiter on, the game waits on it instead of Sleep.");
 
             if (ImGui::Checkbox("Improve Draw Distance", &g_config.ImproveDrawDistance.get()))
             {
@@ -99,10 +104,10 @@ public:
             ImGui::Checkbox("Hybrid Input (Simultaneous KB/M + Controller)", &g_config.EnableXInput.get());
             ImGui::Checkbox("Skip Intro Videos", &g_config.SkipIntroVideos.get());
             ImGui::Checkbox("Unlock UPlay Bonuses", &g_config.UPlayItems.get());
-            if (ImGui::Checkbox("Fix CPU Affinity (Disable Core 0)", &g_config.FixCpuAffinity.get()))
+            if (ImGui::Checkbox("Fix CPU Affinity (Recommended Cores)", &g_config.FixCpuAffinity.get()))
             {
                 if (g_config.FixCpuAffinity)
-                    CpuAffinity::Apply(CpuAffinity::GetSystemAffinityMask() & ~1ULL);
+                    CpuAffinity::Apply(CpuAffinity::GetRecommendedMask(CpuTopology::kKeepSmtPolicy));
                 else
                     CpuAffinity::Apply(CpuAffinity::GetSystemAffinityMask());
             }
@@ -13,12 +13,31 @@ namespace AC2EaglePatch
         SleepCall, 0x0C
     );
 
+    // When the loader's FPS limiter is on, the game's throttle point waits on it instead of Sleep
+    // (one precise wait per frame, and the limiter skips its own wait in Present).
+    static bool s_limiterWaited = false;
+
+    static bool __cdecl WaitForFrameLimit()
+    {
+        return g_loader_ref && g_loader_ref->WaitForFrameLimit && g_loader_ref->WaitForFrameLimit();
+    }
+
     // Hook implementation
     HOOK_IMPL(FPSUnlock)
     {
         __asm {
+            pushad
+            pushfd
+            call WaitForFrameLimit
+            mov [s_limiterWaited], al
+            popfd
+            popad
+            cmp byte ptr [s_limiterWaited], 0
+            jne Label_Continue
+
             cmp eax, 1
             jb Label_Sleep
+        Label_Continue:
             jmp [FPSUnlock_ContinueRender]
 
         Label_Sleep:
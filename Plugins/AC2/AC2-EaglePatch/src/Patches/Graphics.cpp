@@ -146,7 +146,11 @@ namespace AC2EaglePatch
 
         // Create LodLevel skip patch
         if (LodLevelSkipLoc_Desc.IsResolved()) {
-            s_LodSkipPatch = new AutoAssembleWrapper<LodLevelSkipPatch>(LodLevelSkipLoc_Desc.GetAddress());
+            std::string error;
+            s_LodSkipPatch = TryAutoAssemble<LodLevelSkipPatch>(error, LodLevelSkipLoc_Desc.GetAddress()).release();
+            if (!s_LodSkipPatch) {
+                LOG_ERROR("[EaglePatch] LodLevel skip patch failed to assemble: %s", error.c_str());
+            }
         }
 
         // --- Apply Initial State ---
@@ -1,5 +1,6 @@
 #pragma once
 #include "Cheats/CheatBase.h"
+#include "PluginHotkey.h"
 
 class GameFlowCheats : public CheatBase
 {
@@ -12,5 +13,8 @@ private:
     const char* GetBinkFileName();
     void TriggerSkip();
 
-    bool m_BinkKeyWasDown = false;
+    static void OnSkipBinkKey(void* self, const HotkeyEventInfo&) { static_cast<GameFlowCheats*>(self)->m_SkipRequested = true; }
+
+    PluginHotkey m_SkipBinkKey;
+    bool m_SkipRequested = false;
 };
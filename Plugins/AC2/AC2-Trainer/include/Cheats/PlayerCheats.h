@@ -6,7 +6,8 @@ class PlayerCheats : public CheatBase
 public:
     void DrawUI() override; // Draws Player Status section
     void DrawMiscUI();      // Draws Speed/Resize for Misc tab
-    void Update() override;
+    void Update() override;  // Every frame: god mode and health, which the game overwrites at once
+    void UpdateLowRate();    // Flags the game rarely touches (invisibility, speed, scale)
     std::string GetName() const override { return "Player Status"; }
 
 private:
@@ -1,6 +1,8 @@
 #pragma once
 #include "Cheats/CheatBase.h"
 #include "Scimitar/math.h"
+#include "PluginHotkey.h"
+#include "FrameClock.h"
 
 class TeleportCheats : public CheatBase
 {
@@ -16,15 +18,50 @@ private:
     // Free Roam
     void UpdateFlyMode();
     void UpdateCameraFlyMode();
+    // Units per second from the held fly keys, relative to the camera. False without a free camera.
+    bool GetFlyVelocity(float velocity[3]) const;
+
+    // Free-roam movement runs in fixed steps and is written interpolated between the last two, so
+    // the speed doesn't depend on the frame rate. The position is left alone while no key is held.
+    struct FlightPath
+    {
+        FixedStepAccumulator clock{ 1.0 / 120.0 };
+        float previous[3] = {};
+        float current[3] = {};
+        float written[3] = {};
+        bool active = false;
+
+        void Advance(float* position, const float velocity[3], double delta);
+        void Restart(const float* position);
+        void Stop() { active = false; }
+    };
     
     // Save/Restore
-    void HandleSaveRestore();
+    void HandleSaveRestore(bool save, bool restore);
+
+    void SyncHotkeys();
+    static void OnWaypointKey(void* self, const HotkeyEventInfo&) { static_cast<TeleportCheats*>(self)->m_WaypointRequested = true; }
+    static void OnSaveKey(void* self, const HotkeyEventInfo&) { static_cast<TeleportCheats*>(self)->m_SaveRequested = true; }
+    static void OnRestoreKey(void* self, const HotkeyEventInfo&) { static_cast<TeleportCheats*>(self)->m_RestoreRequested = true; }
 
     AC2::Scimitar::Vector3 m_SavedPos = { 0, 0, 0 };
     bool m_HasSavedPos = false;
 
-    // Edge detection for keybinds
-    bool m_WaypointKeyWasDown = false;
-    bool m_SaveKeyWasDown = false;
-    bool m_RestoreKeyWasDown = false;
+    // Keybinds, matched by the loader. Presses are latched here and handled in Update().
+    PluginHotkey m_WaypointKey;
+    PluginHotkey m_SaveKey;
+    PluginHotkey m_RestoreKey;
+    bool m_WaypointRequested = false;
+    bool m_SaveRequested = false;
+    bool m_RestoreRequested = false;
+
+    PluginHotkey m_FlyForwardKey;
+    PluginHotkey m_FlyBackwardKey;
+    PluginHotkey m_FlyLeftKey;
+    PluginHotkey m_FlyRightKey;
+    PluginHotkey m_FlyUpKey;
+    PluginHotkey m_FlyDownKey;
+
+    FlightPath m_PlayerFlight;
+    FlightPath m_CameraFlight;
 };
@@ -4,6 +4,7 @@
 #include <KeyBind.h>
 
 extern const PluginLoaderInterface* g_loader_ref;
+extern IPlugin* g_plugin_ref;
 
 namespace Trainer
 {
@@ -2,6 +2,7 @@
 #include "Game/Singletons.h"
 #include "Game/Managers/ProgressionManager.h"
 #include "imgui.h"
+#include <ImGuiCTX.h>
 
 CharacterCheats::CharacterCheats()
 {
@@ -63,10 +64,17 @@ void CharacterCheats::DrawUI()
         {
             AC2::PlayerProfile* currentProfilePtr = prog->m_pSelectedProfile;
             
-            std::string currName = "Unknown/Custom";
-            if (currentProfilePtr) currName = GetCharacterName(currentProfilePtr->m_PlayerID);
+            // Looked up in place rather than through GetCharacterName() to avoid a string copy every frame
+            const char* currName = "Unknown/Custom";
+            if (currentProfilePtr)
+            {
+                auto it = m_KnownNames.find(currentProfilePtr->m_PlayerID);
+                currName = (it != m_KnownNames.end())
+                    ? it->second.c_str()
+                    : ImGuiCTX::Format("Unknown (0x%X)", (uint32_t)currentProfilePtr->m_PlayerID);
+            }
 
-            ImGui::Text("Active: %s", currName.c_str());
+            ImGui::Text("Active: %s", currName);
 
             if (ImGui::BeginListBox("##Models", ImVec2(-FLT_MIN, 150)))
             {
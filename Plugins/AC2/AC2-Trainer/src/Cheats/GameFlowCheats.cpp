@@ -4,8 +4,10 @@
 #include "Trainer.h"
 #include "Hooks.h"
 #include "imgui.h"
+#include <ImGuiConfigUtils.h>
 #include <PatternScanner.h>
 #include <AutoAssemblerKinda.h>
+#include <utility>
 
 extern Trainer::Configuration g_config;
 
@@ -50,18 +52,16 @@ void GameFlowCheats::TriggerSkip()
 
 void GameFlowCheats::Update()
 {
-    bool binkDown = g_config.Key_SkipBink.get().IsPressed();
-    if (binkDown && !m_BinkKeyWasDown) {
+    m_SkipBinkKey.Sync(*g_loader_ref, g_plugin_ref, g_config.Key_SkipBink.get(), HotkeyEvents::Pressed, &OnSkipBinkKey, this);
+    if (std::exchange(m_SkipRequested, false)) {
         TriggerSkip();
     }
-    m_BinkKeyWasDown = binkDown;
 }
 
 void GameFlowCheats::DrawUI()
 {
     // Skip Current Video Button
-    std::string btnLabel = "Skip Current Video [" + g_config.Key_SkipBink.get().ToString() + "]";
-    if (ImGui::Button(btnLabel.c_str(), ImVec2(-FLT_MIN, 0))) {
+    if (ImGui::Button(ImGui::KeyBindLabel("Skip Current Video", g_config.Key_SkipBink.get()), ImVec2(-FLT_MIN, 0))) {
         TriggerSkip();
     }
     if (ImGui::IsItemHovered()) ImGui::SetTooltip("Skips Bink videos (Logos/Movies). Auto-disables after skip.");
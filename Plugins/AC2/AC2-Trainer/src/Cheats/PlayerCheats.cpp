@@ -125,11 +125,17 @@ void PlayerCheats::Update()
     if (AC2::IsInWhiteRoom()) return;
 
     UpdateGodMode();
+    UpdateMiscAndFallDamage();
+}
+
+void PlayerCheats::UpdateLowRate()
+{
+    if (AC2::IsInWhiteRoom()) return;
+
     UpdateInvisibility();
     UpdateNotoriety();
     UpdateSpeed();
     UpdateScale();
-    UpdateMiscAndFallDamage();
 }
 
 void PlayerCheats::UpdateGodMode()
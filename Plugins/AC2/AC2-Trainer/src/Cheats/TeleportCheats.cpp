@@ -9,9 +9,25 @@
 #include "imgui.h"
 #include <ImGuiConfigUtils.h>
 #include <cmath>
+#include <utility>
 
 extern Trainer::Configuration g_config;
 
+namespace
+{
+    // FlySpeed 1.0 used to move 0.1 units per frame; this keeps that speed at 60 FPS.
+    constexpr float kFlyUnitsPerSecond = 6.0f;
+
+    double GetFrameDelta()
+    {
+        // Smoothed so a hitch doesn't throw the player forward
+        FrameTiming timing;
+        if (g_loader_ref && g_loader_ref->GetFrameTiming && g_loader_ref->GetFrameTiming(&timing))
+            return timing.smoothedDelta;
+        return 1.0 / 60.0; // Older loader
+    }
+}
+
 void TeleportCheats::DrawUI()
 {
     if (AC2::IsInWhiteRoom())
@@ -44,8 +60,7 @@ void TeleportCheats::DrawUI()
         if (player)
         {
             ImGui::Spacing();
-            std::string saveLabel = "Save [" + g_config.Key_SavePosition.get().ToString() + "]";
-            if (ImGui::Button(saveLabel.c_str()))
+            if (ImGui::Button(ImGui::KeyBindLabel("Save", g_config.Key_SavePosition.get())))
             {
                 m_SavedPos = player->Position;
                 m_HasSavedPos = true;
@@ -53,8 +68,7 @@ void TeleportCheats::DrawUI()
             
             ImGui::SameLine();
             ImGui::BeginDisabled(!m_HasSavedPos);
-            std::string restoreLabel = "Restore [" + g_config.Key_RestorePosition.get().ToString() + "]";
-            if (ImGui::Button(restoreLabel.c_str()))
+            if (ImGui::Button(ImGui::KeyBindLabel("Restore", g_config.Key_RestorePosition.get())))
             {
                 TeleportTo(m_SavedPos);
             }
@@ -74,8 +88,7 @@ void TeleportCheats::DrawUI()
         auto* waypoint = (AC2::MapWaypoint*)AC2::GetMapManager();
         bool hasWaypoint = (waypoint && (waypoint->Position.x != 0 || waypoint->Position.y != 0));
 
-        std::string tpLabel = "Teleport [" + g_config.Key_TeleportWaypoint.get().ToString() + "]";
-        if (ImGui::Button(tpLabel.c_str()))
+        if (ImGui::Button(ImGui::KeyBindLabel("Teleport", g_config.Key_TeleportWaypoint.get())))
         {
             TeleportToWaypoint();
         }
@@ -151,6 +164,7 @@ void TeleportCheats::DrawUI()
         }
 
         ImGui::DragFloat("Fly Speed", &g_config.FlySpeed.get(), 0.1f, 0.5f, 20.0f, "%.1f");
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("%.0f units per second", g_config.FlySpeed * kFlyUnitsPerSecond);
         ImGui::SameLine();
         if (ImGui::Button("Reset##FlySpeed")) g_config.FlySpeed = 1.0f;
     }
@@ -206,22 +220,43 @@ void TeleportCheats::DrawUI()
     }
 }
 
+void TeleportCheats::SyncHotkeys()
+{
+    const PluginLoaderInterface& loader = *g_loader_ref;
+    m_WaypointKey.Sync(loader, g_plugin_ref, g_config.Key_TeleportWaypoint.get(), HotkeyEvents::Pressed, &OnWaypointKey, this);
+    m_SaveKey.Sync(loader, g_plugin_ref, g_config.Key_SavePosition.get(), HotkeyEvents::Pressed, &OnSaveKey, this);
+    m_RestoreKey.Sync(loader, g_plugin_ref, g_config.Key_RestorePosition.get(), HotkeyEvents::Pressed, &OnRestoreKey, this);
+
+    // Fly keys are only queried for their held state.
+    m_FlyForwardKey.Sync(loader, g_plugin_ref, g_config.Key_FlyForward.get(), 0);
+    m_FlyBackwardKey.Sync(loader, g_plugin_ref, g_config.Key_FlyBackward.get(), 0);
+    m_FlyLeftKey.Sync(loader, g_plugin_ref, g_config.Key_FlyLeft.get(), 0);
+    m_FlyRightKey.Sync(loader, g_plugin_ref, g_config.Key_FlyRight.get(), 0);
+    m_FlyUpKey.Sync(loader, g_plugin_ref, g_config.Key_FlyUp.get(), 0);
+    m_FlyDownKey.Sync(loader, g_plugin_ref, g_config.Key_FlyDown.get(), 0);
+}
+
 void TeleportCheats::Update()
 {
+    SyncHotkeys();
+
+    // Presses seen while loading are dropped, not replayed afterwards.
+    const bool waypoint = std::exchange(m_WaypointRequested, false);
+    const bool save = std::exchange(m_SaveRequested, false);
+    const bool restore = std::exchange(m_RestoreRequested, false);
+
     // Skip updates while in loading screen to prevent crash
     if (AC2::IsInWhiteRoom()) return;
 
     UpdateFlyMode();
     UpdateCameraFlyMode();
-    HandleSaveRestore();
+    HandleSaveRestore(save, restore);
 
-    // Shortcut for Waypoint (edge detection)
-    bool waypointKeyDown = g_config.Key_TeleportWaypoint.get().IsPressed();
-    if (waypointKeyDown && !m_WaypointKeyWasDown)
+    // Shortcut for Waypoint
+    if (waypoint)
     {
         TeleportToWaypoint();
     }
-    m_WaypointKeyWasDown = waypointKeyDown;
 }
 
 void TeleportCheats::TeleportTo(const AC2::Scimitar::Vector3& pos)
@@ -263,7 +298,11 @@ void TeleportCheats::TeleportToWaypoint()
 void TeleportCheats::UpdateFlyMode()
 {
     // Skip if not in Player mode (1)
-    if (g_config.FreeRoamTarget != 1) return;
+    if (g_config.FreeRoamTarget != 1)
+    {
+        m_PlayerFlight.Stop();
+        return;
+    }
 
     auto* player = AC2::GetPlayer();
     if (!player) return;
@@ -271,105 +310,44 @@ void TeleportCheats::UpdateFlyMode()
     // Enforce fall damage protection while flying
     g_config.IgnoreFallDamage = true;
 
-    // Get camera yaw/pitch from pFreeCam
-    void* pFreeCam = Hooks::GetFreeCamPointer();
-    if (!pFreeCam) return;
+    float velocity[3];
+    if (!GetFlyVelocity(velocity)) return;
 
-    float* pCamData = reinterpret_cast<float*>(pFreeCam);
-    float yawComponent1 = pCamData[0x20 / 4]; // [pFreeCam+0x20]
-    float yawComponent2 = pCamData[0x30 / 4]; // [pFreeCam+0x30]
-    float pitchValue = pCamData[0x38 / 4];    // [pFreeCam+0x38]
-    
-    // CE: yaw = atan2(-[addrYaw+0x20], [addrYaw+0x30])
-    float yaw = std::atan2(-yawComponent1, yawComponent2);
-    // CE: pitch = asin(fPitch), then z = cos(90-pitch) * speed
-    float pitch = std::asin(pitchValue);
-    float zStep = std::cos(1.5708f - pitch); // cos(PI/2 - pitch) = sin(pitch)
-    
-    // Forward/backward vectors based on camera yaw
-    float cosYaw = std::cos(yaw);
-    float sinYaw = std::sin(yaw);
-    
-    float speed = g_config.FlySpeed * 0.1f;
-    
-    // Forward (Numpad 8): x += cos(yaw), y -= sin(yaw), z += zStep (CE logic)
-    if (g_config.Key_FlyForward.get().IsPressed())
-    {
-        player->Position.x += cosYaw * speed;
-        player->Position.y -= sinYaw * speed;
-        player->Position.z += zStep * speed;
-    }
-    // Backward (Numpad 2): opposite of forward
-    if (g_config.Key_FlyBackward.get().IsPressed())
-    {
-        player->Position.x -= cosYaw * speed;
-        player->Position.y += sinYaw * speed;
-        player->Position.z -= zStep * speed;
-    }
-    // Left (Numpad 4): yaw - 90 degrees (no Z change)
-    if (g_config.Key_FlyLeft.get().IsPressed())
-    {
-        float leftCos = std::cos(yaw - 1.5708f);
-        float leftSin = std::sin(yaw - 1.5708f);
-        player->Position.x += leftCos * speed;
-        player->Position.y -= leftSin * speed;
-    }
-    // Right (Numpad 6): yaw + 90 degrees (no Z change)
-    if (g_config.Key_FlyRight.get().IsPressed())
-    {
-        float rightCos = std::cos(yaw + 1.5708f);
-        float rightSin = std::sin(yaw + 1.5708f);
-        player->Position.x += rightCos * speed;
-        player->Position.y -= rightSin * speed;
-    }
-    // Up (Numpad 9): simple vertical movement
-    if (g_config.Key_FlyUp.get().IsPressed())
-    {
-        player->Position.z += speed;
-    }
-    // Down (Numpad 7): simple vertical movement
-    if (g_config.Key_FlyDown.get().IsPressed())
-    {
-        player->Position.z -= speed;
-    }
+    m_PlayerFlight.Advance(&player->Position.x, velocity, GetFrameDelta());
 }
 
-void TeleportCheats::HandleSaveRestore()
+void TeleportCheats::HandleSaveRestore(bool save, bool restore)
 {
     auto* player = AC2::GetPlayer();
     if (!player) return;
 
-    // Save (edge detection)
-    bool saveKeyDown = g_config.Key_SavePosition.get().IsPressed();
-    if (saveKeyDown && !m_SaveKeyWasDown)
+    if (save)
     {
         m_SavedPos = player->Position;
         m_HasSavedPos = true;
     }
-    m_SaveKeyWasDown = saveKeyDown;
 
-    // Restore (edge detection)
-    bool restoreKeyDown = g_config.Key_RestorePosition.get().IsPressed();
-    if (restoreKeyDown && !m_RestoreKeyWasDown && m_HasSavedPos)
+    if (restore && m_HasSavedPos)
     {
         TeleportTo(m_SavedPos);
     }
-    m_RestoreKeyWasDown = restoreKeyDown;
 }
 
 void TeleportCheats::UpdateCameraFlyMode()
 {
     // Skip if not in Camera mode (2)
-    if (g_config.FreeRoamTarget != 2) return;
+    if (g_config.FreeRoamTarget != 2)
+    {
+        m_CameraFlight.Stop();
+        return;
+    }
 
     float* camPos = Hooks::GetCameraPosPointer();
     if (!camPos) return;
 
-    // Get camera yaw from pFreeCam (same as player fly mode)
-    void* pFreeCam = Hooks::GetFreeCamPointer();
-    if (!pFreeCam) return;
+    // Camera yaw comes from pFreeCam (same as player fly mode)
+    if (!Hooks::GetFreeCamPointer()) return;
 
-    // Initialize camera position from current camera if not set
     // Initialize camera position from current camera if not set
     if (camPos[0] == 0 && camPos[1] == 0 && camPos[2] == 0)
     {
@@ -395,56 +373,122 @@ void TeleportCheats::UpdateCameraFlyMode()
         }
     }
 
+    float velocity[3];
+    if (!GetFlyVelocity(velocity)) return;
+
+    m_CameraFlight.Advance(camPos, velocity, GetFrameDelta());
+}
+
+bool TeleportCheats::GetFlyVelocity(float velocity[3]) const
+{
+    velocity[0] = velocity[1] = velocity[2] = 0.0f;
+
+    // Get camera yaw/pitch from pFreeCam
+    void* pFreeCam = Hooks::GetFreeCamPointer();
+    if (!pFreeCam) return false;
+
     float* pCamData = reinterpret_cast<float*>(pFreeCam);
-    float yawComponent1 = pCamData[0x20 / 4];
-    float yawComponent2 = pCamData[0x30 / 4];
-    float pitchValue = pCamData[0x38 / 4];
+    float yawComponent1 = pCamData[0x20 / 4]; // [pFreeCam+0x20]
+    float yawComponent2 = pCamData[0x30 / 4]; // [pFreeCam+0x30]
+    float pitchValue = pCamData[0x38 / 4];    // [pFreeCam+0x38]
+
+    // CE: yaw = atan2(-[addrYaw+0x20], [addrYaw+0x30])
     float yaw = std::atan2(-yawComponent1, yawComponent2);
+    // CE: pitch = asin(fPitch), then z = cos(90-pitch) * speed
     float pitch = std::asin(pitchValue);
-    float zStep = std::cos(1.5708f - pitch);
-    
+    float zStep = std::cos(1.5708f - pitch); // cos(PI/2 - pitch) = sin(pitch)
+
+    // Forward/backward vectors based on camera yaw
     float cosYaw = std::cos(yaw);
     float sinYaw = std::sin(yaw);
-    float speed = g_config.FlySpeed * 0.1f;
-    
-    // Forward (Numpad 8): camera-relative with pitch Z
-    if (g_config.Key_FlyForward.get().IsPressed())
+
+    float speed = g_config.FlySpeed * kFlyUnitsPerSecond;
+
+    // Forward (Numpad 8): x += cos(yaw), y -= sin(yaw), z += zStep (CE logic)
+    if (m_FlyForwardKey.IsDown())
     {
-        camPos[0] += cosYaw * speed;
-        camPos[1] -= sinYaw * speed;
-        camPos[2] += zStep * speed;
+        velocity[0] += cosYaw * speed;
+        velocity[1] -= sinYaw * speed;
+        velocity[2] += zStep * speed;
     }
-    // Backward (Numpad 2)
-    if (g_config.Key_FlyBackward.get().IsPressed())
+    // Backward (Numpad 2): opposite of forward
+    if (m_FlyBackwardKey.IsDown())
     {
-        camPos[0] -= cosYaw * speed;
-        camPos[1] += sinYaw * speed;
-        camPos[2] -= zStep * speed;
+        velocity[0] -= cosYaw * speed;
+        velocity[1] += sinYaw * speed;
+        velocity[2] -= zStep * speed;
     }
-    // Left (Numpad 4): no Z change
-    if (g_config.Key_FlyLeft.get().IsPressed())
+    // Left (Numpad 4): yaw - 90 degrees (no Z change)
+    if (m_FlyLeftKey.IsDown())
     {
-        float leftCos = std::cos(yaw - 1.5708f);
-        float leftSin = std::sin(yaw - 1.5708f);
-        camPos[0] += leftCos * speed;
-        camPos[1] -= leftSin * speed;
+        velocity[0] += std::cos(yaw - 1.5708f) * speed;
+        velocity[1] -= std::sin(yaw - 1.5708f) * speed;
     }
-    // Right (Numpad 6): no Z change
-    if (g_config.Key_FlyRight.get().IsPressed())
+    // Right (Numpad 6): yaw + 90 degrees (no Z change)
+    if (m_FlyRightKey.IsDown())
     {
-        float rightCos = std::cos(yaw + 1.5708f);
-        float rightSin = std::sin(yaw + 1.5708f);
-        camPos[0] += rightCos * speed;
-        camPos[1] -= rightSin * speed;
+        velocity[0] += std::cos(yaw + 1.5708f) * speed;
+        velocity[1] -= std::sin(yaw + 1.5708f) * speed;
     }
     // Up (Numpad 9): simple vertical movement
-    if (g_config.Key_FlyUp.get().IsPressed())
+    if (m_FlyUpKey.IsDown())
     {
-        camPos[2] += speed;
+        velocity[2] += speed;
     }
     // Down (Numpad 7): simple vertical movement
-    if (g_config.Key_FlyDown.get().IsPressed())
+    if (m_FlyDownKey.IsDown())
     {
-        camPos[2] -= speed;
+        velocity[2] -= speed;
+    }
+    return true;
+}
+
+void TeleportCheats::FlightPath::Advance(float* position, const float velocity[3], double delta)
+{
+    const bool moving = velocity[0] != 0.0f || velocity[1] != 0.0f || velocity[2] != 0.0f;
+    if (!active)
+    {
+        // Idle: leave the position to the game
+        if (!moving) return;
+        Restart(position);
+    }
+    else
+    {
+        // Carry over anything the game (or a teleport) did to the position since our last write
+        for (int i = 0; i < 3; ++i)
+        {
+            const float offset = position[i] - written[i];
+            previous[i] += offset;
+            current[i] += offset;
+        }
     }
+
+    const float step = static_cast<float>(clock.GetStep());
+    for (int steps = clock.Advance(delta); steps > 0; --steps)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            previous[i] = current[i];
+            current[i] += velocity[i] * step;
+        }
+    }
+
+    const float alpha = static_cast<float>(clock.Alpha());
+    for (int i = 0; i < 3; ++i)
+    {
+        written[i] = previous[i] + (current[i] - previous[i]) * alpha;
+        position[i] = written[i];
+    }
+
+    // Once the last step has been drawn, hand the position back to the game
+    if (!moving && previous[0] == current[0] && previous[1] == current[1] && previous[2] == current[2])
+        active = false;
+}
+
+void TeleportCheats::FlightPath::Restart(const float* position)
+{
+    for (int i = 0; i < 3; ++i)
+        previous[i] = current[i] = written[i] = position[i];
+    clock.Reset();
+    active = true;
 }
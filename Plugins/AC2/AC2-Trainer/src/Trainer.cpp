@@ -16,9 +16,11 @@
 #include <memory>
 #include <vector>
 #include "log.h"
+#include "Trace.h"
 
 // Global references
 const PluginLoaderInterface* g_loader_ref = nullptr;
+IPlugin* g_plugin_ref = nullptr;
 Trainer::Configuration g_config;
 std::filesystem::path g_configPath;
 static bool g_imgui_context_set = false;
@@ -34,20 +36,45 @@ private:
     std::unique_ptr<CharacterCheats> m_CharacterCheats;
     std::unique_ptr<GameFlowCheats> m_GameFlowCheats;
 
+    UpdateTaskHandle m_playerTask = 0;
+
+    // Scale, speed and invisibility only need to win against the game's own writes now and then.
+    // God mode and health stay in OnUpdate(): a hit landing between two low-rate runs would kill.
+    static void UpdatePlayerCheats(void* userData)
+    {
+        auto* self = static_cast<TrainerPlugin*>(userData);
+        if (self->m_PlayerCheats) self->m_PlayerCheats->UpdateLowRate();
+    }
+
 public:
     const char* GetPluginName() override { return "AC2 Trainer"; }
     uint32_t GetPluginVersion() override { return MAKE_PLUGIN_API_VERSION(1, 0); }
 
     ~TrainerPlugin() {
+        if (m_playerTask && g_loader_ref && g_loader_ref->UnregisterUpdateTask)
+            g_loader_ref->UnregisterUpdateTask(m_playerTask);
+        Hooks::Shutdown();
+    }
+
+    // Everything the game can call into goes through Hooks; the rest is torn down by the destructor.
+    bool OnPluginShutdown() override
+    {
+        if (m_playerTask && g_loader_ref->UnregisterUpdateTask)
+            g_loader_ref->UnregisterUpdateTask(m_playerTask);
+        m_playerTask = 0;
         Hooks::Shutdown();
+        return true;
     }
 
     void OnPluginInit(const PluginLoaderInterface& loader_interface) override
     {
         g_loader_ref = &loader_interface;
+        g_plugin_ref = this;
 
         // Configure logging to forward to loader
         Log::InitSink(g_loader_ref->LogToConsole);
+        if (g_loader_ref->SubmitTraceSpan)
+            Trace::InitSink(g_loader_ref->SubmitTraceSpan);
 
         LOG_INFO("[AC2 Trainer] Initializing...");
         
@@ -65,6 +92,21 @@ public:
         m_CharacterCheats = std::make_unique<CharacterCheats>();
         m_GameFlowCheats = std::make_unique<GameFlowCheats>();
 
+        if (g_loader_ref->RegisterUpdateTask)
+        {
+            UpdateTaskDesc desc;
+            desc.name = "PlayerCheats";
+            desc.callback = &TrainerPlugin::UpdatePlayerCheats;
+            desc.userData = this;
+            desc.frequency = UpdateFrequency::FixedRate;
+            desc.rateHz = 20.0f;
+            m_playerTask = g_loader_ref->RegisterUpdateTask(this, desc);
+        }
+
+        // The panel shows live values and rebuilds hotkey labels; 10 Hz is plenty when not interacting.
+        if (g_loader_ref->SetGuiRefreshRate)
+            g_loader_ref->SetGuiRefreshRate(this, 10.0f);
+
         // Apply initial config states if needed
     }
 
@@ -164,7 +206,12 @@ public:
     {
         Hooks::Update();
         Hooks::SyncPointers();
-        if (m_PlayerCheats) m_PlayerCheats->Update();
+        if (m_PlayerCheats)
+        {
+            m_PlayerCheats->Update();
+            // Fallback for loaders without update tasks (API < 1.2)
+            if (!m_playerTask) m_PlayerCheats->UpdateLowRate();
+        }
         if (m_InventoryCheats) m_InventoryCheats->Update();
         if (m_WorldCheats) m_WorldCheats->Update();
         if (m_TeleportCheats) m_TeleportCheats->Update();
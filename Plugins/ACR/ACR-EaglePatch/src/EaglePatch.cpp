@@ -8,6 +8,7 @@
 #include <CpuAffinity.h>
 #include <filesystem>
 #include "log.h"
+#include "Trace.h"
 #include <AutoAssemblerKinda.h>
 
 // Define the global loader reference here
@@ -28,6 +29,8 @@ public:
         
         // Configure logging
         Log::InitSink(g_loader_ref->LogToConsole);
+        if (g_loader_ref->SubmitTraceSpan)
+            Trace::InitSink(g_loader_ref->SubmitTraceSpan);
 
         LOG_INFO("[ACR EaglePatch] Initializing...");
 
@@ -47,7 +50,7 @@ public:
 
             if (g_config.FixCpuAffinity)
             {
-                uint64_t mask = CpuAffinity::GetSystemAffinityMask() & ~1ULL;
+                uint64_t mask = CpuAffinity::GetRecommendedMask(CpuTopology::kKeepSmtPolicy);
                 CpuAffinity::Apply(mask);
             }
         }
@@ -69,10 +72,10 @@ public:
         {
             ImGui::Checkbox("Hybrid Input (Simultaneous KB/M + Controller)", &g_config.EnableXInput.get());
             ImGui::Checkbox("Skip Intro Videos", &g_config.SkipIntroVideos.get());
-            if (ImGui::Checkbox("Fix CPU Affinity (Disable Core 0)", &g_config.FixCpuAffinity.get()))
+            if (ImGui::Checkbox("Fix CPU Affinity (Recommended Cores)", &g_config.FixCpuAffinity.get()))
             {
                 if (g_config.FixCpuAffinity)
-                    CpuAffinity::Apply(CpuAffinity::GetSystemAffinityMask() & ~1ULL);
+                    CpuAffinity::Apply(CpuAffinity::GetRecommendedMask(CpuTopology::kKeepSmtPolicy));
                 else
                     CpuAffinity::Apply(CpuAffinity::GetSystemAffinityMask());
             }
@@ -20,9 +20,19 @@ namespace ACREaglePatch
 
     namespace
     {
+        // The loader's presence monitor probes XInput off the game thread (API 1.7).
+        bool GetControllerPresence(ControllerPresence& out)
+        {
+            return g_loader_ref && g_loader_ref->GetControllerPresence && g_loader_ref->GetControllerPresence(&out);
+        }
+
         // Helper to find the first connected XInput controller for hotplugging
         int GetActiveXInputIndex()
         {
+            ControllerPresence presence;
+            if (GetControllerPresence(presence))
+                return presence.preferredIndex;
+
             XINPUT_STATE state;
             for (DWORD i = 0; i < XUSER_MAX_COUNT; ++i)
             {
@@ -207,7 +217,15 @@ namespace ACREaglePatch
         }
 
         // --- 2. Hotplugging Support ---
-        if (padXenon) {
+        ControllerPresence presence;
+        if (padXenon && GetControllerPresence(presence)) {
+            // Only switch when our controller is gone, so a second pad being plugged in doesn't steal input
+            bool isConnected = (presence.connectedMask & (1u << padXenon->m_PadIndex)) != 0;
+            if (!isConnected && presence.preferredIndex != -1)
+                padXenon->m_PadIndex = presence.preferredIndex;
+        }
+        else if (padXenon) {
+            // Older loader: probe ourselves
             static DWORD lastScanTime = 0;
             DWORD currentTime = GetTickCount();
 
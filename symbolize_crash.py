@@ -0,0 +1,203 @@
+"""
+Resolves the raw frames of a crash log offline.
+
+Crash logs always contain a RAW FRAMES section ("[frame] #NN 0xADDR ...") and a MODULES section
+("[module] base=0x... size=0x... timestamp=0x... path"). This matches each frame to its module and
+looks the offset up in the module's linker map (<name>.map, from /MAP) or, failing that, in the PE's
+export table. Needs no PDBs or Windows tools, so it runs anywhere Python does.
+
+Usage:
+    python symbolize_crash.py PluginLoader.log [-s build/Win32/Release] [-s path/to/game]
+"""
+import argparse
+import bisect
+import re
+import struct
+from pathlib import Path, PureWindowsPath
+
+FRAME_RE = re.compile(r"\[frame\] #(\d+) 0x([0-9A-Fa-f]+)")
+MODULE_RE = re.compile(r"\[module\] base=0x([0-9A-Fa-f]+) size=0x([0-9A-Fa-f]+) timestamp=0x([0-9A-Fa-f]+) (.+)$")
+
+MAP_BASE_RE = re.compile(r"Preferred load address is ([0-9A-Fa-f]+)")
+MAP_SYMBOL_RE = re.compile(r"^\s*([0-9A-Fa-f]{4}):[0-9A-Fa-f]{8}\s+(\S+)\s+([0-9A-Fa-f]{8,16})\s")
+
+
+class Module:
+    def __init__(self, base, size, timestamp, path):
+        self.base = base
+        self.size = size
+        self.timestamp = timestamp
+        self.path = path
+        self.name = PureWindowsPath(path).name
+        self.rvas = []      # Sorted symbol RVAs
+        self.names = []     # Parallel to rvas
+        self.source = None  # Where the symbols came from
+
+    def contains(self, address):
+        return self.base <= address < self.base + self.size
+
+    def set_symbols(self, symbols, source):
+        symbols.sort()
+        self.rvas = [rva for rva, _ in symbols]
+        self.names = [name for _, name in symbols]
+        self.source = source
+
+    def lookup(self, rva):
+        i = bisect.bisect_right(self.rvas, rva) - 1
+        if i < 0:
+            return None
+        return self.names[i], rva - self.rvas[i]
+
+
+def parse_log(path):
+    frames = []
+    modules = []
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            m = FRAME_RE.search(line)
+            if m:
+                frames.append((int(m.group(1)), int(m.group(2), 16)))
+                continue
+            m = MODULE_RE.search(line)
+            if m:
+                modules.append(Module(int(m.group(1), 16), int(m.group(2), 16), int(m.group(3), 16), m.group(4).strip()))
+    return frames, modules
+
+
+def read_map(path):
+    """Publics and statics from an MSVC linker map, as (rva, name)."""
+    symbols = []
+    preferred = None
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            if preferred is None:
+                m = MAP_BASE_RE.search(line)
+                if m:
+                    preferred = int(m.group(1), 16)
+                continue
+            m = MAP_SYMBOL_RE.match(line)
+            if not m or m.group(1) == "0000":  # Section 0000 holds absolute symbols
+                continue
+            va = int(m.group(3), 16)
+            if va >= preferred:
+                symbols.append((va - preferred, m.group(2)))
+    return symbols
+
+
+def read_pe(path):
+    """Link timestamp and named exports of a PE file, as (timestamp, [(rva, name)])."""
+    data = Path(path).read_bytes()
+    if data[:2] != b"MZ":
+        raise ValueError("not a PE file")
+    nt = struct.unpack_from("<I", data, 0x3C)[0]
+    if data[nt:nt + 4] != b"PE\0\0":
+        raise ValueError("bad NT header")
+
+    _, section_count, timestamp, _, _, optional_size, _ = struct.unpack_from("<HHIIIHH", data, nt + 4)
+    optional = nt + 24
+    magic = struct.unpack_from("<H", data, optional)[0]
+    directories = optional + (96 if magic == 0x10B else 112)
+    export_rva, export_size = struct.unpack_from("<II", data, directories)
+
+    sections = []
+    table = optional + optional_size
+    for i in range(section_count):
+        vsize, vaddr, raw_size, raw_ptr = struct.unpack_from("<IIII", data, table + i * 40 + 8)
+        sections.append((vaddr, max(vsize, raw_size), raw_ptr))
+
+    def rva_to_offset(rva):
+        for vaddr, size, raw_ptr in sections:
+            if vaddr <= rva < vaddr + size:
+                return rva - vaddr + raw_ptr
+        raise ValueError(f"RVA 0x{rva:X} is outside every section")
+
+    def read_cstring(rva):
+        start = rva_to_offset(rva)
+        return data[start:data.index(b"\0", start)].decode("ascii", errors="replace")
+
+    symbols = []
+    if export_rva:
+        exports = rva_to_offset(export_rva)
+        _, _, _, _, _, _, function_count, name_count, functions, names, ordinals = struct.unpack_from("<IIHHIIIIIII", data, exports)
+        for i in range(name_count):
+            name_rva = struct.unpack_from("<I", data, rva_to_offset(names + i * 4))[0]
+            ordinal = struct.unpack_from("<H", data, rva_to_offset(ordinals + i * 2))[0]
+            if ordinal >= function_count:
+                continue
+            function_rva = struct.unpack_from("<I", data, rva_to_offset(functions + ordinal * 4))[0]
+            if export_rva <= function_rva < export_rva + export_size:
+                continue  # Forwarder string, not code
+            symbols.append((function_rva, read_cstring(name_rva)))
+    return timestamp, symbols
+
+
+def find_file(search_dirs, name):
+    for directory in search_dirs:
+        for candidate in (directory / name, *directory.rglob(name)):
+            if candidate.is_file():
+                return candidate
+    return None
+
+
+def load_symbols(module, search_dirs):
+    stem = PureWindowsPath(module.name).stem
+
+    map_path = find_file(search_dirs, f"{stem}.map")
+    if map_path:
+        module.set_symbols(read_map(map_path), str(map_path))
+        return
+
+    pe_path = find_file(search_dirs, module.name)
+    if not pe_path:
+        return
+    try:
+        timestamp, exports = read_pe(pe_path)
+    except (ValueError, struct.error) as e:
+        print(f"[!] {pe_path}: {e}")
+        return
+    if timestamp != module.timestamp:
+        print(f"[!] {pe_path}: timestamp 0x{timestamp:08X} does not match the crashed module (0x{module.timestamp:08X}); skipping")
+        return
+    if exports:
+        module.set_symbols(exports, f"{pe_path} (exports)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolize the raw frames of an AC-Definitive crash log.")
+    parser.add_argument("log", type=Path, help="Log file containing a crash report")
+    parser.add_argument("-s", "--search", type=Path, action="append", default=[],
+                        help="Directory with the crashed binaries and/or their .map files (repeatable)")
+    args = parser.parse_args()
+
+    frames, modules = parse_log(args.log)
+    if not frames:
+        print(f"[!] No raw frames found in {args.log}")
+        return
+
+    search_dirs = args.search or [args.log.parent]
+    used = {}
+    for index, address in frames:
+        module = next((m for m in modules if m.contains(address)), None)
+        if module is None:
+            print(f"#{index:02d} 0x{address:X}")
+            continue
+
+        if module.name not in used:
+            load_symbols(module, search_dirs)
+            used[module.name] = module
+
+        rva = address - module.base
+        symbol = module.lookup(rva) if module.rvas else None
+        if symbol:
+            name, displacement = symbol
+            print(f"#{index:02d} 0x{address:X} {module.name}!{name}+0x{displacement:X}")
+        else:
+            print(f"#{index:02d} 0x{address:X} {module.name}+0x{rva:X}")
+
+    print("\nSymbol sources:")
+    for module in used.values():
+        print(f"  {module.name}: {module.source or '(none)'}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,96 @@
+#include "Test.h"
+#include "Bench.h"
+#include "AssemblerStubs.h"
+#include <string>
+#include <vector>
+
+// Cost of assembling a generated script with thousands of labels and references, and of looking
+// its symbols up by name. The linear scan is what GetSymbol did before the name index.
+namespace
+{
+    constexpr int kLabels = 5000;
+    constexpr uintptr_t kInjectAt = 0x140001000;
+
+    std::vector<std::string> MakeNames()
+    {
+        std::vector<std::string> names;
+        for (int i = 0; i < kLabels; ++i)
+            names.push_back("case_" + std::to_string(i));
+        return names;
+    }
+
+    // A jump table in a cave: every entry jumps to a label placed further down, appended one entry
+    // at a time the way generated scripts build their bodies.
+    struct JumpTable : AutoAssemblerCodeHolder_Base
+    {
+        explicit JumpTable(const std::vector<std::string>& names)
+        {
+            DEFINE_ADDR(injectAt, kInjectAt);
+            ALLOC(cave, 0x40000, kInjectAt);
+            injectAt = { "E9", RIP(cave) };
+
+            std::vector<Label*> labels;
+            for (const std::string& name : names)
+                labels.push_back(&m_ctx->MakeNew_Label(name));
+            for (Label* label : labels)
+                cave += { "E9", RIP(*label) };
+            for (Label* label : labels)
+                cave += { PutLabel(*label), "48 FF C0" };
+        }
+    };
+
+    SymbolWithAnAddress* LinearScan(const std::vector<std::unique_ptr<SymbolWithAnAddress>>& symbols, std::string_view name)
+    {
+        for (auto& symbol : symbols)
+            if (symbol->m_SymbolName == name)
+                return symbol.get();
+        return nullptr;
+    }
+}
+
+TEST(AssembleLargeScript)
+{
+    const std::vector<std::string> names = MakeNames();
+    {
+        std::string error;
+        auto wrapper = TryAutoAssemble<JumpTable>(error, names);
+        REQUIRE(wrapper);
+        AssemblerContext& ctx = wrapper->debug_GetAssemblerContext();
+        const uintptr_t cave = ctx.GetSymbol("cave")->m_ResolvedAddr.value();
+        // Entry i jumps over the rest of the table and i label bodies.
+        CHECK_EQ(ctx.GetSymbol("case_0")->m_ResolvedAddr.value(), cave + kLabels * 5);
+        CHECK_EQ(ctx.GetSymbol("case_4999")->m_ResolvedAddr.value(), cave + kLabels * 5 + 4999 * 3);
+    }
+
+    Bench::Measure("assemble 5000 labels + 5000 references", [&] {
+        std::string error;
+        Bench::DoNotOptimize(TryAutoAssemble<JumpTable>(error, names));
+    });
+}
+
+TEST(LookUpEverySymbol)
+{
+    const std::vector<std::string> names = MakeNames();
+    std::string error;
+    auto wrapper = TryAutoAssemble<JumpTable>(error, names);
+    REQUIRE(wrapper);
+    AssemblerContext& ctx = wrapper->debug_GetAssemblerContext();
+
+    std::vector<std::unique_ptr<SymbolWithAnAddress>> copies;
+    for (const std::string& name : names)
+    {
+        copies.push_back(std::make_unique<Label>(std::optional<uintptr_t>()));
+        copies.back()->m_SymbolName = name;
+    }
+    for (const std::string& name : names)
+        CHECK_EQ(LinearScan(copies, name)->m_SymbolName, ctx.GetSymbol(name)->m_SymbolName);
+
+    Bench::Measure("look up 5000 names, GetSymbol", [&] {
+        for (const std::string& name : names)
+            Bench::DoNotOptimize(ctx.GetSymbol(name));
+    });
+    Bench::Measure("look up 5000 names, linear scan", [&] {
+        for (const std::string& name : names)
+            Bench::DoNotOptimize(LinearScan(copies, name));
+    });
+}
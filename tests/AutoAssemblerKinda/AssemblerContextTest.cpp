@@ -0,0 +1,137 @@
+#include "Test.h"
+#include "AssemblerStubs.h"
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr uintptr_t kInjectAt = 0x140001000;
+
+    // jmp to a code cave that NOPs and jumps back right after the injected jump.
+    struct JumpToCave : AutoAssemblerCodeHolder_Base
+    {
+        JumpToCave()
+        {
+            DEFINE_ADDR(injectAt, kInjectAt);
+            ALLOC(cave, 0x100, kInjectAt);
+            LABEL(return_);
+            injectAt = {
+                "E9", RIP(cave),
+                PutLabel(return_)
+            };
+            cave = {
+                "90 90",
+                "E9", RIP(return_)
+            };
+            cave += {
+                "48 B8", ABS(injectAt, 8)
+            };
+        }
+    };
+
+    struct DuplicateLabel : AutoAssemblerCodeHolder_Base
+    {
+        DuplicateLabel()
+        {
+            DEFINE_ADDR(injectAt, kInjectAt);
+            LABEL_NAMED(first, "return");
+            LABEL_NAMED(second, "return");
+            injectAt = { PutLabel(first), "90", PutLabel(second) };
+        }
+    };
+
+    struct UnplacedLabel : AutoAssemblerCodeHolder_Base
+    {
+        UnplacedLabel()
+        {
+            DEFINE_ADDR(injectAt, kInjectAt);
+            LABEL(neverPlaced);
+            injectAt = { "E9", RIP(neverPlaced) };
+        }
+    };
+
+    std::string Rel32(uintptr_t target, uintptr_t nextInstruction)
+    {
+        const uint32_t rel = (uint32_t)(int32_t)(target - nextInstruction);
+        char text[16];
+        snprintf(text, sizeof(text), "%02x %02x %02x %02x ", rel & 0xff, (rel >> 8) & 0xff, (rel >> 16) & 0xff, rel >> 24);
+        return text;
+    }
+}
+
+TEST(GetSymbolFindsEveryKindByName)
+{
+    AssemblerContext ctx;
+    StaticSymbol& define = ctx.MakeNew_Define(kInjectAt, "injectAt");
+    Label& label = ctx.MakeNew_Label("return");
+    AllocatedWriteableSymbol& alloc = ctx.MakeNew_Alloc(0x100, "cave", kInjectAt);
+
+    CHECK_EQ(ctx.GetSymbol("injectAt"), static_cast<SymbolWithAnAddress*>(&define));
+    CHECK_EQ(ctx.GetSymbol("return"), static_cast<SymbolWithAnAddress*>(&label));
+    CHECK_EQ(ctx.GetSymbol("cave"), static_cast<SymbolWithAnAddress*>(&alloc));
+    CHECK(ctx.GetSymbol("missing") == nullptr);
+    CHECK(ctx.GetSymbol("") == nullptr);
+}
+
+TEST(DuplicateDefinitionThrows)
+{
+    AssemblerContext ctx;
+    Label& first = ctx.MakeNew_Label("return");
+
+    bool threw = false;
+    try {
+        ctx.MakeNew_Define(kInjectAt, "return");
+    }
+    catch (const std::runtime_error& e) {
+        threw = true;
+        CHECK_EQ(std::string(e.what()), std::string("Duplicate symbol definition: return"));
+    }
+    CHECK(threw);
+    // The rejected symbol didn't replace the original.
+    CHECK_EQ(ctx.GetSymbol("return"), static_cast<SymbolWithAnAddress*>(&first));
+}
+
+TEST(UnnamedSymbolsAreNotDuplicates)
+{
+    AssemblerContext ctx;
+    ctx.MakeNew_Define(kInjectAt, "");
+    ctx.MakeNew_Define(kInjectAt + 0x10, "");
+    CHECK(ctx.GetSymbol("") == nullptr);
+}
+
+TEST(ResolvesRelativeAndAbsoluteReferences)
+{
+    std::string error;
+    auto wrapper = TryAutoAssemble<JumpToCave>(error);
+    REQUIRE(wrapper);
+    CHECK(error.empty());
+
+    AssemblerContext& ctx = wrapper->debug_GetAssemblerContext();
+    const uintptr_t cave = kInjectAt + kFakeAllocDistance;
+    CHECK_EQ(ctx.GetSymbol("cave")->m_ResolvedAddr.value(), cave);
+    CHECK_EQ(ctx.GetSymbol("return_")->m_ResolvedAddr.value(), kInjectAt + 5);
+
+    auto* injectAt = static_cast<WriteableSymbol*>(ctx.GetSymbol("injectAt"));
+    CHECK_EQ(injectAt->GetResultBytesString(), "e9 " + Rel32(cave, kInjectAt + 5));
+
+    // The appended ABS lands after the bytes of the first assignment.
+    auto* caveSymbol = static_cast<WriteableSymbol*>(ctx.GetSymbol("cave"));
+    CHECK_EQ(caveSymbol->GetResultBytesString(),
+        "90 90 e9 " + Rel32(kInjectAt + 5, cave + 7) + "48 b8 00 10 00 40 01 00 00 00 ");
+}
+
+TEST(DuplicateDefinitionIsAFailedAssemble)
+{
+    std::string error;
+    auto wrapper = TryAutoAssemble<DuplicateLabel>(error);
+    CHECK(!wrapper);
+    CHECK_EQ(error, std::string("Duplicate symbol definition: return"));
+}
+
+TEST(UnplacedLabelIsAFailedAssemble)
+{
+    std::string error;
+    auto wrapper = TryAutoAssemble<UnplacedLabel>(error);
+    CHECK(!wrapper);
+    CHECK_EQ(error, std::string("Label not placed with PutLabel(): neverPlaced"));
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "AutoAssemblerKinda.h"
+
+// The parts of AutoAssemblerKinda.cpp that touch process memory, for the test binaries. Allocations
+// get made-up addresses a megabyte past their preferred address, one 64 KiB block apart, so scripts
+// can be resolved without VirtualAlloc.
+inline constexpr uintptr_t kFakeAllocDistance = 0x100000;
+inline constexpr uintptr_t kFakeAllocGranularity = 0x10000;
+
+AllocatedWriteableSymbol::~AllocatedWriteableSymbol() {}
+
+void AssemblerContext::AllocateVariables()
+{
+    uintptr_t offset = kFakeAllocDistance;
+    for (AllocatedWriteableSymbol* alloc : m_AllocsQuickAccess)
+    {
+        alloc->m_ResolvedAddr = alloc->m_PreferredAddr + offset;
+        offset += kFakeAllocGranularity;
+    }
+}
+
+// Only reachable through Activate(), which the tests never call.
+void AssemblerContext::Unwrite() {}
@@ -0,0 +1,11 @@
+#pragma once
+// Stand-in for the <windows.h> PatternScanner.h includes. AutoAssemblerKinda.h also spells its
+// sized integers with MSVC's __intN keywords.
+#include "../../support/win32/Windows.h"
+
+#ifndef _MSC_VER
+#define __int8 char
+#define __int16 short
+#define __int32 int
+#define __int64 long long
+#endif
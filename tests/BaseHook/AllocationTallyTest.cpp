@@ -0,0 +1,90 @@
+#include "Test.h"
+#include "util/AllocationTally.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using BaseHook::AllocationTally;
+
+TEST(CloseFrameMovesCountsToLastFrame)
+{
+    AllocationTally tally;
+    tally.Add(16);
+    tally.Add(0);
+    tally.Add(100);
+    CHECK_EQ(tally.GetLastFrame().allocations, 0u);
+
+    tally.CloseFrame();
+    CHECK_EQ(tally.GetLastFrame().allocations, 3u);
+    CHECK_EQ(tally.GetLastFrame().bytes, 116ull);
+
+    // A frame without allocations reads as zero, not as the previous frame.
+    tally.CloseFrame();
+    CHECK_EQ(tally.GetLastFrame().allocations, 0u);
+    CHECK_EQ(tally.GetLastFrame().bytes, 0ull);
+}
+
+TEST(PeakKeepsTheBusiestFrame)
+{
+    AllocationTally tally;
+    for (int allocations : { 4, 9, 2, 0, 7 })
+    {
+        for (int i = 0; i < allocations; ++i)
+            tally.Add(8);
+        tally.CloseFrame();
+    }
+    CHECK_EQ(tally.GetPeakAllocations(), 9u);
+    CHECK_EQ(tally.GetLastFrame().allocations, 7u);
+}
+
+TEST(ResetClearsEverything)
+{
+    AllocationTally tally;
+    tally.Add(32);
+    tally.CloseFrame();
+    tally.Add(64);
+    tally.Reset();
+    CHECK_EQ(tally.GetPeakAllocations(), 0u);
+    CHECK_EQ(tally.GetLastFrame().allocations, 0u);
+
+    // What was counted before the reset doesn't leak into the next frame.
+    tally.CloseFrame();
+    CHECK_EQ(tally.GetLastFrame().allocations, 0u);
+    CHECK_EQ(tally.GetLastFrame().bytes, 0ull);
+}
+
+// Allocating threads against the render thread closing frames: nothing is lost or counted twice.
+TEST(ConcurrentAddAndCloseFrame)
+{
+    constexpr int kThreads = 4;
+    constexpr int kAllocations = 50000;
+    AllocationTally tally;
+    std::atomic<int> running{ kThreads };
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kAllocations; ++i)
+                tally.Add(3);
+            running--;
+        });
+    }
+    while (running.load() > 0)
+    {
+        tally.CloseFrame();
+        allocations += tally.GetLastFrame().allocations;
+        bytes += tally.GetLastFrame().bytes;
+    }
+    for (auto& t : threads)
+        t.join();
+    tally.CloseFrame();
+    allocations += tally.GetLastFrame().allocations;
+    bytes += tally.GetLastFrame().bytes;
+
+    CHECK_EQ(allocations, (uint64_t)kThreads * kAllocations);
+    CHECK_EQ(bytes, (uint64_t)kThreads * kAllocations * 3);
+    CHECK(tally.GetPeakAllocations() > 0u);
+}
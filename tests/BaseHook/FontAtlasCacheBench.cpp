@@ -0,0 +1,57 @@
+#include "Test.h"
+#include "Bench.h"
+#include "util/FontAtlasCache.h"
+#include "imgui.h"
+#include <filesystem>
+#include <vector>
+
+namespace FontAtlasCache = BaseHook::FontAtlasCache;
+
+// Font setup as InitImGuiStyle does it (install the cache, add the font, preload the configured
+// scales), per run: without the cache, with an empty cache directory (every glyph rasterized, then
+// written out), and with the directory a previous run left.
+namespace
+{
+    const std::vector<float> kPreloadScales = { 1.0f, 1.5f, 2.0f };
+
+    void BuildFonts(const std::filesystem::path* cacheDir)
+    {
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+        if (cacheDir)
+            FontAtlasCache::Install(io.Fonts, *cacheDir);
+
+        ImFontConfig config;
+        config.SizePixels = 16.0f;
+        config.OversampleH = 2;
+        io.Fonts->AddFontDefault(&config);
+        FontAtlasCache::Preload(io.Fonts, kPreloadScales);
+
+        FontAtlasCache::Flush();
+        ImGui::DestroyContext();
+    }
+}
+
+TEST(ColdVersusCachedAtlas)
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "ac_font_atlas_cache_bench";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    Bench::Measure("no cache (stb_truetype)", [&] { BuildFonts(nullptr); });
+    Bench::Measure("cold: empty cache dir (rasterize + write)", [&] {
+        std::filesystem::remove_all(dir, ec);
+        BuildFonts(&dir);
+    });
+
+    const FontAtlasCache::Stats beforeWarm = FontAtlasCache::GetStats();
+    Bench::Measure("cached: warm cache dir", [&] { BuildFonts(&dir); });
+    const FontAtlasCache::Stats afterWarm = FontAtlasCache::GetStats();
+
+    // The warm runs must really have been served from the cache.
+    CHECK(afterWarm.hits > beforeWarm.hits);
+    CHECK_EQ(afterWarm.misses, beforeWarm.misses);
+    std::filesystem::remove_all(dir, ec);
+}
@@ -0,0 +1,177 @@
+#include "Test.h"
+#include "util/FontAtlasCache.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using BaseHook::GlyphCache;
+namespace FontAtlasCache = BaseHook::FontAtlasCache;
+
+namespace
+{
+    GlyphCache MakeSmallCache(GlyphCache::BakeKey& key)
+    {
+        GlyphCache cache(42);
+        key.size = 13.0f;
+        GlyphCache::Glyph a;
+        a.visible = true;
+        a.width = 2;
+        a.height = 3;
+        a.pixels = { 1, 2, 3, 4, 5, 6 };
+        a.advanceX = 7.0f;
+        cache.Add(key, 'A', a);
+        GlyphCache::Glyph space;
+        space.advanceX = 3.0f;
+        cache.Add(key, ' ', space);
+        return cache;
+    }
+
+    // Every glyph of the default font in the atlas at a few sizes, with the pixels it was baked to.
+    // Atlas placement (UVs, pack ids) legitimately differs between runs and is left out.
+    struct AtlasSnapshot
+    {
+        std::vector<ImFontGlyph> glyphs;
+        std::vector<std::vector<uint8_t>> pixels;
+    };
+
+    constexpr float kSizes[] = { 13.0f, 20.0f, 32.0f };
+
+    AtlasSnapshot BuildAtlas(const std::filesystem::path* cacheDir)
+    {
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+        if (cacheDir)
+            FontAtlasCache::Install(io.Fonts, *cacheDir);
+
+        ImFontConfig config;
+        config.OversampleH = 2;
+        ImFont* font = io.Fonts->AddFontDefault(&config);
+        FontAtlasCache::Preload(io.Fonts, { 1.0f, 2.0f });
+
+        AtlasSnapshot snapshot;
+        for (float size : kSizes)
+        {
+            ImFontBaked* baked = font->GetFontBaked(size);
+            for (ImWchar c = 0x20; c < 0x100; ++c)
+            {
+                ImFontGlyph* glyph = baked->FindGlyphNoFallback(c);
+                if (!glyph)
+                    continue;
+                ImFontGlyph copy = *glyph;
+                copy.U0 = copy.V0 = copy.U1 = copy.V1 = 0.0f;
+                copy.PackId = 0;
+                snapshot.glyphs.push_back(copy);
+
+                std::vector<uint8_t> pixels;
+                if (glyph->Visible)
+                {
+                    // Baking can grow the atlas, which replaces TexData, so look it up per glyph.
+                    ImTextureData* tex = io.Fonts->TexData;
+                    const ImTextureRect* r = ImFontAtlasPackGetRect(io.Fonts, glyph->PackId);
+                    const int channel = tex->Format == ImTextureFormat_RGBA32 ? 3 : 0;
+                    for (int y = 0; y < r->h; ++y)
+                        for (int x = 0; x < r->w; ++x)
+                            pixels.push_back(static_cast<const uint8_t*>(tex->GetPixelsAt(r->x + x, r->y + y))[channel]);
+                }
+                snapshot.pixels.push_back(std::move(pixels));
+            }
+        }
+
+        FontAtlasCache::Flush();
+        ImGui::DestroyContext();
+        return snapshot;
+    }
+}
+
+TEST(GlyphCacheRoundTrips)
+{
+    GlyphCache::BakeKey key;
+    const GlyphCache cache = MakeSmallCache(key);
+    const std::vector<uint8_t> bytes = cache.Serialize(IMGUI_VERSION_NUM);
+
+    GlyphCache loaded(42);
+    REQUIRE(loaded.Deserialize(bytes.data(), bytes.size(), IMGUI_VERSION_NUM));
+    CHECK_EQ(loaded.GetBakeCount(), (size_t)1);
+    CHECK_EQ(loaded.GetGlyphCount(), (size_t)2);
+    REQUIRE(loaded.Find(key, 'A') != nullptr);
+    CHECK(loaded.Find(key, 'A')->pixels == std::vector<uint8_t>({ 1, 2, 3, 4, 5, 6 }));
+    CHECK_EQ(loaded.Find(key, ' ')->advanceX, 3.0f);
+    CHECK(loaded.Find(key, 'B') == nullptr);
+
+    // Any difference in how the bake was made is a different bake.
+    GlyphCache::BakeKey oversampled = key;
+    oversampled.oversampleH = 2;
+    CHECK(loaded.Find(oversampled, 'A') == nullptr);
+}
+
+TEST(GlyphCacheRejectsOtherFontsAndVersions)
+{
+    GlyphCache::BakeKey key;
+    const std::vector<uint8_t> bytes = MakeSmallCache(key).Serialize(IMGUI_VERSION_NUM);
+
+    GlyphCache otherFont(43);
+    CHECK(!otherFont.Deserialize(bytes.data(), bytes.size(), IMGUI_VERSION_NUM));
+    GlyphCache otherImGui(42);
+    CHECK(!otherImGui.Deserialize(bytes.data(), bytes.size(), IMGUI_VERSION_NUM + 1));
+    CHECK_EQ(otherImGui.GetGlyphCount(), (size_t)0);
+}
+
+TEST(GlyphCacheRejectsTruncatedAndCorruptData)
+{
+    GlyphCache::BakeKey key;
+    const std::vector<uint8_t> bytes = MakeSmallCache(key).Serialize(IMGUI_VERSION_NUM);
+
+    int accepted = 0;
+    for (size_t size = 0; size < bytes.size(); ++size)
+    {
+        GlyphCache cache(42);
+        accepted += cache.Deserialize(bytes.data(), size, IMGUI_VERSION_NUM);
+    }
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        std::vector<uint8_t> damaged = bytes;
+        damaged[i] ^= 0x10;
+        GlyphCache cache(42);
+        accepted += cache.Deserialize(damaged.data(), damaged.size(), IMGUI_VERSION_NUM);
+        CHECK_EQ(cache.GetGlyphCount(), (size_t)0);
+    }
+    CHECK_EQ(accepted, 0);
+}
+
+// A warm cache must give exactly the glyphs stb_truetype would have baked, without rasterizing.
+TEST(WarmAtlasMatchesAnUncachedOne)
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "ac_font_atlas_cache_test";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    const AtlasSnapshot reference = BuildAtlas(nullptr);
+    const FontAtlasCache::Stats before = FontAtlasCache::GetStats();
+    const AtlasSnapshot cold = BuildAtlas(&dir);
+    const FontAtlasCache::Stats afterCold = FontAtlasCache::GetStats();
+    const AtlasSnapshot warm = BuildAtlas(&dir);
+    const FontAtlasCache::Stats afterWarm = FontAtlasCache::GetStats();
+    std::filesystem::remove_all(dir, ec);
+
+    CHECK(afterCold.misses > before.misses);
+    CHECK_EQ(afterWarm.misses, afterCold.misses);
+    CHECK(afterWarm.hits > afterCold.hits);
+
+    REQUIRE(!reference.glyphs.empty());
+    REQUIRE(cold.glyphs.size() == reference.glyphs.size());
+    REQUIRE(warm.glyphs.size() == reference.glyphs.size());
+    int different = 0;
+    for (size_t i = 0; i < reference.glyphs.size(); ++i)
+    {
+        for (const AtlasSnapshot* run : { &cold, &warm })
+        {
+            if (memcmp(&reference.glyphs[i], &run->glyphs[i], sizeof(ImFontGlyph)) != 0 || reference.pixels[i] != run->pixels[i])
+                different++;
+        }
+    }
+    CHECK_EQ(different, 0);
+}
@@ -0,0 +1,147 @@
+#include "Test.h"
+#include "util/FrameBoundaryTracker.h"
+
+using BaseHook::FrameBoundaryTracker;
+using BaseHook::OverlayDrawPoint;
+
+namespace
+{
+    // One presented frame of `scenes` EndScenes. Only the last one targets the back buffer, and only
+    // if `lastOnBackBuffer`. Run() returns where the overlay went.
+    struct Frame
+    {
+        uint32_t scenes = 4;
+        bool lastOnBackBuffer = true;
+        uint32_t checks = 0;    // Times the target callable ran
+        uint32_t drawnInScene = 0;
+
+        OverlayDrawPoint Run(FrameBoundaryTracker& tracker)
+        {
+            for (uint32_t scene = 1; scene <= scenes; ++scene)
+            {
+                const bool onBackBuffer = scene == scenes && lastOnBackBuffer;
+                if (tracker.OnEndScene([&] { ++checks; return onBackBuffer; }))
+                {
+                    drawnInScene = scene;
+                    tracker.OnOverlayBuilt();
+                    tracker.OnOverlayDrawn();
+                }
+            }
+            if (tracker.ShouldDrawBeforePresent())
+            {
+                tracker.OnOverlayBuilt();
+                tracker.OnOverlayDrawn();
+            }
+            tracker.OnPresent();
+            return tracker.GetLastFrame().drawPoint;
+        }
+    };
+
+    void Stabilize(FrameBoundaryTracker& tracker, uint32_t scenes)
+    {
+        for (uint32_t i = 0; i <= FrameBoundaryTracker::kStableFrames; ++i)
+            Frame{ scenes }.Run(tracker);
+    }
+}
+
+TEST(LearningDrawsBeforePresentWithoutCheckingTargets)
+{
+    FrameBoundaryTracker tracker;
+    for (uint32_t i = 0; i < FrameBoundaryTracker::kStableFrames; ++i)
+    {
+        Frame frame;
+        CHECK_EQ(frame.Run(tracker), OverlayDrawPoint::Present);
+        CHECK_EQ(frame.checks, 0u);
+        CHECK_EQ(tracker.GetLastFrame().targetChecks, 0u);
+        CHECK_EQ(tracker.GetLastFrame().endScenes, 4u);
+    }
+}
+
+TEST(StableFramesDrawInTheLastSceneWithOneCheck)
+{
+    FrameBoundaryTracker tracker;
+    Stabilize(tracker, 4);
+    REQUIRE(tracker.IsAnchoredToEndScene());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        Frame frame;
+        CHECK_EQ(frame.Run(tracker), OverlayDrawPoint::EndScene);
+        CHECK_EQ(frame.drawnInScene, 4u);
+        CHECK_EQ(frame.checks, 1u);
+        const FrameBoundaryTracker::FrameStats& stats = tracker.GetLastFrame();
+        CHECK_EQ(stats.targetChecks, 1u);
+        CHECK_EQ(stats.builds, 1u);
+        CHECK_EQ(stats.draws, 1u);
+    }
+}
+
+TEST(OffscreenLastSceneFallsBackToPresent)
+{
+    FrameBoundaryTracker tracker;
+    Stabilize(tracker, 3);
+
+    Frame frame;
+    frame.scenes = 3;
+    frame.lastOnBackBuffer = false;
+    CHECK_EQ(frame.Run(tracker), OverlayDrawPoint::Present);
+    CHECK_EQ(frame.checks, 1u);
+    CHECK_EQ(tracker.GetLastFrame().draws, 1u);
+    // Same scene count, so it stays anchored and checks again next frame.
+    CHECK(tracker.IsAnchoredToEndScene());
+}
+
+TEST(FewerScenesDrawBeforePresentAndRelearn)
+{
+    FrameBoundaryTracker tracker;
+    Stabilize(tracker, 4);
+
+    Frame frame;
+    frame.scenes = 2;
+    CHECK_EQ(frame.Run(tracker), OverlayDrawPoint::Present);
+    CHECK_EQ(frame.checks, 0u);
+    CHECK(!tracker.IsAnchoredToEndScene());
+}
+
+// More scenes than expected: the overlay was drawn in what turned out not to be the last scene, so
+// it may have been covered. It must not be drawn twice, and learning starts over.
+TEST(MoreScenesDrawOnceAndRelearn)
+{
+    FrameBoundaryTracker tracker;
+    Stabilize(tracker, 4);
+
+    // Every scene targets the back buffer; scene 4 still looks like the last one.
+    uint32_t checks = 0;
+    for (uint32_t scene = 1; scene <= 6; ++scene)
+    {
+        if (tracker.OnEndScene([&] { ++checks; return true; }))
+            tracker.OnOverlayDrawn();
+    }
+    CHECK(!tracker.ShouldDrawBeforePresent());
+    tracker.OnPresent();
+
+    CHECK_EQ(checks, 1u);
+    CHECK_EQ(tracker.GetLastFrame().draws, 1u);
+    CHECK_EQ(tracker.GetLastFrame().drawPoint, OverlayDrawPoint::EndScene);
+    CHECK(!tracker.IsAnchoredToEndScene());
+}
+
+TEST(InvalidateStartsLearningOver)
+{
+    FrameBoundaryTracker tracker;
+    Stabilize(tracker, 4);
+    tracker.Invalidate();
+    CHECK(!tracker.IsAnchoredToEndScene());
+
+    Frame frame;
+    CHECK_EQ(frame.Run(tracker), OverlayDrawPoint::Present);
+    CHECK_EQ(frame.checks, 0u);
+}
+
+TEST(FramesWithoutEndSceneNeverAnchor)
+{
+    FrameBoundaryTracker tracker;
+    for (uint32_t i = 0; i < 2 * FrameBoundaryTracker::kStableFrames; ++i)
+        CHECK_EQ(Frame{ 0 }.Run(tracker), OverlayDrawPoint::Present);
+    CHECK(!tracker.IsAnchoredToEndScene());
+}
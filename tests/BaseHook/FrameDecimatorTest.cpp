@@ -0,0 +1,128 @@
+#include "Test.h"
+#include "util/FrameDecimator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using BaseHook::FrameDecimator;
+
+namespace
+{
+    // Game frames at gameHz for `seconds`, with input arriving at the given times. Every third frame
+    // comes in early and every other third late by jitterUs. Returns the frames that rebuilt.
+    struct Run
+    {
+        std::vector<int64_t> rebuilds;
+        int64_t worstInputLatencyUs = 0;
+    };
+
+    Run Simulate(FrameDecimator& decimator, double gameHz, double seconds, const std::vector<int64_t>& inputs = {}, int64_t jitterUs = 0)
+    {
+        Run run;
+        size_t nextInput = 0;
+        bool pending = false;
+        int64_t pendingSince = 0;
+        const int frames = (int)(gameHz * seconds);
+        for (int i = 0; i < frames; ++i)
+        {
+            const int64_t now = (int64_t)(i * 1e6 / gameHz) + (i % 3 == 1 ? jitterUs : i % 3 == 2 ? -jitterUs : 0);
+            for (; nextInput < inputs.size() && inputs[nextInput] <= now; ++nextInput)
+            {
+                if (!pending)
+                    pendingSince = inputs[nextInput];
+                pending = true;
+            }
+            if (decimator.ShouldRebuild(now, pending))
+            {
+                run.rebuilds.push_back(now);
+                if (pending)
+                    run.worstInputLatencyUs = std::max(run.worstInputLatencyUs, now - pendingSince);
+                pending = false;
+            }
+        }
+        return run;
+    }
+}
+
+TEST(ZeroRateRebuildsEveryFrame)
+{
+    FrameDecimator decimator;
+    CHECK_EQ(Simulate(decimator, 144, 2).rebuilds.size(), (size_t)288);
+    CHECK_EQ(decimator.GetReusedFrames(), 0ull);
+
+    decimator.SetRateHz(-5);
+    CHECK_EQ(decimator.GetRateHz(), 0);
+}
+
+// A grid rather than "interval after the last rebuild": 60 Hz on a 144 Hz game averages 60 Hz,
+// not every third frame (48 Hz), and pacing jitter doesn't push a rebuild a whole frame out.
+TEST(UiRateAveragesOnAFasterGame)
+{
+    for (double gameHz : { 144.0, 165.0, 240.0, 300.0 })
+    {
+        FrameDecimator decimator;
+        decimator.SetRateHz(60);
+        const Run run = Simulate(decimator, gameHz, 10, {}, 150);
+
+        const double uiHz = run.rebuilds.size() / 10.0;
+        CHECK(std::fabs(uiHz - 60.0) < 1.0);
+        CHECK_EQ(decimator.GetRebuiltFrames() + decimator.GetReusedFrames(), (uint64_t)(gameHz * 10));
+
+        int64_t widestGap = 0;
+        for (size_t i = 1; i < run.rebuilds.size(); ++i)
+            widestGap = std::max(widestGap, run.rebuilds[i] - run.rebuilds[i - 1]);
+        CHECK(widestGap <= 16667 + (int64_t)(1e6 / gameHz) + 300);
+    }
+}
+
+TEST(SlowerGameRebuildsEveryFrame)
+{
+    FrameDecimator decimator;
+    decimator.SetRateHz(60);
+    CHECK_EQ(Simulate(decimator, 50, 2).rebuilds.size(), (size_t)100);
+}
+
+TEST(InputRebuildsAtOnceThenSettles)
+{
+    FrameDecimator decimator;
+    decimator.SetRateHz(30);
+    std::vector<int64_t> inputs;
+    for (int i = 0; i < 20; ++i)
+        inputs.push_back(50000 + i * 97000);
+    const Run run = Simulate(decimator, 240, 2, inputs);
+
+    // Seen on the first frame after it arrives.
+    CHECK(run.worstInputLatencyUs <= (int64_t)(1e6 / 240) + 1);
+    // That frame plus kSettleFrames more, before the 30 Hz grid takes over again.
+    const int64_t frameUs = (int64_t)(1e6 / 240);
+    const auto settled = std::count_if(run.rebuilds.begin(), run.rebuilds.end(), [&](int64_t t) {
+        return t >= 50000 && t <= 50000 + (FrameDecimator::kSettleFrames + 1) * frameUs + 10;
+    });
+    CHECK_EQ(settled, (std::ptrdiff_t)(FrameDecimator::kSettleFrames + 1));
+
+    // Continuous motion keeps every frame live.
+    FrameDecimator dragging;
+    dragging.SetRateHz(60);
+    inputs.clear();
+    for (int64_t t = 0; t < 1000000; t += 1000)
+        inputs.push_back(t);
+    CHECK_EQ(Simulate(dragging, 144, 1, inputs).rebuilds.size(), (size_t)144);
+}
+
+TEST(InvalidateAndHitchesRestartTheGrid)
+{
+    FrameDecimator decimator;
+    decimator.SetRateHz(10);
+    CHECK(decimator.ShouldRebuild(0, false));
+    CHECK(!decimator.ShouldRebuild(1000, false));
+    decimator.Invalidate();
+    CHECK(decimator.ShouldRebuild(2000, false));
+    CHECK(!decimator.ShouldRebuild(3000, false));
+
+    // A second-long pause: one rebuild, then back to 100 ms steps from there rather than a burst of
+    // catch-up rebuilds.
+    CHECK(decimator.ShouldRebuild(1000000, false));
+    CHECK(!decimator.ShouldRebuild(1010000, false));
+    CHECK(!decimator.ShouldRebuild(1050000, false));
+    CHECK(decimator.ShouldRebuild(1100000, false));
+}
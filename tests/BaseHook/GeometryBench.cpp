@@ -0,0 +1,144 @@
+#include "Test.h"
+#include "Bench.h"
+#include "util/GeometryTransform.h"
+#include "util/SeqLock.h"
+#include <atomic>
+#include <thread>
+
+using namespace BaseHook;
+
+// The cursor hooks' physical -> virtual conversion, per call and through the cached snapshot.
+//
+// The per-call path used to ask user32 for the client rect and origin on every call
+// (GetClientRect + ClientToScreen). Those can't run here, so they are stand-ins that return stored
+// values: this measures everything except the two user32 round trips the snapshot also removes,
+// which makes the per-call numbers a lower bound.
+namespace
+{
+    struct Rect
+    {
+        int left, top, right, bottom;
+    };
+
+    // WindowedMode::GeometrySnapshot with the Win32 types replaced by same-sized ones.
+    struct Snapshot
+    {
+        uint32_t hWnd = 0;
+        Rect windowRect{};
+        Rect clientRect{};
+        Rect monitorRect{};
+        Geometry::ClientTransform transform;
+        uint32_t generation = 0;
+        bool valid = false;
+    };
+
+    volatile int g_clientW = 2560, g_clientH = 1440, g_originX = 640, g_originY = 360;
+    const int kVirtualW = 1920, kVirtualH = 1080;
+    const uint32_t kWindow = 0x10a2c;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE __declspec(noinline)
+#endif
+
+    BENCH_NOINLINE bool GetClientRectStandIn(Rect& rect)
+    {
+        rect = { 0, 0, g_clientW, g_clientH };
+        return true;
+    }
+
+    BENCH_NOINLINE void ClientToScreenStandIn(int& x, int& y)
+    {
+        x += g_originX;
+        y += g_originY;
+    }
+
+    Snapshot Build(uint32_t generation)
+    {
+        Snapshot s;
+        s.hWnd = kWindow;
+        GetClientRectStandIn(s.clientRect);
+        int x = 0, y = 0;
+        ClientToScreenStandIn(x, y);
+        s.transform = Geometry::MakeClientTransform(s.clientRect.right, s.clientRect.bottom, x, y, kVirtualW, kVirtualH);
+        s.generation = generation;
+        s.valid = s.transform.IsValid();
+        return s;
+    }
+
+    // The old ConvertPhysicalToVirtual.
+    bool PerCall(int& x, int& y)
+    {
+        Rect rect;
+        if (!GetClientRectStandIn(rect))
+            return false;
+        int originX = 0, originY = 0;
+        ClientToScreenStandIn(originX, originY);
+        const Geometry::ClientTransform t = Geometry::MakeClientTransform(rect.right - rect.left, rect.bottom - rect.top, originX, originY, kVirtualW, kVirtualH);
+        if (!t.IsValid())
+            return false;
+        Geometry::PhysicalScreenToVirtual(t, x, y);
+        return true;
+    }
+
+    std::atomic<uint32_t> g_invalidations{ 0 };
+    SeqLock<Snapshot> g_geometry(Build(0));
+
+    // WindowedMode::GetGeometry's fast path, then the transform.
+    bool Cached(int& x, int& y)
+    {
+        const uint32_t generation = g_invalidations.load(std::memory_order_acquire);
+        Snapshot geo;
+        for (int attempt = 0; attempt < 4; ++attempt)
+        {
+            if (!g_geometry.TryLoad(geo))
+                continue;
+            if (geo.generation == generation && geo.hWnd == kWindow && geo.transform.virtualW == kVirtualW && geo.transform.virtualH == kVirtualH)
+            {
+                if (!geo.valid)
+                    return false;
+                Geometry::PhysicalScreenToVirtual(geo.transform, x, y);
+                return true;
+            }
+            break;
+        }
+        return PerCall(x, y);
+    }
+}
+
+TEST(PhysicalToVirtual)
+{
+    int x = 1000, y = 500, cachedX = 1000, cachedY = 500;
+    REQUIRE(PerCall(x, y) && Cached(cachedX, cachedY));
+    CHECK_EQ(cachedX, x);
+    CHECK_EQ(cachedY, y);
+
+    int px = 0;
+
+    Bench::Measure("per call (user32 stand-ins)", [&] {
+        int bx = ++px & 4095, by = 500;
+        PerCall(bx, by);
+        Bench::DoNotOptimize(bx + by);
+    });
+    Bench::Measure("cached snapshot", [&] {
+        int bx = ++px & 4095, by = 500;
+        Cached(bx, by);
+        Bench::DoNotOptimize(bx + by);
+    });
+
+    // Worst case: another thread republishes the snapshot nonstop, as if WM_MOVE never stopped.
+    std::atomic<bool> stop{ false };
+    std::thread writer([&] {
+        uint32_t generation = 0;
+        while (!stop.load(std::memory_order_relaxed))
+            g_geometry.Store(Build(generation));
+    });
+    Bench::Measure("cached snapshot, writer storing constantly", [&] {
+        int bx = ++px & 4095, by = 500;
+        Cached(bx, by);
+        Bench::DoNotOptimize(bx + by);
+    });
+    stop = true;
+    writer.join();
+}
@@ -0,0 +1,115 @@
+#include "Test.h"
+#include "util/GeometryTransform.h"
+#include <cmath>
+#include <cstdlib>
+
+using namespace BaseHook::Geometry;
+
+namespace
+{
+    struct Sizes
+    {
+        int clientW, clientH, virtualW, virtualH;
+    };
+    constexpr Sizes kSizes[] = {
+        { 1280, 720, 1920, 1080 },
+        { 2560, 1440, 1920, 1080 },
+        { 1366, 768, 1280, 720 },
+        { 3840, 2160, 1024, 768 },
+    };
+    constexpr int kOriginX = 137;
+    constexpr int kOriginY = -42;
+}
+
+TEST(InvalidSizesGiveAnInvalidTransform)
+{
+    CHECK(!MakeClientTransform(0, 720, 0, 0, 1920, 1080).IsValid());
+    CHECK(!MakeClientTransform(1280, 720, 0, 0, 1920, 0).IsValid());
+    CHECK(!ClientTransform{}.IsValid());
+    CHECK(MakeClientTransform(1280, 720, 0, 0, 1920, 1080).IsValid());
+}
+
+TEST(EqualSizesOnlyShiftByTheOrigin)
+{
+    const ClientTransform t = MakeClientTransform(1920, 1080, kOriginX, kOriginY, 1920, 1080);
+    int x = 500, y = 300;
+    PhysicalScreenToVirtual(t, x, y);
+    CHECK_EQ(x, 500 - kOriginX);
+    CHECK_EQ(y, 300 - kOriginY);
+    VirtualToPhysicalScreen(t, x, y);
+    CHECK_EQ(x, 500);
+    CHECK_EQ(y, 300);
+}
+
+// The cached ratios must give exactly what the old per-call expressions did, rounding included.
+TEST(CachedRatiosMatchThePerCallMath)
+{
+    int mismatches = 0;
+    for (const Sizes& s : kSizes)
+    {
+        const ClientTransform t = MakeClientTransform(s.clientW, s.clientH, kOriginX, kOriginY, s.virtualW, s.virtualH);
+        for (int x = -50; x < 4000; x += 7)
+        {
+            for (int y = -50; y < 2200; y += 13)
+            {
+                int vx = x, vy = y;
+                PhysicalScreenToVirtual(t, vx, vy);
+                if (vx != std::lroundf((float)(x - kOriginX) * ((float)s.virtualW / (float)s.clientW)) ||
+                    vy != std::lroundf((float)(y - kOriginY) * ((float)s.virtualH / (float)s.clientH)))
+                    mismatches++;
+
+                int px = x, py = y;
+                VirtualToPhysicalScreen(t, px, py);
+                if (px != std::lroundf((float)x * ((float)s.clientW / (float)s.virtualW)) + kOriginX ||
+                    py != std::lroundf((float)y * ((float)s.clientH / (float)s.virtualH)) + kOriginY)
+                    mismatches++;
+
+                int w = x, h = y;
+                VirtualSizeToPhysical(t, w, h);
+                if (w != std::lroundf((float)x * (float)s.clientW / (float)s.virtualW) ||
+                    h != std::lroundf((float)y * (float)s.clientH / (float)s.virtualH))
+                    mismatches++;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+TEST(RoundTripStaysWithinAVirtualPixel)
+{
+    for (const Sizes& s : kSizes)
+    {
+        const ClientTransform t = MakeClientTransform(s.clientW, s.clientH, kOriginX, kOriginY, s.virtualW, s.virtualH);
+        for (int x = 0; x < s.virtualW; x += 11)
+        {
+            int px = x, py = x % s.virtualH;
+            VirtualToPhysicalScreen(t, px, py);
+            PhysicalScreenToVirtual(t, px, py);
+            CHECK(std::abs(px - x) <= 1);
+            CHECK(std::abs(py - x % s.virtualH) <= 1);
+        }
+    }
+}
+
+TEST(ClientCornersMapToVirtualCorners)
+{
+    for (const Sizes& s : kSizes)
+    {
+        const ClientTransform t = MakeClientTransform(s.clientW, s.clientH, kOriginX, kOriginY, s.virtualW, s.virtualH);
+        int x = kOriginX, y = kOriginY;
+        PhysicalScreenToVirtual(t, x, y);
+        CHECK_EQ(x, 0);
+        CHECK_EQ(y, 0);
+
+        x = s.clientW;
+        y = s.clientH;
+        PhysicalClientToVirtual(t, x, y);
+        CHECK_EQ(x, s.virtualW);
+        CHECK_EQ(y, s.virtualH);
+
+        int w = s.virtualW, h = s.virtualH;
+        VirtualSizeToPhysical(t, w, h);
+        CHECK_EQ(w, s.clientW);
+        CHECK_EQ(h, s.clientH);
+    }
+}
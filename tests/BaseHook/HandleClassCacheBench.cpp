@@ -0,0 +1,105 @@
+#include "Test.h"
+#include "Bench.h"
+#include "util/HandleClassCache.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// IsImGuiPlatformWindow's lookup cost through the cache, against classifying the handle on every
+// call. The per-call path was GetClassNameA + strstr; GetClassNameA can't run here, so its stand-in
+// copies the class name from a table. That leaves out the user32 round trip, which makes the
+// per-call numbers a lower bound.
+namespace
+{
+    using Cache = HandleClassCache<256>;
+
+    // A game session's worth of handles: a few ImGui platform windows among the game window, IME
+    // and tooltip windows and whatever else the hooks get asked about. Spaced like real HWNDs.
+    constexpr int kPlatformWindows = 6;
+    constexpr int kOtherWindows = 40;
+
+    struct Window
+    {
+        uint32_t handle;
+        const char* className;
+    };
+
+    std::vector<Window> MakeWindows()
+    {
+        static const char* kOtherClasses[] = { "AssassinsCreedIIWindow", "IME", "MSCTFIME UI", "tooltips_class32", "#32770" };
+        std::vector<Window> windows;
+        uint32_t handle = 0x000103f2;
+        for (int i = 0; i < kPlatformWindows + kOtherWindows; ++i)
+        {
+            handle += 0x1a6 + (i * 0x22);
+            windows.push_back({ handle, i < kPlatformWindows ? "ImGui Platform" : kOtherClasses[i % 5] });
+        }
+        return windows;
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE __declspec(noinline)
+#endif
+
+    BENCH_NOINLINE int GetClassNameStandIn(const Window& window, char* out, int size)
+    {
+        const int length = (int)strlen(window.className);
+        const int copied = length < size - 1 ? length : size - 1;
+        memcpy(out, window.className, copied);
+        out[copied] = '\0';
+        return copied;
+    }
+
+    bool ClassifyPerCall(const Window& window)
+    {
+        char className[256];
+        if (GetClassNameStandIn(window, className, sizeof(className)))
+            return strstr(className, "ImGui Platform") != nullptr;
+        return false;
+    }
+}
+
+TEST(Lookup)
+{
+    const std::vector<Window> windows = MakeWindows();
+    Cache cache;
+    for (const Window& window : windows)
+        cache.Set(window.handle, ClassifyPerCall(window) ? Cache::Class::Match : Cache::Class::Other);
+    for (const Window& window : windows)
+        CHECK_EQ(cache.Find(window.handle) == Cache::Class::Match, ClassifyPerCall(window));
+
+    size_t next = 0;
+    Bench::Measure("per call (GetClassNameA stand-in + strstr)", [&] {
+        Bench::DoNotOptimize(ClassifyPerCall(windows[next++ % windows.size()]));
+    });
+    Bench::Measure("cache hit, mixed handles", [&] {
+        Bench::DoNotOptimize(cache.Find(windows[next++ % windows.size()].handle));
+    });
+    Bench::Measure("cache hit, one handle over and over", [&] {
+        Bench::DoNotOptimize(cache.Find(windows[kPlatformWindows].handle));
+    });
+    uint32_t missing = 0x7f000000;
+    Bench::Measure("cache miss (handle seen for the first time)", [&] {
+        Bench::DoNotOptimize(cache.Find(missing += 0x1a6));
+    });
+
+    // Platform windows come and go (viewports dragged out and back) while the hooks read.
+    std::atomic<bool> stop{ false };
+    std::thread writer([&] {
+        uint32_t handle = 0x7e000000;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            handle += 0x1a6;
+            cache.Set(handle, Cache::Class::Match);
+            cache.Forget(handle);
+        }
+    });
+    Bench::Measure("cache hit, writer churning", [&] {
+        Bench::DoNotOptimize(cache.Find(windows[next++ % windows.size()].handle));
+    });
+    stop = true;
+    writer.join();
+}
@@ -0,0 +1,121 @@
+#include "Test.h"
+#include "util/HandleClassCache.h"
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace
+{
+    using Cache = HandleClassCache<256>;
+    using Class = Cache::Class;
+
+    // Looks like HWNDs: small, 4-aligned, only the low bits differ.
+    constexpr uint32_t MatchKey(uint32_t i) { return 0x10000 + i * 4; }
+}
+
+TEST(FindReturnsWhatWasSet)
+{
+    Cache cache;
+    for (uint32_t i = 1; i <= 10; ++i)
+        cache.Set(MatchKey(i), Class::Match);
+    cache.Set(0x999, Class::Other);
+
+    for (uint32_t i = 1; i <= 10; ++i)
+        CHECK_EQ(cache.Find(MatchKey(i)), Class::Match);
+    CHECK_EQ(cache.Find(0x999), Class::Other);
+    CHECK_EQ(cache.Find(0x998), Class::Unknown);
+    CHECK_EQ(cache.GetUsedSlots(), (size_t)11);
+
+    cache.Set(0x999, Class::Match);
+    CHECK_EQ(cache.Find(0x999), Class::Match);
+    CHECK_EQ(cache.GetUsedSlots(), (size_t)11);
+}
+
+TEST(ZeroIsNeverCached)
+{
+    Cache cache;
+    cache.Set(0, Class::Match);
+    CHECK_EQ(cache.Find(0), Class::Unknown);
+    CHECK_EQ(cache.GetUsedSlots(), (size_t)0);
+}
+
+TEST(ForgetKeepsProbeChainsIntact)
+{
+    // Fill a small table densely enough that keys share probe chains.
+    using SmallCache = HandleClassCache<8>;
+    SmallCache cache;
+    for (uint32_t i = 1; i <= 6; ++i)
+        cache.Set(MatchKey(i), SmallCache::Class::Match);
+
+    cache.Forget(MatchKey(1));
+    CHECK_EQ(cache.Find(MatchKey(1)), SmallCache::Class::Unknown);
+    for (uint32_t i = 2; i <= 6; ++i)
+        CHECK_EQ(cache.Find(MatchKey(i)), SmallCache::Class::Match);
+
+    cache.Clear();
+    CHECK_EQ(cache.Find(MatchKey(2)), SmallCache::Class::Unknown);
+    CHECK_EQ(cache.GetUsedSlots(), (size_t)0);
+}
+
+TEST(ChurnPurgesNegativesButKeepsMatches)
+{
+    Cache cache;
+    for (uint32_t i = 1; i <= 10; ++i)
+        cache.Set(MatchKey(i), Class::Match);
+
+    std::mt19937 rng(1);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const uint32_t key = ((rng() | 1) & 0xFFFFFF) | 0x1000000; // odd, never a MatchKey
+        if (cache.Find(key) == Class::Unknown)
+            cache.Set(key, Class::Other);
+        CHECK_EQ(cache.Find(key), Class::Other);
+    }
+
+    CHECK(cache.GetPurgeCount() > 0);
+    CHECK(cache.GetUsedSlots() <= 256 * 3 / 4);
+    for (uint32_t i = 1; i <= 10; ++i)
+        CHECK_EQ(cache.Find(MatchKey(i)), Class::Match);
+}
+
+// Lock-free readers against a writer that keeps forcing purges. A reader may briefly miss an entry
+// mid-rebuild (Unknown) but must never see the wrong class.
+TEST(ConcurrentReadersNeverSeeTheWrongClass)
+{
+    static Cache cache;
+    for (uint32_t i = 1; i <= 10; ++i)
+        cache.Set(MatchKey(i), Class::Match);
+
+    std::atomic<bool> stop{ false };
+    std::atomic<int> wrong{ 0 };
+    std::atomic<int> hits{ 0 };
+    std::thread readers[2];
+    for (auto& reader : readers)
+    {
+        reader = std::thread([&] {
+            while (!stop.load())
+            {
+                for (uint32_t i = 1; i <= 10; ++i)
+                {
+                    const Class cls = cache.Find(MatchKey(i));
+                    if (cls == Class::Other)
+                        wrong++;
+                    else if (cls == Class::Match)
+                        hits++;
+                }
+            }
+        });
+    }
+
+    std::mt19937 rng(2);
+    for (int i = 0; i < 20000 || hits.load() == 0; ++i)
+        cache.Set(((rng() | 1) & 0xFFFFFF) | 0x1000000, Class::Other);
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK_EQ(wrong.load(), 0);
+    CHECK(cache.GetPurgeCount() > 0);
+    for (uint32_t i = 1; i <= 10; ++i)
+        CHECK_EQ(cache.Find(MatchKey(i)), Class::Match);
+}
@@ -0,0 +1,150 @@
+#include "Test.h"
+#include "util/InputEventRing.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using BaseHook::InputEvent;
+using BaseHook::InputEventRing;
+
+namespace
+{
+    InputEvent Move(int x, int y, int64_t timeUs, uint8_t buttons = 0)
+    {
+        InputEvent event;
+        event.type = InputEvent::Type::Move;
+        event.buttons = buttons;
+        event.x = x;
+        event.y = y;
+        event.timeUs = timeUs;
+        return event;
+    }
+
+    InputEvent Button(uint8_t code, bool down, uint8_t buttons, int64_t timeUs)
+    {
+        InputEvent event;
+        event.type = InputEvent::Type::Button;
+        event.code = code;
+        event.down = down;
+        event.buttons = buttons;
+        event.timeUs = timeUs;
+        return event;
+    }
+}
+
+TEST(FullRingDropsNewEventsAndKeepsOrder)
+{
+    InputEventRing<4> ring;
+    CHECK(ring.IsEmpty());
+    for (int i = 0; i < 6; ++i)
+        CHECK_EQ(ring.Push(Move(0, 0, i)), i < 4);
+    CHECK_EQ(ring.GetPushedCount(), 4ull);
+    CHECK_EQ(ring.GetDroppedCount(), 2ull);
+
+    InputEvent event;
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(ring.Pop(event));
+        CHECK_EQ(event.timeUs, (int64_t)i);
+    }
+    CHECK(!ring.Pop(event));
+    CHECK(ring.IsEmpty());
+}
+
+TEST(DrainVisitsOldestFirstAcrossTheWrap)
+{
+    InputEventRing<4> ring;
+    InputEvent event;
+    // Move the indices past the end of the storage first.
+    for (int i = 0; i < 3; ++i)
+    {
+        ring.Push(Move(0, 0, -1));
+        ring.Pop(event);
+    }
+    for (int i = 0; i < 4; ++i)
+        ring.Push(Move(i, 0, i));
+
+    std::vector<int64_t> seen;
+    CHECK_EQ(ring.Drain([&](const InputEvent& e) { seen.push_back(e.timeUs); }), (size_t)4);
+    CHECK(seen == std::vector<int64_t>({ 0, 1, 2, 3 }));
+    CHECK(ring.IsEmpty());
+    CHECK_EQ(ring.Drain([](const InputEvent&) {}), (size_t)0);
+    CHECK(ring.Push(Move(0, 0, 4)));
+}
+
+TEST(CoalesceMergesOnlyAdjacentMovesWithTheSameButtons)
+{
+    InputEvent events[] = {
+        Move(1, 1, 0), Move(2, -1, 1),
+        Button(0, true, 1, 2),
+        Move(3, 0, 3, 1), Move(4, 0, 4, 1),
+        Move(5, 0, 5),
+    };
+    const size_t count = BaseHook::CoalesceMoves(events, 6);
+    REQUIRE(count == 4);
+    CHECK_EQ(events[0].x, 3);
+    CHECK_EQ(events[0].y, 0);
+    CHECK_EQ(events[0].timeUs, (int64_t)1);
+    CHECK(events[1].type == InputEvent::Type::Button);
+    CHECK_EQ(events[2].x, 7);
+    CHECK_EQ(events[2].buttons, (uint8_t)1);
+    CHECK_EQ(events[2].timeUs, (int64_t)4);
+    CHECK_EQ(events[3].x, 5);
+    CHECK_EQ(events[3].buttons, (uint8_t)0);
+
+    InputEvent last = Button(0, false, 0, 0);
+    CHECK(!BaseHook::CoalesceMove(last, Move(1, 1, 1)));
+}
+
+// One producer pushing flat out against one consumer alternating between Pop and Drain. Everything
+// the producer managed to queue arrives once, in order and intact; the rest is counted as dropped.
+// Under TSan this checks the acquire/release pairing on the two indices.
+TEST(ConcurrentProducerAndConsumer)
+{
+    constexpr int kEvents = 200000;
+    InputEventRing<256> ring;
+    std::atomic<bool> done{ false };
+
+    std::thread producer([&] {
+        for (int i = 0; i < kEvents; ++i)
+        {
+            InputEvent event = Move(i, ~i, i, (uint8_t)i);
+            event.code = (uint8_t)(i * 7);
+            ring.Push(event);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    int64_t lastTime = -1;
+    uint64_t received = 0;
+    int bad = 0;
+    auto consume = [&](const InputEvent& e) {
+        if (e.timeUs <= lastTime || e.x != (int32_t)e.timeUs || e.y != ~(int32_t)e.timeUs ||
+            e.buttons != (uint8_t)e.timeUs || e.code != (uint8_t)(e.timeUs * 7))
+            bad++;
+        lastTime = e.timeUs;
+        received++;
+    };
+
+    for (int round = 0;; ++round)
+    {
+        const bool finished = done.load(std::memory_order_acquire);
+        if (round & 1)
+        {
+            ring.Drain(consume);
+        }
+        else
+        {
+            InputEvent event;
+            for (int i = 0; i < 64 && ring.Pop(event); ++i)
+                consume(event);
+        }
+        if (finished && ring.IsEmpty())
+            break;
+    }
+    producer.join();
+
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(received, ring.GetPushedCount());
+    CHECK_EQ(received + ring.GetDroppedCount(), (uint64_t)kEvents);
+}
@@ -0,0 +1,164 @@
+#include "Test.h"
+#include "core/BaseHook.h"
+#include "util/OverlayFrameGate.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    bool g_bufferedMouseInput = false;
+
+    class TestSettings : public BaseHook::Settings
+    {
+    public:
+        BaseHook::OverlayActivity GetOverlayActivity() override { return activity; }
+        BaseHook::OverlayActivity activity = BaseHook::OverlayActivity::Active;
+    };
+
+    // Each test gets a fresh context; the gate looks at its input queue.
+    struct ImGuiFixture
+    {
+        ImGuiFixture() { ImGui::CreateContext(); }
+        ~ImGuiFixture() { ImGui::DestroyContext(); }
+    };
+}
+
+namespace BaseHook::Hooks
+{
+    bool HasBufferedMouseInput() { return g_bufferedMouseInput; }
+}
+
+using BaseHook::OverlayActivity;
+using BaseHook::OverlayFrameMode;
+
+TEST(ActiveBuildsEveryFrame)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    TestSettings settings;
+    for (int i = 0; i < 5; ++i)
+        CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.GetSkippedFrames(), 0ull);
+}
+
+TEST(IdleBuildsOneQuietFrameThenSkips)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    TestSettings settings;
+    settings.activity = OverlayActivity::Idle;
+
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Skip);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Skip);
+    CHECK_EQ(gate.GetSkippedFrames(), 2ull);
+
+    settings.activity = OverlayActivity::Active;
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+}
+
+TEST(StaticReplaysAndRefreshesPeriodically)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    TestSettings settings;
+    settings.activity = OverlayActivity::Static;
+
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Replay);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Replay);
+}
+
+TEST(InvalidateAndDisableForceFullFrames)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    TestSettings settings;
+    settings.activity = OverlayActivity::Idle;
+
+    gate.Begin(&settings);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Skip);
+    gate.Invalidate();
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Skip);
+
+    gate.SetEnabled(false);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(nullptr), OverlayFrameMode::Full);
+}
+
+TEST(UiRateReusesFramesUntilInputArrives)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    gate.SetUiRateHz(10);
+    TestSettings settings;
+
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Reuse);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Reuse);
+
+    // Queued ImGui events count as input...
+    ImGui::GetIO().AddMousePosEvent(10.0f, 20.0f);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    ImGui::GetIO().ClearEventsQueue();
+    // ...followed by the settle frames.
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Reuse);
+
+    // ...and so do DirectInput clicks not applied yet.
+    g_bufferedMouseInput = true;
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    g_bufferedMouseInput = false;
+
+    CHECK_EQ(gate.GetDecimator().GetReusedFrames(), 3ull);
+}
+
+TEST(GoingQuietRestartsTheUiRateGrid)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    gate.SetUiRateHz(10);
+    TestSettings settings;
+
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Reuse);
+    settings.activity = OverlayActivity::Idle;
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+    settings.activity = OverlayActivity::Active;
+    CHECK_EQ(gate.Begin(&settings), OverlayFrameMode::Full);
+}
+
+TEST(DiscardPendingInputKeepsOnlyTheLatestMousePosition)
+{
+    ImGuiFixture imgui;
+    BaseHook::OverlayFrameGate gate;
+    ImGuiIO& io = ImGui::GetIO();
+    ImGuiContext& g = *ImGui::GetCurrentContext();
+
+    io.AddMousePosEvent(1.0f, 2.0f);
+    io.AddMouseButtonEvent(0, true);
+    io.AddKeyEvent(ImGuiKey_A, true);
+    io.AddMousePosEvent(30.0f, 40.0f);
+    gate.DiscardPendingInput();
+
+    REQUIRE(g.InputEventsQueue.Size >= 1);
+    const ImGuiInputEvent& last = g.InputEventsQueue.back();
+    CHECK_EQ(last.Type, ImGuiInputEventType_MousePos);
+    CHECK_EQ(last.MousePos.PosX, 30.0f);
+    CHECK_EQ(last.MousePos.PosY, 40.0f);
+    for (const ImGuiInputEvent& e : g.InputEventsQueue)
+        CHECK(e.Type != ImGuiInputEventType_Key && e.Type != ImGuiInputEventType_MouseButton);
+
+    // Later calls in the same idle stretch keep the position without releasing anything again.
+    const int queued = g.InputEventsQueue.Size;
+    gate.DiscardPendingInput();
+    CHECK_EQ(g.InputEventsQueue.Size, queued);
+}
@@ -0,0 +1,392 @@
+#include "Test.h"
+#include "util/InputRecording.h"
+#include "util/LatencyHistogram.h"
+#include "util/SonyReportDecoder.h"
+#include "util/VirtualPad.h"
+#include "fixtures/SonyReports.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace BaseHook;
+namespace Recording = BaseHook::InputRecording;
+
+// The Sony HID reader -> VirtualPadMerger -> XInputGetState path of DirectInput8.cpp, with the
+// recording and the latency histogram around it.
+namespace
+{
+    // dualsense_usb_200ms.input.bin: a DualSense on USB at 1000 Hz, read 1, 2, 3, 4, 1, ... reports at
+    // a time (80 reads, 200 reports). Report n has the left stick at 0x80 + n (clamped to 0xFF),
+    // Cross held for n in [50, 120), 100 deg/s of yaw and a sensor clock 1 ms apart. Synthesized
+    // to that script, since the values have to be known; written in the Writer's format.
+    const std::filesystem::path kFixture = std::filesystem::path(__FILE__).parent_path() / "fixtures" / "dualsense_usb_200ms.input.bin";
+    constexpr size_t kFixtureRecords = 80;
+    constexpr size_t kFixtureReports = 200;
+
+    constexpr uint16_t kA = 0x1000, kY = 0x8000;
+
+    // Same sources, priorities and stale timeout as DirectInput8.cpp.
+    constexpr int kSonyHID = 1, kHookedDevice = 2;
+    constexpr int kSonyPriority = 3, kHookedPriority = 2;
+    constexpr uint64_t kStaleMs = 500;
+
+    std::vector<Recording::Record> LoadFixture()
+    {
+        std::vector<Recording::Record> records;
+        Recording::Reader reader;
+        if (!reader.Open(kFixture))
+            return records;
+        Recording::Record record;
+        while (reader.Next(record))
+            records.push_back(record);
+        return records;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+
+    // What the reader loop does with one read: decode every report, submit the latest.
+    size_t DecodeRead(const Recording::Record& record, std::vector<Sony::DecodedReport>& decoded)
+    {
+        const size_t size = record.data.size();
+        const size_t stride = size >= record.reportSize ? record.reportSize : size;
+        decoded.resize(size / stride);
+        return Sony::DecodeReports(static_cast<Sony::ControllerType>(record.controllerType), record.data.data(), stride, size / stride, decoded.data());
+    }
+
+    int64_t SteadyNowUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+TEST(FixtureHoldsTheScriptedSession)
+{
+    const std::vector<Recording::Record> records = LoadFixture();
+    REQUIRE(records.size() == kFixtureRecords);
+
+    size_t reports = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const Recording::Record& r = records[i];
+        CHECK_EQ(r.controllerType, (uint8_t)Sony::ControllerType::DualSense);
+        CHECK_EQ(r.reportSize, (uint16_t)64);
+        CHECK_EQ(r.data.size() % 64, (size_t)0);
+        CHECK_EQ(r.data.size() / 64, i % 4 + 1);
+        if (i > 0)
+            CHECK(r.timeUs > records[i - 1].timeUs);
+        reports += r.data.size() / 64;
+    }
+    CHECK_EQ(reports, kFixtureReports);
+    CHECK_EQ(records.front().timeUs, (int64_t)0);
+    CHECK(records.back().timeUs >= 199000 && records.back().timeUs < 200000);
+}
+
+// Replays every read through the decoder and the merger, as the reader loop would, with a hooked
+// DirectInput device submitting too; the merged pad must follow the DualSense report by report.
+TEST(ReplayedSessionDrivesTheMergedPad)
+{
+    const std::vector<Recording::Record> records = LoadFixture();
+    REQUIRE(records.size() == kFixtureRecords);
+
+    VirtualPadMerger merger(kStaleMs);
+    const int sonyDevice = 0, hookedDevice = 0;
+    std::vector<Sony::DecodedReport> decoded;
+    PadState hooked;
+    hooked.buttons = kY;
+
+    size_t reportIndex = 0;
+    uint32_t previousPacket = 0;
+    int16_t previousLX = -32768;
+    uint32_t previousSensorTime = 0;
+    double yawDeg = 0.0;
+    int crossReads = 0;
+    int hookedAccepted = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const Recording::Record& record = records[i];
+        const size_t count = DecodeRead(record, decoded);
+        REQUIRE(count == record.data.size() / 64);
+
+        for (size_t n = 0; n < count; ++n)
+        {
+            const Sony::DecodedReport& report = decoded[n];
+            REQUIRE(report.hasMotion);
+            if (reportIndex + n > 0)
+                yawDeg += report.gyro[2] * Sony::SensorTimestampDeltaUs(Sony::ControllerType::DualSense, previousSensorTime, report.sensorTimestamp) / 1e6;
+            previousSensorTime = report.sensorTimestamp;
+        }
+        reportIndex += count;
+        const size_t last = reportIndex - 1;
+
+        const uint64_t nowMs = static_cast<uint64_t>(record.timeUs / 1000);
+        bool swapped = false;
+        CHECK(merger.Submit(kSonyHID, kSonyPriority, &sonyDevice, Sony::ToPadState(decoded[count - 1]), record.timeUs, nowMs, swapped));
+        CHECK_EQ(swapped, i == 0);
+
+        // Lower priority: never gets in while the DualSense keeps reporting.
+        if (merger.Submit(kHookedDevice, kHookedPriority, &hookedDevice, hooked, record.timeUs, nowMs, swapped))
+            hookedAccepted++;
+
+        PadState merged;
+        REQUIRE(merger.Peek(nowMs, merged));
+        if (previousPacket != 0)
+            CHECK_EQ(merged.packetNumber, previousPacket + 1);
+        previousPacket = merged.packetNumber;
+
+        const bool cross = last >= 50 && last < 120;
+        CHECK_EQ((merged.buttons & kA) != 0, cross);
+        CHECK_EQ(merged.buttons & kY, 0);
+        crossReads += cross ? 1 : 0;
+
+        CHECK(merged.thumbLX >= previousLX);
+        previousLX = merged.thumbLX;
+        CHECK_EQ(merged.leftTrigger, 0);
+        CHECK_EQ(merged.rightTrigger, 0);
+    }
+    CHECK_EQ(reportIndex, kFixtureReports);
+    CHECK_EQ(hookedAccepted, 0);
+    CHECK_EQ(crossReads, 28);              // Reads whose last report falls in [50, 120)
+    CHECK_EQ(previousLX, (int16_t)32767);
+
+    // 100 deg/s (1638 units) for the 199 ms between the first and last sample.
+    CHECK(std::fabs(yawDeg - 1638 * 2000.0 / 32768.0 * 0.199) < 0.01);
+
+    // Once the DualSense has been quiet for longer than the stale timeout, the hooked device takes over.
+    const uint64_t endMs = static_cast<uint64_t>(records.back().timeUs / 1000);
+    PadState merged;
+    CHECK(merger.Peek(endMs + kStaleMs, merged));
+    CHECK(!merger.Peek(endMs + kStaleMs + 1, merged));
+    bool swapped = false;
+    CHECK(merger.Submit(kHookedDevice, kHookedPriority, &hookedDevice, hooked, 0, endMs + kStaleMs + 1, swapped));
+    CHECK(swapped);
+    REQUIRE(merger.Peek(endMs + kStaleMs + 1, merged));
+    CHECK_EQ(merged.buttons, kY);
+}
+
+// The game polls at 60 Hz on the recording's clock: each poll finds a newer update and records its
+// age once; polling again before the next update records nothing.
+TEST(ReplayedPollsRecordEachUpdateOnce)
+{
+    const std::vector<Recording::Record> records = LoadFixture();
+    REQUIRE(records.size() == kFixtureRecords);
+
+    VirtualPadMerger merger(kStaleMs);
+    LatencyHistogram histogram;
+    const int sonyDevice = 0;
+    std::vector<Sony::DecodedReport> decoded;
+
+    constexpr int64_t kPollUs = 16667;
+    int64_t nextPollUs = 0;
+    int polls = 0;
+    int64_t maxAgeUs = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const Recording::Record& record = records[i];
+        const size_t count = DecodeRead(record, decoded);
+        REQUIRE(count > 0);
+        bool swapped = false;
+        merger.Submit(kSonyHID, kSonyPriority, &sonyDevice, Sony::ToPadState(decoded[count - 1]), record.timeUs, record.timeUs / 1000, swapped);
+
+        const int64_t nextRecordUs = i + 1 < records.size() ? records[i + 1].timeUs : INT64_MAX;
+        while (nextPollUs < nextRecordUs && nextPollUs <= records.back().timeUs)
+        {
+            VirtualPadMerger::Delivery delivery;
+            REQUIRE(merger.Consume(nextPollUs / 1000, delivery));
+            CHECK(delivery.firstDelivery);
+            CHECK_EQ(delivery.sourceTimeUs, record.timeUs);
+            histogram.Record(nextPollUs - delivery.sourceTimeUs);
+            maxAgeUs = std::max(maxAgeUs, nextPollUs - delivery.sourceTimeUs);
+
+            REQUIRE(merger.Consume(nextPollUs / 1000, delivery));
+            CHECK(!delivery.firstDelivery);
+
+            polls++;
+            nextPollUs += kPollUs;
+        }
+    }
+    CHECK_EQ(polls, 12);    // 0 .. 183 ms
+
+    const LatencyHistogram::Summary summary = histogram.Summarize();
+    CHECK_EQ(summary.count, (uint64_t)polls);
+    CHECK_EQ(summary.maxUs, maxAgeUs);
+    CHECK(maxAgeUs < 4000);                // Reads are at most 4 ms apart
+    uint64_t inBuckets = 0;
+    for (int b = 0; b <= LatencyHistogram::kBucketCount; ++b)
+        inBuckets += summary.buckets[b];
+    CHECK_EQ(inBuckets, summary.count);
+    CHECK_EQ(summary.buckets[LatencyHistogram::kBucketCount], (uint64_t)0);
+}
+
+// Writing the fixture's records back out, on a different clock, gives the same file; a capture cut
+// short keeps its whole records.
+TEST(RecordingRoundTripsAndStopsAtATruncatedRecord)
+{
+    const std::vector<Recording::Record> records = LoadFixture();
+    REQUIRE(records.size() == kFixtureRecords);
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "ac_pad_input_pipeline_test";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    const std::filesystem::path copy = dir / "copy.input.bin";
+    const std::filesystem::path cut = dir / "cut.input.bin";
+
+    {
+        Recording::Writer writer;
+        REQUIRE(writer.Open(copy));
+        CHECK(writer.IsOpen());
+        for (const Recording::Record& r : records)
+            writer.Append(r.timeUs + 123456789, r.controllerType, r.reportSize, r.data.data(), static_cast<uint32_t>(r.data.size()));
+        CHECK_EQ(writer.GetRecordCount(), (uint64_t)kFixtureRecords);
+        writer.Close();
+        CHECK(!writer.IsOpen());
+    }
+    const std::vector<uint8_t> original = ReadFile(kFixture);
+    const std::vector<uint8_t> written = ReadFile(copy);
+    CHECK(written == original);
+
+    {
+        std::ofstream out(cut, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(original.data()), static_cast<std::streamsize>(original.size() - 10));
+    }
+    Recording::Reader reader;
+    REQUIRE(reader.Open(cut));
+    Recording::Record record;
+    size_t read = 0;
+    while (reader.Next(record))
+        read++;
+    CHECK_EQ(read, kFixtureRecords - 1);
+
+    Recording::Reader missing;
+    CHECK(!missing.Open(dir / "missing.input.bin"));
+    std::filesystem::remove_all(dir, ec);
+}
+
+// Live version: two sources stamp updates at 1000 Hz (the DualSense also recording its reads) while
+// XInputGetState-style readers consume the pad and record each update's age. Every update is first
+// delivered to exactly one read, and the histogram counts exactly those.
+TEST(WritersAt1000HzAgainstXInputReaders)
+{
+    constexpr int kWriteMs = 200;
+    constexpr int kReaders = 3;
+
+    VirtualPadMerger merger(kStaleMs);
+    LatencyHistogram histogram;
+    Recording::Writer recording;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "ac_pad_input_pipeline_threads";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    const std::filesystem::path capture = dir / "live.input.bin";
+    REQUIRE(recording.Open(capture));
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto nowMs = [&] {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    std::atomic<bool> writing{ true };
+    std::atomic<uint64_t> accepted{ 0 };
+    std::atomic<uint64_t> sonyWrites{ 0 };
+    const int sonyDevice = 0, hookedDevice = 0;
+
+    const auto writer = [&](int source, int priority, const void* context, bool record) {
+        auto next = std::chrono::steady_clock::now();
+        for (int i = 0; i < kWriteMs; ++i)
+        {
+            const int64_t arrivalUs = SteadyNowUs();
+            if (record)
+            {
+                recording.Append(arrivalUs, static_cast<uint8_t>(Sony::ControllerType::DualSense), 64, SonyFixtures::kDualSenseUsb, 64);
+                sonyWrites.fetch_add(1, std::memory_order_relaxed);
+            }
+            PadState state;
+            state.buttons = static_cast<uint16_t>(i);
+            bool swapped = false;
+            if (merger.Submit(source, priority, context, state, arrivalUs, nowMs(), swapped))
+                accepted.fetch_add(1, std::memory_order_relaxed);
+            next += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(next);
+        }
+    };
+
+    std::vector<std::vector<uint32_t>> delivered(kReaders);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < kReaders; ++r)
+    {
+        threads.emplace_back([&, r] {
+            uint32_t lastPacket = 0;
+            while (writing.load(std::memory_order_acquire))
+            {
+                VirtualPadMerger::Delivery delivery;
+                if (merger.Consume(nowMs(), delivery))
+                {
+                    CHECK(delivery.state.packetNumber >= lastPacket);
+                    lastPacket = delivery.state.packetNumber;
+                    if (delivery.firstDelivery)
+                    {
+                        histogram.Record(SteadyNowUs() - delivery.sourceTimeUs);
+                        delivered[r].push_back(delivery.state.packetNumber);
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    // The overlay's latency readout, summarizing while samples come in.
+    threads.emplace_back([&] {
+        uint64_t lastCount = 0;
+        while (writing.load(std::memory_order_acquire))
+        {
+            const LatencyHistogram::Summary summary = histogram.Summarize();
+            CHECK(summary.count >= lastCount);
+            lastCount = summary.count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    std::thread sony(writer, kSonyHID, kSonyPriority, &sonyDevice, true);
+    std::thread hooked(writer, kHookedDevice, kHookedPriority, &hookedDevice, false);
+    sony.join();
+    hooked.join();
+    writing.store(false, std::memory_order_release);
+    for (std::thread& t : threads)
+        t.join();
+    recording.Close();
+
+    std::vector<uint32_t> all;
+    for (const std::vector<uint32_t>& packets : delivered)
+        all.insert(all.end(), packets.begin(), packets.end());
+    std::sort(all.begin(), all.end());
+    CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+
+    const LatencyHistogram::Summary summary = histogram.Summarize();
+    CHECK_EQ(summary.count, (uint64_t)all.size());
+    CHECK(summary.count > 0);
+    CHECK(summary.count <= accepted.load());
+    CHECK(accepted.load() >= (uint64_t)kWriteMs);    // The DualSense is never rejected
+    CHECK(summary.p50Us <= summary.p99Us);
+
+    Recording::Reader reader;
+    REQUIRE(reader.Open(capture));
+    Recording::Record record;
+    uint64_t recorded = 0;
+    int64_t previousUs = -1;
+    while (reader.Next(record))
+    {
+        CHECK(record.timeUs >= previousUs);
+        previousUs = record.timeUs;
+        CHECK(record.data.size() == 64);
+        recorded++;
+    }
+    CHECK_EQ(recorded, sonyWrites.load());
+    CHECK_EQ(recorded, (uint64_t)kWriteMs);
+    std::filesystem::remove_all(dir, ec);
+}
@@ -0,0 +1,130 @@
+#include "Test.h"
+#include "util/PadPresence.h"
+#include <atomic>
+#include <thread>
+
+using BaseHook::PadPresence;
+using BaseHook::PadPresenceTracker;
+
+TEST(FirstProbeIsCommittedAsIs)
+{
+    PadPresenceTracker tracker(250);
+    CHECK_EQ(tracker.Get().generation, 0u);
+
+    CHECK(tracker.Observe(0b0110, 0));
+    const PadPresence presence = tracker.Get();
+    CHECK_EQ(presence.connectedMask, (uint8_t)0b0110);
+    CHECK_EQ(presence.preferredIndex, (int8_t)1);
+    CHECK_EQ(presence.generation, 1u);
+
+    CHECK(!tracker.Observe(0b0110, 100));
+    CHECK_EQ(tracker.Get().generation, 1u);
+}
+
+TEST(BriefDropoutIsIgnored)
+{
+    PadPresenceTracker tracker(250);
+    tracker.Observe(0b0110, 0);
+
+    CHECK(!tracker.Observe(0b0100, 200));
+    CHECK(tracker.HasPendingChange());
+    CHECK(!tracker.Observe(0b0110, 300));
+    CHECK(!tracker.HasPendingChange());
+    // The flicker leaves no pending time behind: a real dropout later still waits the full debounce.
+    CHECK(!tracker.Observe(0b0100, 400));
+    CHECK(!tracker.Observe(0b0100, 649));
+    CHECK(tracker.Observe(0b0100, 650));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0b0100);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)2);
+}
+
+TEST(PreferredSlotIsStickyThenMovesToTheLongestConnected)
+{
+    PadPresenceTracker tracker(250);
+    tracker.Observe(0b0110, 0);
+
+    // Slot 0 connects: committed after the debounce, but slot 1 stays preferred.
+    CHECK(!tracker.Observe(0b0111, 400));
+    CHECK(tracker.Observe(0b0111, 650));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0b0111);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)1);
+
+    // Slot 1 leaves: slot 2 (connected since 0) wins over slot 0 (since 650) despite its index.
+    CHECK(!tracker.Observe(0b0101, 1000));
+    CHECK(tracker.Observe(0b0101, 1250));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0b0101);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)2);
+
+    tracker.Observe(0, 2000);
+    CHECK(tracker.Observe(0, 2300));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)-1);
+
+    tracker.Observe(0b1000, 3000);
+    CHECK(tracker.Observe(0b1000, 3250));
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)3);
+    CHECK_EQ(tracker.Get().generation, 5u);
+}
+
+TEST(TiesGoToTheLowestSlot)
+{
+    PadPresenceTracker tracker(250);
+    tracker.Observe(0b1010, 0);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)1);
+}
+
+TEST(SlotsDebounceIndependently)
+{
+    PadPresenceTracker tracker(250);
+    tracker.Observe(0b0001, 0);
+
+    tracker.Observe(0b0011, 100);   // Slot 1 pending since 100
+    tracker.Observe(0b0111, 200);   // Slot 2 pending since 200
+    CHECK(tracker.Observe(0b0111, 350));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0b0011);
+    CHECK(tracker.HasPendingChange());
+    CHECK(tracker.Observe(0b0111, 450));
+    CHECK_EQ(tracker.Get().connectedMask, (uint8_t)0b0111);
+    CHECK(!tracker.HasPendingChange());
+}
+
+TEST(ZeroDebounceCommitsImmediately)
+{
+    PadPresenceTracker tracker(0);
+    CHECK(tracker.Observe(0, 0));
+    CHECK_EQ(tracker.Get().generation, 1u);
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)-1);
+    CHECK(tracker.Observe(0b0001, 1));
+    CHECK_EQ(tracker.Get().preferredIndex, (int8_t)0);
+    // Bits above the four XInput slots are ignored.
+    CHECK(!tracker.Observe(0b11110001, 2));
+}
+
+// The monitor thread observes while the game's XInput calls read; a reader must always get a
+// snapshot that was actually published.
+TEST(ConcurrentReadersSeeConsistentSnapshots)
+{
+    PadPresenceTracker tracker(0);
+    std::atomic<bool> stop{ false };
+    std::atomic<int> inconsistent{ 0 };
+
+    std::thread reader([&] {
+        uint32_t lastGeneration = 0;
+        while (!stop.load())
+        {
+            const PadPresence p = tracker.Get();
+            const bool preferredOk = p.preferredIndex < 0 ? p.connectedMask == 0 : (p.connectedMask >> p.preferredIndex) & 1;
+            if (!preferredOk || p.generation < lastGeneration)
+                inconsistent++;
+            lastGeneration = p.generation;
+        }
+    });
+
+    for (uint64_t now = 0; now < 20000; ++now)
+        tracker.Observe((uint8_t)(now * 7 % 16), now);
+    stop = true;
+    reader.join();
+
+    CHECK_EQ(inconsistent.load(), 0);
+    CHECK(tracker.Get().generation > 1000u);
+}
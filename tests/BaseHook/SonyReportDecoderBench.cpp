@@ -0,0 +1,49 @@
+#include "Test.h"
+#include "Bench.h"
+#include "util/SonyReportDecoder.h"
+#include "fixtures/SonyReports.h"
+#include <cstring>
+#include <vector>
+
+// Decoder throughput per report variant, in the 8-report batches the reader thread gets from one
+// ReadFile, and one report at a time for comparison. Per-op times are for a whole batch.
+namespace
+{
+    using namespace BaseHook::Sony;
+
+    constexpr size_t kBatch = 8;
+
+    template <size_t N>
+    void MeasureVariant(const char* batchLabel, const char* singleLabel, ControllerType type, const uint8_t (&report)[N])
+    {
+        std::vector<uint8_t> buffer(N * kBatch);
+        for (size_t i = 0; i < kBatch; ++i)
+            memcpy(&buffer[i * N], report, N);
+        DecodedReport out[kBatch];
+        CHECK_EQ(DecodeReports(type, buffer.data(), N, kBatch, out), kBatch);
+
+        Bench::Measure(batchLabel, [&] {
+            Bench::DoNotOptimize(DecodeReports(type, buffer.data(), N, kBatch, out));
+            Bench::DoNotOptimize(out);
+        });
+        Bench::Measure(singleLabel, [&] {
+            for (size_t i = 0; i < kBatch; ++i)
+                Bench::DoNotOptimize(DecodeReport(type, &buffer[i * N], N, out[i]));
+            Bench::DoNotOptimize(out);
+        });
+    }
+}
+
+TEST(DecodeThroughput)
+{
+    MeasureVariant("DS4 USB, 8 per batch", "DS4 USB, 8 one at a time",
+        ControllerType::DualShock4, SonyFixtures::kDualShock4Usb);
+    MeasureVariant("DS4 BT 0x11, 8 per batch", "DS4 BT 0x11, 8 one at a time",
+        ControllerType::DualShock4, SonyFixtures::kDualShock4Bluetooth);
+    MeasureVariant("DualSense USB, 8 per batch", "DualSense USB, 8 one at a time",
+        ControllerType::DualSense, SonyFixtures::kDualSenseUsb);
+    MeasureVariant("DualSense BT 0x31, 8 per batch", "DualSense BT 0x31, 8 one at a time",
+        ControllerType::DualSense, SonyFixtures::kDualSenseBluetooth);
+    MeasureVariant("DualSense BT short, 8 per batch", "DualSense BT short, 8 one at a time",
+        ControllerType::DualSense, SonyFixtures::kDualSenseBluetoothShort);
+}
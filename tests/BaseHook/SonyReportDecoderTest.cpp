@@ -0,0 +1,218 @@
+#include "Test.h"
+#include "util/SonyReportDecoder.h"
+#include "fixtures/SonyReports.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace BaseHook::Sony;
+
+namespace
+{
+    // XInput wButtons bits.
+    constexpr uint16_t kDpadUp = 0x0001, kDpadDown = 0x0002, kDpadLeft = 0x0004, kDpadRight = 0x0008;
+    constexpr uint16_t kStart = 0x0010, kBack = 0x0020, kLeftThumb = 0x0040, kRightThumb = 0x0080;
+    constexpr uint16_t kLeftShoulder = 0x0100, kRightShoulder = 0x0200, kGuide = 0x0400;
+    constexpr uint16_t kA = 0x1000, kB = 0x2000, kX = 0x4000, kY = 0x8000;
+
+    constexpr float kGyroDegPerUnit = 2000.0f / 32768.0f;
+    constexpr float kAccelGPerUnit = 1.0f / 8192.0f;
+
+    bool Near(float actual, float expected) { return std::fabs(actual - expected) < 1e-4f; }
+
+    void CheckSticks(const DecodedReport& r, int16_t lx, int16_t ly, int16_t rx, int16_t ry)
+    {
+        CHECK_EQ(r.thumbLX, lx);
+        CHECK_EQ(r.thumbLY, ly);
+        CHECK_EQ(r.thumbRX, rx);
+        CHECK_EQ(r.thumbRY, ry);
+    }
+
+    void CheckMotion(const DecodedReport& r, const int16_t (&gyro)[3], const int16_t (&accel)[3])
+    {
+        REQUIRE(r.hasMotion);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            CHECK(Near(r.gyro[axis], gyro[axis] * kGyroDegPerUnit));
+            CHECK(Near(r.accel[axis], accel[axis] * kAccelGPerUnit));
+        }
+    }
+
+    void CheckTouch(const TouchPoint& p, bool active, uint8_t id, uint16_t x, uint16_t y)
+    {
+        CHECK_EQ(p.active, active);
+        CHECK_EQ(p.id, id);
+        CHECK_EQ(p.x, x);
+        CHECK_EQ(p.y, y);
+    }
+}
+
+TEST(DualShock4Usb)
+{
+    const auto& bytes = SonyFixtures::kDualShock4Usb;
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualShock4, bytes, sizeof(bytes), r));
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualShock4, bytes, sizeof(bytes))), std::string("DualShock 4 USB"));
+
+    CHECK_EQ(r.buttons, (uint16_t)(kX | kLeftShoulder | kBack | kGuide));
+    CheckSticks(r, 32767, 32767, 128, 128);
+    CHECK_EQ(r.leftTrigger, 0x40);
+    CHECK_EQ(r.rightTrigger, 0xFF);
+    CheckMotion(r, { -3, 2, 1 }, { -120, 8150, 310 });
+    CHECK_EQ(r.sensorTimestamp, 0xB7A0u);
+    REQUIRE(r.hasTouch);
+    CheckTouch(r.touch[0], true, 5, 960, 471);
+    CheckTouch(r.touch[1], false, 4, 0, 0);
+}
+
+TEST(DualShock4Bluetooth)
+{
+    const auto& bytes = SonyFixtures::kDualShock4Bluetooth;
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualShock4, bytes, sizeof(bytes), r));
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualShock4, bytes, sizeof(bytes))), std::string("DualShock 4 BT"));
+
+    CHECK_EQ(r.buttons, (uint16_t)(kDpadLeft | kY | kB | kRightThumb | kTouchpadButton));
+    CheckSticks(r, -32767, -32767, -20431, -20688);
+    CHECK_EQ(r.leftTrigger, 0xE0);
+    CHECK_EQ(r.rightTrigger, 0);
+    CheckMotion(r, { 1638, -1638, 0 }, { 4096, -4096, 8192 });
+    CHECK(Near(r.gyro[0], 99.975586f));
+    CHECK_EQ(r.sensorTimestamp, 0xFFF0u);
+    REQUIRE(r.hasTouch);
+    CheckTouch(r.touch[0], true, 12, 1919, 942);
+    CheckTouch(r.touch[1], true, 13, 10, 20);
+}
+
+TEST(DualSenseUsb)
+{
+    const auto& bytes = SonyFixtures::kDualSenseUsb;
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualSense, bytes, sizeof(bytes), r));
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualSense, bytes, sizeof(bytes))), std::string("DualSense USB"));
+
+    // Create is Back; the touchpad click has its own bit.
+    CHECK_EQ(r.buttons, (uint16_t)(kDpadRight | kA | kBack | kTouchpadButton));
+    CheckSticks(r, 128, -128, -32767, -128);
+    CHECK_EQ(r.leftTrigger, 0);
+    CHECK_EQ(r.rightTrigger, 0x80);
+    CheckMotion(r, { -1, 0, 4 }, { 52, 8190, -17 });
+    CHECK_EQ(r.sensorTimestamp, 0x00A1B2C3u);
+    REQUIRE(r.hasTouch);
+    CheckTouch(r.touch[0], true, 0x21, 1000, 500);
+    CheckTouch(r.touch[1], false, 0x20, 1000, 500);
+}
+
+TEST(DualSenseBluetooth)
+{
+    const auto& bytes = SonyFixtures::kDualSenseBluetooth;
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualSense, bytes, sizeof(bytes), r));
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualSense, bytes, sizeof(bytes))), std::string("DualSense BT"));
+
+    // Mute has no XInput bit.
+    CHECK_EQ(r.buttons, (uint16_t)(kDpadLeft | kDpadUp | kX | kRightShoulder | kGuide));
+    CheckSticks(r, -128, -385, 32767, -32767);
+    CHECK_EQ(r.leftTrigger, 0xFF);
+    CHECK_EQ(r.rightTrigger, 0xFF);
+    CheckMotion(r, { 3277, 0, -3277 }, { 0, 0, -8192 });
+    CHECK_EQ(r.sensorTimestamp, 0xFFFFFFF0u);
+    REQUIRE(r.hasTouch);
+    CheckTouch(r.touch[0], true, 0x7F, 0, 0);
+    CheckTouch(r.touch[1], true, 1, 1919, 1079);
+}
+
+TEST(DualSenseBluetoothShort)
+{
+    const auto& bytes = SonyFixtures::kDualSenseBluetoothShort;
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualSense, bytes, sizeof(bytes), r));
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualSense, bytes, sizeof(bytes))), std::string("DualSense BT short"));
+
+    CHECK_EQ(r.buttons, (uint16_t)(kDpadDown | kA | kStart | kLeftThumb | kRightShoulder));
+    CheckSticks(r, -16319, -16576, 128, -128);
+    CHECK_EQ(r.leftTrigger, 0x11);
+    CHECK_EQ(r.rightTrigger, 0);
+    CHECK(!r.hasMotion);
+    CHECK(!r.hasTouch);
+}
+
+TEST(CreateAndTouchpadClickAreSeparate)
+{
+    // Same DualSense USB report with only one of the two pressed at a time.
+    uint8_t bytes[sizeof(SonyFixtures::kDualSenseUsb)];
+    memcpy(bytes, SonyFixtures::kDualSenseUsb, sizeof(bytes));
+    DecodedReport r;
+
+    bytes[10] &= ~0x02; // Touchpad click up, Create still down
+    REQUIRE(DecodeReport(ControllerType::DualSense, bytes, sizeof(bytes), r));
+    CHECK((r.buttons & kBack) != 0);
+    CHECK((r.buttons & kTouchpadButton) == 0);
+
+    bytes[10] |= 0x02;
+    bytes[9] &= ~0x10;  // Create up, touchpad click down
+    REQUIRE(DecodeReport(ControllerType::DualSense, bytes, sizeof(bytes), r));
+    CHECK((r.buttons & kBack) == 0);
+    CHECK((r.buttons & kTouchpadButton) != 0);
+}
+
+TEST(RejectsUnknownAndTruncatedReports)
+{
+    DecodedReport r;
+    CHECK(!DecodeReport(ControllerType::DualShock4, SonyFixtures::kDualShock4Usb, 9, r));
+    CHECK(!DecodeReport(ControllerType::DualSense, SonyFixtures::kDualSenseBluetooth, 77, r));
+    CHECK(!DecodeReport(ControllerType::DualShock4, SonyFixtures::kDualSenseBluetooth, sizeof(SonyFixtures::kDualSenseBluetooth), r));
+    CHECK(!DecodeReport(ControllerType::DualSense, nullptr, 64, r));
+    CHECK(GetLayoutName(ControllerType::DualSense, SonyFixtures::kDualShock4Bluetooth, sizeof(SonyFixtures::kDualShock4Bluetooth)) == nullptr);
+
+    // A 0x01 report too short for the USB layout is the Bluetooth short one.
+    CHECK_EQ(std::string(GetLayoutName(ControllerType::DualSense, SonyFixtures::kDualSenseUsb, 10)), std::string("DualSense BT short"));
+}
+
+TEST(DecodesBackToBackReportsOfOneRead)
+{
+    // Eight DualSense USB reports in one buffer, the fourth with a garbage ID.
+    constexpr size_t kSize = sizeof(SonyFixtures::kDualSenseUsb);
+    std::vector<uint8_t> buffer(kSize * 8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        memcpy(&buffer[i * kSize], SonyFixtures::kDualSenseUsb, kSize);
+        buffer[i * kSize + 28] = static_cast<uint8_t>(i); // Timestamp low byte
+    }
+    buffer[3 * kSize] = 0x7E;
+
+    DecodedReport out[8];
+    const size_t decoded = DecodeReports(ControllerType::DualSense, buffer.data(), kSize, 8, out);
+    REQUIRE(decoded == 7);
+    CHECK_EQ(out[2].sensorTimestamp & 0xFF, 2u);
+    CHECK_EQ(out[3].sensorTimestamp & 0xFF, 4u);
+    CHECK_EQ(out[6].sensorTimestamp & 0xFF, 7u);
+    for (size_t i = 0; i < decoded; ++i)
+        CHECK_EQ(out[i].buttons, (uint16_t)(kDpadRight | kA | kBack | kTouchpadButton));
+}
+
+TEST(SensorTimestampWraps)
+{
+    // DualShock 4: 16-bit ticks of 16/3 us. 0xFFF0 -> 0x0010 is 32 ticks.
+    CHECK_EQ(SensorTimestampDeltaUs(ControllerType::DualShock4, 0xFFF0, 0x0010), 170u);
+    // DualSense: 32-bit ticks of 1/3 us.
+    CHECK_EQ(SensorTimestampDeltaUs(ControllerType::DualSense, 0xFFFFFFF0u, 0x00000BC8u), 1010u);
+
+    uint16_t width = 0, height = 0;
+    GetTouchpadSize(ControllerType::DualSense, width, height);
+    CHECK_EQ(width, 1920);
+    CHECK_EQ(height, 1080);
+    GetTouchpadSize(ControllerType::DualShock4, width, height);
+    CHECK_EQ(height, 943);
+}
+
+TEST(PadStateCarriesTheXInputPart)
+{
+    DecodedReport r;
+    REQUIRE(DecodeReport(ControllerType::DualShock4, SonyFixtures::kDualShock4Bluetooth, sizeof(SonyFixtures::kDualShock4Bluetooth), r));
+    const BaseHook::PadState pad = ToPadState(r);
+    CHECK_EQ(pad.buttons, r.buttons);
+    CHECK_EQ(pad.leftTrigger, 0xE0);
+    CHECK_EQ(pad.thumbLX, -32767);
+    CHECK_EQ(pad.thumbRY, -20688);
+}
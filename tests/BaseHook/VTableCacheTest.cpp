@@ -0,0 +1,149 @@
+#include "Test.h"
+#include "util/VTableCache.h"
+
+using namespace BaseHook::VTableCache;
+
+namespace
+{
+    ModuleIdentity Dxgi()
+    {
+        ModuleIdentity module;
+        module.name = "dxgi.dll";
+        module.fileVersion = (10ull << 48) | (0ull << 32) | (19041ull << 16) | 3636;
+        module.timestamp = 0x5f1a2b3c;
+        module.imageSize = 0xC5000;
+        return module;
+    }
+
+    ModuleIdentity D3D11()
+    {
+        ModuleIdentity module;
+        module.name = "d3d11.dll";
+        module.fileVersion = (10ull << 48) | (19041ull << 16) | 3570;
+        module.timestamp = 0x1234abcd;
+        module.imageSize = 0x250000;
+        return module;
+    }
+
+    Entry SwapChain()
+    {
+        Entry entry;
+        entry.interfaceName = "IDXGISwapChain";
+        entry.modules = { Dxgi(), D3D11() };
+        entry.rvas = { 0x1a2b0, 0x3c4d0, 0x5e6f0 };
+        return entry;
+    }
+}
+
+TEST(FindNeedsEveryModuleWithTheSameIdentity)
+{
+    Cache cache;
+    REQUIRE(cache.Store(SwapChain()));
+
+    const Entry* found = cache.Find("IDXGISwapChain", { D3D11(), Dxgi() });
+    REQUIRE(found != nullptr);
+    CHECK(found->rvas == std::vector<uint32_t>({ 0x1a2b0, 0x3c4d0, 0x5e6f0 }));
+    CHECK(cache.Find("IDXGIFactory", { D3D11(), Dxgi() }) == nullptr);
+
+    // d3d10 created the swap chain instead.
+    CHECK(cache.Find("IDXGISwapChain", { Dxgi() }) == nullptr);
+
+    // A Windows update or a wrapper DLL changes any of the identity fields.
+    ModuleIdentity updated = Dxgi();
+    updated.fileVersion++;
+    CHECK(cache.Find("IDXGISwapChain", { updated, D3D11() }) == nullptr);
+    updated = Dxgi();
+    updated.timestamp++;
+    CHECK(cache.Find("IDXGISwapChain", { updated, D3D11() }) == nullptr);
+    updated = Dxgi();
+    updated.imageSize += 0x1000;
+    CHECK(cache.Find("IDXGISwapChain", { updated, D3D11() }) == nullptr);
+}
+
+TEST(StoreRejectsRvasOutsideTheModule)
+{
+    Cache cache;
+    Entry entry = SwapChain();
+    entry.rvas.push_back(Dxgi().imageSize);
+    CHECK(!cache.Store(entry));
+    entry.rvas.back() = 0;
+    CHECK(!cache.Store(entry));
+    entry.rvas.clear();
+    CHECK(!cache.Store(entry));
+    entry = SwapChain();
+    entry.modules.clear();
+    CHECK(!cache.Store(entry));
+    CHECK(cache.GetEntries().empty());
+}
+
+TEST(StoreReplacesPerInterfaceAndReportsChanges)
+{
+    Cache cache;
+    CHECK(cache.Store(SwapChain()));
+    CHECK(!cache.Store(SwapChain()));
+
+    Entry moved = SwapChain();
+    moved.rvas[0] = 0x1a2c0;
+    CHECK(cache.Store(moved));
+    REQUIRE(cache.GetEntries().size() == 1);
+    CHECK_EQ(cache.GetEntries()[0].rvas[0], (uint32_t)0x1a2c0);
+
+    Entry other = SwapChain();
+    other.interfaceName = "IDXGISwapChain1";
+    CHECK(cache.Store(other));
+    CHECK_EQ(cache.GetEntries().size(), (size_t)2);
+}
+
+TEST(SerializeRoundTrips)
+{
+    Cache cache;
+    cache.Store(SwapChain());
+    Entry other = SwapChain();
+    other.interfaceName = "IDXGISwapChain1";
+    other.modules = { Dxgi() };
+    other.rvas = { 0x10 };
+    cache.Store(other);
+
+    const std::string text = cache.Serialize();
+    CHECK(text.find("IDXGISwapChain module dxgi.dll 10.0.19041.3636 5f1a2b3c 000c5000 module d3d11.dll") == 0);
+
+    Cache loaded;
+    std::string error;
+    REQUIRE(loaded.Parse("# written by a previous run\n\n" + text, &error));
+    CHECK_EQ(error, std::string());
+    CHECK_EQ(loaded.Serialize(), text);
+    CHECK(loaded.Find("IDXGISwapChain", { Dxgi(), D3D11() }) != nullptr);
+    CHECK(loaded.Find("IDXGISwapChain1", { Dxgi() }) != nullptr);
+}
+
+TEST(ParseRejectsMalformedInputAndKeepsTheCache)
+{
+    Cache cache;
+    cache.Store(SwapChain());
+    const std::string before = cache.Serialize();
+
+    const char* bad[] = {
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3c c5000\n",                     // no rva list
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3c\n",                           // truncated module
+        "IDXGISwapChain module dxgi.dll 10.0.1 5f1a2b3c c5000 rva 10\n",                // short version
+        "IDXGISwapChain module dxgi.dll 10.0.1.70000 5f1a2b3c c5000 rva 10\n",          // version part > 0xFFFF
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3cz c5000 rva 10\n",             // bad timestamp
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3c 100000000 rva 10\n",          // size over 32 bits
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3c c5000 rva 10 xyz\n",          // bad rva
+        "IDXGISwapChain module dxgi.dll 10.0.1.2 5f1a2b3c c5000 rva c5000\n",           // rva outside the module
+        "IDXGISwapChain rva 10\n",                                                      // no modules
+        "IDXGISwapChain dll dxgi.dll\n",                                                // unknown key
+        "A module dxgi.dll 10.0.1.2 5f1a2b3c c5000 rva 10\nA module dxgi.dll 10.0.1.2 5f1a2b3c c5000 rva 20\n",
+    };
+    for (const char* text : bad)
+    {
+        std::string error;
+        CHECK(!cache.Parse(text, &error));
+        CHECK(error.rfind("line ", 0) == 0);
+    }
+    CHECK_EQ(cache.Serialize(), before);
+
+    std::string error;
+    CHECK(!cache.Parse("# ok\nA module dxgi.dll 1.2.3.4 1 1000 rva 10\nB rva 10\n", &error));
+    CHECK(error.rfind("line 3:", 0) == 0);
+}
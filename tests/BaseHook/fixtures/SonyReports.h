@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+// One input report of each variant SonyReportDecoder knows, byte for byte as ReadFile returns them
+// (report ID first). Built to the published layouts rather than captured, so every field has a value
+// the tests can check; the Bluetooth reports carry a valid CRC32 (seeded with 0xA1) like real ones.
+// Unchecked bytes hold typical values (battery, temperature, sequence counters).
+namespace SonyFixtures
+{
+    // DualShock 4 over USB. Square, L1, Share, PS; d-pad released. Left stick up-right, right stick
+    // centred; L2 0x40, R2 full. Resting on a table: gyro (-3, 2, 1), accel (-120, 8150, 310).
+    // Timestamp 0xB7A0. One finger (id 5) at (960, 471), second slot lifted (id 4).
+    inline constexpr uint8_t kDualShock4Usb[64] = {
+        0x01, 0xFF, 0x00, 0x80, 0x7F, 0x18, 0x11, 0xA9, 0x40, 0xFF, 0xA0, 0xB7, 0x17, 0xFD, 0xFF, 0x02,
+        0x00, 0x01, 0x00, 0x88, 0xFF, 0xD6, 0x1F, 0x36, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1B, 0x00,
+        0x00, 0x01, 0x2C, 0x05, 0xC0, 0x73, 0x1D, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    // DualShock 4 over Bluetooth (0x11). D-pad left, Triangle, Circle, R3, touchpad click. The R2
+    // button bit is set with the R2 axis at 0: triggers come from the axis bytes only.
+    // Left stick down-left, right stick (0x30, 0xD0); L2 0xE0. Gyro (1638, -1638, 0),
+    // accel (4096, -4096, 8192). Timestamp 0xFFF0, just before the 16-bit wrap. Two fingers:
+    // id 12 at the far corner (1919, 942) and id 13 at (10, 20).
+    inline constexpr uint8_t kDualShock4Bluetooth[78] = {
+        0x11, 0xC0, 0x00, 0x00, 0xFF, 0x30, 0xD0, 0xC6, 0x88, 0x16, 0xE0, 0x00, 0xF0, 0xFF, 0x17, 0x66,
+        0x06, 0x9A, 0xF9, 0x00, 0x00, 0x00, 0x10, 0x00, 0xF0, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x1B, 0x00, 0x00, 0x01, 0x2C, 0x0C, 0x7F, 0xE7, 0x3A, 0x0D, 0x0A, 0x40, 0x01, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x4B, 0x39, 0x40,
+    };
+
+    // DualSense over USB. D-pad right, Cross, Create and touchpad click together. Right stick full
+    // left, the rest centred; R2 half. Gyro (-1, 0, 4), accel (52, 8190, -17), timestamp 0x00A1B2C3.
+    // One finger (id 0x21) at (1000, 500); the second slot lifted at the same spot.
+    inline constexpr uint8_t kDualSenseUsb[64] = {
+        0x01, 0x80, 0x80, 0x00, 0x80, 0x00, 0x80, 0x41, 0x22, 0x10, 0x02, 0x00, 0x9E, 0x3C, 0x71, 0x05,
+        0xFF, 0xFF, 0x00, 0x00, 0x04, 0x00, 0x34, 0x00, 0xFE, 0x1F, 0xEF, 0xFF, 0xC3, 0xB2, 0xA1, 0x00,
+        0x1D, 0x21, 0xE8, 0x43, 0x1F, 0xA0, 0xE8, 0x43, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    // DualSense over Bluetooth (0x31). D-pad up-left, Square, R1, PS and mute (mute has no XInput
+    // equivalent). Sticks (0x7F, 0x81, 0xFF, 0xFF); both triggers full. Gyro (3277, 0, -3277),
+    // accel (0, 0, -8192), timestamp 0xFFFFFFF0. Fingers id 0x7F at (0, 0) and id 1 at (1919, 1079).
+    inline constexpr uint8_t kDualSenseBluetooth[78] = {
+        0x31, 0x10, 0x7F, 0x81, 0xFF, 0xFF, 0xFF, 0xFF, 0x99, 0x17, 0x02, 0x05, 0x00, 0x9E, 0x3C, 0x71,
+        0x05, 0xCD, 0x0C, 0x00, 0x00, 0x33, 0xF3, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xF0, 0xFF, 0xFF,
+        0xFF, 0x1D, 0x7F, 0x00, 0x00, 0x00, 0x01, 0x7F, 0x77, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x98, 0xC9, 0x8B,
+    };
+
+    // DualSense over Bluetooth before feature report 0x05 switches it to 0x31: buttons, sticks and
+    // triggers only. D-pad down, Cross, Options, L3, R1; sticks (0x40, 0xC0, 0x80, 0x80); L2 0x11.
+    inline constexpr uint8_t kDualSenseBluetoothShort[10] = {
+        0x01, 0x40, 0xC0, 0x80, 0x80, 0x24, 0x62, 0x40, 0x11, 0x00,
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+// Stand-in for BaseHook/include/core/BaseHook.h: just the overlay activity interface the frame gate
+// reads, so the gate builds without the hooks, the device and the Win32 SDK.
+namespace BaseHook
+{
+    enum class OverlayActivity : int
+    {
+        Active,
+        Static,
+        Idle
+    };
+
+    class Settings
+    {
+    public:
+        virtual ~Settings() = default;
+        virtual OverlayActivity GetOverlayActivity() { return OverlayActivity::Active; }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+// Stand-in for BaseHook/include/hooks/InputHooks.h; the test defines what the DirectInput hook
+// would report.
+namespace BaseHook::Hooks
+{
+    bool HasBufferedMouseInput();
+}
@@ -0,0 +1,316 @@
+#include "Test.h"
+#include "d3d9.h"
+#include "imgui.h"
+#include "imgui_impl_dx9.h"
+#include "imgui_impl_dx9_state.h"
+#include <functional>
+#include <initializer_list>
+#include <random>
+
+namespace
+{
+    IDirect3DPixelShader9 g_gamePS;
+    IDirect3DVertexShader9 g_gameVS;
+    IDirect3DVertexDeclaration9 g_gameDecl;
+    IDirect3DVertexBuffer9 g_gameVB;
+    IDirect3DIndexBuffer9 g_gameIB;
+    IDirect3DBaseTexture9 g_gameTex;
+
+    bool RefsBalanced()
+    {
+        for (MockUnknown* object : std::initializer_list<MockUnknown*>{ &g_gamePS, &g_gameVS, &g_gameDecl, &g_gameVB, &g_gameIB, &g_gameTex })
+        {
+            if (object->refs != 1)
+                return false;
+        }
+        return true;
+    }
+
+    // An ImGui context drawing through the real DX9 backend onto a mock device.
+    struct Overlay
+    {
+        explicit Overlay(IDirect3DDevice9& device)
+        {
+            ImGui::CreateContext();
+            ImGuiIO& io = ImGui::GetIO();
+            io.IniFilename = nullptr;
+            io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+            io.DeltaTime = 1.0f / 60.0f;
+            ImGui_ImplDX9_Init(&device);
+            Frame();    // New windows stay hidden for their first frame
+        }
+        ~Overlay()
+        {
+            ImGui_ImplDX9_Shutdown();
+            ImGui::DestroyContext();
+        }
+
+        // A window with some text, and whatever `extra` adds to its draw list between the two lines.
+        ImDrawData* Frame(const std::function<void(ImDrawList*)>& extra = nullptr)
+        {
+            ImGui_ImplDX9_NewFrame();
+            ImGui::NewFrame();
+            ImGui::Begin("Overlay");
+            ImGui::Text("before");
+            if (extra)
+                extra(ImGui::GetWindowDrawList());
+            ImGui::Text("after");
+            ImGui::End();
+            ImGui::Render();
+            return ImGui::GetDrawData();
+        }
+    };
+
+    // Draws issued before the last user callback ran.
+    size_t g_drawsBeforeCallback = 0;
+
+    // A user callback that changes state ImGui_ImplDX9_StateBackup doesn't cover, and some it does.
+    void ChangeEverything(const ImDrawList*, const ImDrawCmd* cmd)
+    {
+        IDirect3DDevice9* device = (IDirect3DDevice9*)cmd->UserCallbackData;
+        g_drawsBeforeCallback = device->draws.size();
+        device->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        device->SetRenderState(D3DRS_TEXTUREFACTOR, 0x12345678);
+        device->SetTextureStageState(2, D3DTSS_COLORARG1, 7);
+        device->SetSamplerState(1, D3DSAMP_MINFILTER, 1);
+        device->SetPixelShader(&g_gamePS);
+        device->SetTexture(0, &g_gameTex);
+    }
+
+    // The state the backend draws with, checked on a snapshot taken at a draw.
+    void CheckOverlayState(const IDirect3DDevice9::StateMap& s)
+    {
+        using D = IDirect3DDevice9;
+        CHECK_EQ(D::Read<DWORD>(s, D::Key("RS", D3DRS_ALPHABLENDENABLE)), (DWORD)TRUE);
+        CHECK_EQ(D::Read<DWORD>(s, D::Key("RS", D3DRS_ZENABLE)), (DWORD)FALSE);
+        CHECK_EQ(D::Read<DWORD>(s, D::Key("RS", D3DRS_SCISSORTESTENABLE)), (DWORD)TRUE);
+        CHECK_EQ(D::Read<DWORD>(s, D::Key("TSS", 0, D3DTSS_COLOROP)), (DWORD)D3DTOP_MODULATE);
+        CHECK(D::Read<IDirect3DPixelShader9*>(s, "PS") == nullptr);
+        CHECK(D::Read<IDirect3DVertexShader9*>(s, "VS") == nullptr);
+        CHECK_EQ(D::Read<DWORD>(s, "FVF"), (DWORD)(D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1));
+        IDirect3DBaseTexture9* texture = D::Read<IDirect3DBaseTexture9*>(s, D::Key("TEX", 0));
+        CHECK(texture != nullptr && texture != &g_gameTex);
+        CHECK(D::Read<D::Stream>(s, D::Key("STREAM", 0)).buffer != &g_gameVB);
+        CHECK_EQ(D::Read<D3DVIEWPORT9>(s, "VP").Width, (DWORD)1920);
+    }
+
+    // A game frame's worth of state, including states the overlay doesn't touch.
+    void SetRandomGameState(IDirect3DDevice9* device, std::mt19937& rng, bool useDeclaration)
+    {
+        auto r = [&] { return (DWORD)rng(); };
+        for (int s : { 7, 8, 9, 14, 15, 19, 20, 22, 27, 28, 29, 48, 52, 60, 128, 136, 137, 171, 174, 206, 207, 208 })
+            device->SetRenderState((D3DRENDERSTATETYPE)s, r());
+        for (DWORD stage = 0; stage < 4; ++stage)
+        {
+            for (int t = 1; t <= 6; ++t)
+                device->SetTextureStageState(stage, (D3DTEXTURESTAGESTATETYPE)t, r());
+        }
+        for (DWORD sampler = 0; sampler < 2; ++sampler)
+        {
+            for (int t : { 1, 2, 5, 6 })
+                device->SetSamplerState(sampler, (D3DSAMPLERSTATETYPE)t, r());
+        }
+
+        device->SetPixelShader(rng() % 2 ? &g_gamePS : nullptr);
+        device->SetVertexShader(rng() % 2 ? &g_gameVS : nullptr);
+        if (useDeclaration)
+            device->SetVertexDeclaration(&g_gameDecl);
+        else
+            device->SetFVF(r() | 1);
+        device->SetStreamSource(0, &g_gameVB, r() % 64, 32);
+        device->SetIndices(rng() % 2 ? &g_gameIB : nullptr);
+        device->SetTexture(0, rng() % 2 ? &g_gameTex : nullptr);
+
+        const D3DVIEWPORT9 vp = { r() % 10, r() % 10, r() % 4000, r() % 3000, 0.0f, 1.0f };
+        device->SetViewport(&vp);
+        const RECT scissor = { (LONG)(r() % 10), 0, (LONG)(r() % 1000), 500 };
+        device->SetScissorRect(&scissor);
+        for (int t : { D3DTS_VIEW, D3DTS_PROJECTION, D3DTS_WORLD })
+        {
+            D3DMATRIX m;
+            for (float& f : m.f)
+                f = (float)(r() % 1000);
+            device->SetTransform((D3DTRANSFORMSTATETYPE)t, &m);
+        }
+    }
+}
+
+// The backup is complete if the real RenderDrawData can't leave anything it touched changed, for
+// any game state. No state block on the way: that's what the backup replaces.
+TEST(RestoreUndoesEverythingTheDrawTouches)
+{
+    IDirect3DDevice9 device;
+    Overlay overlay(device);
+    ImDrawData* drawData = overlay.Frame();
+
+    std::mt19937 rng(42);
+    for (int iteration = 0; iteration < 500; ++iteration)
+    {
+        SetRandomGameState(&device, rng, iteration % 3 == 0);
+        const auto before = device.state;
+
+        device.recording = true;
+        ImGui_ImplDX9_RenderDrawData(drawData);
+        device.recording = false;
+
+        for (const std::string& key : device.touched)
+        {
+            // Every key the draw sets was also set by the game, so "restored" is well defined.
+            REQUIRE(before.count(key) == 1);
+            if (device.state[key] != before.at(key))
+            {
+                printf("    not restored: %s (iteration %d)\n", key.c_str(), iteration);
+                CHECK(false);
+            }
+        }
+        // One bad iteration is enough to report.
+        REQUIRE(device.state == before);
+        REQUIRE(RefsBalanced());
+    }
+    CHECK(!device.draws.empty());
+    CHECK_EQ(device.stateBlocksCreated, 0);
+}
+
+TEST(DrawsUseTheBackendState)
+{
+    IDirect3DDevice9 device;
+    std::mt19937 rng(3);
+    SetRandomGameState(&device, rng, false);
+    device.SetPixelShader(&g_gamePS);
+    device.SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    {
+        Overlay overlay(device);
+        ImGui_ImplDX9_RenderDrawData(overlay.Frame());
+    }
+    REQUIRE(!device.draws.empty());
+    for (const IDirect3DDevice9::Draw& draw : device.draws)
+    {
+        CHECK(draw.primitives > 0);
+        CheckOverlayState(draw.state);
+    }
+    CHECK(RefsBalanced());
+}
+
+// A callback that wrecks the state, then ImDrawCallback_ResetRenderState: the draws after it are
+// back on the backend's state, and the callback's changes (beyond the backup's tables) are undone.
+TEST(UserCallbacksGetTheFullStateRestored)
+{
+    IDirect3DDevice9 device;
+    std::mt19937 rng(5);
+    SetRandomGameState(&device, rng, true);
+    const auto before = device.state;
+    {
+        Overlay overlay(device);
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            device.draws.clear();
+            ImGui_ImplDX9_RenderDrawData(overlay.Frame([&](ImDrawList* drawList) {
+                drawList->AddCallback(ChangeEverything, &device);
+                drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+            }));
+            CHECK(device.state == before);
+            CHECK(RefsBalanced());
+
+            REQUIRE(g_drawsBeforeCallback > 0 && g_drawsBeforeCallback < device.draws.size());
+            for (size_t i = g_drawsBeforeCallback; i < device.draws.size(); ++i)
+                CheckOverlayState(device.draws[i].state);
+        }
+    }
+    // One block for the device objects' lifetime, re-captured every frame.
+    CHECK_EQ(device.stateBlocksCreated, 1);
+}
+
+// ImDrawCallback_ResetRenderState alone only re-applies the backend's own state: the backup suffices.
+TEST(ResetRenderStateAloneKeepsTheCheapBackup)
+{
+    IDirect3DDevice9 device;
+    std::mt19937 rng(6);
+    SetRandomGameState(&device, rng, false);
+    const auto before = device.state;
+    {
+        Overlay overlay(device);
+        ImGui_ImplDX9_RenderDrawData(overlay.Frame([](ImDrawList* drawList) {
+            drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+        }));
+    }
+    CHECK(device.state == before);
+    CHECK_EQ(device.stateBlocksCreated, 0);
+    for (const IDirect3DDevice9::Draw& draw : device.draws)
+        CheckOverlayState(draw.state);
+}
+
+// Pure devices, or a Get* that fails, fall back to the state block.
+TEST(StateBlockFallbackRestoresToo)
+{
+    for (bool pure : { true, false })
+    {
+        IDirect3DDevice9 device;
+        std::mt19937 rng(pure ? 11 : 12);
+        SetRandomGameState(&device, rng, false);
+        device.SetPixelShader(&g_gamePS);
+        device.SetTexture(0, &g_gameTex);
+        if (pure)
+            device.behaviorFlags = D3DCREATE_PUREDEVICE;
+        else
+            device.failGet = "VP";
+        const auto before = device.state;
+        {
+            Overlay overlay(device);
+            ImGui_ImplDX9_RenderDrawData(overlay.Frame());
+            ImGui_ImplDX9_RenderDrawData(overlay.Frame());
+        }
+        CHECK(device.state == before);
+        CHECK_EQ(device.stateBlocksCreated, 1);
+        CHECK(RefsBalanced());
+    }
+}
+
+TEST(DeclarationGameGetsItsDeclarationBack)
+{
+    IDirect3DDevice9 device;
+    device.SetVertexDeclaration(&g_gameDecl);
+    {
+        Overlay overlay(device);
+        ImGui_ImplDX9_RenderDrawData(overlay.Frame());
+    }
+
+    IDirect3DVertexDeclaration9* decl = nullptr;
+    DWORD fvf = 1;
+    device.GetVertexDeclaration(&decl);
+    device.GetFVF(&fvf);
+    CHECK(decl == &g_gameDecl);
+    CHECK_EQ(fvf, (DWORD)0);
+    decl->Release();
+    CHECK(RefsBalanced());
+}
+
+TEST(FailedCaptureHoldsNoReferences)
+{
+    IDirect3DDevice9 device;
+    std::mt19937 rng(7);
+    SetRandomGameState(&device, rng, false);
+    device.SetPixelShader(&g_gamePS);
+    device.SetTexture(0, &g_gameTex);
+    device.failGet = "VP";
+
+    ImGui_ImplDX9_StateBackup backup;
+    CHECK(!backup.Capture(&device));
+    CHECK(RefsBalanced());
+}
+
+TEST(ReleaseDropsReferencesWithoutTouchingTheDevice)
+{
+    IDirect3DDevice9 device;
+    std::mt19937 rng(9);
+    SetRandomGameState(&device, rng, true);
+    device.SetIndices(&g_gameIB);
+
+    ImGui_ImplDX9_StateBackup backup;
+    REQUIRE(backup.Capture(&device));
+    CHECK(g_gameIB.refs == 2);
+    const auto before = device.state;
+    backup.Release();
+    backup.Release();
+    CHECK(device.state == before);
+    CHECK(RefsBalanced());
+}
@@ -0,0 +1,386 @@
+#pragma once
+// Stand-in for <d3d9.h> with just what imgui_impl_dx9.cpp and imgui_impl_dx9_state.h use. The device
+// keeps every piece of state it is given in a flat map (one key per render state, stage state,
+// binding, ...), so a test can compare the whole device before and after, see which keys a sequence
+// of calls touched, and what was bound at each draw. Bound objects are refcounted like COM objects:
+// Get* adds a reference. Objects the device creates live as long as the device.
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// Win32 widths: these are 32-bit on every Windows target, unlike `long` here.
+typedef uint32_t DWORD;
+typedef unsigned int UINT;
+typedef int32_t HRESULT;
+typedef int32_t LONG;
+typedef int INT;
+typedef int BOOL;
+typedef void* HANDLE;
+typedef struct HWND__* HWND;
+typedef DWORD D3DCOLOR;
+
+#define FALSE 0
+#define TRUE 1
+#define D3D_OK 0
+#define D3DERR_INVALIDCALL ((HRESULT)0x8876086C)
+#define D3DERR_DEVICELOST ((HRESULT)0x88760868)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define ZeroMemory(p, n) memset((p), 0, (n))
+
+struct RECT { LONG left, top, right, bottom; };
+struct D3DVIEWPORT9 { DWORD X, Y, Width, Height; float MinZ, MaxZ; };
+struct D3DMATRIX { union { float m[4][4]; float f[16]; }; };
+
+enum D3DRENDERSTATETYPE
+{
+    D3DRS_ZENABLE = 7, D3DRS_FILLMODE = 8, D3DRS_SHADEMODE = 9, D3DRS_ZWRITEENABLE = 14, D3DRS_ALPHATESTENABLE = 15,
+    D3DRS_SRCBLEND = 19, D3DRS_DESTBLEND = 20, D3DRS_CULLMODE = 22, D3DRS_ALPHABLENDENABLE = 27, D3DRS_FOGENABLE = 28,
+    D3DRS_SPECULARENABLE = 29, D3DRS_RANGEFOGENABLE = 48, D3DRS_STENCILENABLE = 52, D3DRS_TEXTUREFACTOR = 60,
+    D3DRS_WRAP0 = 128, D3DRS_CLIPPING = 136, D3DRS_LIGHTING = 137, D3DRS_BLENDOP = 171, D3DRS_SCISSORTESTENABLE = 174,
+    D3DRS_SEPARATEALPHABLENDENABLE = 206, D3DRS_SRCBLENDALPHA = 207, D3DRS_DESTBLENDALPHA = 208,
+};
+enum { D3DFILL_SOLID = 3 };
+enum { D3DSHADE_GOURAUD = 2 };
+enum { D3DCULL_NONE = 1 };
+enum { D3DBLENDOP_ADD = 1 };
+enum { D3DBLEND_ONE = 2, D3DBLEND_SRCALPHA = 5, D3DBLEND_INVSRCALPHA = 6 };
+
+enum D3DTEXTURESTAGESTATETYPE
+{
+    D3DTSS_COLOROP = 1, D3DTSS_COLORARG1 = 2, D3DTSS_COLORARG2 = 3, D3DTSS_ALPHAOP = 4, D3DTSS_ALPHAARG1 = 5, D3DTSS_ALPHAARG2 = 6,
+};
+enum { D3DTOP_DISABLE = 1, D3DTOP_MODULATE = 4 };
+enum { D3DTA_DIFFUSE = 0, D3DTA_TEXTURE = 2 };
+
+enum D3DSAMPLERSTATETYPE { D3DSAMP_ADDRESSU = 1, D3DSAMP_ADDRESSV = 2, D3DSAMP_MAGFILTER = 5, D3DSAMP_MINFILTER = 6 };
+enum { D3DTEXF_LINEAR = 2 };
+enum { D3DTADDRESS_CLAMP = 3 };
+
+enum D3DTRANSFORMSTATETYPE { D3DTS_VIEW = 2, D3DTS_PROJECTION = 3, D3DTS_WORLD = 256 };
+
+#define D3DFVF_XYZ 0x002
+#define D3DFVF_DIFFUSE 0x040
+#define D3DFVF_TEX1 0x100
+#define D3DUSAGE_WRITEONLY 0x00000008L
+#define D3DUSAGE_DYNAMIC 0x00000200L
+#define D3DUSAGE_QUERY_FILTER 0x00020000L
+#define D3DUSAGE_QUERY_POSTPIXELSHADER_BLENDING 0x00080000L
+#define D3DLOCK_DISCARD 0x00002000L
+#define D3DCREATE_PUREDEVICE 0x00000010L
+#define D3DCLEAR_TARGET 0x00000001L
+#define D3DPRESENT_INTERVAL_IMMEDIATE 0x80000000L
+#define D3DCOLOR_RGBA(r, g, b, a) ((D3DCOLOR)((((a) & 0xff) << 24) | (((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff)))
+
+enum D3DFORMAT { D3DFMT_UNKNOWN = 0, D3DFMT_A8R8G8B8 = 21, D3DFMT_A8B8G8R8 = 32, D3DFMT_D16 = 80, D3DFMT_INDEX16 = 101, D3DFMT_INDEX32 = 102 };
+enum D3DPOOL { D3DPOOL_DEFAULT = 0 };
+enum D3DPRIMITIVETYPE { D3DPT_TRIANGLELIST = 4 };
+enum D3DSTATEBLOCKTYPE { D3DSBT_ALL = 1 };
+enum D3DDEVTYPE { D3DDEVTYPE_HAL = 1 };
+enum D3DRESOURCETYPE { D3DRTYPE_TEXTURE = 3 };
+enum D3DSWAPEFFECT { D3DSWAPEFFECT_DISCARD = 1 };
+enum D3DBACKBUFFER_TYPE { D3DBACKBUFFER_TYPE_MONO = 0 };
+
+struct D3DDEVICE_CREATION_PARAMETERS { UINT AdapterOrdinal; D3DDEVTYPE DeviceType; HWND hFocusWindow; DWORD BehaviorFlags; };
+struct D3DDISPLAYMODE { UINT Width, Height, RefreshRate; D3DFORMAT Format; };
+struct D3DLOCKED_RECT { INT Pitch; void* pBits; };
+struct D3DPRESENT_PARAMETERS
+{
+    UINT BackBufferWidth, BackBufferHeight;
+    D3DFORMAT BackBufferFormat;
+    D3DSWAPEFFECT SwapEffect;
+    HWND hDeviceWindow;
+    BOOL Windowed;
+    BOOL EnableAutoDepthStencil;
+    D3DFORMAT AutoDepthStencilFormat;
+    UINT PresentationInterval;
+};
+
+struct MockUnknown
+{
+    int refs = 1;
+    virtual ~MockUnknown() = default;
+    unsigned long AddRef() { return ++refs; }
+    unsigned long Release() { return --refs; }
+};
+struct IDirect3DPixelShader9 : MockUnknown {};
+struct IDirect3DVertexShader9 : MockUnknown {};
+struct IDirect3DVertexDeclaration9 : MockUnknown {};
+struct IDirect3DSurface9 : MockUnknown {};
+
+struct MockBuffer : MockUnknown
+{
+    std::vector<uint8_t> bytes;
+    HRESULT Lock(UINT offset, UINT, void** data, DWORD)
+    {
+        *data = bytes.data() + offset;
+        return D3D_OK;
+    }
+    HRESULT Unlock() { return D3D_OK; }
+};
+struct IDirect3DVertexBuffer9 : MockBuffer {};
+struct IDirect3DIndexBuffer9 : MockBuffer {};
+
+struct IDirect3DBaseTexture9 : MockUnknown {};
+struct IDirect3DTexture9 : IDirect3DBaseTexture9
+{
+    UINT width = 0, height = 0;
+    std::vector<uint32_t> pixels;
+    HRESULT LockRect(UINT, D3DLOCKED_RECT* locked, const RECT* rect, DWORD)
+    {
+        locked->Pitch = (INT)(width * 4);
+        locked->pBits = pixels.data() + (rect ? rect->top * width + rect->left : 0);
+        return D3D_OK;
+    }
+    HRESULT UnlockRect(UINT) { return D3D_OK; }
+};
+
+struct IDirect3D9 : MockUnknown
+{
+    HRESULT CheckDeviceFormat(UINT, D3DDEVTYPE, D3DFORMAT, DWORD, D3DRESOURCETYPE, D3DFORMAT) { return D3D_OK; }
+};
+
+struct IDirect3DSwapChain9 : MockUnknown
+{
+    HRESULT GetBackBuffer(UINT, D3DBACKBUFFER_TYPE, IDirect3DSurface9**) { return D3DERR_INVALIDCALL; }
+    HRESULT Present(const RECT*, const RECT*, HWND, const void*, DWORD) { return D3D_OK; }
+};
+
+struct IDirect3DStateBlock9;
+
+typedef struct IDirect3D9* LPDIRECT3D9;
+typedef struct IDirect3DDevice9* LPDIRECT3DDEVICE9;
+typedef struct IDirect3DVertexBuffer9* LPDIRECT3DVERTEXBUFFER9;
+typedef struct IDirect3DIndexBuffer9* LPDIRECT3DINDEXBUFFER9;
+typedef struct IDirect3DTexture9* LPDIRECT3DTEXTURE9;
+typedef struct IDirect3DSurface9* LPDIRECT3DSURFACE9;
+
+struct IDirect3DDevice9 : MockUnknown
+{
+    using StateMap = std::map<std::string, std::string>;
+
+    StateMap state;
+    std::set<std::string> touched;  // Keys set while `recording`
+    bool recording = false;
+    std::string failGet;            // Get* on this key fails
+    DWORD behaviorFlags = 0;        // D3DCREATE_* the device was "created" with
+
+    // Every DrawIndexedPrimitive, with the state it drew with.
+    struct Draw
+    {
+        StateMap state;
+        UINT primitives;
+    };
+    std::vector<Draw> draws;
+    int stateBlocksCreated = 0;
+    std::vector<std::unique_ptr<MockUnknown>> created;
+
+    // Value of `key` in a state map (a snapshot or the device's own), zero if unset.
+    template <typename T>
+    static T Read(const StateMap& map, const std::string& key)
+    {
+        T value;
+        memset((void*)&value, 0, sizeof(T));
+        auto it = map.find(key);
+        if (it != map.end())
+            memcpy((void*)&value, it->second.data(), sizeof(T));
+        return value;
+    }
+
+    // D3D9 keeps FVF and vertex declaration as one piece of state: SetFVF binds an internal
+    // declaration, SetVertexDeclaration clears the FVF.
+    static IDirect3DVertexDeclaration9* FvfDeclaration()
+    {
+        static IDirect3DVertexDeclaration9 s_decl;
+        return &s_decl;
+    }
+
+    static std::string Key(const char* name, long a = 0, long b = 0)
+    {
+        return std::string(name) + ":" + std::to_string(a) + ":" + std::to_string(b);
+    }
+
+    HRESULT SetRenderState(D3DRENDERSTATETYPE s, DWORD v) { return Set(Key("RS", s), v); }
+    HRESULT GetRenderState(D3DRENDERSTATETYPE s, DWORD* v) { return Get(Key("RS", s), v); }
+    HRESULT SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE t, DWORD v) { return Set(Key("TSS", stage, t), v); }
+    HRESULT GetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE t, DWORD* v) { return Get(Key("TSS", stage, t), v); }
+    HRESULT SetSamplerState(DWORD s, D3DSAMPLERSTATETYPE t, DWORD v) { return Set(Key("SS", s, t), v); }
+    HRESULT GetSamplerState(DWORD s, D3DSAMPLERSTATETYPE t, DWORD* v) { return Get(Key("SS", s, t), v); }
+
+    HRESULT SetPixelShader(IDirect3DPixelShader9* p) { return Set("PS", p); }
+    HRESULT GetPixelShader(IDirect3DPixelShader9** p) { return GetRef("PS", p); }
+    HRESULT SetVertexShader(IDirect3DVertexShader9* p) { return Set("VS", p); }
+    HRESULT GetVertexShader(IDirect3DVertexShader9** p) { return GetRef("VS", p); }
+
+    HRESULT SetFVF(DWORD fvf)
+    {
+        Set("FVF", fvf);
+        return Set("DECL", FvfDeclaration());
+    }
+    HRESULT GetFVF(DWORD* fvf) { return Get("FVF", fvf); }
+    HRESULT SetVertexDeclaration(IDirect3DVertexDeclaration9* decl)
+    {
+        Set("FVF", (DWORD)0);
+        return Set("DECL", decl);
+    }
+    HRESULT GetVertexDeclaration(IDirect3DVertexDeclaration9** decl) { return GetRef("DECL", decl); }
+
+    struct Stream
+    {
+        IDirect3DVertexBuffer9* buffer;
+        UINT offset, stride;
+    };
+    HRESULT SetStreamSource(UINT n, IDirect3DVertexBuffer9* vb, UINT offset, UINT stride) { return Set(Key("STREAM", n), Stream{ vb, offset, stride }); }
+    HRESULT GetStreamSource(UINT n, IDirect3DVertexBuffer9** vb, UINT* offset, UINT* stride)
+    {
+        Stream s;
+        const HRESULT hr = Get(Key("STREAM", n), &s);
+        *vb = s.buffer;
+        *offset = s.offset;
+        *stride = s.stride;
+        if (*vb)
+            (*vb)->AddRef();
+        return hr;
+    }
+
+    HRESULT SetIndices(IDirect3DIndexBuffer9* ib) { return Set("IB", ib); }
+    HRESULT GetIndices(IDirect3DIndexBuffer9** ib) { return GetRef("IB", ib); }
+    HRESULT SetTexture(DWORD stage, IDirect3DBaseTexture9* tex) { return Set(Key("TEX", stage), tex); }
+    HRESULT GetTexture(DWORD stage, IDirect3DBaseTexture9** tex) { return GetRef(Key("TEX", stage), tex); }
+
+    HRESULT SetViewport(const D3DVIEWPORT9* vp) { return Set("VP", *vp); }
+    HRESULT GetViewport(D3DVIEWPORT9* vp) { return Get("VP", vp); }
+    HRESULT SetScissorRect(const RECT* r) { return Set("SCISSOR", *r); }
+    HRESULT GetScissorRect(RECT* r) { return Get("SCISSOR", r); }
+    HRESULT SetTransform(D3DTRANSFORMSTATETYPE t, const D3DMATRIX* m) { return Set(Key("XF", t), *m); }
+    HRESULT GetTransform(D3DTRANSFORMSTATETYPE t, D3DMATRIX* m) { return Get(Key("XF", t), m); }
+
+    HRESULT DrawIndexedPrimitive(D3DPRIMITIVETYPE, INT, UINT, UINT, UINT, UINT primitives)
+    {
+        draws.push_back({ state, primitives });
+        return D3D_OK;
+    }
+
+    HRESULT CreateVertexBuffer(UINT length, DWORD, DWORD, D3DPOOL, IDirect3DVertexBuffer9** out, HANDLE*) { return CreateBuffer(length, out); }
+    HRESULT CreateIndexBuffer(UINT length, DWORD, D3DFORMAT, D3DPOOL, IDirect3DIndexBuffer9** out, HANDLE*) { return CreateBuffer(length, out); }
+    HRESULT CreateTexture(UINT width, UINT height, UINT, DWORD, D3DFORMAT, D3DPOOL, IDirect3DTexture9** out, HANDLE*)
+    {
+        IDirect3DTexture9* texture = Create<IDirect3DTexture9>();
+        texture->width = width;
+        texture->height = height;
+        texture->pixels.resize((size_t)width * height);
+        *out = texture;
+        return D3D_OK;
+    }
+    HRESULT CreateStateBlock(D3DSTATEBLOCKTYPE, IDirect3DStateBlock9** out);
+
+    HRESULT GetDirect3D(IDirect3D9** out)
+    {
+        static IDirect3D9 s_d3d;
+        s_d3d.AddRef();
+        *out = &s_d3d;
+        return D3D_OK;
+    }
+    HRESULT GetCreationParameters(D3DDEVICE_CREATION_PARAMETERS* params)
+    {
+        *params = { 0, D3DDEVTYPE_HAL, nullptr, behaviorFlags };
+        return D3D_OK;
+    }
+    HRESULT GetDisplayMode(UINT, D3DDISPLAYMODE* mode)
+    {
+        *mode = { 1920, 1080, 60, D3DFMT_A8R8G8B8 };
+        return D3D_OK;
+    }
+
+    // Multi-viewport only; the tests don't open platform windows.
+    HRESULT CreateAdditionalSwapChain(D3DPRESENT_PARAMETERS*, IDirect3DSwapChain9**) { return D3DERR_INVALIDCALL; }
+    HRESULT GetRenderTarget(DWORD, IDirect3DSurface9**) { return D3DERR_INVALIDCALL; }
+    HRESULT GetDepthStencilSurface(IDirect3DSurface9**) { return D3DERR_INVALIDCALL; }
+    HRESULT SetRenderTarget(DWORD, IDirect3DSurface9*) { return D3DERR_INVALIDCALL; }
+    HRESULT SetDepthStencilSurface(IDirect3DSurface9*) { return D3DERR_INVALIDCALL; }
+    HRESULT Clear(DWORD, const void*, DWORD, D3DCOLOR, float, DWORD) { return D3D_OK; }
+
+private:
+    template <typename T>
+    T* Create()
+    {
+        created.push_back(std::make_unique<T>());
+        return static_cast<T*>(created.back().get());
+    }
+
+    template <typename T>
+    HRESULT CreateBuffer(UINT length, T** out)
+    {
+        T* buffer = Create<T>();
+        buffer->bytes.resize(length);
+        *out = buffer;
+        return D3D_OK;
+    }
+
+    template <typename T>
+    HRESULT Set(const std::string& key, const T& value)
+    {
+        state[key] = std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+        if (recording)
+            touched.insert(key);
+        return D3D_OK;
+    }
+
+    // Unset state reads as zero, like a freshly created device.
+    template <typename T>
+    HRESULT Get(const std::string& key, T* out)
+    {
+        memset((void*)out, 0, sizeof(T));
+        if (key == failGet)
+            return D3DERR_INVALIDCALL;
+        auto it = state.find(key);
+        if (it != state.end())
+            memcpy((void*)out, it->second.data(), sizeof(T));
+        return D3D_OK;
+    }
+
+    template <typename T>
+    HRESULT GetRef(const std::string& key, T** out)
+    {
+        const HRESULT hr = Get(key, out);
+        if (*out)
+            (*out)->AddRef();
+        return hr;
+    }
+};
+
+// D3DSBT_ALL block: the whole state map, as of the last Capture().
+struct IDirect3DStateBlock9 : MockUnknown
+{
+    IDirect3DDevice9* device = nullptr;
+    IDirect3DDevice9::StateMap captured;
+
+    HRESULT Capture()
+    {
+        captured = device->state;
+        return D3D_OK;
+    }
+    HRESULT Apply()
+    {
+        if (device->recording)
+        {
+            for (const auto& entry : captured)
+                device->touched.insert(entry.first);
+        }
+        device->state = captured;
+        return D3D_OK;
+    }
+};
+
+inline HRESULT IDirect3DDevice9::CreateStateBlock(D3DSTATEBLOCKTYPE, IDirect3DStateBlock9** out)
+{
+    IDirect3DStateBlock9* block = Create<IDirect3DStateBlock9>();
+    block->device = this;
+    block->Capture();
+    stateBlocksCreated++;
+    *out = block;
+    return D3D_OK;
+}
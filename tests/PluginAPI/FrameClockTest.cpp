@@ -0,0 +1,108 @@
+#include "Test.h"
+#include "FrameClock.h"
+#include <cmath>
+#include <random>
+
+TEST(FirstTickOnlyStartsTheClock)
+{
+    FrameDeltaSmoother smoother;
+    CHECK(!smoother.Tick(1000000));
+    CHECK_EQ(smoother.GetDelta(), 0.0);
+    CHECK(smoother.Tick(1016667));
+    CHECK(std::abs(smoother.GetDelta() - 0.016667) < 1e-9);
+    CHECK_EQ(smoother.GetSmoothedDelta(), smoother.GetDelta());
+}
+
+TEST(SmoothedDeltaFollowsJitteryFrames)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> jitter(0.0, 1000.0);
+    FrameDeltaSmoother smoother;
+    int64_t now = 0;
+    smoother.Tick(now);
+    for (int i = 0; i < 300; ++i)
+        smoother.Tick(now += 16667 + (int64_t)jitter(rng));
+    CHECK(std::abs(smoother.GetSmoothedDelta() - 1.0 / 60.0) < 0.002);
+}
+
+TEST(SpikesAreBoundedAndLongGapsCapped)
+{
+    FrameDeltaSmoother smoother;
+    int64_t now = 0;
+    smoother.Tick(now);
+    for (int i = 0; i < 100; ++i)
+        smoother.Tick(now += 16667);
+    const double before = smoother.GetSmoothedDelta();
+
+    // A 200 ms hitch counts in full as the raw delta, but moves the average only a little.
+    smoother.Tick(now += 200000);
+    CHECK(std::abs(smoother.GetDelta() - 0.2) < 1e-9);
+    CHECK(smoother.GetSmoothedDelta() <= before * (1.0 + (FrameDeltaSmoother::kSpikeFactor - 1.0) * FrameDeltaSmoother::kWeight) + 1e-9);
+
+    smoother.Tick(now += 5000000);
+    CHECK_EQ(smoother.GetDelta(), FrameDeltaSmoother::kMaxDelta);
+
+    // Time going backwards (timer reset) is a zero-length frame.
+    smoother.Tick(now - 1000);
+    CHECK_EQ(smoother.GetDelta(), 0.0);
+}
+
+TEST(SmoothedDeltaConvergesAfterARateChange)
+{
+    FrameDeltaSmoother smoother;
+    int64_t now = 0;
+    smoother.Tick(now);
+    for (int i = 0; i < 100; ++i)
+        smoother.Tick(now += 16667);
+    for (int i = 0; i < 100; ++i)
+        smoother.Tick(now += 50000);
+    CHECK(std::abs(smoother.GetSmoothedDelta() - 0.05) < 0.001);
+
+    smoother.Reset();
+    CHECK(!smoother.Tick(now));
+    CHECK_EQ(smoother.GetSmoothedDelta(), 0.0);
+}
+
+// The point of the accumulator: the same total time gives the same number of steps however it is
+// split into frames.
+TEST(StepCountDoesNotDependOnFrameSplits)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> frame(0.002, 0.04);
+    const double step = 1.0 / 120.0;
+    for (int run = 0; run < 50; ++run)
+    {
+        FixedStepAccumulator jittery(step, 1000), steady(step, 1000);
+        int jitterySteps = 0, steadySteps = 0;
+        double total = 0.0;
+        while (total < 10.0)
+        {
+            const double delta = frame(rng);
+            total += delta;
+            jitterySteps += jittery.Advance(delta);
+            CHECK(jittery.Alpha() >= 0.0 && jittery.Alpha() < 1.0 + 1e-9);
+        }
+
+        const int frames = (int)(total * 60.0);
+        for (int i = 0; i < frames; ++i)
+            steadySteps += steady.Advance(1.0 / 60.0);
+        steadySteps += steady.Advance(total - frames / 60.0);
+
+        CHECK(std::abs(jitterySteps - steadySteps) <= 1);
+        CHECK(std::abs(jitterySteps - (int)std::floor(total / step)) <= 1);
+    }
+}
+
+TEST(HitchesDropTimeBeyondMaxSteps)
+{
+    FixedStepAccumulator accumulator(0.01, 8);
+    CHECK_EQ(accumulator.Advance(1.0), 8);
+    CHECK(accumulator.Alpha() < 1.0);
+    CHECK_EQ(accumulator.Advance(0.0), 0);
+    CHECK_EQ(accumulator.Advance(-1.0), 0);
+
+    accumulator.Reset();
+    CHECK_EQ(accumulator.Alpha(), 0.0);
+    CHECK_EQ(accumulator.Advance(0.025), 2);
+    CHECK(std::abs(accumulator.Alpha() - 0.5) < 1e-9);
+}
@@ -0,0 +1,442 @@
+#include "Test.h"
+#include "HotkeyMatcher.h"
+#include "HotkeyRegistry.h"
+#include "KeyBind.h"
+#include <vector>
+
+// Scripted input through HotkeyMatcher (snapshots and explicit timestamps) and through
+// HotkeyRegistry (window messages, the pad provider and mock/Windows.h's hand-advanced tick count).
+namespace
+{
+    constexpr uint32_t kVkF1 = 0x70, kVkF2 = 0x71, kVkF5 = 0x74;
+    constexpr uint32_t kVkT = 'T';
+    constexpr uint32_t kAllEvents = HotkeyMatchEvents::Pressed | HotkeyMatchEvents::Released | HotkeyMatchEvents::Held;
+    constexpr uint32_t kBothTriggers = KeyBind::PAD_L_TRIGGER | KeyBind::PAD_R_TRIGGER;
+
+    struct Recorder
+    {
+        std::vector<HotkeyMatcher::Event> events;
+
+        void Frame(HotkeyMatcher& matcher, KeyStateTracker& keys, uint64_t nowMs)
+        {
+            events.clear();
+            matcher.Match(keys.TakeSnapshot(), nowMs, [this](const HotkeyMatcher::Event& e) { events.push_back(e); });
+        }
+        bool Saw(uint32_t id, uint32_t event) const
+        {
+            for (const auto& e : events)
+                if (e.id == id && e.event == event)
+                    return true;
+            return false;
+        }
+    };
+
+    HotkeyChord Key(uint32_t vk, bool ctrl = false, bool shift = false, bool alt = false, bool strict = false)
+    {
+        HotkeyChord chord;
+        chord.keyboardKey = vk;
+        chord.ctrl = ctrl;
+        chord.shift = shift;
+        chord.alt = alt;
+        chord.strict = strict;
+        return chord;
+    }
+}
+
+TEST(TapBetweenFramesIsReported)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t id = matcher.Add(Key(kVkF5), kAllEvents);
+
+    // Down and up before the next frame samples.
+    keys.SetKey(kVkF5, true);
+    keys.SetKey(kVkF5, false);
+    frame.Frame(matcher, keys, 100);
+    CHECK_EQ(frame.events.size(), 1u);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Pressed));
+
+    frame.Frame(matcher, keys, 116);
+    CHECK_EQ(frame.events.size(), 1u);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Released));
+    CHECK_EQ(frame.events[0].heldMs, 16u);
+
+    frame.Frame(matcher, keys, 132);
+    CHECK(frame.events.empty());
+}
+
+TEST(HeldReportsDurationEveryFrame)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t id = matcher.Add(Key(kVkF5), kAllEvents);
+
+    keys.SetKey(kVkF5, true);
+    frame.Frame(matcher, keys, 1000);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Pressed));
+    CHECK(matcher.IsDown(id));
+    for (uint64_t t = 1016; t <= 1048; t += 16)
+    {
+        frame.Frame(matcher, keys, t);
+        REQUIRE(frame.events.size() == 1);
+        CHECK_EQ(frame.events[0].event, HotkeyMatchEvents::Held);
+        CHECK_EQ(frame.events[0].heldMs, t - 1000);
+    }
+    keys.SetKey(kVkF5, false);
+    frame.Frame(matcher, keys, 1064);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Released));
+    CHECK_EQ(frame.events[0].heldMs, 64u);
+    CHECK(!matcher.IsDown(id));
+}
+
+TEST(EventMaskFiltersEvents)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t id = matcher.Add(Key(kVkF5), HotkeyMatchEvents::Released);
+
+    keys.SetKey(kVkF5, true);
+    frame.Frame(matcher, keys, 0);
+    frame.Frame(matcher, keys, 16);
+    CHECK(frame.events.empty());
+    CHECK(matcher.IsDown(id));
+    keys.SetKey(kVkF5, false);
+    frame.Frame(matcher, keys, 32);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Released));
+}
+
+TEST(StrictModifiersMustMatchExactly)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t loose = matcher.Add(Key(kVkT, true), HotkeyMatchEvents::Pressed);
+    const uint32_t strict = matcher.Add(Key(kVkT, true, false, false, true), HotkeyMatchEvents::Pressed);
+    const uint32_t bare = matcher.Add(Key(kVkT, false, false, false, true), HotkeyMatchEvents::Pressed);
+
+    // Ctrl+Shift+T: "at least Ctrl" matches, "exactly Ctrl" doesn't.
+    keys.SetKey(0xA2, true); // Left Ctrl
+    keys.SetKey(0xA1, true); // Right Shift
+    keys.SetKey(kVkT, true);
+    frame.Frame(matcher, keys, 0);
+    CHECK(frame.Saw(loose, HotkeyMatchEvents::Pressed));
+    CHECK(!frame.Saw(strict, HotkeyMatchEvents::Pressed));
+    CHECK(!frame.Saw(bare, HotkeyMatchEvents::Pressed));
+
+    // Shift let go with T and Ctrl still held: now the strict bind matches too.
+    keys.SetKey(0xA1, false);
+    frame.Frame(matcher, keys, 16);
+    CHECK(frame.Saw(strict, HotkeyMatchEvents::Pressed));
+    CHECK(!frame.Saw(bare, HotkeyMatchEvents::Pressed));
+
+    // Bare T with strict matching needs every modifier up.
+    keys.SetKey(kVkT, false);
+    keys.SetKey(0xA2, false);
+    frame.Frame(matcher, keys, 32);
+    keys.SetKey(kVkT, true);
+    frame.Frame(matcher, keys, 48);
+    CHECK(frame.Saw(bare, HotkeyMatchEvents::Pressed));
+    CHECK(!frame.Saw(loose, HotkeyMatchEvents::Pressed));
+}
+
+TEST(TriggerPseudoKeysNeedBothTriggers)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    HotkeyChord chord;
+    chord.controllerKey = kBothTriggers;
+    const uint32_t id = matcher.Add(chord, kAllEvents);
+
+    keys.SetPadButtons(KeyBind::PAD_L_TRIGGER);
+    frame.Frame(matcher, keys, 0);
+    CHECK(frame.events.empty());
+
+    keys.SetPadButtons(kBothTriggers | XINPUT_GAMEPAD_A);
+    frame.Frame(matcher, keys, 16);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Pressed));
+    frame.Frame(matcher, keys, 516);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Held));
+    CHECK_EQ(frame.events[0].heldMs, 500u);
+
+    keys.SetPadButtons(KeyBind::PAD_R_TRIGGER);
+    frame.Frame(matcher, keys, 532);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Released));
+    CHECK_EQ(frame.events[0].heldMs, 516u);
+}
+
+TEST(RebindWhileHeldWaitsForRelease)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t id = matcher.Add(Key(kVkF1), kAllEvents);
+
+    // The key that was just captured in the UI is still down when the bind changes to it.
+    keys.SetKey(kVkF2, true);
+    frame.Frame(matcher, keys, 0);
+    CHECK(frame.events.empty());
+    CHECK(matcher.SetChord(id, Key(kVkF2)));
+    frame.Frame(matcher, keys, 16);
+    frame.Frame(matcher, keys, 32);
+    CHECK(frame.events.empty());
+    CHECK(!matcher.IsDown(id));
+
+    keys.SetKey(kVkF2, false);
+    frame.Frame(matcher, keys, 48);
+    CHECK(frame.events.empty());
+    keys.SetKey(kVkF2, true);
+    frame.Frame(matcher, keys, 64);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Pressed));
+
+    // Setting the same chord again is not a rebind: the held key keeps reporting.
+    CHECK(matcher.SetChord(id, Key(kVkF2)));
+    frame.Frame(matcher, keys, 80);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Held));
+}
+
+TEST(RebindWhileOldChordHeldReleasesSilently)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t id = matcher.Add(Key(kVkF1), kAllEvents);
+
+    keys.SetKey(kVkF1, true);
+    frame.Frame(matcher, keys, 0);
+    CHECK(frame.Saw(id, HotkeyMatchEvents::Pressed));
+    CHECK(matcher.SetChord(id, Key(kVkF2)));
+    keys.SetKey(kVkF1, false);
+    frame.Frame(matcher, keys, 16);
+    CHECK(frame.events.empty());
+    CHECK(!matcher.IsDown(id));
+}
+
+TEST(RemovedBindStopsReporting)
+{
+    HotkeyMatcher matcher;
+    KeyStateTracker keys;
+    Recorder frame;
+    const uint32_t a = matcher.Add(Key(kVkF1), kAllEvents);
+    const uint32_t b = matcher.Add(Key(kVkF1), kAllEvents);
+    CHECK(a != 0 && b != 0 && a != b);
+
+    CHECK(matcher.Remove(a));
+    CHECK(!matcher.Remove(a));
+    CHECK_EQ(matcher.GetCount(), 1u);
+    keys.SetKey(kVkF1, true);
+    frame.Frame(matcher, keys, 0);
+    CHECK_EQ(frame.events.size(), 1u);
+    CHECK(frame.Saw(b, HotkeyMatchEvents::Pressed));
+}
+
+// --- HotkeyRegistry ---
+
+namespace
+{
+    constexpr LPARAM kLeftShiftScan = 0x2A << 16;
+    constexpr LPARAM kRightShiftScan = 0x36 << 16;
+    constexpr LPARAM kExtended = 1 << 24;
+
+    XINPUT_STATE g_Pad{};
+    bool g_PadConnected = false;
+
+    struct Calls
+    {
+        std::vector<HotkeyEventInfo> events;
+        HotkeyRegistry* unregisterFrom = nullptr;
+
+        static void Record(void* userData, const HotkeyEventInfo& info)
+        {
+            auto* self = static_cast<Calls*>(userData);
+            self->events.push_back(info);
+            if (self->unregisterFrom)
+                self->unregisterFrom->Unregister(info.handle);
+        }
+    };
+
+    HotkeyDesc Desc(uint32_t vk, Calls& calls, uint32_t events = HotkeyEvents::Pressed | HotkeyEvents::Released)
+    {
+        HotkeyDesc desc;
+        desc.keyboardKey = vk;
+        desc.events = events;
+        desc.callback = &Calls::Record;
+        desc.userData = &calls;
+        return desc;
+    }
+
+    void Key(HotkeyRegistry& registry, uint32_t vk, bool down, LPARAM lParam = 0)
+    {
+        registry.OnWindowMessage(down ? WM_KEYDOWN : WM_KEYUP, vk, lParam);
+    }
+
+    struct PadProvider
+    {
+        PadProvider()
+        {
+            KeyBind::SetInputProvider([](DWORD, XINPUT_STATE* state) {
+                *state = g_Pad;
+                return g_PadConnected;
+            });
+        }
+        ~PadProvider()
+        {
+            KeyBind::SetInputProvider(nullptr);
+            g_Pad = {};
+            g_PadConnected = false;
+        }
+    };
+}
+
+TEST(RegistryMatchesKeyMessages)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    HotkeyDesc desc = Desc(kVkT, calls);
+    desc.ctrl = true;
+    const HotkeyHandle handle = registry.Register(nullptr, desc);
+
+    g_MockTickCount = 5000;
+    // Generic VK_CONTROL messages: the registry records which side from the extended bit.
+    Key(registry, VK_CONTROL, true, kExtended);
+    Key(registry, kVkT, true);
+    registry.Poll();
+    REQUIRE(calls.events.size() == 1);
+    CHECK_EQ(calls.events[0].handle, handle);
+    CHECK_EQ(calls.events[0].event, HotkeyEvents::Pressed);
+    CHECK(registry.IsDown(handle));
+
+    g_MockTickCount = 5250;
+    Key(registry, kVkT, false);
+    registry.Poll();
+    REQUIRE(calls.events.size() == 2);
+    CHECK_EQ(calls.events[1].event, HotkeyEvents::Released);
+    CHECK_EQ(calls.events[1].heldMs, 250u);
+}
+
+TEST(RegistryTracksModifiersPerSide)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    HotkeyDesc desc = Desc(kVkF5, calls);
+    desc.shift = true;
+    const HotkeyHandle handle = registry.Register(nullptr, desc);
+
+    // Both Shifts down, left one released: Shift is still held.
+    Key(registry, VK_SHIFT, true, kLeftShiftScan);
+    Key(registry, VK_SHIFT, true, kRightShiftScan);
+    Key(registry, VK_SHIFT, false, kLeftShiftScan);
+    Key(registry, kVkF5, true);
+    registry.Poll();
+    CHECK(registry.IsDown(handle));
+
+    Key(registry, VK_SHIFT, false, kRightShiftScan);
+    registry.Poll();
+    CHECK(!registry.IsDown(handle));
+}
+
+TEST(RegistryReleasesEverythingOnFocusLoss)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    const HotkeyHandle handle = registry.Register(nullptr, Desc(kVkF5, calls));
+
+    Key(registry, kVkF5, true);
+    registry.Poll();
+    CHECK(registry.IsDown(handle));
+
+    // Alt-tabbed away: the key-up goes to another window.
+    registry.OnWindowMessage(WM_KILLFOCUS, 0, 0);
+    registry.Poll();
+    CHECK(!registry.IsDown(handle));
+    REQUIRE(calls.events.size() == 2);
+    CHECK_EQ(calls.events[1].event, HotkeyEvents::Released);
+
+    // Nothing arrives while unfocused, so keyboard binds stay quiet until focus comes back.
+    registry.Poll();
+    CHECK_EQ(calls.events.size(), 2u);
+}
+
+TEST(RegistryMatchesTriggersFromPadProvider)
+{
+    PadProvider provider;
+    HotkeyRegistry registry;
+    Calls calls;
+    HotkeyDesc desc = Desc(0, calls);
+    desc.controllerKey = kBothTriggers;
+    const HotkeyHandle handle = registry.Register(nullptr, desc);
+
+    g_PadConnected = true;
+    g_Pad.Gamepad.bLeftTrigger = 255;
+    g_Pad.Gamepad.bRightTrigger = XINPUT_GAMEPAD_TRIGGER_THRESHOLD; // At the threshold: not pulled
+    registry.Poll();
+    CHECK(calls.events.empty());
+
+    g_Pad.Gamepad.bRightTrigger = XINPUT_GAMEPAD_TRIGGER_THRESHOLD + 1;
+    registry.Poll();
+    REQUIRE(calls.events.size() == 1);
+    CHECK_EQ(calls.events[0].event, HotkeyEvents::Pressed);
+
+    // Pad unplugged mid-hold.
+    g_PadConnected = false;
+    registry.Poll();
+    CHECK(!registry.IsDown(handle));
+}
+
+TEST(RegistryUpdateWhileHeldWaitsForRelease)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    const HotkeyHandle handle = registry.Register(nullptr, Desc(kVkF1, calls));
+
+    Key(registry, kVkF2, true);
+    registry.Poll();
+    CHECK(registry.Update(handle, Desc(kVkF2, calls)));
+    registry.Poll();
+    CHECK(calls.events.empty());
+
+    Key(registry, kVkF2, false);
+    registry.Poll();
+    Key(registry, kVkF2, true);
+    registry.Poll();
+    REQUIRE(calls.events.size() == 1);
+    CHECK_EQ(calls.events[0].event, HotkeyEvents::Pressed);
+
+    CHECK(!registry.Update(handle + 100, Desc(kVkF2, calls)));
+}
+
+TEST(RegistryCallbackMayUnregisterItself)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    calls.unregisterFrom = &registry;
+    const HotkeyHandle handle = registry.Register(nullptr, Desc(kVkF5, calls));
+
+    Key(registry, kVkF5, true);
+    registry.Poll();
+    CHECK_EQ(calls.events.size(), 1u);
+    CHECK(!registry.IsDown(handle));
+
+    Key(registry, kVkF5, false);
+    registry.Poll();
+    CHECK_EQ(calls.events.size(), 1u);
+}
+
+TEST(RegistryRemovesAPluginsHotkeys)
+{
+    HotkeyRegistry registry;
+    Calls calls;
+    auto* pluginA = reinterpret_cast<IPlugin*>(0x1000);
+    auto* pluginB = reinterpret_cast<IPlugin*>(0x2000);
+    registry.Register(pluginA, Desc(kVkF1, calls));
+    const HotkeyHandle kept = registry.Register(pluginB, Desc(kVkF1, calls));
+
+    registry.RemovePlugin(pluginA);
+    Key(registry, kVkF1, true);
+    registry.Poll();
+    REQUIRE(calls.events.size() == 1);
+    CHECK_EQ(calls.events[0].handle, kept);
+}
@@ -0,0 +1,191 @@
+#include "Test.h"
+#include "PluginLifecycle.h"
+#include <initializer_list>
+#include <string>
+
+// Mock plugins A-D: B holds A's interface and A holds C's (twice), so a request for C takes B, A and
+// C down in that order. D is unrelated.
+namespace
+{
+    using Stage = PluginLifecycle::Stage;
+    using Action = PluginLifecycle::Action;
+
+    void AddChain(PluginLifecycle& lc)
+    {
+        for (const char* name : { "A", "B", "C", "D" })
+            lc.AddPlugin(name);
+        lc.AddInterfaceRef("A", "C");
+        lc.AddInterfaceRef("B", "A");
+        lc.AddInterfaceRef("A", "C");
+    }
+
+    void DetachAll(PluginLifecycle& lc, int64_t nowMs)
+    {
+        for (std::string name = lc.NextToDetach(); !name.empty(); name = lc.NextToDetach())
+            lc.OnDetached(name, nowMs);
+    }
+
+    // Samples every quiescing plugin the way the loader thread does, `busy` deciding per plugin.
+    template <typename Busy>
+    void Sample(PluginLifecycle& lc, int64_t nowMs, Busy&& busy)
+    {
+        for (const char* name : { "A", "B", "C", "D" })
+        {
+            if (lc.NeedsSample(name, nowMs))
+                lc.OnQuiescenceSample(name, busy(name), nowMs);
+        }
+    }
+}
+
+TEST(InterfaceRefsAreCountedPerTarget)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    CHECK_EQ(lc.GetInterfaceRefs("C"), 2u);
+    CHECK_EQ(lc.GetInterfaceRefs("A"), 1u);
+    CHECK_EQ(lc.GetInterfaceRefs("B"), 0u);
+
+    // Self-references and unknown plugins are ignored.
+    lc.AddInterfaceRef("A", "A");
+    lc.AddInterfaceRef("X", "A");
+    CHECK_EQ(lc.GetInterfaceRefs("A"), 1u);
+}
+
+TEST(HoldersDetachBeforeTheirTargets)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    REQUIRE(lc.Request("C", Action::Reload));
+    CHECK(lc.IsBusy());
+
+    std::string error;
+    CHECK(!lc.Request("D", Action::Unload, &error));
+    CHECK(!error.empty());
+    CHECK(!lc.Request("Nope", Action::Unload));
+
+    CHECK_EQ(lc.NextToDetach(), std::string("B"));
+    lc.OnDetached("B", 0);
+    CHECK_EQ(lc.NextToDetach(), std::string("A"));
+    lc.OnDetached("A", 0);
+    CHECK_EQ(lc.NextToDetach(), std::string("C"));
+    lc.OnDetached("C", 0);
+    CHECK(lc.NextToDetach().empty());
+    CHECK_EQ(lc.GetStage("D"), Stage::Active);
+}
+
+TEST(ReloadFreesHoldersFirstAndLoadsTargetsFirst)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    REQUIRE(lc.Request("C", Action::Reload));
+    DetachAll(lc, 0);
+
+    // A is still running code for two samples; B and C are clean from the start.
+    int64_t now = 0;
+    for (int i = 0; i < 3; ++i)
+        Sample(lc, now += 50, [&](const std::string& name) { return name == "A" && i < 2; });
+    CHECK_EQ(lc.GetStage("B"), Stage::Free);
+    CHECK_EQ(lc.GetStage("C"), Stage::Free);
+    CHECK_EQ(lc.GetStage("A"), Stage::Quiescing);
+
+    CHECK_EQ(lc.NextToFree(), std::string("B"));
+    lc.OnFreed("B");
+    // C's holder A is still on its way down.
+    CHECK(lc.NextToFree().empty());
+
+    for (int i = 0; i < 3; ++i)
+        Sample(lc, now += 50, [](const std::string&) { return false; });
+    CHECK_EQ(lc.NextToFree(), std::string("A"));
+    lc.OnFreed("A");
+    CHECK(lc.NextToLoad().empty()); // Nothing loads while C is still up
+    CHECK_EQ(lc.NextToFree(), std::string("C"));
+    lc.OnFreed("C");
+
+    CHECK_EQ(lc.NextToLoad(), std::string("C"));
+    lc.OnLoaded("C", true);
+    CHECK_EQ(lc.NextToLoad(), std::string("A"));
+    lc.OnLoaded("A", true);
+    CHECK_EQ(lc.NextToLoad(), std::string("B"));
+    lc.OnLoaded("B", false);
+
+    CHECK(!lc.Has("B"));
+    CHECK(!lc.IsBusy());
+    CHECK_EQ(lc.GetStage("A"), Stage::Active);
+    // Reloaded plugins ask for interfaces again; the old refs are gone.
+    CHECK_EQ(lc.GetInterfaceRefs("C"), 0u);
+}
+
+TEST(UnloadForgetsThePlugins)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    REQUIRE(lc.Request("A", Action::Unload));
+    DetachAll(lc, 0);
+    for (int64_t now = 50; now <= 150; now += 50)
+        Sample(lc, now, [](const std::string&) { return false; });
+    for (std::string name = lc.NextToFree(); !name.empty(); name = lc.NextToFree())
+        lc.OnFreed(name);
+
+    CHECK(!lc.Has("A"));
+    CHECK(!lc.Has("B"));
+    CHECK(lc.Has("C"));
+    CHECK_EQ(lc.GetInterfaceRefs("C"), 0u);
+    CHECK(lc.NextToLoad().empty());
+    CHECK(!lc.IsBusy());
+}
+
+TEST(RefusedDetachKeepsTheRestActive)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    REQUIRE(lc.Request("C", Action::Unload));
+    CHECK_EQ(lc.NextToDetach(), std::string("B"));
+    lc.OnDetached("B", 0);
+    CHECK_EQ(lc.NextToDetach(), std::string("A"));
+    lc.OnDetachRefused("A");
+
+    CHECK_EQ(lc.GetStage("A"), Stage::Active);
+    CHECK_EQ(lc.GetStage("C"), Stage::Active);
+    // B already detached and carries on down.
+    CHECK_EQ(lc.GetStage("B"), Stage::Quiescing);
+    CHECK(lc.IsBusy());
+}
+
+// A sample that finds a thread inside the module (instruction pointer or any return address on its
+// stack) starts the clean count over.
+TEST(BusySampleRestartsTheCleanCount)
+{
+    PluginLifecycle lc;
+    lc.AddPlugin("D");
+    REQUIRE(lc.Request("D", Action::Unload));
+    lc.OnDetached("D", 1000);
+
+    CHECK(lc.NeedsSample("D", 1000));
+    CHECK_EQ(lc.OnQuiescenceSample("D", false, 1000), Stage::Quiescing);
+    CHECK(!lc.NeedsSample("D", 1049));
+    CHECK_EQ(lc.OnQuiescenceSample("D", false, 1050), Stage::Quiescing);
+    CHECK_EQ(lc.OnQuiescenceSample("D", true, 1100), Stage::Quiescing);
+    CHECK_EQ(lc.OnQuiescenceSample("D", false, 1150), Stage::Quiescing);
+    CHECK_EQ(lc.OnQuiescenceSample("D", false, 1200), Stage::Quiescing);
+    CHECK_EQ(lc.OnQuiescenceSample("D", false, 1250), Stage::Free);
+}
+
+TEST(StayingBusyTimesOutAndUnblocksTheNextRequest)
+{
+    PluginLifecycle lc;
+    AddChain(lc);
+    PluginLifecycle::QuiescencePolicy policy;
+    policy.timeoutMs = 1000;
+    lc.SetPolicy(policy);
+
+    REQUIRE(lc.Request("D", Action::Unload));
+    lc.OnDetached("D", 1000);
+    for (int64_t now = 1000; now <= 3000; now += 50)
+        lc.OnQuiescenceSample("D", true, now);
+
+    CHECK_EQ(lc.GetStage("D"), Stage::Failed);
+    CHECK(!lc.NeedsSample("D", 5000));
+    CHECK(lc.NextToFree().empty());
+    CHECK(!lc.IsBusy());
+    CHECK(lc.Request("C", Action::Unload));
+}
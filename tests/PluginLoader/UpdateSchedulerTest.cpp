@@ -0,0 +1,357 @@
+#include "Test.h"
+#include "UpdateScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    class TestPlugin : public IPlugin
+    {
+    public:
+        const char* GetPluginName() override { return "Test"; }
+        uint32_t GetPluginVersion() override { return 1; }
+        void OnPluginInit(const PluginLoaderInterface&) override {}
+        void OnUpdate() override
+        {
+            if (onUpdateCost.count() > 0)
+                std::this_thread::sleep_for(onUpdateCost);
+        }
+
+        std::chrono::microseconds onUpdateCost{ 0 };
+    };
+
+    struct Counter
+    {
+        std::atomic<int> runs{ 0 };
+        std::atomic<std::thread::id> lastThread{};
+        std::chrono::microseconds cost{ 0 };
+
+        static void Run(void* userData)
+        {
+            auto* self = static_cast<Counter*>(userData);
+            self->lastThread = std::this_thread::get_id();
+            if (self->cost.count() > 0)
+                std::this_thread::sleep_for(self->cost);
+            self->runs++;
+        }
+    };
+
+    UpdateTaskDesc Desc(Counter& counter, UpdateFrequency frequency, UpdateAffinity affinity = UpdateAffinity::RenderThread)
+    {
+        UpdateTaskDesc desc;
+        desc.name = "task";
+        desc.callback = &Counter::Run;
+        desc.userData = &counter;
+        desc.frequency = frequency;
+        desc.affinity = affinity;
+        return desc;
+    }
+
+    template <typename Pred>
+    bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms)
+    {
+        const auto end = std::chrono::steady_clock::now() + timeout;
+        while (!pred())
+        {
+            if (std::chrono::steady_clock::now() > end)
+                return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+}
+
+TEST(EveryFrameRunsOncePerFrame)
+{
+    UpdateScheduler scheduler;
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+    Counter counter;
+    REQUIRE(scheduler.Register(&plugin, Desc(counter, UpdateFrequency::EveryFrame)) != 0);
+
+    for (int i = 0; i < 5; ++i)
+        scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 5);
+    CHECK(counter.lastThread.load() == std::this_thread::get_id());
+}
+
+TEST(InvalidDescriptionsAreRejected)
+{
+    UpdateScheduler scheduler;
+    TestPlugin plugin;
+    Counter counter;
+
+    UpdateTaskDesc rate = Desc(counter, UpdateFrequency::FixedRate);
+    rate.rateHz = 0.0f;
+    CHECK_EQ(scheduler.Register(&plugin, rate), 0u);
+
+    UpdateTaskDesc event = Desc(counter, UpdateFrequency::OnEvent);
+    CHECK_EQ(scheduler.Register(&plugin, event), 0u);
+
+    UpdateTaskDesc noCallback = Desc(counter, UpdateFrequency::EveryFrame);
+    noCallback.callback = nullptr;
+    CHECK_EQ(scheduler.Register(&plugin, noCallback), 0u);
+}
+
+TEST(FixedRateRunsAtMostOncePerFrameAndWaitsForItsPeriod)
+{
+    UpdateScheduler scheduler;
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+    Counter counter;
+    UpdateTaskDesc desc = Desc(counter, UpdateFrequency::FixedRate);
+    desc.rateHz = 20.0f; // 50 ms
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 1);
+    for (int i = 0; i < 10; ++i)
+        scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 1);
+
+    std::this_thread::sleep_for(60ms);
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 2);
+}
+
+TEST(OnEventCoalescesSignals)
+{
+    UpdateScheduler scheduler;
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+    Counter counter;
+    UpdateTaskDesc desc = Desc(counter, UpdateFrequency::OnEvent);
+    desc.eventName = "test.event";
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 0);
+
+    scheduler.Signal("test.event");
+    scheduler.Signal("test.event");
+    scheduler.Signal("other.event");
+    scheduler.RunRenderThread({ &plugin });
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(counter.runs.load(), 1);
+}
+
+TEST(WorkerTasksRunOffTheRenderThread)
+{
+    UpdateScheduler scheduler;
+    scheduler.Start();
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+    Counter counter;
+    UpdateTaskDesc desc = Desc(counter, UpdateFrequency::OnEvent, UpdateAffinity::Worker);
+    desc.eventName = "test.worker";
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    scheduler.Signal("test.worker");
+    CHECK(WaitFor([&] { return counter.runs.load() == 1; }));
+    CHECK(counter.lastThread.load() != std::this_thread::get_id());
+    scheduler.Stop();
+}
+
+TEST(RemovePluginWaitsForARunningWorkerTask)
+{
+    UpdateScheduler scheduler;
+    scheduler.Start();
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    std::atomic<bool> entered{ false }, finished{ false };
+    struct Slow
+    {
+        std::atomic<bool>* entered;
+        std::atomic<bool>* finished;
+        static void Run(void* userData)
+        {
+            auto* self = static_cast<Slow*>(userData);
+            *self->entered = true;
+            std::this_thread::sleep_for(30ms);
+            *self->finished = true;
+        }
+    } slow{ &entered, &finished };
+
+    UpdateTaskDesc desc;
+    desc.name = "slow";
+    desc.callback = &Slow::Run;
+    desc.userData = &slow;
+    desc.frequency = UpdateFrequency::OnEvent;
+    desc.eventName = "test.slow";
+    desc.affinity = UpdateAffinity::Worker;
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    scheduler.Signal("test.slow");
+    REQUIRE(WaitFor([&] { return entered.load(); }));
+    scheduler.RemovePlugin(&plugin);
+    CHECK(finished.load());
+
+    UpdateScheduler::PluginStats stats;
+    CHECK(!scheduler.GetStats(&plugin, stats));
+    scheduler.Stop();
+}
+
+TEST(UnregisterFromInsideTheCallback)
+{
+    UpdateScheduler scheduler;
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    struct SelfRemoving
+    {
+        UpdateScheduler* scheduler;
+        UpdateTaskHandle handle = 0;
+        int runs = 0;
+        static void Run(void* userData)
+        {
+            auto* self = static_cast<SelfRemoving*>(userData);
+            self->runs++;
+            self->scheduler->Unregister(self->handle);
+        }
+    } task{ &scheduler };
+
+    UpdateTaskDesc desc;
+    desc.name = "self";
+    desc.callback = &SelfRemoving::Run;
+    desc.userData = &task;
+    task.handle = scheduler.Register(&plugin, desc);
+    REQUIRE(task.handle != 0);
+
+    scheduler.RunRenderThread({ &plugin });
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(task.runs, 1);
+
+    UpdateScheduler::PluginStats stats;
+    REQUIRE(scheduler.GetStats(&plugin, stats));
+    CHECK_EQ(stats.taskCount, (size_t)0);
+}
+
+// A plugin whose own tasks used up the budget has its rate/event tasks pushed to a later frame.
+TEST(TaskTimeOverBudgetDefersRateAndEventTasks)
+{
+    UpdateScheduler scheduler;
+    scheduler.SetBudgetMs(0.5);
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    Counter heavy;
+    heavy.cost = 2ms;
+    REQUIRE(scheduler.Register(&plugin, Desc(heavy, UpdateFrequency::EveryFrame)) != 0);
+    Counter event;
+    UpdateTaskDesc desc = Desc(event, UpdateFrequency::OnEvent);
+    desc.eventName = "test.deferred";
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    scheduler.Signal("test.deferred");
+    scheduler.RunRenderThread({ &plugin });
+    CHECK_EQ(event.runs.load(), 0);
+
+    UpdateScheduler::PluginStats stats;
+    REQUIRE(scheduler.GetStats(&plugin, stats));
+    CHECK(stats.deferredRuns >= 1);
+    CHECK(stats.overruns >= 1);
+}
+
+// The starvation case: OnUpdate() alone exceeds the budget every frame. Its time must not keep the
+// plugin's rate and event tasks from ever running.
+TEST(SlowOnUpdateDoesNotStarveRateAndEventTasks)
+{
+    UpdateScheduler scheduler;
+    scheduler.SetBudgetMs(0.5);
+    TestPlugin plugin;
+    plugin.onUpdateCost = 2ms;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    Counter rate;
+    UpdateTaskDesc rateDesc = Desc(rate, UpdateFrequency::FixedRate);
+    rateDesc.rateHz = 1000.0f;
+    REQUIRE(scheduler.Register(&plugin, rateDesc) != 0);
+
+    Counter event;
+    UpdateTaskDesc eventDesc = Desc(event, UpdateFrequency::OnEvent);
+    eventDesc.eventName = "test.starved";
+    REQUIRE(scheduler.Register(&plugin, eventDesc) != 0);
+
+    scheduler.Signal("test.starved");
+    for (int i = 0; i < 5; ++i)
+        scheduler.RunRenderThread({ &plugin });
+
+    CHECK_EQ(rate.runs.load(), 5);
+    CHECK_EQ(event.runs.load(), 1);
+
+    UpdateScheduler::PluginStats stats;
+    REQUIRE(scheduler.GetStats(&plugin, stats));
+    CHECK(stats.overruns >= 5); // Still reported as over budget
+    CHECK(stats.lastFrameMs >= 2.0);
+}
+
+// Even when the plugin's own tasks exceed the budget every frame, a deferred task runs once it has
+// waited the maximum deferral.
+TEST(DeferredTaskRunsAfterTheMaximumDeferral)
+{
+    UpdateScheduler scheduler;
+    scheduler.SetBudgetMs(0.5);
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    Counter heavy;
+    heavy.cost = 2ms;
+    REQUIRE(scheduler.Register(&plugin, Desc(heavy, UpdateFrequency::EveryFrame)) != 0);
+    Counter rate;
+    UpdateTaskDesc desc = Desc(rate, UpdateFrequency::FixedRate);
+    desc.rateHz = 100.0f;
+    REQUIRE(scheduler.Register(&plugin, desc) != 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    while (rate.runs.load() == 0 && std::chrono::steady_clock::now() - start < 1s)
+        scheduler.RunRenderThread({ &plugin });
+
+    const auto waited = std::chrono::steady_clock::now() - start;
+    CHECK_EQ(rate.runs.load(), 1);
+    CHECK(waited >= 100ms);
+    CHECK(waited < 500ms);
+}
+
+// Concurrent registration, signals and frames against the worker; meant for the TSan build.
+TEST(ConcurrentSignalsRegistrationAndFrames)
+{
+    UpdateScheduler scheduler;
+    scheduler.Start();
+    TestPlugin plugin;
+    scheduler.AddPlugin(&plugin, "Test");
+
+    Counter worker, render;
+    UpdateTaskDesc workerDesc = Desc(worker, UpdateFrequency::OnEvent, UpdateAffinity::Worker);
+    workerDesc.eventName = "test.mt";
+    REQUIRE(scheduler.Register(&plugin, workerDesc) != 0);
+    REQUIRE(scheduler.Register(&plugin, Desc(render, UpdateFrequency::EveryFrame)) != 0);
+
+    std::atomic<bool> done{ false };
+    std::atomic<int> signals{ 0 };
+    std::thread signaler([&] {
+        while (!done)
+        {
+            scheduler.Signal("test.mt");
+            signals++;
+            Counter temp;
+            const UpdateTaskHandle handle = scheduler.Register(&plugin, Desc(temp, UpdateFrequency::EveryFrame, UpdateAffinity::Worker));
+            scheduler.Unregister(handle);
+            std::this_thread::yield();
+        }
+    });
+
+    int frames = 0;
+    for (; frames < 200 || signals.load() < 100; ++frames)
+        scheduler.RunRenderThread({ &plugin });
+    done = true;
+    signaler.join();
+
+    CHECK_EQ(render.runs.load(), frames);
+    CHECK(WaitFor([&] { return worker.runs.load() > 0; }));
+    scheduler.RemovePlugin(&plugin);
+    scheduler.Stop();
+}
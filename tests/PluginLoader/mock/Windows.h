@@ -0,0 +1,50 @@
+#pragma once
+// Stand-in for the parts of <Windows.h> the hotkey code uses: window messages, virtual-key codes and
+// a tick count the test advances by hand. GetAsyncKeyState/GetKeyState report nothing down; keyboard
+// state only comes from the scripted messages.
+#include <cstdint>
+
+using BYTE = unsigned char;
+using WORD = unsigned short;
+using SHORT = short;
+using UINT = unsigned int;
+using DWORD = unsigned long;
+using ULONGLONG = unsigned long long;
+using WPARAM = uintptr_t;
+using LPARAM = intptr_t;
+using HANDLE = void*;
+using HMODULE = struct HINSTANCE__*;
+using HWND = struct HWND__*;
+
+#ifndef __declspec
+#define __declspec(x)
+#endif
+
+constexpr UINT WM_KEYDOWN = 0x0100, WM_KEYUP = 0x0101, WM_SYSKEYDOWN = 0x0104, WM_SYSKEYUP = 0x0105;
+constexpr UINT WM_KILLFOCUS = 0x0008, WM_ACTIVATEAPP = 0x001C;
+constexpr UINT WM_LBUTTONDOWN = 0x0201, WM_LBUTTONUP = 0x0202, WM_LBUTTONDBLCLK = 0x0203;
+constexpr UINT WM_RBUTTONDOWN = 0x0204, WM_RBUTTONUP = 0x0205, WM_RBUTTONDBLCLK = 0x0206;
+constexpr UINT WM_MBUTTONDOWN = 0x0207, WM_MBUTTONUP = 0x0208, WM_MBUTTONDBLCLK = 0x0209;
+constexpr UINT WM_XBUTTONDOWN = 0x020B, WM_XBUTTONUP = 0x020C, WM_XBUTTONDBLCLK = 0x020D;
+
+constexpr UINT VK_LBUTTON = 0x01, VK_RBUTTON = 0x02, VK_MBUTTON = 0x04, VK_XBUTTON1 = 0x05, VK_XBUTTON2 = 0x06;
+constexpr UINT VK_SHIFT = 0x10, VK_CONTROL = 0x11, VK_MENU = 0x12;
+constexpr UINT VK_LSHIFT = 0xA0, VK_RSHIFT = 0xA1, VK_LCONTROL = 0xA2, VK_RCONTROL = 0xA3, VK_LMENU = 0xA4, VK_RMENU = 0xA5;
+constexpr UINT XBUTTON1 = 0x0001, XBUTTON2 = 0x0002;
+constexpr UINT MAPVK_VSC_TO_VK_EX = 3;
+
+#define GET_XBUTTON_WPARAM(wParam) ((WORD)(((uintptr_t)(wParam) >> 16) & 0xFFFF))
+
+// Set 1 scan codes of the two Shift keys.
+inline UINT MapVirtualKeyW(UINT code, UINT mapType)
+{
+    if (mapType == MAPVK_VSC_TO_VK_EX)
+        return code == 0x36 ? VK_RSHIFT : code == 0x2A ? VK_LSHIFT : 0;
+    return 0;
+}
+
+inline SHORT GetAsyncKeyState(int) { return 0; }
+inline SHORT GetKeyState(int) { return 0; }
+
+inline ULONGLONG g_MockTickCount = 0;
+inline ULONGLONG GetTickCount64() { return g_MockTickCount; }
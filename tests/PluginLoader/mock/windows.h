@@ -0,0 +1,3 @@
+#pragma once
+// KeyBind.h spells it in lowercase.
+#include "Windows.h"
@@ -0,0 +1,28 @@
+#pragma once
+// Stand-in for <xinput.h>: the state struct and button flags.
+#include "Windows.h"
+
+constexpr WORD XINPUT_GAMEPAD_DPAD_UP = 0x0001, XINPUT_GAMEPAD_DPAD_DOWN = 0x0002;
+constexpr WORD XINPUT_GAMEPAD_DPAD_LEFT = 0x0004, XINPUT_GAMEPAD_DPAD_RIGHT = 0x0008;
+constexpr WORD XINPUT_GAMEPAD_START = 0x0010, XINPUT_GAMEPAD_BACK = 0x0020;
+constexpr WORD XINPUT_GAMEPAD_LEFT_THUMB = 0x0040, XINPUT_GAMEPAD_RIGHT_THUMB = 0x0080;
+constexpr WORD XINPUT_GAMEPAD_LEFT_SHOULDER = 0x0100, XINPUT_GAMEPAD_RIGHT_SHOULDER = 0x0200;
+constexpr WORD XINPUT_GAMEPAD_A = 0x1000, XINPUT_GAMEPAD_B = 0x2000, XINPUT_GAMEPAD_X = 0x4000, XINPUT_GAMEPAD_Y = 0x8000;
+constexpr BYTE XINPUT_GAMEPAD_TRIGGER_THRESHOLD = 30;
+
+struct XINPUT_GAMEPAD
+{
+    WORD wButtons;
+    BYTE bLeftTrigger;
+    BYTE bRightTrigger;
+    SHORT sThumbLX;
+    SHORT sThumbLY;
+    SHORT sThumbRX;
+    SHORT sThumbRY;
+};
+
+struct XINPUT_STATE
+{
+    DWORD dwPacketNumber;
+    XINPUT_GAMEPAD Gamepad;
+};
@@ -0,0 +1,174 @@
+"""
+Tests for symbolize_crash.py. Builds the crash log, linker map and a minimal PE with an export
+table in a temporary directory, so no binaries are checked in.
+
+Usage:
+    python tests/Tools/test_symbolize_crash.py
+"""
+import struct
+import subprocess
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parents[2]
+SCRIPT = REPO_ROOT / "symbolize_crash.py"
+sys.path.insert(0, str(REPO_ROOT))
+sys.dont_write_bytecode = True  # Don't leave __pycache__ next to the script in the source tree
+import symbolize_crash  # noqa: E402
+
+TIMESTAMP = 0x5F3A2B1C
+
+LOADER_MAP = """\
+ Loader
+
+ Timestamp is 5f3a2b1c (Mon Aug 17 2020)
+
+ Preferred load address is 10000000
+
+ Start         Length     Name                   Class
+ 0001:00000000 00001000H .text                   CODE
+
+  Address         Publics by Value              Rva+Base       Lib:Object
+
+ 0000:00000000       ___AbsoluteZero            00000000     <absolute>
+ 0001:00000000       _DllMain@12                10001000 f   dllmain.obj
+ 0001:00000100       ?Tick@PluginLoaderApp@@QAEXXZ 10001100 f   PluginLoaderApp.obj
+"""
+
+CRASH_LOG = """\
+[12:00:00] Unhandled exception 0xC0000005
+[12:00:00] [frame] #00 0x6A001120 Loader.asi+0x1120
+[12:00:00] [frame] #01 0x6A000800 Loader.asi+0x800
+[12:00:00] [frame] #02 0x00401190 Test.dll+0x1190
+[12:00:00] [frame] #03 0x77001234 ntdll.dll+0x1234
+[12:00:00] [frame] #04 0x12345678 0x12345678
+[12:00:00] [module] base=0x6A000000 size=0x20000 timestamp=0x5F3A2B1C C:\\Games\\ACB\\scripts\\Loader.asi
+[12:00:00] [module] base=0x400000 size=0x2000 timestamp=0x5F3A2B1C C:\\Games\\ACB\\Test.dll
+[12:00:00] [module] base=0x77000000 size=0x100000 timestamp=0x11111111 C:\\Windows\\SYSTEM32\\ntdll.dll
+"""
+
+
+def build_pe(timestamp, exports, forwarders=()):
+    """A PE32 image with a single section at RVA 0x1000 holding only an export directory.
+    `exports` maps name -> function RVA; `forwarders` are names exported as forwarder strings."""
+    section_rva, section_raw = 0x1000, 0x200
+    names = sorted(list(exports) + list(forwarders))
+    count = len(names)
+
+    header_size = 40
+    functions_rva = section_rva + header_size
+    names_rva = functions_rva + 4 * count
+    ordinals_rva = names_rva + 4 * count
+    strings_rva = ordinals_rva + 2 * count
+
+    strings = b""
+    name_rvas = []
+    function_rvas = []
+    for name in names:
+        name_rvas.append(strings_rva + len(strings))
+        strings += name.encode() + b"\0"
+    for name in names:
+        if name in exports:
+            function_rvas.append(exports[name])
+        else:
+            function_rvas.append(strings_rva + len(strings))
+            strings += b"OTHER." + name.encode() + b"\0"
+
+    export = struct.pack("<IIHHIIIIIII", 0, timestamp, 0, 0, 0, 1, count, count, functions_rva, names_rva, ordinals_rva)
+    export += b"".join(struct.pack("<I", rva) for rva in function_rvas)
+    export += b"".join(struct.pack("<I", rva) for rva in name_rvas)
+    export += b"".join(struct.pack("<H", i) for i in range(count))
+    export += strings
+    raw_size = (len(export) + 0x1FF) & ~0x1FF
+    export_size = len(export)
+
+    image = bytearray(section_raw + raw_size)
+    image[0:2] = b"MZ"
+    struct.pack_into("<I", image, 0x3C, 0x80)
+    image[0x80:0x84] = b"PE\0\0"
+    struct.pack_into("<HHIIIHH", image, 0x84, 0x14C, 1, timestamp, 0, 0, 0xE0, 0x2102)
+    optional = 0x98
+    struct.pack_into("<H", image, optional, 0x10B)
+    struct.pack_into("<II", image, optional + 96, section_rva, export_size)
+    table = optional + 0xE0
+    image[table:table + 8] = b".text\0\0\0"
+    struct.pack_into("<IIII", image, table + 8, raw_size, section_rva, raw_size, section_raw)
+    image[section_raw:section_raw + len(export)] = export
+    return bytes(image)
+
+
+class SymbolizeCrashTest(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.root = Path(self.dir.name)
+        (self.root / "crash.log").write_text(CRASH_LOG)
+        (self.root / "Loader.map").write_text(LOADER_MAP)
+        self.write_pe(TIMESTAMP)
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def write_pe(self, timestamp):
+        (self.root / "Test.dll").write_bytes(build_pe(timestamp, {"Alpha": 0x1100, "Beta": 0x1180}, forwarders=["Gamma"]))
+
+    def run_script(self, *args):
+        result = subprocess.run([sys.executable, str(SCRIPT), str(self.root / "crash.log"), *args],
+                                capture_output=True, text=True, check=True)
+        return result.stdout.splitlines()
+
+    def test_map_symbols_resolve_with_displacement(self):
+        lines = self.run_script()
+        self.assertIn("#00 0x6A001120 Loader.asi!?Tick@PluginLoaderApp@@QAEXXZ+0x20", lines)
+        # Below the first public: no symbol, just the module offset.
+        self.assertIn("#01 0x6A000800 Loader.asi+0x800", lines)
+
+    def test_exports_resolve_when_there_is_no_map(self):
+        lines = self.run_script()
+        self.assertIn("#02 0x401190 Test.dll!Beta+0x10", lines)
+        self.assertTrue(any(line.strip().startswith("Test.dll:") and "(exports)" in line for line in lines))
+
+    def test_frames_outside_known_binaries_stay_raw(self):
+        lines = self.run_script()
+        self.assertIn("#03 0x77001234 ntdll.dll+0x1234", lines)
+        self.assertIn("#04 0x12345678", lines)
+        self.assertIn("  ntdll.dll: (none)", lines)
+
+    def test_mismatched_timestamp_is_not_trusted(self):
+        self.write_pe(TIMESTAMP + 1)
+        lines = self.run_script()
+        self.assertIn("#02 0x401190 Test.dll+0x1190", lines)
+        self.assertTrue(any("does not match the crashed module" in line for line in lines))
+
+    def test_search_directories_are_searched_recursively(self):
+        other = Path(tempfile.mkdtemp(dir=self.root))
+        nested = other / "Release"
+        nested.mkdir()
+        (self.root / "Loader.map").rename(nested / "Loader.map")
+        lines = self.run_script("-s", str(other))
+        self.assertIn("#00 0x6A001120 Loader.asi!?Tick@PluginLoaderApp@@QAEXXZ+0x20", lines)
+
+    def test_log_without_frames(self):
+        (self.root / "crash.log").write_text("[12:00:00] Nothing to see\n")
+        lines = self.run_script()
+        self.assertEqual(len(lines), 1)
+        self.assertTrue(lines[0].startswith("[!] No raw frames found"))
+
+    def test_read_map_skips_absolute_symbols(self):
+        symbols = symbolize_crash.read_map(self.root / "Loader.map")
+        self.assertEqual(symbols, [(0x1000, "_DllMain@12"), (0x1100, "?Tick@PluginLoaderApp@@QAEXXZ")])
+
+    def test_read_pe_skips_forwarders(self):
+        timestamp, exports = symbolize_crash.read_pe(self.root / "Test.dll")
+        self.assertEqual(timestamp, TIMESTAMP)
+        self.assertEqual(sorted(exports), [(0x1100, "Alpha"), (0x1180, "Beta")])
+
+    def test_read_pe_rejects_other_files(self):
+        (self.root / "bogus.dll").write_bytes(b"not a pe")
+        with self.assertRaises(ValueError):
+            symbolize_crash.read_pe(self.root / "bogus.dll")
+
+
+if __name__ == "__main__":
+    unittest.main()
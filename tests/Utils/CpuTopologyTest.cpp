@@ -0,0 +1,177 @@
+#include "Test.h"
+#include "CpuAffinity.h"
+#include "CpuTopology.h"
+#include <windows.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace CpuTopology;
+
+namespace
+{
+    // Dumps in the format the loader's "Recommended" button copies (right-click), written from
+    // each part's published layout: Windows numbers SMT siblings next to each other.
+    const std::filesystem::path kDumps = std::filesystem::path(__FILE__).parent_path() / "fixtures" / "topology";
+
+    struct Expected
+    {
+        const char* file;
+        const char* description;
+        uint64_t defaultMask;   // Policy{}
+        uint64_t keepSmtMask;   // kKeepSmtPolicy (EaglePatch)
+    };
+
+    const Expected kExpected[] = {
+        // 4 cores: leaving core 0 free would drop below minCores, so it stays in.
+        { "i7-7700k_4c8t.txt",  "1 package, 4 cores / 8 threads, 1 L3 domain",                    0x55,       0xFF },
+        { "ryzen7_5800x.txt",   "1 package, 8 cores / 16 threads, 1 L3 domain",                   0x5554,     0xFFFC },
+        // Both CCDs have the same cache; the one without core 0 has more cores left.
+        { "ryzen9_5950x.txt",   "1 package, 16 cores / 32 threads, 2 L3 domains",                 0x55550000, 0xFFFF0000 },
+        // The stacked-cache CCD wins even though it holds core 0.
+        { "ryzen9_7950x3d.txt", "1 package, 16 cores / 32 threads, 2 L3 domains",                 0x5554,     0xFFFC },
+        // P-cores only.
+        { "i9-13900k.txt",      "1 package, 24 cores / 32 threads, 1 L3 domain (8P + 16E)",       0x5554,     0xFFFC },
+    };
+
+    std::string ReadDump(const char* file)
+    {
+        std::ifstream in(kDumps / file);
+        std::stringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    // The dump without its comment lines, which is what Serialize writes.
+    std::string StripComments(const std::string& text)
+    {
+        std::istringstream lines(text);
+        std::string line, out;
+        while (std::getline(lines, line))
+        {
+            if (!line.empty() && line[0] != '#')
+                out += line + "\n";
+        }
+        return out;
+    }
+
+    int CountBits(uint64_t mask)
+    {
+        int count = 0;
+        for (; mask; mask &= mask - 1)
+            count++;
+        return count;
+    }
+}
+
+TEST(DumpsRoundTripThroughParseAndSerialize)
+{
+    for (const Expected& expected : kExpected)
+    {
+        const std::string text = ReadDump(expected.file);
+        REQUIRE(!text.empty());
+
+        Topology topology;
+        std::string error;
+        CHECK(Parse(text, topology, &error));
+        CHECK_EQ(error, std::string());
+        CHECK_EQ(Serialize(topology), StripComments(text));
+        CHECK_EQ(Describe(topology), std::string(expected.description));
+
+        Topology again;
+        REQUIRE(Parse(Serialize(topology), again));
+        CHECK_EQ(Serialize(again), Serialize(topology));
+    }
+}
+
+TEST(PlannedMaskForEachDump)
+{
+    for (const Expected& expected : kExpected)
+    {
+        Topology topology;
+        REQUIRE(Parse(ReadDump(expected.file), topology));
+        const uint64_t all = topology.processors.size() == 64 ? ~0ULL : (1ULL << topology.processors.size()) - 1;
+
+        const Plan plan = PlanAffinity(topology, Policy{}, all);
+        CHECK_EQ(plan.mask, expected.defaultMask);
+        CHECK_EQ(plan.cores, (uint32_t)CountBits(expected.defaultMask));
+        CHECK_EQ(PlanAffinity(topology, kKeepSmtPolicy, all).mask, expected.keepSmtMask);
+    }
+}
+
+// What the EaglePatch fix gives the game: on SMT parts, one thread per core would take it from the
+// 15 threads the old "everything but CPU 0" fix left down to 7 of 16; keeping the siblings of the
+// planned cores gives 14 (the sibling of CPU 0 goes with it).
+TEST(KeepSmtPolicyKeepsSiblingsOfThePlannedCores)
+{
+    Topology topology;
+    REQUIRE(Parse(ReadDump("ryzen7_5800x.txt"), topology));
+    const Plan onePerCore = PlanAffinity(topology, Policy{}, 0xFFFF);
+    const Plan keepSmt = PlanAffinity(topology, kKeepSmtPolicy, 0xFFFF);
+    CHECK_EQ(CountBits(onePerCore.mask), 7);
+    CHECK_EQ(CountBits(keepSmt.mask), 14);
+    CHECK_EQ(keepSmt.cores, onePerCore.cores);
+    CHECK(keepSmt.reserveFirstCore);
+    CHECK_EQ(keepSmt.mask & onePerCore.mask, onePerCore.mask);
+}
+
+TEST(PlanStaysInsideTheAllowedMask)
+{
+    Topology topology;
+    REQUIRE(Parse(ReadDump("ryzen9_5950x.txt"), topology));
+
+    // The process is already limited to CCD0: plan inside it.
+    Plan plan = PlanAffinity(topology, Policy{}, 0xFFFF);
+    CHECK_EQ(plan.mask, 0x5554ULL);
+    CHECK(plan.sameL3);
+
+    // Two cores allowed: every constraint gives way, but never an empty mask.
+    plan = PlanAffinity(topology, Policy{}, 0x0F);
+    CHECK_EQ(plan.mask, 0x05ULL);
+    CHECK(!plan.sameL3 && !plan.preferPerformance && !plan.reserveFirstCore);
+
+    // Processors the topology doesn't know about: the allowed mask as is.
+    CHECK_EQ(PlanAffinity(topology, Policy{}, 1ULL << 40).mask, 1ULL << 40);
+    CHECK_EQ(PlanAffinity(Topology{}, Policy{}, 0xFF).mask, 0xFFULL);
+}
+
+TEST(ParseRejectsMalformedDumps)
+{
+    Topology topology;
+    std::string error;
+    CHECK(!Parse("cpu 0 core 0\ncpu 0 core 1\n", topology, &error));
+    CHECK_EQ(error, std::string("line 2: duplicate cpu 0"));
+    CHECK(!Parse("cpu 64 core 0\n", topology, &error));
+    CHECK_EQ(error, std::string("line 1: bad cpu index"));
+    CHECK(!Parse("cpu 1 core\n", topology, &error));
+    CHECK_EQ(error, std::string("line 1: missing value for 'core'"));
+    CHECK(!Parse("# header\ncore 1\n", topology, &error));
+    CHECK_EQ(error, std::string("line 2: expected 'cpu', got 'core'"));
+    CHECK(!Parse("cpu 1 smt 1\n", topology, &error));
+    CHECK_EQ(error, std::string("line 1: unknown field 'smt'"));
+
+    // Out of order is fine; the result is sorted by index.
+    REQUIRE(Parse("cpu 1 core 0\ncpu 0 core 0 # sibling\n", topology));
+    CHECK_EQ(topology.processors[0].index, 0u);
+    CHECK(topology.HasSmt());
+}
+
+// CpuAffinity reads the same layout from GetLogicalProcessorInformationEx (the stand-in answers from
+// g_MockTopology); GetTopology caches it, so this is the one test that queries.
+TEST(RecommendedMaskFromTheWindowsQuery)
+{
+    REQUIRE(Parse(ReadDump("ryzen9_7950x3d.txt"), g_MockTopology));
+
+    const Topology& queried = CpuAffinity::GetTopology();
+    CHECK_EQ(Serialize(queried), Serialize(g_MockTopology));
+    CHECK_EQ(CpuAffinity::GetSystemAffinityMask(), 0xFFFFFFFFULL);
+
+    CHECK_EQ(CpuAffinity::GetRecommendedMask(), 0x5554ULL);
+    const uint64_t eaglePatch = CpuAffinity::GetRecommendedMask(kKeepSmtPolicy);
+    CHECK_EQ(eaglePatch, 0xFFFCULL);
+
+    CpuAffinity::Apply(eaglePatch);
+    CHECK_EQ(CpuAffinity::GetCurrentProcessMask(), 0xFFFCULL);
+    CpuAffinity::Apply(0);
+    CHECK_EQ(CpuAffinity::GetCurrentProcessMask(), 0xFFFCULL);
+}
@@ -0,0 +1,211 @@
+#include "Test.h"
+#include "ExceptionRecorder.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using SiteKey = std::pair<uint32_t, uint64_t>;
+
+    // The recorder is ~20 KB of atomics; keep it off the test thread's stack.
+    std::unique_ptr<ExceptionRecorder> MakeRecorder() { return std::make_unique<ExceptionRecorder>(); }
+
+    // Every field of a recent entry derives from the same (thread, i), so a torn read shows up as a
+    // mismatch.
+    uint32_t CodeFor(uint64_t i) { return 0xC0000005u + (uint32_t)(i % 2); }
+    uint64_t AddressFor(uint64_t i) { return 0x401000 + (i % 37) * 16; }
+    uint64_t StampFor(uint32_t thread, uint64_t i) { return ((uint64_t)thread << 32) | i; }
+
+    bool IsConsistent(const ExceptionRecorder::Entry& e)
+    {
+        const uint64_t i = e.timestamp & 0xFFFFFFFF;
+        return (e.timestamp >> 32) == e.threadId && e.code == CodeFor(i) && e.address == AddressFor(i);
+    }
+
+    // Releases all producers at once so they contend from the first Add.
+    class StartLine
+    {
+    public:
+        explicit StartLine(int threads) : m_waiting(threads) {}
+        void Arrive()
+        {
+            m_waiting.fetch_sub(1);
+            while (m_waiting.load() > 0)
+                std::this_thread::yield();
+        }
+
+    private:
+        std::atomic<int> m_waiting;
+    };
+}
+
+TEST(DrainReportsCountsSinceThePreviousDrain)
+{
+    auto recorder = MakeRecorder();
+    for (int i = 0; i < 3; ++i)
+        recorder->Add(0xC0000005, 0x1000, 7, i);
+    recorder->Add(0x80000003, 0x2000, 8, 3);
+
+    std::map<SiteKey, ExceptionRecorder::SiteSummary> sites;
+    CHECK_EQ(recorder->DrainSites([&](const ExceptionRecorder::SiteSummary& s) { sites[{ s.code, s.address }] = s; }), (size_t)2);
+    CHECK_EQ(sites[SiteKey(0xC0000005, 0x1000)].count, 3u);
+    CHECK_EQ(sites[SiteKey(0x80000003, 0x2000)].lastThreadId, 8u);
+
+    // Quiet sites are skipped; totals keep growing across drains.
+    CHECK_EQ(recorder->DrainSites([](const ExceptionRecorder::SiteSummary&) {}), (size_t)0);
+    recorder->Add(0xC0000005, 0x1000, 7, 4);
+    recorder->DrainSites([&](const ExceptionRecorder::SiteSummary& s) {
+        CHECK_EQ(s.count, 1u);
+        CHECK_EQ(s.total, (uint64_t)4);
+    });
+    CHECK_EQ(recorder->GetAddedCount(), (uint64_t)5);
+}
+
+TEST(RecentKeepsTheLastRecordsOldestFirst)
+{
+    auto recorder = MakeRecorder();
+    const uint64_t total = ExceptionRecorder::kRecentCount + 10;
+    for (uint64_t i = 0; i < total; ++i)
+        recorder->Add(CodeFor(i), AddressFor(i), 0, StampFor(0, i));
+
+    std::vector<uint64_t> stamps;
+    recorder->ForEachRecent([&](const ExceptionRecorder::Entry& e) { stamps.push_back(e.timestamp); });
+    REQUIRE(stamps.size() == ExceptionRecorder::kRecentCount);
+    for (size_t i = 0; i < stamps.size(); ++i)
+        CHECK_EQ(stamps[i], StampFor(0, total - ExceptionRecorder::kRecentCount + i));
+}
+
+TEST(FullTableCountsUntrackedSites)
+{
+    auto recorder = MakeRecorder();
+    constexpr int kAdds = 2000;
+    for (int i = 0; i < kAdds; ++i)
+        recorder->Add(1, (uint64_t)i * 4096, 0, 0);
+
+    uint64_t drained = 0;
+    const size_t sites = recorder->DrainSites([&](const ExceptionRecorder::SiteSummary& s) { drained += s.count; });
+    const uint64_t untracked = recorder->TakeUntrackedCount();
+    CHECK(sites <= ExceptionRecorder::kSiteCount);
+    CHECK(untracked > 0);
+    CHECK_EQ(drained + untracked, (uint64_t)kAdds);
+    CHECK_EQ(recorder->TakeUntrackedCount(), (uint64_t)0);
+}
+
+// All producers hit the same handful of brand-new sites at the same moment, so most of them find a
+// slot another producer has claimed but not yet published and go through the claiming spin. However
+// the race goes, no exception may be lost or counted against the wrong key.
+TEST(ConcurrentProducersClaimingTheSameSites)
+{
+    constexpr int kThreads = 8;
+    constexpr int kRounds = 200;
+    constexpr uint64_t kSitesPerRound = 4;
+
+    auto recorder = MakeRecorder();
+    std::map<SiteKey, uint64_t> counts;
+    uint64_t unexpected = 0;
+    auto drain = [&] {
+        recorder->DrainSites([&](const ExceptionRecorder::SiteSummary& s) {
+            if (s.code != 0xE06D7363 || (s.address & 0xFFF) >= kSitesPerRound)
+                ++unexpected;
+            counts[{ s.code, s.address }] += s.count;
+        });
+    };
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        StartLine start(kThreads);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            producers.emplace_back([&, t] {
+                start.Arrive();
+                for (uint64_t s = 0; s < kSitesPerRound; ++s)
+                    recorder->Add(0xE06D7363, ((uint64_t)round << 12) + s, t, 0);
+            });
+        }
+        for (auto& p : producers)
+            p.join();
+        // Keep the table from filling up: this is about claiming, not overflow.
+        if (round % 32 == 31)
+        {
+            drain();
+            recorder = MakeRecorder();
+        }
+    }
+    drain();
+
+    CHECK_EQ(unexpected, (uint64_t)0);
+    CHECK_EQ(counts.size(), (size_t)(kRounds * kSitesPerRound));
+    for (const auto& [key, count] : counts)
+        CHECK_EQ(count, (uint64_t)kThreads);
+}
+
+// Many producers on a 64-slot ring wrap it constantly, so a producer regularly lands on a slot that
+// a stalled one is still filling and drops its record. A drainer reads both structures throughout:
+// it must never see a torn recent entry, and the site counters must still account for every Add.
+TEST(ConcurrentProducersWrapTheRecentRing)
+{
+    constexpr int kThreads = 8;
+    constexpr uint64_t kAdds = 50000;
+
+    auto recorder = MakeRecorder();
+    std::atomic<bool> stop{ false };
+    uint64_t drained = 0;
+    size_t recentSeen = 0;
+    size_t torn = 0;
+    std::map<SiteKey, uint64_t> totals;
+
+    auto drainOnce = [&] {
+        recorder->DrainSites([&](const ExceptionRecorder::SiteSummary& s) {
+            drained += s.count;
+            totals[{ s.code, s.address }] = s.total;
+        });
+        recorder->ForEachRecent([&](const ExceptionRecorder::Entry& e) {
+            ++recentSeen;
+            if (!IsConsistent(e))
+                ++torn;
+        });
+    };
+
+    std::thread drainer([&] {
+        while (!stop.load())
+            drainOnce();
+    });
+
+    StartLine start(kThreads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        producers.emplace_back([&, t] {
+            start.Arrive();
+            for (uint64_t i = 0; i < kAdds; ++i)
+                recorder->Add(CodeFor(i), AddressFor(i), (uint32_t)t, StampFor((uint32_t)t, i));
+        });
+    }
+    for (auto& p : producers)
+        p.join();
+    stop = true;
+    drainer.join();
+    drainOnce();
+
+    CHECK_EQ(torn, (size_t)0);
+    CHECK(recentSeen > 0);
+    CHECK_EQ(drained, (uint64_t)kThreads * kAdds);
+    CHECK_EQ(recorder->TakeUntrackedCount(), (uint64_t)0);
+    CHECK_EQ(totals.size(), (size_t)(2 * 37));
+    CHECK_EQ(recorder->GetAddedCount(), (uint64_t)kThreads * kAdds);
+
+    // Whatever the race left behind, the ring is fully readable again once producers are quiet.
+    for (uint64_t i = 0; i < ExceptionRecorder::kRecentCount; ++i)
+        recorder->Add(CodeFor(i), AddressFor(i), 99, StampFor(99, i));
+    size_t fresh = 0;
+    recorder->ForEachRecent([&](const ExceptionRecorder::Entry& e) {
+        CHECK_EQ(e.timestamp, StampFor(99, fresh));
+        ++fresh;
+    });
+    CHECK_EQ(fresh, (size_t)ExceptionRecorder::kRecentCount);
+}
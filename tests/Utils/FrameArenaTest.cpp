@@ -0,0 +1,106 @@
+#include "Test.h"
+#include "FrameArena.h"
+#include "imgui.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+TEST(FormatAndCopyReturnTerminatedStrings)
+{
+    FrameArena arena(64);
+    const char* label = arena.Format("Save [%s]", "Ctrl + F5");
+    const char* copy = arena.Copy(std::string_view("abcdef", 3));
+    CHECK_EQ(std::string(label), std::string("Save [Ctrl + F5]"));
+    CHECK_EQ(std::string(copy), std::string("abc"));
+    CHECK_EQ(std::string(arena.Format("%s", "")), std::string(""));
+}
+
+TEST(AllocRespectsAlignment)
+{
+    FrameArena arena(256);
+    arena.Alloc(1, 1);
+    for (size_t align : { 2u, 4u, 8u, 16u, 64u })
+    {
+        void* p = arena.Alloc(3, align);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(p) % align, (uintptr_t)0);
+    }
+    double* d = arena.AllocArray<double>(3);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), (uintptr_t)0);
+}
+
+// Overflowing the first block must not move or clobber anything handed out before it.
+TEST(OverflowKeepsEarlierAllocationsIntact)
+{
+    FrameArena arena(64);
+    const char* first = arena.Format("Save [%s]", "Ctrl + F5");
+    for (int i = 0; i < 100; ++i)
+    {
+        const char* s = arena.Format("item %d %s", i, "xxxxxxxxxxxxxxxxxxxxxxxx");
+        char expected[64];
+        snprintf(expected, sizeof(expected), "item %d %s", i, "xxxxxxxxxxxxxxxxxxxxxxxx");
+        CHECK_EQ(std::string(s), std::string(expected));
+    }
+    // Larger than any block so far.
+    const std::string big(1000, 'b');
+    CHECK_EQ(std::string(arena.Copy(big)), big);
+
+    CHECK_EQ(std::string(first), std::string("Save [Ctrl + F5]"));
+    CHECK(arena.GetOverflowCount() > 0);
+    CHECK(arena.GetUsed() <= arena.GetCapacity());
+}
+
+TEST(ResetMergesOverflowSoTheNextFrameFits)
+{
+    FrameArena arena(64);
+    auto fillFrame = [&] {
+        for (int i = 0; i < 100; ++i)
+            arena.Format("item %d %s", i, "xxxxxxxxxxxxxxxxxxxxxxxx");
+    };
+
+    fillFrame();
+    const size_t used = arena.GetUsed();
+    const size_t capacity = arena.GetCapacity();
+    CHECK(arena.GetOverflowCount() > 0);
+
+    arena.Reset();
+    CHECK_EQ(arena.GetUsed(), (size_t)0);
+    CHECK_EQ(arena.GetCapacity(), capacity);
+    CHECK_EQ(arena.GetPeakUsed(), used);
+
+    const size_t overflows = arena.GetOverflowCount();
+    fillFrame();
+    CHECK_EQ(arena.GetOverflowCount(), overflows);
+    CHECK_EQ(arena.GetUsed(), used);
+
+    // A frame that fits reuses the block in place.
+    arena.Reset();
+    fillFrame();
+    CHECK_EQ(arena.GetCapacity(), capacity);
+    CHECK_EQ(arena.GetOverflowCount(), overflows);
+}
+
+TEST(GetResetsOncePerImGuiFrame)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+    io.DisplaySize = ImVec2(640, 480);
+    io.DeltaTime = 1.0f / 60.0f;
+
+    ImGui::NewFrame();
+    FrameArena::BeginFrame();
+    FrameArena::Get().Copy("first frame");
+    const size_t used = FrameArena::Get().GetUsed();
+    CHECK(used > 0);
+    ImGui::EndFrame();
+
+    ImGui::NewFrame();
+    CHECK_EQ(FrameArena::Get().GetUsed(), (size_t)0);
+    FrameArena::Get().Copy("x");
+    CHECK_EQ(FrameArena::Get().GetUsed(), (size_t)2);
+    ImGui::EndFrame();
+
+    ImGui::DestroyContext();
+}
@@ -0,0 +1,191 @@
+#include "Test.h"
+#include "StartupTimeline.h"
+#include "Trace.h"
+#include <chrono>
+#include <thread>
+
+using namespace StartupTimeline;
+
+namespace
+{
+    Span MakeSpan(const char* name, const char* category, const char* detail, int64_t startMs, int64_t durationMs, uint32_t threadId)
+    {
+        return Span{ name, category, detail, startMs * 1000, durationMs * 1000, threadId };
+    }
+
+    // A recorded startup: the game thread (1) runs DllMain, the loader thread (2) loads two plugins
+    // and the render thread (3) presents the first frame. `hookMs` slows one hook down.
+    std::vector<Span> RecordedStartup(int64_t hookMs)
+    {
+        return {
+            MakeSpan("ProcessStart", "loader", "", 0, 400, 1),
+            MakeSpan("Config::Load", "config", "", 402, 3, 1),
+            MakeSpan("InstallEarlyHooks", "basehook", "", 406, 20, 1),
+            MakeSpan("DllMain", "loader", "", 400, 30, 1),
+            MakeSpan("CrashHandler::Init", "loader", "", 431, 5, 2),
+            MakeSpan("PluginLoaderApp::Init", "loader", "", 430, 900 + hookMs, 2),
+            MakeSpan("BaseHook::Start", "basehook", "", 440, 50, 2),
+            MakeSpan("LoadPlugins", "plugins", "", 500, 800 + hookMs, 2),
+            MakeSpan("LoadPlugin", "plugins", "AC2-EaglePatch.asi", 500, 700 + hookMs, 2),
+            MakeSpan("LoadLibrary", "plugins", "AC2-EaglePatch.asi", 500, 50, 2),
+            MakeSpan("OnPluginInit", "plugins", "EaglePatch", 560, 600 + hookMs, 2),
+            MakeSpan("HookManager::ResolveAll", "hooks", "", 570, 400 + hookMs, 2),
+            MakeSpan("Resolve", "hooks", "FovHook", 570, 300 + hookMs, 2),
+            MakeSpan("Resolve", "hooks", "Fps", 870 + hookMs, 100, 2),
+            MakeSpan("PluginConfig::Load", "config", "", 980 + hookMs, 30, 2),
+            MakeSpan("LoadPlugin", "plugins", "AC2-Trainer.asi", 1200 + hookMs, 100, 2),
+            MakeSpan("InitImGui (DX9)", "render", "", 1400 + hookMs, 80, 3),
+            MakeSpan("LoadSystemFonts", "render", "", 1410 + hookMs, 60, 3),
+            MakeSpan("FirstFrame (DX9)", "render", "", 1400 + hookMs, 120, 3),
+            MakeSpan("AfterFirstFrame", "render", "", 5000, 1, 3),
+        };
+    }
+
+    const Node* FindNode(const Timeline& timeline, const std::string& name, const std::string& detail)
+    {
+        for (const Node& node : timeline.GetNodes())
+        {
+            if (node.span.name == name && node.span.detail == detail)
+                return &node;
+        }
+        return nullptr;
+    }
+}
+
+TEST(NestsSpansPerThreadAndAttributesPlugins)
+{
+    const Timeline timeline(RecordedStartup(0), 1520 * 1000);
+    CHECK_EQ(timeline.GetNodes().size(), (size_t)19);
+    CHECK(FindNode(timeline, "AfterFirstFrame", "") == nullptr);
+    CHECK_EQ(timeline.GetStartUs(), (int64_t)0);
+
+    const Node* resolve = FindNode(timeline, "Resolve", "FovHook");
+    REQUIRE(resolve != nullptr);
+    CHECK_EQ(resolve->owner, std::string("AC2-EaglePatch.asi"));
+    CHECK_EQ(resolve->depth, 5);
+    CHECK_EQ(resolve->path, std::string("PluginLoaderApp::Init / LoadPlugins / LoadPlugin [AC2-EaglePatch.asi] / "
+                                        "OnPluginInit [EaglePatch] / HookManager::ResolveAll / Resolve [FovHook]"));
+
+    const Node* resolveAll = FindNode(timeline, "HookManager::ResolveAll", "");
+    REQUIRE(resolveAll != nullptr);
+    CHECK_EQ(resolveAll->selfUs, (int64_t)0);
+    // 600 ms minus ResolveAll and the plugin's config load.
+    CHECK_EQ(FindNode(timeline, "OnPluginInit", "EaglePatch")->selfUs, (int64_t)(170 * 1000));
+
+    // Parents come from the same thread only.
+    const Node* config = FindNode(timeline, "Config::Load", "");
+    REQUIRE(config != nullptr && config->parent >= 0);
+    CHECK_EQ(timeline.GetNodes()[config->parent].span.name, std::string("DllMain"));
+    const Node* crashHandler = FindNode(timeline, "CrashHandler::Init", "");
+    REQUIRE(crashHandler != nullptr && crashHandler->parent >= 0);
+    CHECK_EQ(timeline.GetNodes()[crashHandler->parent].span.name, std::string("PluginLoaderApp::Init"));
+    CHECK(crashHandler->owner.empty());
+    const Node* frame = FindNode(timeline, "FirstFrame (DX9)", "");
+    REQUIRE(frame != nullptr);
+    CHECK_EQ(frame->parent, -1);
+    CHECK_EQ(FindNode(timeline, "LoadSystemFonts", "")->depth, 2);
+}
+
+TEST(CriticalPathCoversStartupInOrder)
+{
+    const Timeline timeline(RecordedStartup(0), 1520 * 1000);
+    const std::vector<PathEntry> path = timeline.GetCriticalPath();
+    REQUIRE(!path.empty());
+
+    int64_t covered = 0;
+    int64_t cursor = timeline.GetStartUs();
+    for (const PathEntry& entry : path)
+    {
+        CHECK_EQ(entry.startUs, cursor);
+        CHECK(entry.durationUs > 0);
+        cursor += entry.durationUs;
+        covered += entry.durationUs;
+    }
+    CHECK_EQ(covered, (int64_t)(1520 * 1000));
+
+    // Startup waited on the plugin loader and then on the first frame.
+    bool loader = false;
+    for (const PathEntry& entry : path)
+        loader |= entry.node >= 0 && timeline.GetNodes()[entry.node].span.name == "PluginLoaderApp::Init";
+    CHECK(loader);
+    REQUIRE(path.back().node >= 0);
+    CHECK_EQ(timeline.GetNodes()[path.back().node].span.name, std::string("FirstFrame (DX9)"));
+}
+
+TEST(TotalsRoundTrip)
+{
+    const Totals totals = Timeline(RecordedStartup(0), 1520 * 1000).GetTotals();
+    CHECK_EQ(totals.totalUs, (int64_t)(1520 * 1000));
+    CHECK(totals.pathUs.count("PluginLoaderApp::Init / LoadPlugins") == 1);
+
+    Totals loaded;
+    REQUIRE(ParseTotals(SerializeTotals(totals), loaded));
+    CHECK_EQ(loaded.totalUs, totals.totalUs);
+    CHECK(loaded.pathUs == totals.pathUs);
+
+    std::string error;
+    CHECK(!ParseTotals("12 x\n", loaded, &error));
+    CHECK(!error.empty());
+    CHECK(!ParseTotals("total 1\nabc path\n", loaded, &error));
+    CHECK(!ParseTotals("total -5\n", loaded, &error));
+}
+
+TEST(RegressionsNeedBothThresholdsAndRankBySlowdown)
+{
+    const DiffOptions options;
+    const Totals previous = Timeline(RecordedStartup(0), 1520 * 1000).GetTotals();
+    CHECK(FindRegressions(previous, previous, options).empty());
+
+    // 10 ms slower is noise.
+    CHECK(FindRegressions(previous, Timeline(RecordedStartup(10), 1530 * 1000).GetTotals(), options).empty());
+
+    const Timeline slower(RecordedStartup(250), 1770 * 1000);
+    const std::vector<Regression> regressions = FindRegressions(previous, slower.GetTotals(), options);
+    REQUIRE(!regressions.empty());
+    CHECK_EQ(regressions[0].currentUs - regressions[0].previousUs, (int64_t)(250 * 1000));
+    // Among the equal slowdowns, the hook that caused it comes first.
+    CHECK(regressions[0].path.find("Resolve [FovHook]") != std::string::npos);
+    for (size_t i = 1; i < regressions.size(); ++i)
+        CHECK(regressions[i].currentUs - regressions[i].previousUs <= regressions[i - 1].currentUs - regressions[i - 1].previousUs);
+
+    bool total = false;
+    for (const Regression& regression : regressions)
+        total |= regression.path == "(total)";
+    CHECK(total);
+
+    const std::string report = FormatReport(slower, &previous, options);
+    CHECK(report.find("AC2-EaglePatch.asi") != std::string::npos);
+    CHECK(report.find("FovHook") != std::string::npos);
+}
+
+// Spans from the real recorder on two threads, the way the loader feeds them in.
+TEST(BuildsFromTraceEvents)
+{
+    {
+        TRACE_SCOPE_CAT("Timeline.Outer", "plugins");
+        {
+            TRACE_SCOPE_DETAIL("LoadPlugin", "plugins", "Timeline.asi");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            {
+                TRACE_SCOPE_DETAIL("Resolve", "hooks", "Timeline.Hook");
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    std::thread([] {
+        TRACE_SCOPE("Timeline.Other");
+    }).join();
+
+    std::vector<Span> spans;
+    for (const Trace::Event& e : Trace::GetEvents())
+        spans.push_back({ e.name, e.category, e.detail, e.startUs, e.durationUs, e.threadId });
+    const Timeline timeline(spans, Trace::NowUs());
+
+    const Node* resolve = FindNode(timeline, "Resolve", "Timeline.Hook");
+    REQUIRE(resolve != nullptr);
+    CHECK_EQ(resolve->owner, std::string("Timeline.asi"));
+    CHECK_EQ(resolve->depth, 2);
+    const Node* other = FindNode(timeline, "Timeline.Other", "");
+    REQUIRE(other != nullptr);
+    CHECK_EQ(other->depth, 0);
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// The recorder is process-global, so every test looks only at the spans it recorded itself
+// (filtered by name) rather than at totals.
+namespace
+{
+    std::vector<Trace::Event> EventsNamed(const char* name)
+    {
+        std::vector<Trace::Event> events = Trace::GetEvents();
+        events.erase(std::remove_if(events.begin(), events.end(), [&](const Trace::Event& e) { return strcmp(e.name, name) != 0; }),
+            events.end());
+        return events;
+    }
+
+    struct SinkCall
+    {
+        std::string name;
+        std::string category;
+        int64_t durationUs;
+    };
+    std::vector<SinkCall> g_sinkCalls;
+
+    void TestSink(const char* name, const char* category, const char* /*detail*/, int64_t /*startUs*/, int64_t durationUs, uint32_t /*threadId*/)
+    {
+        g_sinkCalls.push_back({ name, category ? category : "", durationUs });
+    }
+}
+
+TEST(ScopeRecordsNestedSpans)
+{
+    {
+        TRACE_SCOPE_CAT("Trace.Outer", "test");
+        {
+            TRACE_SCOPE_DETAIL("Trace.Inner", "test", "detail");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    const auto outer = EventsNamed("Trace.Outer");
+    const auto inner = EventsNamed("Trace.Inner");
+    REQUIRE(outer.size() == 1 && inner.size() == 1);
+    CHECK_EQ(std::string(outer[0].category), std::string("test"));
+    CHECK_EQ(std::string(inner[0].detail), std::string("detail"));
+    CHECK_EQ(outer[0].threadId, Trace::CurrentThreadId());
+    CHECK(inner[0].durationUs >= 2000);
+    // Inner closes first but lies within the outer span.
+    CHECK(inner[0].startUs >= outer[0].startUs);
+    CHECK(inner[0].startUs + inner[0].durationUs <= outer[0].startUs + outer[0].durationUs);
+}
+
+TEST(MissingCategoryBecomesDefaultAndLongNamesTruncate)
+{
+    const std::string longName = "Trace.Long" + std::string(100, 'x');
+    Trace::Record(longName.c_str(), nullptr, nullptr, 10, 5, 1);
+
+    const auto events = EventsNamed(longName.substr(0, sizeof(Trace::Event::name) - 1).c_str());
+    REQUIRE(events.size() == 1);
+    CHECK_EQ(std::string(events[0].category), std::string("default"));
+    CHECK_EQ(std::string(events[0].detail), std::string(""));
+}
+
+TEST(DisabledRecordsNothing)
+{
+    Trace::SetEnabled(false);
+    {
+        TRACE_SCOPE("Trace.WhileDisabled");
+    }
+    Trace::Record("Trace.WhileDisabled", "test", nullptr, 0, 1, 1);
+    Trace::SetEnabled(true);
+
+    CHECK(EventsNamed("Trace.WhileDisabled").empty());
+}
+
+TEST(SinkReceivesSpansInsteadOfBuffers)
+{
+    g_sinkCalls.clear();
+    Trace::InitSink(&TestSink);
+    {
+        TRACE_SCOPE_CAT("Trace.ToSink", "plugins");
+    }
+    Trace::InitSink(nullptr);
+
+    REQUIRE(g_sinkCalls.size() == 1);
+    CHECK_EQ(g_sinkCalls[0].name, std::string("Trace.ToSink"));
+    CHECK_EQ(g_sinkCalls[0].category, std::string("plugins"));
+    CHECK(EventsNamed("Trace.ToSink").empty());
+}
+
+TEST(ChromeJsonEscapesAndNamesThreads)
+{
+    std::thread([] {
+        Trace::SetThreadName("Named \"worker\"");
+        Trace::Record("Trace.Json\t\"quoted\"\\", "test", "line\nbreak", 100, 7, Trace::CurrentThreadId());
+    }).join();
+
+    const std::string json = Trace::SerializeChromeJSON();
+    CHECK(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    CHECK(json.size() >= 2 && json.compare(json.size() - 2, 2, "]}") == 0);
+    CHECK(json.find("\"name\":\"Trace.Json\\t\\\"quoted\\\"\\\\\"") != std::string::npos);
+    CHECK(json.find("\"args\":{\"detail\":\"line\\nbreak\"}") != std::string::npos);
+    CHECK(json.find("\"name\":\"thread_name\"") != std::string::npos);
+    CHECK(json.find("Named \\\"worker\\\"") != std::string::npos);
+    CHECK(json.find("\"dur\":7,") != std::string::npos);
+}
+
+TEST(FullThreadBufferDropsAndCounts)
+{
+    const size_t droppedBefore = Trace::GetDroppedCount();
+    std::thread([] {
+        // 256 chunks of 256 spans per thread, then everything is dropped.
+        for (int i = 0; i < 256 * 256 + 10; ++i)
+            Trace::Record("Trace.Flood", "test", nullptr, i, 1, Trace::CurrentThreadId());
+    }).join();
+
+    CHECK_EQ(EventsNamed("Trace.Flood").size(), (size_t)(256 * 256));
+    CHECK_EQ(Trace::GetDroppedCount() - droppedBefore, (size_t)10);
+}
+
+// Recording is lock-free per thread and readers snapshot while writers run; under TSan this
+// checks the publish order of the per-thread count against the event writes.
+TEST(ConcurrentRecordAndSnapshot)
+{
+    constexpr int kThreads = 4;
+    constexpr int kSpans = 5000;
+    std::atomic<bool> done{ false };
+    std::atomic<int> torn{ 0 };
+
+    std::thread reader([&] {
+        while (!done.load())
+        {
+            for (const Trace::Event& e : Trace::GetEvents())
+            {
+                if (strcmp(e.name, "Trace.Concurrent") == 0 && (e.durationUs != e.startUs * 2 || strcmp(e.category, "mt") != 0))
+                    torn++;
+            }
+            Trace::SerializeChromeJSON();
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([] {
+            for (int i = 0; i < kSpans; ++i)
+                Trace::Record("Trace.Concurrent", "mt", nullptr, i, i * 2, Trace::CurrentThreadId());
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    done = true;
+    reader.join();
+
+    CHECK_EQ(torn.load(), 0);
+    CHECK_EQ(EventsNamed("Trace.Concurrent").size(), (size_t)(kThreads * kSpans));
+}
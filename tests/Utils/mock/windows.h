@@ -0,0 +1,156 @@
+#pragma once
+// Stand-in for the <windows.h> CpuAffinity.cpp includes: the process affinity calls and
+// GetLogicalProcessorInformationEx, answered from g_MockTopology as Windows would lay it out
+// (one entry per core, per package and per L3 cache).
+#include "../../support/win32/Windows.h"
+#include "CpuTopology.h"
+#include <cstring>
+#include <set>
+#include <vector>
+
+using BOOL = int;
+using BYTE = unsigned char;
+using WORD = unsigned short;
+using DWORD_PTR = uintptr_t;
+using KAFFINITY = uintptr_t;
+
+#define TRUE 1
+#define FALSE 0
+#define ANYSIZE_ARRAY 1
+#define ERROR_INSUFFICIENT_BUFFER 122L
+
+enum LOGICAL_PROCESSOR_RELATIONSHIP
+{
+    RelationProcessorCore = 0,
+    RelationNumaNode = 1,
+    RelationCache = 2,
+    RelationProcessorPackage = 3,
+    RelationGroup = 4,
+    RelationAll = 0xffff,
+};
+
+enum PROCESSOR_CACHE_TYPE { CacheUnified, CacheInstruction, CacheData, CacheTrace };
+
+struct GROUP_AFFINITY
+{
+    KAFFINITY Mask;
+    WORD Group;
+    WORD Reserved[3];
+};
+
+struct PROCESSOR_RELATIONSHIP
+{
+    BYTE Flags;
+    BYTE EfficiencyClass;
+    BYTE Reserved[20];
+    WORD GroupCount;
+    GROUP_AFFINITY GroupMask[ANYSIZE_ARRAY];
+};
+
+struct CACHE_RELATIONSHIP
+{
+    BYTE Level;
+    BYTE Associativity;
+    WORD LineSize;
+    DWORD CacheSize;
+    PROCESSOR_CACHE_TYPE Type;
+    BYTE Reserved[18];
+    WORD GroupCount;
+    GROUP_AFFINITY GroupMask;
+};
+
+struct SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX
+{
+    LOGICAL_PROCESSOR_RELATIONSHIP Relationship;
+    DWORD Size;
+    union
+    {
+        PROCESSOR_RELATIONSHIP Processor;
+        CACHE_RELATIONSHIP Cache;
+    };
+};
+
+inline CpuTopology::Topology g_MockTopology;
+inline DWORD_PTR g_MockProcessMask = 0;
+inline DWORD g_MockLastError = 0;
+
+inline DWORD GetLastError() { return g_MockLastError; }
+inline HANDLE GetCurrentProcess() { return reinterpret_cast<HANDLE>(static_cast<intptr_t>(-1)); }
+
+inline DWORD_PTR MockSystemMask()
+{
+    DWORD_PTR mask = 0;
+    for (const CpuTopology::LogicalProcessor& lp : g_MockTopology.processors)
+        mask |= DWORD_PTR(1) << lp.index;
+    return mask;
+}
+
+inline BOOL GetProcessAffinityMask(HANDLE, DWORD_PTR* processMask, DWORD_PTR* systemMask)
+{
+    *systemMask = MockSystemMask();
+    *processMask = g_MockProcessMask ? g_MockProcessMask : *systemMask;
+    return TRUE;
+}
+
+inline BOOL SetProcessAffinityMask(HANDLE, DWORD_PTR mask)
+{
+    g_MockProcessMask = mask;
+    return TRUE;
+}
+
+inline BOOL GetLogicalProcessorInformationEx(LOGICAL_PROCESSOR_RELATIONSHIP, SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* buffer, DWORD* length)
+{
+    // Entries are variable-sized on Windows; here every one takes the full struct.
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX> entries;
+    auto add = [&](LOGICAL_PROCESSOR_RELATIONSHIP relation, auto&& belongs) {
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.Relationship = relation;
+        entry.Size = sizeof(entry);
+        GROUP_AFFINITY& affinity = relation == RelationCache ? entry.Cache.GroupMask : entry.Processor.GroupMask[0];
+        for (const CpuTopology::LogicalProcessor& lp : g_MockTopology.processors)
+        {
+            if (belongs(lp))
+            {
+                affinity.Mask |= KAFFINITY(1) << lp.index;
+                if (relation == RelationProcessorCore)
+                    entry.Processor.EfficiencyClass = lp.efficiencyClass;
+                else if (relation == RelationCache)
+                {
+                    entry.Cache.Level = 3;
+                    entry.Cache.CacheSize = lp.l3SizeKB * 1024;
+                    entry.Cache.GroupCount = 1;
+                }
+            }
+        }
+        if (relation != RelationCache)
+            entry.Processor.GroupCount = 1;
+        entries.push_back(entry);
+    };
+
+    std::set<uint32_t> cores, packages, l3Domains;
+    for (const CpuTopology::LogicalProcessor& lp : g_MockTopology.processors)
+    {
+        cores.insert(lp.core);
+        packages.insert(lp.package);
+        l3Domains.insert(lp.l3);
+    }
+    for (uint32_t core : cores)
+        add(RelationProcessorCore, [core](const CpuTopology::LogicalProcessor& lp) { return lp.core == core; });
+    for (uint32_t l3 : l3Domains)
+        add(RelationCache, [l3](const CpuTopology::LogicalProcessor& lp) { return lp.l3 == l3; });
+    for (uint32_t package : packages)
+        add(RelationProcessorPackage, [package](const CpuTopology::LogicalProcessor& lp) { return lp.package == package; });
+
+    const DWORD needed = static_cast<DWORD>(entries.size() * sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX));
+    if (!buffer || *length < needed)
+    {
+        *length = needed;
+        g_MockLastError = ERROR_INSUFFICIENT_BUFFER;
+        return FALSE;
+    }
+    std::memcpy(buffer, entries.data(), needed);
+    *length = needed;
+    g_MockLastError = 0;
+    return TRUE;
+}
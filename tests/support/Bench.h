@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Timing loop for the *_bench executables (see ac_bench in CMakeLists.txt). Benchmarks are TEST()s
+// that call Bench::Measure for each variant they compare:
+//
+//   TEST(Lookup) { Bench::Measure("cached", [&] { Bench::DoNotOptimize(cache.Find(key)); }); }
+//
+// Measure runs the body in doubling batches until one takes at least 200 ms and prints the time per
+// call. ctest sets AC_BENCH_QUICK, which runs each body a handful of times: the gate checks that
+// benchmarks build and run, and the numbers come from running the binary directly.
+namespace Bench
+{
+    inline bool IsQuick()
+    {
+        static const bool quick = getenv("AC_BENCH_QUICK") != nullptr;
+        return quick;
+    }
+
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // Returns nanoseconds per call.
+    template <typename Fn>
+    double Measure(const char* label, Fn&& fn)
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto minTime = IsQuick() ? std::chrono::nanoseconds(0) : std::chrono::nanoseconds(std::chrono::milliseconds(200));
+
+        uint64_t batch = IsQuick() ? 4 : 1;
+        for (;;)
+        {
+            const auto start = Clock::now();
+            for (uint64_t i = 0; i < batch; ++i)
+                fn();
+            const auto elapsed = Clock::now() - start;
+            if (elapsed >= minTime || batch >= (1ull << 40))
+            {
+                const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (double)batch;
+                if (ns >= 100000.0)
+                    printf("  %-48s %10.2f ms/op  (%llu ops)\n", label, ns / 1e6, (unsigned long long)batch);
+                else
+                    printf("  %-48s %10.1f ns/op  (%llu ops)\n", label, ns, (unsigned long long)batch);
+                return ns;
+            }
+            batch *= 2;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#include "Test.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct Entry
+    {
+        const char* name;
+        Test::TestFn fn;
+    };
+
+    std::vector<Entry>& Registry()
+    {
+        static std::vector<Entry> tests;
+        return tests;
+    }
+
+    int g_failures = 0;
+}
+
+namespace Test
+{
+    void Register(const char* name, TestFn fn)
+    {
+        Registry().push_back({ name, fn });
+    }
+
+    void Fail(const char* file, int line, const std::string& what)
+    {
+        ++g_failures;
+        fprintf(stderr, "%s:%d: %s\n", file, line, what.c_str());
+    }
+}
+
+// Usage: <test> [name filter]
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int failedTests = 0, ran = 0;
+    for (const Entry& test : Registry())
+    {
+        if (filter && !strstr(test.name, filter))
+            continue;
+        const int before = g_failures;
+        test.fn();
+        ++ran;
+        const bool failed = g_failures != before;
+        failedTests += failed;
+        printf("[%s] %s\n", failed ? "FAIL" : " OK ", test.name);
+    }
+    printf("%d/%d passed\n", ran - failedTests, ran);
+    return failedTests == 0 && ran > 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+// Minimal test harness for the portable parts of the tree. Every test file is its own executable:
+//
+//   TEST(RingKeepsOrder) { CHECK(ring.Push(e)); CHECK_EQ(ring.GetDroppedCount(), 0u); }
+//
+// support/Test.cpp provides main(), which runs every registered test and fails if any check did.
+namespace Test
+{
+    using TestFn = void (*)();
+
+    void Register(const char* name, TestFn fn);
+    void Fail(const char* file, int line, const std::string& what);
+
+    struct Registrar
+    {
+        Registrar(const char* name, TestFn fn) { Register(name, fn); }
+    };
+
+    inline std::string ToString(const std::string& v) { return "\"" + v + "\""; }
+    inline std::string ToString(const char* v) { return v ? ToString(std::string(v)) : "null"; }
+    inline std::string ToString(bool v) { return v ? "true" : "false"; }
+    template <typename T>
+    std::string ToString(const T& v)
+    {
+        if constexpr (std::is_enum_v<T>)
+            return std::to_string(static_cast<long long>(v));
+        else if constexpr (std::is_pointer_v<T>)
+            return std::to_string(reinterpret_cast<uintptr_t>(v));
+        else
+            return std::to_string(v);
+    }
+}
+
+#define TEST(name)                                                      \
+    static void name();                                                 \
+    static const Test::Registrar name##_registrar(#name, &name);        \
+    static void name()
+
+#define CHECK(expr)                                                     \
+    do {                                                                \
+        if (!(expr))                                                    \
+            Test::Fail(__FILE__, __LINE__, "CHECK(" #expr ")");         \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                      \
+    do {                                                                \
+        const auto& actual_ = (actual);                                 \
+        const auto& expected_ = (expected);                             \
+        if (!(actual_ == expected_))                                    \
+            Test::Fail(__FILE__, __LINE__, "CHECK_EQ(" #actual ", " #expected "): " + \
+                Test::ToString(actual_) + " != " + Test::ToString(expected_)); \
+    } while (0)
+
+// Stops the current test; for checks later ones depend on.
+#define REQUIRE(expr)                                                   \
+    do {                                                                \
+        if (!(expr)) {                                                  \
+            Test::Fail(__FILE__, __LINE__, "REQUIRE(" #expr ")");       \
+            return;                                                     \
+        }                                                               \
+    } while (0)
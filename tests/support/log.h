@@ -0,0 +1,21 @@
+#pragma once
+#ifndef LOG_H
+#define LOG_H
+
+// Stand-in for CommonLib/Utils/include/log.h (which needs Windows.h): same macros, printed to stdout.
+#include <chrono>
+#include <cstdio>
+
+#define LOG_INFO(fmt, ...)  printf("[INFO] [%s] " fmt "\n", __func__, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  printf("[WARN] [%s] " fmt "\n", __func__, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) printf("[ERROR] [%s] " fmt "\n", __func__, ##__VA_ARGS__)
+#define LOG_THROTTLED(interval_ms, fmt, ...) do { \
+    static std::chrono::steady_clock::time_point s_lastLogTime; \
+    const auto now = std::chrono::steady_clock::now(); \
+    if (now - s_lastLogTime > std::chrono::milliseconds(interval_ms)) { \
+        s_lastLogTime = now; \
+        LOG_INFO(fmt, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+#endif // LOG_H
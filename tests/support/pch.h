@@ -0,0 +1,5 @@
+#pragma once
+// Stand-in for BaseHook/include/pch.h: the BaseHook sources under test only rely on it for logging
+// and tracing.
+#include "log.h"
+#include "Trace.h"
@@ -0,0 +1,21 @@
+#pragma once
+// The few Win32 declarations the headers under test use in their signatures, for building them
+// without the Windows SDK. Only on the include path of tests that need it.
+#include <chrono>
+#include <cstdint>
+
+using DWORD = unsigned long;
+using ULONGLONG = unsigned long long;
+using HANDLE = void*;
+using HMODULE = struct HINSTANCE__*;
+using HWND = struct HWND__*;
+
+#ifndef __declspec
+#define __declspec(x)
+#endif
+
+inline ULONGLONG GetTickCount64()
+{
+    using namespace std::chrono;
+    return (ULONGLONG)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}